@@ -153,6 +153,22 @@ const std::pair<int, std::string> conditionTree::bind_value(soci::details::once_
 	return {0, "success"};
 }
 
+const std::pair<int, std::string> conditionTree::bind_value(std::vector<const BindValue*>& values) {
+	std::string conditions;
+	if (bind_values_.empty())
+		format_conditions(1, conditions);
+
+	size_t size = bind_values_.size();
+	for (size_t indx = 0; indx < size; indx++) {
+		const std::vector<BindValue>& v = bind_values_[indx];
+		if (v.empty())
+			break;
+		for (size_t i = 0; i < v.size(); i++)
+			values.push_back(&v[i]);
+	}
+	return {0, "success"};
+}
+
 int conditionTree::bind_value(const BindValue& value, soci::details::once_temp_type& t) {
 	int result = 0;
 	if (value.isString() || value.isBlob() || value.isText() || value.isVarchar()) {
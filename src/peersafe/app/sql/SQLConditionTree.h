@@ -117,6 +117,8 @@ public:
 	const std::pair<int, std::string> asConditionString() const;
 	// bind once_temp_type with values,return {0, "success"} if success,otherwise return {-1, "bind value unsuccessfully"}
 	const std::pair<int, std::string> bind_value(soci::details::once_temp_type& t);
+	// collect values in the order they are bound,pointers are valid as long as this tree
+	const std::pair<int, std::string> bind_value(std::vector<const BindValue*>& values);
 private:
 	int format_conditions(int style, std::string& conditions) const;
 	int format_value(const BindValue& value, std::string& result) const;
@@ -0,0 +1,350 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <peersafe/app/sql/SQLPredicate.h>
+
+#include <boost/algorithm/string.hpp> // boost::iequals
+
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <cstdlib>
+
+namespace ripple {
+
+namespace {
+
+// a string which is a number as a whole
+bool as_number(const std::string& s, double& d) {
+	if (s.empty())
+		return false;
+	char* end = nullptr;
+	d = std::strtod(s.c_str(), &end);
+	return end == s.c_str() + s.size();
+}
+
+// LIKE of sqlite and the default collations of mysql,ascii letters are case insensitive
+bool like_match(const char* s, const char* p) {
+	const char* star_p = nullptr;
+	const char* star_s = nullptr;
+	while (*s) {
+		if (*p == '%') {
+			star_p = ++p;
+			star_s = s;
+		}
+		else if (*p && (*p == '_' ||
+			std::tolower((unsigned char)*p) == std::tolower((unsigned char)*s))) {
+			++p;
+			++s;
+		}
+		else if (star_p) {
+			p = star_p;
+			s = ++star_s;
+		}
+		else {
+			return false;
+		}
+	}
+	while (*p == '%')
+		++p;
+	return *p == 0;
+}
+
+// text ordered the same way by sqlite's binary collation and the case
+// insensitive collations of mysql,Unknown when they may disagree
+std::pair<SQLPredicate::Result, int> compare_text(const std::string& l, const std::string& r) {
+	int binary = l.compare(r);
+	binary = binary < 0 ? -1 : (binary > 0 ? 1 : 0);
+
+	size_t const n = std::min(l.size(), r.size());
+	size_t i = 0;
+	while (i < n && std::tolower((unsigned char)l[i]) == std::tolower((unsigned char)r[i]))
+		++i;
+	if (i == n) {
+		if (l.size() == r.size())
+			return{ binary == 0 ? SQLPredicate::True : SQLPredicate::Unknown, 0 };
+		// mysql pads the shorter one with spaces
+		unsigned char const next = l.size() > n ? l[n] : r[n];
+		if (!std::isalnum(next))
+			return{ SQLPredicate::Unknown, 0 };
+		return{ SQLPredicate::True, binary };
+	}
+
+	// letters and digits sort alike everywhere,except for the case
+	unsigned char const lc = std::tolower((unsigned char)l[i]);
+	unsigned char const rc = std::tolower((unsigned char)r[i]);
+	if (!std::isalnum(lc) || !std::isalnum(rc))
+		return{ SQLPredicate::Unknown, 0 };
+	int const folded = lc < rc ? -1 : 1;
+	if (folded != binary)
+		return{ SQLPredicate::Unknown, 0 };
+	return{ SQLPredicate::True, binary };
+}
+
+// `$regex` is bound as a LIKE pattern,see conditionTree::format_conditions
+std::string like_pattern(const std::string& regex) {
+	if (regex.size() >= 3 && regex[0] == '/' && regex[1] == '^' && regex.back() == '/')
+		return "%" + regex.substr(2, regex.size() - 3);
+	if (regex.size() >= 2 && regex[0] == '/' && regex.back() == '/')
+		return "%" + regex.substr(1, regex.size() - 2) + "%";
+	return regex;
+}
+
+bool to_value(const BindValue& b, SQLPredicate::Value& v) {
+	if (b.isString() || b.isVarchar() || b.isText() || b.isBlob() || b.isChar())
+		v = SQLPredicate::Value(b.asString());
+	else if (b.isInt())
+		v = SQLPredicate::Value(std::int64_t(b.asInt()));
+	else if (b.isUint())
+		v = SQLPredicate::Value(std::int64_t(b.asUint()));
+	else if (b.isDouble())
+		v = SQLPredicate::Value(b.asDouble());
+	else
+		return false;
+	return true;
+}
+
+} // namespace
+
+SQLPredicate::Value SQLPredicate::Value::fromJson(const Json::Value& j) {
+	if (j.isString())
+		return Value(j.asString());
+	if (j.isInt())
+		return Value(std::int64_t(j.asInt()));
+	if (j.isUInt())
+		return Value(std::int64_t(j.asUInt()));
+	if (j.isBool())
+		return Value(std::int64_t(j.asBool() ? 1 : 0));
+	if (j.isDouble())
+		return Value(j.asDouble());
+	return Value();
+}
+
+std::pair<SQLPredicate::Result, int> SQLPredicate::Value::compare(const Value& r) const {
+	if (type_ == Null || r.type_ == Null)
+		return{ False, 0 };
+
+	if (type_ == Text && r.type_ == Text)
+		return compare_text(s_, r.s_);
+
+	if (type_ == Integer && r.type_ == Integer)
+		return{ True, i_ < r.i_ ? -1 : (i_ > r.i_ ? 1 : 0) };
+
+	// the databases disagree on comparing text with numbers,
+	// unless the text is a number
+	double ld = d_, rd = r.d_;
+	if (type_ == Text && !as_number(s_, ld))
+		return{ Unknown, 0 };
+	if (r.type_ == Text && !as_number(r.s_, rd))
+		return{ Unknown, 0 };
+	return{ True, ld < rd ? -1 : (ld > rd ? 1 : 0) };
+}
+
+SQLPredicate::Result SQLPredicate::Value::like(const std::string& pattern) const {
+	if (type_ == Null)
+		return False;
+	if (type_ == Real)
+		return Unknown;
+	const std::string& s = type_ == Text ? s_ : std::to_string(i_);
+	// only ascii letters fold alike in both databases
+	auto const ascii = [](unsigned char c) { return c < 0x80; };
+	if (!std::all_of(s.begin(), s.end(), ascii) ||
+		!std::all_of(pattern.begin(), pattern.end(), ascii))
+		return Unknown;
+	return like_match(s.c_str(), pattern.c_str()) ? True : False;
+}
+
+SQLPredicate::SQLPredicate() {
+	root_.type = conditionTree::NodeType::Logical_And;
+}
+
+std::pair<int, std::string> SQLPredicate::compile(const Json::Value& conditions, SQLPredicate& predicate) {
+	auto root = conditionTree::createRoot(conditions);
+	if (root.first != 0)
+		return{ -1, "conditions are malformed." };
+
+	auto result = conditionParse::parse_conditions(conditions, root.second);
+	if (result.first != 0)
+		return result;
+	return compile(root.second, predicate);
+}
+
+std::pair<int, std::string> SQLPredicate::compile(conditionTree& root, SQLPredicate& predicate) {
+	SQLPredicate p;
+	std::string message;
+	if (p.compile_node(root, p.root_, message) != 0)
+		return{ -1, message };
+	predicate = std::move(p);
+	return{ 0, "success" };
+}
+
+int SQLPredicate::compile_node(conditionTree& tree, Node& node, std::string& message) {
+	node.type = tree.node_type();
+	if (node.type != conditionTree::NodeType::Expression) {
+		if (tree.size() < 2) {
+			message = "logical operator has less than two conditions.";
+			return -1;
+		}
+		for (auto it = tree.begin(); it != tree.end(); it++) {
+			node.children.push_back(Node());
+			if (compile_node(*it, node.children.back(), message) != 0)
+				return -1;
+		}
+		return 0;
+	}
+
+	auto expression = tree.parse_expression();
+	const std::string& keyname = std::get<0>(expression);
+	const std::string& op = std::get<1>(expression);
+	const std::vector<BindValue>& values = std::get<2>(expression);
+	if (keyname.empty() || values.empty()) {
+		message = "expression is malformed.";
+		return -1;
+	}
+
+	if (boost::iequals(op, "$eq"))
+		node.op = Eq;
+	else if (boost::iequals(op, "$ne"))
+		node.op = Ne;
+	else if (boost::iequals(op, "$lt"))
+		node.op = Lt;
+	else if (boost::iequals(op, "$le"))
+		node.op = Le;
+	else if (boost::iequals(op, "$gt"))
+		node.op = Gt;
+	else if (boost::iequals(op, "$ge"))
+		node.op = Ge;
+	else if (boost::iequals(op, "$in"))
+		node.op = In;
+	else if (boost::iequals(op, "$nin"))
+		node.op = Nin;
+	else if (boost::iequals(op, "$regex"))
+		node.op = Like;
+	else {
+		message = "operator " + op + " is not supported.";
+		return -1;
+	}
+
+	for (auto const& b : values) {
+		Value v;
+		if (!to_value(b, v)) {
+			message = "value of " + keyname + " is not supported.";
+			return -1;
+		}
+		node.values.push_back(std::move(v));
+	}
+	if (node.op == Like) {
+		if (!values[0].isString()) {
+			message = "$regex must be a string.";
+			return -1;
+		}
+		node.pattern = like_pattern(values[0].asString());
+	}
+	node.column = column_index(keyname);
+	return 0;
+}
+
+size_t SQLPredicate::column_index(const std::string& name) {
+	for (size_t i = 0; i < columns_.size(); i++) {
+		if (boost::iequals(columns_[i], name))
+			return i;
+	}
+	columns_.push_back(name);
+	return columns_.size() - 1;
+}
+
+SQLPredicate::Result SQLPredicate::evaluate(const Row& row) const {
+	assert(row.size() == columns_.size());
+	if (row.size() != columns_.size())
+		return Unknown;
+	return evaluate(root_, row);
+}
+
+SQLPredicate::Result SQLPredicate::evaluate(const Json::Value& row) const {
+	std::vector<Value> values(columns_.size());
+	Row r(columns_.size(), nullptr);
+	for (size_t i = 0; i < columns_.size(); i++) {
+		if (row.isMember(columns_[i])) {
+			values[i] = Value::fromJson(row[columns_[i]]);
+			r[i] = &values[i];
+		}
+	}
+	return evaluate(r);
+}
+
+SQLPredicate::Result SQLPredicate::evaluate(const Node& node, const Row& row) const {
+	if (node.type == conditionTree::NodeType::Expression) {
+		const Value* v = row[node.column];
+		if (v == nullptr)
+			return Unknown;
+		return evaluate_expression(node, *v);
+	}
+
+	// three-valued and/or
+	bool is_and = node.type == conditionTree::NodeType::Logical_And;
+	Result result = is_and ? True : False;
+	for (auto const& child : node.children) {
+		Result r = evaluate(child, row);
+		if (is_and && r == False)
+			return False;
+		if (!is_and && r == True)
+			return True;
+		if (r == Unknown)
+			result = Unknown;
+	}
+	return result;
+}
+
+SQLPredicate::Result SQLPredicate::evaluate_expression(const Node& node, const Value& v) {
+	if (node.op == Like)
+		return v.like(node.pattern);
+
+	if (node.op == In || node.op == Nin) {
+		if (v.type() == Value::Null)
+			return False;
+		Result found = False;
+		for (auto const& e : node.values) {
+			auto c = v.compare(e);
+			if (c.first == True && c.second == 0) {
+				found = True;
+				break;
+			}
+			if (c.first == Unknown)
+				found = Unknown;
+		}
+		if (node.op == In || found == Unknown)
+			return found;
+		return found == True ? False : True;
+	}
+
+	auto c = v.compare(node.values[0]);
+	if (c.first != True)
+		return c.first;
+	switch (node.op) {
+	case Eq: return c.second == 0 ? True : False;
+	case Ne: return c.second != 0 ? True : False;
+	case Lt: return c.second < 0 ? True : False;
+	case Le: return c.second <= 0 ? True : False;
+	case Gt: return c.second > 0 ? True : False;
+	case Ge: return c.second >= 0 ? True : False;
+	default: return Unknown;
+	}
+}
+
+} // namespace ripple
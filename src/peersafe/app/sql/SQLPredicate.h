@@ -0,0 +1,128 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#ifndef RIPPLE_APP_MISC_SQLPREDICATE_H_INCLUDED
+#define RIPPLE_APP_MISC_SQLPREDICATE_H_INCLUDED
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <peersafe/app/sql/SQLConditionTree.h>
+
+#include <ripple/json/json_value.h>
+
+namespace ripple {
+
+// A conditionTree compiled once for evaluating rows in memory,with the meaning
+// the bound SQL of the tree has: NULL matches nothing,`$regex` is a LIKE pattern.
+// A row may not know some columns(e.g. an insert leaving a column to its default),
+// so a row is matched,not matched or unknown.
+class SQLPredicate {
+public:
+	enum Result {
+		False,
+		True,
+		Unknown
+	};
+
+	// value of a column
+	class Value {
+	public:
+		enum Type {
+			Null,
+			Integer,
+			Real,
+			Text
+		};
+
+		Value() : type_(Null), i_(0), d_(0) {}
+		explicit Value(std::int64_t i) : type_(Integer), i_(i), d_(double(i)) {}
+		explicit Value(double d) : type_(Real), i_(0), d_(d) {}
+		explicit Value(std::string s) : type_(Text), i_(0), d_(0), s_(std::move(s)) {}
+
+		// Null for values which aren't strings or numbers
+		static Value fromJson(const Json::Value& j);
+
+		Type type() const {
+			return type_;
+		}
+
+		// result.first is False,True or Unknown if the values are incomparable,
+		// result.second is negative,zero or positive
+		std::pair<Result, int> compare(const Value& r) const;
+		Result like(const std::string& pattern) const;
+
+	private:
+		Type type_;
+		std::int64_t i_;
+		double d_;
+		std::string s_;
+	};
+
+	// values of columns() for one row,nullptr if the row doesn't know a column
+	typedef std::vector<const Value*> Row;
+
+	SQLPredicate();
+
+	/*
+	* description				compile conditions in the format of Raw
+	* @param conditions			values of raw that `$limit`,`$order` and tables' fields have been exluded out original raw
+	* @return					result.first is zero that indicates success,otherwise is failure.
+	*							result.second is message
+	*/
+	static std::pair<int, std::string> compile(const Json::Value& conditions, SQLPredicate& predicate);
+	static std::pair<int, std::string> compile(conditionTree& root, SQLPredicate& predicate);
+
+	// columns the conditions refer to
+	const std::vector<std::string>& columns() const {
+		return columns_;
+	}
+
+	Result evaluate(const Row& row) const;
+	// `row` is an object keyed by column names
+	Result evaluate(const Json::Value& row) const;
+
+private:
+	enum Op {
+		Eq, Ne, Lt, Le, Gt, Ge, In, Nin, Like
+	};
+
+	struct Node {
+		conditionTree::NodeType type;
+		size_t column;
+		Op op;
+		std::vector<Value> values;
+		std::string pattern;
+		std::vector<Node> children;
+	};
+
+	int compile_node(conditionTree& tree, Node& node, std::string& message);
+	size_t column_index(const std::string& name);
+	Result evaluate(const Node& node, const Row& row) const;
+	static Result evaluate_expression(const Node& node, const Value& v);
+
+	Node root_;
+	std::vector<std::string> columns_;
+};
+
+} // namespace ripple
+
+#endif // RIPPLE_APP_MISC_SQLPREDICATE_H_INCLUDED
@@ -0,0 +1,140 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+
+
+#include <peersafe/app/sql/SQLSchemaCache.h>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/format.hpp>
+
+namespace ripple {
+
+std::atomic<std::uint64_t> SQLSchemaCache::totalHits_(0);
+std::atomic<std::uint64_t> SQLSchemaCache::totalMisses_(0);
+
+bool TableSchema::hasColumn(const std::string& column) const {
+	return columns_.find(boost::to_lower_copy(column)) != columns_.end();
+}
+
+std::string TableSchema::columnType(const std::string& column) const {
+	auto it = columns_.find(boost::to_lower_copy(column));
+	if (it == columns_.end())
+		return std::string();
+	return it->second;
+}
+
+SQLSchemaCache::SQLSchemaCache() {
+}
+
+SQLSchemaCache::~SQLSchemaCache() {
+}
+
+std::shared_ptr<SQLSchemaCache> SQLSchemaCache::forDatabase(const std::string& database) {
+	static std::mutex mutex;
+	static std::map<std::string, std::weak_ptr<SQLSchemaCache>> caches;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	auto cache = caches[database].lock();
+	if (cache == nullptr) {
+		cache = std::make_shared<SQLSchemaCache>();
+		caches[database] = cache;
+	}
+	return cache;
+}
+
+std::shared_ptr<TableSchema const> SQLSchemaCache::get(soci::session& session, const std::string& table) {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = tables_.find(table);
+		if (it != tables_.end()) {
+			++totalHits_;
+			return it->second;
+		}
+	}
+
+	++totalMisses_;
+	auto schema = load(session, table);
+	if (schema) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		tables_[table] = schema;
+	}
+	return schema;
+}
+
+bool SQLSchemaCache::hasColumn(soci::session& session, const std::string& table, const std::string& column) {
+	auto schema = get(session, table);
+	return schema && schema->hasColumn(column);
+}
+
+std::string SQLSchemaCache::columnType(soci::session& session, const std::string& table, const std::string& column) {
+	auto schema = get(session, table);
+	if (schema == nullptr)
+		return std::string();
+	return schema->columnType(column);
+}
+
+void SQLSchemaCache::invalidate(const std::string& table) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	tables_.erase(table);
+}
+
+void SQLSchemaCache::clear() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	tables_.clear();
+}
+
+std::size_t SQLSchemaCache::size() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return tables_.size();
+}
+
+std::shared_ptr<TableSchema const> SQLSchemaCache::load(soci::session& session, const std::string& table) {
+	std::map<std::string, std::string> columns;
+	std::string name;
+	std::string type;
+
+	if (session.get_backend_name() == "sqlite3") {
+		// pragma doesn't accept bound values,table names are generated by chainsqld
+		std::string sql = (boost::format("select name,type from pragma_table_info('%s')") % table).str();
+		soci::statement st = (session.prepare << sql, soci::into(name), soci::into(type));
+		if (st.execute(true)) {
+			do {
+				columns[boost::to_lower_copy(name)] = boost::to_lower_copy(type);
+			} while (st.fetch());
+		}
+	}
+	else {
+		// other databases of the server may have a table of the same name
+		soci::statement st = (session.prepare <<
+			"select column_name,data_type from information_schema.columns where table_schema=DATABASE() and table_name=:table",
+			soci::use(table), soci::into(name), soci::into(type));
+		if (st.execute(true)) {
+			do {
+				columns[boost::to_lower_copy(name)] = boost::to_lower_copy(type);
+			} while (st.fetch());
+		}
+	}
+
+	if (columns.empty())
+		return nullptr;
+	return std::make_shared<TableSchema const>(std::move(columns));
+}
+
+}	// namespace ripple
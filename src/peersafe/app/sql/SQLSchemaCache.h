@@ -0,0 +1,103 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+
+
+#ifndef RIPPLE_APP_MISC_SQLSCHEMACACHE_H_INCLUDED
+#define RIPPLE_APP_MISC_SQLSCHEMACACHE_H_INCLUDED
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <ripple/core/SociDB.h>
+
+namespace ripple {
+
+// Columns of a table as the database reports them,names and types are lower case.
+class TableSchema {
+public:
+	explicit TableSchema(std::map<std::string, std::string> columns)
+	: columns_(std::move(columns)) {
+	}
+
+	bool hasColumn(const std::string& column) const;
+	// declared type of a column,empty if the column doesn't exist
+	std::string columnType(const std::string& column) const;
+
+	const std::map<std::string, std::string>& columns() const {
+		return columns_;
+	}
+
+private:
+	std::map<std::string, std::string> columns_;
+};
+
+// Metadata of tables in one database,shared by all connections to that database.
+// Tables are loaded on first use and kept until a create/drop/recreate/rename
+// table invalidates them,a table which doesn't exist is never cached.
+class SQLSchemaCache {
+public:
+	SQLSchemaCache();
+	~SQLSchemaCache();
+
+	// cache of the database identified by `database`(backend and connection string)
+	static std::shared_ptr<SQLSchemaCache> forDatabase(const std::string& database);
+
+	/*
+	* description		columns of `table`,loaded by `session` if not cached
+	* @return			nullptr if the table doesn't exist,throws soci::soci_error if failed
+	*/
+	std::shared_ptr<TableSchema const> get(soci::session& session, const std::string& table);
+
+	bool exists(soci::session& session, const std::string& table) {
+		return get(session, table) != nullptr;
+	}
+	bool hasColumn(soci::session& session, const std::string& table, const std::string& column);
+	std::string columnType(soci::session& session, const std::string& table, const std::string& column);
+
+	// must be called after the schema of `table` changed
+	void invalidate(const std::string& table);
+	void clear();
+
+	std::size_t size() const;
+
+	// counters of all caches in the process,reported by get_counts
+	static std::uint64_t totalHits() {
+		return totalHits_;
+	}
+	static std::uint64_t totalMisses() {
+		return totalMisses_;
+	}
+
+private:
+	static std::shared_ptr<TableSchema const> load(soci::session& session, const std::string& table);
+
+	mutable std::mutex mutex_;
+	std::unordered_map<std::string, std::shared_ptr<TableSchema const>> tables_;
+
+	static std::atomic<std::uint64_t> totalHits_;
+	static std::atomic<std::uint64_t> totalMisses_;
+};
+
+}	// namespace ripple
+#endif // RIPPLE_APP_MISC_SQLSCHEMACACHE_H_INCLUDED
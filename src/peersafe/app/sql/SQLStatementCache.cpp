@@ -0,0 +1,231 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+
+#include <peersafe/app/sql/SQLStatementCache.h>
+
+namespace ripple {
+
+std::atomic<std::uint64_t> SQLStatementCache::totalHits_(0);
+std::atomic<std::uint64_t> SQLStatementCache::totalMisses_(0);
+std::atomic<std::uint64_t> SQLStatementCache::totalSize_(0);
+
+// type of a value as it is bound to a statement, 0 if it can't be bound
+static char bindKind(const BindValue& value) {
+	if (value.isString() || value.isVarchar() || value.isBlob()
+		|| value.isText() || value.isChar())
+		return 's';
+	else if (value.isInt())
+		return 'i';
+	else if (value.isUint() || value.isInt64() || value.isDateTime())
+		return 'l';
+	else if (value.isFloat() || value.isDouble() || value.isDecimal())
+		return 'd';
+	return 0;
+}
+
+// storage that a placeholder is bound to,values are copied in before each execution
+struct SQLStatementCache::Slot {
+	char kind = 0;
+	std::string s;
+	int i = 0;
+	long long l = 0;
+	double d = 0.0;
+
+	void assign(const BindValue& value) {
+		switch (kind) {
+		case 's':
+			s = value.asString();
+			break;
+		case 'i':
+			i = value.asInt();
+			break;
+		case 'l':
+			if (value.isUint())
+				l = value.asUint();
+			else
+				l = value.asInt64();
+			break;
+		case 'd':
+			if (value.isFloat())
+				d = static_cast<double>(value.asFloat());
+			else
+				d = value.asDouble();
+			break;
+		default:
+			break;
+		}
+	}
+};
+
+struct SQLStatementCache::Entry {
+	explicit Entry(soci::session& session)
+	: key()
+	, table()
+	, slots()
+	, st(session) {
+
+	}
+
+	std::string key;
+	std::string table;
+	std::vector<Slot> slots;	// never resized after binding
+	soci::statement st;
+};
+
+SQLStatementCache::SQLStatementCache(std::size_t capacity)
+: capacity_(capacity > 0 ? capacity : 1)
+, mutex_()
+, entries_()
+, index_()
+, hits_(0)
+, misses_(0) {
+
+}
+
+SQLStatementCache::~SQLStatementCache() {
+	clear();
+}
+
+std::string SQLStatementCache::makeKey(const std::string& table, const std::string& sql,
+	const std::vector<const BindValue*>& values) {
+	std::string key;
+	key.reserve(table.size() + sql.size() + values.size() + 2);
+	key += table;
+	key += '\0';
+	key += sql;
+	key += '\0';
+	for (auto const v : values)
+		key += bindKind(*v);
+	return key;
+}
+
+std::shared_ptr<SQLStatementCache::Entry> SQLStatementCache::prepare(soci::session& session, 
+	const std::string& key, const std::string& table, const std::string& sql, 
+	const std::vector<const BindValue*>& values) {
+	auto entry = std::make_shared<Entry>(session);
+	entry->key = key;
+	entry->table = table;
+	entry->slots.resize(values.size());
+	for (size_t idx = 0; idx < values.size(); idx++) {
+		Slot& slot = entry->slots[idx];
+		slot.kind = bindKind(*values[idx]);
+		switch (slot.kind) {
+		case 's':
+			entry->st.exchange(soci::use(slot.s));
+			break;
+		case 'i':
+			entry->st.exchange(soci::use(slot.i));
+			break;
+		case 'l':
+			entry->st.exchange(soci::use(slot.l));
+			break;
+		case 'd':
+			entry->st.exchange(soci::use(slot.d));
+			break;
+		default:
+			throw soci::soci_error("Unkown type of value when preparing statement.[" + sql + "]");
+		}
+	}
+	entry->st.alloc();
+	entry->st.prepare(sql);
+	entry->st.define_and_bind();
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto it = index_.find(key);
+	if (it != index_.end())
+		erase(it->second);
+	entries_.push_front(entry);
+	index_[key] = entries_.begin();
+	++totalSize_;
+	while (entries_.size() > capacity_)
+		erase(std::prev(entries_.end()));
+	return entry;
+}
+
+long long SQLStatementCache::execute(soci::session& session, const std::string& table,
+	const std::string& sql, const std::vector<const BindValue*>& values) {
+	std::string key = makeKey(table, sql, values);
+
+	std::shared_ptr<Entry> entry;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = index_.find(key);
+		if (it != index_.end()) {
+			entries_.splice(entries_.begin(), entries_, it->second);
+			entry = *it->second;
+		}
+	}
+
+	if (entry) {
+		++hits_;
+		++totalHits_;
+	}
+	else {
+		++misses_;
+		++totalMisses_;
+		entry = prepare(session, key, table, sql, values);
+	}
+
+	for (size_t idx = 0; idx < values.size(); idx++)
+		entry->slots[idx].assign(*values[idx]);
+
+	try {
+		entry->st.execute(true);
+	}
+	catch (...) {
+		// a statement which failed may be unusable,prepare it again next time
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = index_.find(key);
+		if (it != index_.end() && *it->second == entry)
+			erase(it->second);
+		throw;
+	}
+	return entry->st.get_affected_rows();
+}
+
+void SQLStatementCache::erase(EntryList::iterator it) {
+	index_.erase((*it)->key);
+	entries_.erase(it);
+	--totalSize_;
+}
+
+void SQLStatementCache::invalidate(const std::string& table) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	for (auto it = entries_.begin(); it != entries_.end();) {
+		auto next = std::next(it);
+		if ((*it)->table == table)
+			erase(it);
+		it = next;
+	}
+}
+
+void SQLStatementCache::clear() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	totalSize_ -= entries_.size();
+	index_.clear();
+	entries_.clear();
+}
+
+std::size_t SQLStatementCache::size() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return entries_.size();
+}
+
+}	// namespace ripple
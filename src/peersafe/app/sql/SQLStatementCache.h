@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+
+#ifndef RIPPLE_APP_MISC_SQLSTATEMENTCACHE_H_INCLUDED
+#define RIPPLE_APP_MISC_SQLSTATEMENTCACHE_H_INCLUDED
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <peersafe/app/sql/SQLDataType.h>
+#include <ripple/core/SociDB.h>
+
+namespace ripple {
+
+typedef FieldValue BindValue;
+
+// Prepared statements of one connection,keyed by shape of the statement.
+// A shape is the table,the SQL text with placeholders and the types of bound values,
+// so repeated insert/update/delete only bind new values into a statement that
+// has been parsed and planned by the database already.
+// Callers must hold the session(checkoutDb) while executing.
+class SQLStatementCache {
+public:
+	explicit SQLStatementCache(std::size_t capacity = 512);
+	~SQLStatementCache();
+
+	/*
+	* description		execute `sql` with `values` bound to its placeholders in order
+	* @param session	session that statements are prepared on
+	* @param table		table that the statement touches,used to invalidate statements
+	* @param sql		SQL text with placeholders :1,:2,...
+	* @param values		values bound to placeholders
+	* @return			number of affected rows,throws soci::soci_error if failed
+	*/
+	long long execute(soci::session& session, const std::string& table,
+		const std::string& sql, const std::vector<const BindValue*>& values);
+
+	// drop statements of a table,must be called when schema of the table changes
+	void invalidate(const std::string& table);
+	void clear();
+
+	std::size_t size() const;
+	std::uint64_t hits() const {
+		return hits_;
+	}
+	std::uint64_t misses() const {
+		return misses_;
+	}
+
+	// counters of all caches in the process,reported by get_counts
+	static std::uint64_t totalHits() {
+		return totalHits_;
+	}
+	static std::uint64_t totalMisses() {
+		return totalMisses_;
+	}
+	static std::uint64_t totalSize() {
+		return totalSize_;
+	}
+
+private:
+	struct Slot;
+	struct Entry;
+	typedef std::list<std::shared_ptr<Entry>> EntryList;
+
+	static std::string makeKey(const std::string& table, const std::string& sql,
+		const std::vector<const BindValue*>& values);
+	std::shared_ptr<Entry> prepare(soci::session& session, const std::string& key,
+		const std::string& table, const std::string& sql, const std::vector<const BindValue*>& values);
+	void erase(EntryList::iterator it);
+
+	std::size_t capacity_;
+	mutable std::mutex mutex_;
+	EntryList entries_;	// most recently used at front
+	std::unordered_map<std::string, EntryList::iterator> index_;
+
+	std::atomic<std::uint64_t> hits_;
+	std::atomic<std::uint64_t> misses_;
+
+	static std::atomic<std::uint64_t> totalHits_;
+	static std::atomic<std::uint64_t> totalMisses_;
+	static std::atomic<std::uint64_t> totalSize_;
+};
+
+}	// namespace ripple
+#endif // RIPPLE_APP_MISC_SQLSTATEMENTCACHE_H_INCLUDED
@@ -20,6 +20,8 @@
 #include <vector>
 #include <tuple>
 #include <functional>
+#include <cstdint>
+#include <limits>
 
 #include <boost/algorithm/string/trim.hpp>
 
@@ -27,6 +29,8 @@
 #include <peersafe/app/sql/SQLConditionTree.h>
 #include <peersafe/app/sql/STTx2SQL.h>
 #include <peersafe/app/sql/TxStore.h>
+#include <peersafe/app/sql/SQLSchemaCache.h>
+#include <peersafe/app/sql/SQLStatementCache.h>
 
 
 #include <boost/format.hpp>
@@ -40,6 +44,7 @@
 #include <ripple/protocol/JsonFields.h>
 #include <ripple/protocol/ErrorCodes.h>
 #include <ripple/net/RPCErr.h>
+#include <peersafe/protocol/TableDefines.h>
 
 #define TABLE_PREFIX    "t_"
 
@@ -220,6 +225,10 @@ public:
 		return name_;
 	}
 
+	const FieldValue& Value() const {
+		return value_;
+	}
+
 	const std::string& Name() const {
 		return name_;
 	}
@@ -466,9 +475,14 @@ public:
 	virtual void AddTable(const std::string& tablename) = 0;
 	virtual void AddTable(const Json::Value& table) = 0;
 	virtual void AddField(const BuildField& field) = 0;
+	// finish the current row of a multi-row insert,fields added later belong to next row
+	virtual void AddRow() = 0;
 	virtual void AddCondition(const AndCondtionsType& condition) = 0;
 	virtual void AddCondition(const Json::Value& condition) = 0;
 	virtual void AddLimitCondition(const Json::Value& limit) = 0;
+	// skip `offset` rows and keep at most `count` rows (0 keeps all) of
+	// what the query returns, applied on top of the limit condition
+	virtual void AddPageCondition(size_t offset, size_t count) = 0;
 	virtual void AddOrderCondition(const Json::Value& order) = 0;
 	virtual void AddGroupByCondition(const Json::Value& group) = 0;
 	virtual void AddHavingCondition(const Json::Value& having) = 0;
@@ -486,6 +500,8 @@ public:
 	virtual const OrConditionsType& Conditions() const = 0;
 
 	virtual BUILDTYPE build_type(BUILDTYPE type) = 0;
+	// how many rows of `columns` fields can be inserted by one statement
+	virtual size_t max_insert_rows(size_t columns) const = 0;
 	virtual std::string asString() = 0;
 	virtual int execSQL() = 0;
 	virtual void clear() = 0;
@@ -537,8 +553,11 @@ public:
 	: tables_()
 	, tables_obj_()
 	, fields_()
+	, rows_()
 	, orders_()
 	, limit_()
+	, page_offset_(0)
+	, page_count_(0)
 	, group_()
 	, having_()
 	, build_type_(type)
@@ -567,6 +586,13 @@ public:
 		fields_.push_back(field);
 	}
 
+	void AddRow() {
+		if (fields_.size() == 0)
+			return;
+		rows_.push_back(std::move(fields_));
+		fields_.clear();
+	}
+
 	void AddCondition(const BuildSQL::AndCondtionsType& condition) {
 		conditions_.push_back(condition);
 	}
@@ -579,6 +605,11 @@ public:
 		limit_ = limit;
 	}
 
+	void AddPageCondition(size_t offset, size_t count) {
+		page_offset_ = offset;
+		page_count_ = count;
+	}
+
 	void AddGroupByCondition(const Json::Value& group) {
 		group_ = group;
 	}
@@ -764,6 +795,13 @@ public:
 		return old;
 	}
 
+	size_t max_insert_rows(size_t columns) const {
+		if (columns == 0)
+			return 1;
+		size_t rows = std::min<size_t>(max_bind_values() / columns, MAX_INSERT_BATCH_ROWS);
+		return rows > 0 ? rows : 1;
+	}
+
 	std::string asString() {
 		std::string sql;
 		switch (build_type_)
@@ -847,6 +885,7 @@ public:
 	void clear() {
 		tables_.clear();
 		fields_.clear();
+		rows_.clear();
 		conditions_.clear();
 	}
 
@@ -864,12 +903,20 @@ protected:
 	virtual std::string build_createtable_sql() = 0;
 	virtual int execute_createtable_sql() = 0;
 	virtual std::string build_exist_sql() = 0;
+	// upper limit of values bound to one statement by the backend
+	virtual size_t max_bind_values() const = 0;
+
+	// upper limit of rows in one multi-row insert,keeps packets bounded
+	enum { MAX_INSERT_BATCH_ROWS = 256 };
 
 	std::vector<std::string> tables_;
 	std::vector<Json::Value> tables_obj_;
 	std::vector<BuildField> fields_;
+	std::vector<std::vector<BuildField>> rows_;	// finished rows of a multi-row insert
 	std::vector<Json::Value> orders_;
 	Json::Value limit_;
+	size_t page_offset_;
+	size_t page_count_;
 	Json::Value group_;
 	Json::Value having_;
 
@@ -881,7 +928,10 @@ protected:
             if (bExist)
             {
                 LockedSociSession sql = db_conn_->checkoutDb();
+                // cached statements of the table must be released before dropping it
+                db_conn_->getStatementCache().invalidate(tables_[0]);
                 *sql << build_droptable_sql();
+                db_conn_->getSchemaCache().invalidate(tables_[0]);
             }			
 		}
 		catch (soci::soci_error& e) {
@@ -920,7 +970,11 @@ private:
 		
 		try {
 			LockedSociSession sql = db_conn_->checkoutDb();
+			db_conn_->getStatementCache().invalidate(tables_[0]);
+			db_conn_->getStatementCache().invalidate(tables_[1]);
 			*sql << "rename table :old to :new", soci::use(tables_[0]), soci::use(tables_[1]);
+			db_conn_->getSchemaCache().invalidate(tables_[0]);
+			db_conn_->getSchemaCache().invalidate(tables_[1]);
 		}
 		catch (soci::soci_error& e) {
 			last_error(std::make_pair<int,std::string>(-1, e.what()));
@@ -929,6 +983,32 @@ private:
 		return 0;
 	}
 
+	// rows of an insert: finished rows first,then the row still being built
+	std::vector<const std::vector<BuildField>*> insert_rows() const {
+		std::vector<const std::vector<BuildField>*> rows;
+		for (auto const& row : rows_)
+			rows.push_back(&row);
+		if (fields_.size())
+			rows.push_back(&fields_);
+		return rows;
+	}
+
+	// all rows of a multi-row insert must have the same columns in the same order
+	std::pair<int, std::string> check_insert_rows(
+		const std::vector<const std::vector<BuildField>*>& rows) const {
+		const std::vector<BuildField>& first = *rows[0];
+		for (size_t r = 1; r < rows.size(); r++) {
+			const std::vector<BuildField>& row = *rows[r];
+			if (row.size() != first.size())
+				return { -1, "Rows have different fields when building multi-row insert-sql" };
+			for (size_t idx = 0; idx < row.size(); idx++) {
+				if (row[idx].Name() != first[idx].Name())
+					return { -1, "Rows have different fields when building multi-row insert-sql" };
+			}
+		}
+		return { 0, "success" };
+	}
+
 	std::string build_insert_sql() {
 		std::string sql;
 		if (tables_.size() == 0) {
@@ -936,35 +1016,53 @@ private:
 			return sql;
 		}
 
-		if (fields_.size() == 0) {
+		auto rows = insert_rows();
+		if (rows.size() == 0) {
 			last_error(std::make_pair<int, std::string>(-1, "Fields are empty when building sql"));
 			return sql;
 		}
 
+		auto check = check_insert_rows(rows);
+		if (check.first != 0) {
+			last_error(check);
+			return sql;
+		}
+
 		std::string& tablename = tables_[0];
 		std::string fields_str;
-		std::string values_str;
-		for (size_t idx = 0; idx < fields_.size(); idx++) {
-			BuildField& field = fields_[idx];
-			fields_str += field.Name();
-			if(field.isString() || field.isVarchar() 
-				|| field.isBlob() || field.isText())
-				values_str += (boost::format("\"%1%\"") % field.asString()).str();
-			else if (field.isInt())
-				values_str += (boost::format("%d") % field.asInt()).str();
-			else if (field.isFloat())
-				values_str += (boost::format("%f") % field.asFloat()).str();
-			else if (field.isDouble() || field.isDecimal())
-				values_str += (boost::format("%f") % field.asDouble()).str();
-			else if(field.isInt64() || field.isDateTime())
-				values_str += (boost::format("%1%") % field.asInt64()).str();
-
-			if (idx != fields_.size() - 1) {
+		const std::vector<BuildField>& columns = *rows[0];
+		for (size_t idx = 0; idx < columns.size(); idx++) {
+			fields_str += columns[idx].Name();
+			if (idx != columns.size() - 1)
 				fields_str += ",";
+		}
+
+		std::string values_str;
+		for (size_t r = 0; r < rows.size(); r++) {
+			const std::vector<BuildField>& row = *rows[r];
+			values_str += "(";
+			for (size_t idx = 0; idx < row.size(); idx++) {
+				const BuildField& field = row[idx];
+				if(field.isString() || field.isVarchar() 
+					|| field.isBlob() || field.isText())
+					values_str += (boost::format("\"%1%\"") % field.asString()).str();
+				else if (field.isInt())
+					values_str += (boost::format("%d") % field.asInt()).str();
+				else if (field.isFloat())
+					values_str += (boost::format("%f") % field.asFloat()).str();
+				else if (field.isDouble() || field.isDecimal())
+					values_str += (boost::format("%f") % field.asDouble()).str();
+				else if(field.isInt64() || field.isDateTime())
+					values_str += (boost::format("%1%") % field.asInt64()).str();
+
+				if (idx != row.size() - 1)
+					values_str += ",";
+			}
+			values_str += ")";
+			if (r != rows.size() - 1)
 				values_str += ",";
-			}
 		}
-		sql = (boost::format("insert into %s (%s) values (%s)")
+		sql = (boost::format("insert into %s (%s) values %s")
 			%tablename
 			%fields_str
 			%values_str).str();
@@ -978,41 +1076,51 @@ private:
 			return -1;
 		}
 
-		if (fields_.size() == 0) {
+		auto rows = insert_rows();
+		if (rows.size() == 0) {
 			last_error(std::make_pair<int, std::string>(-1, "Fields are empty when executing sql"));
 			return -1;
 		}
 
+		auto check = check_insert_rows(rows);
+		if (check.first != 0) {
+			last_error(check);
+			return -1;
+		}
+
 		std::string& tablename = tables_[0];
 		std::string fields_str;
-		std::string values_str;
-		for (size_t idx = 0; idx < fields_.size(); idx++) {
-			BuildField& field = fields_[idx];
-			fields_str += field.Name();
-			values_str += ":" + std::to_string(idx + 1);
-			if (idx != fields_.size() - 1) {
+		const std::vector<BuildField>& columns = *rows[0];
+		for (size_t idx = 0; idx < columns.size(); idx++) {
+			fields_str += columns[idx].Name();
+			if (idx != columns.size() - 1)
 				fields_str += ",";
+		}
+
+		// one placeholder per value, numbered across all rows
+		std::string values_str;
+		size_t index = 0;
+		for (size_t r = 0; r < rows.size(); r++) {
+			values_str += "(";
+			for (size_t idx = 0; idx < columns.size(); idx++) {
+				values_str += ":" + std::to_string(++index);
+				if (idx != columns.size() - 1)
+					values_str += ",";
+			}
+			values_str += ")";
+			if (r != rows.size() - 1)
 				values_str += ",";
-			}
 		}
-		sql_str = (boost::format("insert into %s (%s) values (%s)")
+		sql_str = (boost::format("insert into %s (%s) values %s")
 			% tablename
 			%fields_str
 			%values_str).str();
 
-        LockedSociSession sql = db_conn_->checkoutDb();
-		{
-			auto tmp = *sql << sql_str;
-			bind_fields_value(tmp);
-		}
-		// fix an issue that we can't catch an exception on top-level,
-		// beacause desctructor of one-temp-type driver to execute actual SQL-engine API.
-		// however destructor can catch an exception but can't throw an exception that was catched by destructor.
-		//if (db_conn_->getSession().last_error().first != 0) {
-		//	last_error(db_conn_->getSession().last_error());
-		//	return -1;
-		//}
-		return 0;
+		std::vector<const BindValue*> values;
+		values.reserve(rows.size() * columns.size());
+		for (size_t r = 0; r < rows.size(); r++)
+			collect_fields_value(values, *rows[r]);
+		return execute_prepared(sql_str, values);
 	}
 
 	std::string build_update_sql() {
@@ -1118,30 +1226,19 @@ private:
 					%c).str();
 			}
 
-			LockedSociSession sql = db_conn_->checkoutDb();
-			{
-				auto tmp = *sql << sql_str;
-				bind_fields_value(tmp);
-				if (c.empty() == false)
-					if (std::get<2>(conditions).bind_value(tmp).first != 0) {
-						last_error(std::make_pair<int, std::string>(-1,
-							"Binding values is unsuccessful when executing update-sql"));
-						return -1;
-					}
-			}
-			// fix an issue that we can't catch an exception on top-level,
-			// beacause desctructor of one-temp-type driver to execute actual SQL-engine API.
-			// however destructor can catch an exception but can't throw an exception that was catched by destructor.
-			//if (db_conn_->getSession().last_error().first != 0) {
-			//	last_error(db_conn_->getSession().last_error());
-			//	return -1;
-			//}
+			std::vector<const BindValue*> values;
+			collect_fields_value(values, fields_);
+			if (c.empty() == false)
+				if (std::get<2>(conditions).bind_value(values).first != 0) {
+					last_error(std::make_pair<int, std::string>(-1,
+						"Binding values is unsuccessful when executing update-sql"));
+					return -1;
+				}
+			return execute_prepared(sql_str, values);
 		}
 		else {
 			return -1;
 		}
-		
-		return 0;
 	}
 
 	std::string build_delete_sql() {
@@ -1194,28 +1291,18 @@ private:
 					%c).str();
 			}
 
-			LockedSociSession sql = db_conn_->checkoutDb();
-			{
-				auto tmp = *sql << sql_str;
-				if (c.empty() == false)
-					if (std::get<2>(conditions).bind_value(tmp).first != 0) {
-						last_error(std::make_pair<int, std::string>(-1, 
-							"binding values is unsuccessfull when executing delete-sql"));
-						return -1;
-					}
-			}
-			// fix an issue that we can't catch an exception on top-level,
-			// beacause desctructor of one-temp-type driver to execute actual SQL-engine API.
-			// however destructor can catch an exception but can't throw an exception that was catched by destructor.
-			//if (db_conn_->getSession().last_error().first != 0) {
-			//	last_error(db_conn_->getSession().last_error());
-			//	return -1;
-			//}
+			std::vector<const BindValue*> values;
+			if (c.empty() == false)
+				if (std::get<2>(conditions).bind_value(values).first != 0) {
+					last_error(std::make_pair<int, std::string>(-1, 
+						"binding values is unsuccessfull when executing delete-sql"));
+					return -1;
+				}
+			return execute_prepared(sql_str, values);
 		}
 		else {
 			return -1;
 		}
-		return 0;
 	}
 
 	std::string build_select_sql() {
@@ -1477,18 +1564,33 @@ private:
 		if (orders.empty() == false)
 			sql += orders;
 
+		// -1 means no upper bound on the rows returned
+		std::int64_t index = 0, total = -1;
 		if (limit_.isObject()) {
-			std::string limit;
 			const std::vector<std::string>& keys = limit_.getMemberNames();
 			if (keys.size() == 2
 				&& boost::iequals(keys[0], "index")
 				&& boost::iequals(keys[1], "total")) {
-				limit = (boost::format(" limit %d,%d")
-					% limit_["index"].asInt() % limit_["total"].asInt()).str();
+				index = limit_["index"].asInt();
+				total = limit_["total"].asInt();
 			}
+		}
 
-			if (limit.empty() == false)
-				sql += limit;
+		if (page_offset_ > 0 || page_count_ > 0) {
+			index += page_offset_;
+			if (total >= 0)
+				total = std::max<std::int64_t>(total - page_offset_, 0);
+			if (page_count_ > 0
+				&& (total < 0 || total > static_cast<std::int64_t>(page_count_)))
+				total = page_count_;
+		}
+
+		if (total >= 0) {
+			sql += (boost::format(" limit %d,%d") % index % total).str();
+		}
+		else if (index > 0) {
+			sql += (boost::format(" limit %d,%d") % index
+				% std::numeric_limits<std::int64_t>::max()).str();
 		}
 		return sql;
 	}
@@ -1621,21 +1723,26 @@ private:
 			conditionTree(conditionTree::NodeType::Expression));
 	}
 
-	void bind_fields_value(soci::details::once_temp_type& t) {
-		for (size_t idx = 0; idx < fields_.size(); idx++) {
-			BuildField& field = fields_[idx];
-			if (field.isString() || field.isVarchar()
-				|| field.isBlob() || field.isText())
-				t = t, soci::use(field.asString());
-			else if (field.isInt())
-				t = t, soci::use(field.asInt());
-			else if (field.isFloat())
-				t = t, soci::use(static_cast<double>(field.asFloat()));
-			else if (field.isDouble() || field.isDecimal())
-				t = t, soci::use(field.asDouble());
-			else if (field.isInt64() || field.isDateTime())
-				t = t, soci::use(field.asInt64());
+	void collect_fields_value(std::vector<const BindValue*>& values, const std::vector<BuildField>& fields) {
+		for (size_t idx = 0; idx < fields.size(); idx++)
+			values.push_back(&fields[idx].Value());
+	}
+
+	// execute a statement with placeholders through prepared statements cached by the connection.
+	// a statement of the same shape is parsed only once,later executions only bind values.
+	int execute_prepared(const std::string& sql_str, const std::vector<const BindValue*>& values) {
+		LockedSociSession sql = db_conn_->checkoutDb();
+		try {
+			long long affected = db_conn_->getStatementCache().execute(*sql, tables_[0], sql_str, values);
+			sql->set_affected_row_count(static_cast<int>(affected));
+			sql->set_last_error({ 0, "success" });
 		}
+		catch (soci::soci_error& e) {
+			sql->set_last_error({ -1, e.what() });
+			last_error(std::make_pair<int, std::string>(-1, e.what()));
+			return -1;
+		}
+		return 0;
 	}
 
 	BuildSQL::BUILDTYPE build_type_;
@@ -1847,9 +1954,11 @@ protected:
 //        std::string sql_str = build_createtable_sql();
 		try {
 			LockedSociSession sql = db_conn_->checkoutDb();
+			db_conn_->getStatementCache().invalidate(tables_[0]);
             soci::statement st =
                 (sql->prepare << sql_str);
             st.execute();
+			db_conn_->getSchemaCache().invalidate(tables_[0]);
 		} catch (soci::soci_error& e) {
 			last_error(std::make_pair<int, std::string>(-1, e.what()));
 			return -1;
@@ -1870,6 +1979,11 @@ protected:
 		return sql;
 	}
 
+	size_t max_bind_values() const override {
+		// placeholders of a prepared statement are limited to 65535 by MySQL
+		return 65535;
+	}
+
 private:
 	DisposeMySQL()
 		: DisposeSQL() {
@@ -2012,7 +2126,9 @@ protected:
 
 		try {
 			LockedSociSession sql = db_conn_->checkoutDb();
+			db_conn_->getStatementCache().invalidate(tables_[0]);
             *sql << sql_str;
+			db_conn_->getSchemaCache().invalidate(tables_[0]);
 		}
 		catch (soci::soci_error& e) {
 			last_error(std::make_pair<int, std::string>(-1, e.what()));
@@ -2035,6 +2151,11 @@ protected:
 		return sql;
 	}
 
+	size_t max_bind_values() const override {
+		// SQLITE_MAX_VARIABLE_NUMBER defaults to 999
+		return 999;
+	}
+
 private:
 	DisposeSqlite()
 		: DisposeSQL() {
@@ -2076,6 +2197,11 @@ public:
 			disposesql_->AddField(field);
 	}
 
+	void AddRow() override {
+		if (disposesql_)
+			disposesql_->AddRow();
+	}
+
 	void AddCondition(const AndCondtionsType& condition) override {
 		if (disposesql_)
 			disposesql_->AddCondition(condition);
@@ -2091,6 +2217,11 @@ public:
 			disposesql_->AddLimitCondition(limit);
 	}
 
+	void AddPageCondition(size_t offset, size_t count) override {
+		if (disposesql_)
+			disposesql_->AddPageCondition(offset, count);
+	}
+
 	void AddOrderCondition(const Json::Value& order) override {
 		if (disposesql_)
 			disposesql_->AddOrderCondition(order);
@@ -2150,6 +2281,12 @@ public:
 		return BUILD_NOSQL;
 	}
 
+	size_t max_insert_rows(size_t columns) const override {
+		if (disposesql_)
+			return disposesql_->max_insert_rows(columns);
+		return 1;
+	}
+
 	std::string asString() override {
 		std::string sql;
 		if (disposesql_)
@@ -2211,6 +2348,11 @@ public:
 			disposesql_->AddField(field);
 	}
 
+	void AddRow() override {
+		if (disposesql_)
+			disposesql_->AddRow();
+	}
+
 	void AddCondition(const AndCondtionsType& condition) override {
 		if (disposesql_)
 			disposesql_->AddCondition(condition);
@@ -2226,6 +2368,11 @@ public:
 			disposesql_->AddLimitCondition(limit);
 	}
 
+	void AddPageCondition(size_t offset, size_t count) override {
+		if (disposesql_)
+			disposesql_->AddPageCondition(offset, count);
+	}
+
 	void AddOrderCondition(const Json::Value& order) override {
 		if (disposesql_)
 			disposesql_->AddOrderCondition(order);
@@ -2285,6 +2432,12 @@ public:
 		return BUILD_NOSQL;
 	}
 
+	size_t max_insert_rows(size_t columns) const override {
+		if (disposesql_)
+			return disposesql_->max_insert_rows(columns);
+		return 1;
+	}
+
 	std::string asString() override {
 		std::string sql;
 		if (disposesql_)
@@ -2478,59 +2631,63 @@ namespace helper {
 		return{ code, error };
 	}
 
+	Json::Value row_to_json(const soci::row& r) {
+		Json::Value e;
+		for (size_t i = 0; i < r.size(); i++) {
+			if (r.get_properties(i).get_data_type() == soci::dt_string
+				|| r.get_properties(i).get_data_type() == soci::dt_blob) {
+				if (r.get_indicator(i) == soci::i_ok)
+					e[r.get_properties(i).get_name()] = r.get<std::string>(i);
+				else
+					e[r.get_properties(i).get_name()] = "null";
+			}
+			else if (r.get_properties(i).get_data_type() == soci::dt_integer) {
+				if (r.get_indicator(i) == soci::i_ok)
+					e[r.get_properties(i).get_name()] = r.get<int>(i);
+				else
+					e[r.get_properties(i).get_name()] = 0;
+			}
+			else if (r.get_properties(i).get_data_type() == soci::dt_double) {
+				if (r.get_indicator(i) == soci::i_ok)
+					e[r.get_properties(i).get_name()] = r.get<double>(i);
+				else
+					e[r.get_properties(i).get_name()] = 0.0;
+			}
+			else if (r.get_properties(i).get_data_type() == soci::dt_long_long) {
+				if (r.get_indicator(i) == soci::i_ok)
+					e[r.get_properties(i).get_name()] = static_cast<int>(r.get<long long>(i));
+				else
+					e[r.get_properties(i).get_name()] = 0;
+			}
+			else if (r.get_properties(i).get_data_type() == soci::dt_unsigned_long_long) {
+				if (r.get_indicator(i) == soci::i_ok)
+					e[r.get_properties(i).get_name()] = static_cast<int>(r.get<unsigned long long>(i));
+				else
+					e[r.get_properties(i).get_name()] = 0;
+			}
+			else if (r.get_properties(i).get_data_type() == soci::dt_date) {
+				std::tm tm = { 0 };
+				std::string datetime = "NULL";
+				if (r.get_indicator(i) == soci::i_ok) {
+					tm = r.get<std::tm>(i);
+					datetime = (boost::format("%d/%d/%d %d:%d:%d")
+						% (tm.tm_year + 1900) % (tm.tm_mon + 1) % tm.tm_mday
+						%tm.tm_hour % (tm.tm_min) % tm.tm_sec).str();
+				}
+
+				e[r.get_properties(i).get_name()] = datetime;
+			}
+		}
+		return e;
+	}
+
 	Json::Value query_result(const soci::rowset<soci::row>& records) {
 		Json::Value obj;
 		Json::Value lines;
 		try {
 			soci::rowset<soci::row>::const_iterator r = records.begin();
 			for (; r != records.end(); r++) {
-				Json::Value e;
-				for (size_t i = 0; i < r->size(); i++) {
-					if (r->get_properties(i).get_data_type() == soci::dt_string
-						|| r->get_properties(i).get_data_type() == soci::dt_blob) {
-						if (r->get_indicator(i) == soci::i_ok)
-							e[r->get_properties(i).get_name()] = r->get<std::string>(i);
-						else
-							e[r->get_properties(i).get_name()] = "null";
-					}
-					else if (r->get_properties(i).get_data_type() == soci::dt_integer) {
-						if (r->get_indicator(i) == soci::i_ok)
-							e[r->get_properties(i).get_name()] = r->get<int>(i);
-						else
-							e[r->get_properties(i).get_name()] = 0;
-					}
-					else if (r->get_properties(i).get_data_type() == soci::dt_double) {
-						if (r->get_indicator(i) == soci::i_ok)
-							e[r->get_properties(i).get_name()] = r->get<double>(i);
-						else
-							e[r->get_properties(i).get_name()] = 0.0;
-					}
-					else if (r->get_properties(i).get_data_type() == soci::dt_long_long) {
-						if (r->get_indicator(i) == soci::i_ok)
-							e[r->get_properties(i).get_name()] = static_cast<int>(r->get<long long>(i));
-						else
-							e[r->get_properties(i).get_name()] = 0;
-					}
-					else if (r->get_properties(i).get_data_type() == soci::dt_unsigned_long_long) {
-						if (r->get_indicator(i) == soci::i_ok)
-							e[r->get_properties(i).get_name()] = static_cast<int>(r->get<unsigned long long>(i));
-						else
-							e[r->get_properties(i).get_name()] = 0;
-					}
-					else if (r->get_properties(i).get_data_type() == soci::dt_date) {
-						std::tm tm = { 0 };
-						std::string datetime = "NULL";
-						if (r->get_indicator(i) == soci::i_ok) {
-							tm = r->get<std::tm>(i);
-							datetime = (boost::format("%d/%d/%d %d:%d:%d")
-								% (tm.tm_year + 1900) % (tm.tm_mon + 1) % tm.tm_mday
-								%tm.tm_hour % (tm.tm_min) % tm.tm_sec).str();
-						}
-
-						e[r->get_properties(i).get_name()] = datetime;
-					}
-				}
-				lines.append(e);
+				lines.append(row_to_json(*r));
 			}
 			obj[jss::lines] = lines;
 			obj[jss::status] = "success";
@@ -2542,6 +2699,42 @@ namespace helper {
 		return obj;
 	}
 
+	// records were selected with one row more than the page holds,
+	// reading that row only tells there is another page
+	Json::Value query_result(const soci::rowset<soci::row>& records, TxStore::QueryPage& page) {
+		Json::Value obj;
+		Json::Value lines(Json::arrayValue);
+		Json::UInt count = 0;
+		page.more = false;
+		try {
+			soci::rowset<soci::row>::const_iterator r = records.begin();
+			for (; r != records.end(); r++) {
+				if (page.limit > 0 && count == page.limit) {
+					page.more = true;
+					break;
+				}
+				lines.append(row_to_json(*r));
+				++count;
+				if (page.chunk > 0 && lines.size() == page.chunk) {
+					page.onChunk(lines);
+					lines = Json::Value(Json::arrayValue);
+				}
+			}
+			if (page.chunk > 0) {
+				if (lines.size() > 0)
+					page.onChunk(lines);
+			}
+			else
+				obj[jss::lines] = lines;
+			obj[jss::count] = count;
+			obj[jss::status] = "success";
+		}
+		catch (soci::soci_error& e) {
+			obj[jss::error] = e.what();
+		}
+		return obj;
+	}
+
     Json::Value query_directly(DatabaseCon* conn, std::string sql) {
         Json::Value obj;
         try {
@@ -2582,6 +2775,34 @@ namespace helper {
 		return obj;
 	}
 
+	Json::Value query_directly(const Json::Value& tx_json, DatabaseCon* conn, BuildSQL* buildsql,
+		TxStore::QueryPage& page) {
+		Json::Value obj;
+		std::pair<int, std::string> result = ParseTxJson(tx_json, *buildsql);
+		if (result.first != 0) {
+			obj[jss::error] = result.second;
+			return obj;
+		}
+
+		buildsql->AddPageCondition(page.offset, page.limit > 0 ? page.limit + 1 : 0);
+		try {
+			std::string sql = buildsql->asString();
+			auto last_error = buildsql->last_error();
+			if (last_error.first != 0) {
+				obj[jss::status] = "failure";
+				obj[jss::error] = last_error.second;
+				return obj;
+			}
+			LockedSociSession query = conn->checkoutDb();
+			soci::rowset<soci::row> records = ((*query).prepare << sql);
+			obj = query_result(records, page);
+		}
+		catch (soci::soci_error& e) {
+			obj[jss::error] = e.what();
+		}
+		return obj;
+	}
+
     
 } // namespace helper
 
@@ -2849,10 +3070,18 @@ std::pair<bool, std::string> STTx2SQL::handle_assert_statement(const Json::Value
 		std::string query_sql;
 		int assert_type = -1;
 		if (aseert_condition.isMember("$IsExisted")) {
-			BuildSQL::BUILDTYPE old = buildsql->build_type(BuildSQL::BUILD_EXIST_TABLE);
-			query_sql = buildsql->asString();
-			buildsql->build_type(old);
-			assert_type = 0;
+			// answered by the schema cache,a table exists if it has columns
+			const Json::Value& expect = aseert_condition["$IsExisted"];
+			try {
+				LockedSociSession query = db_conn_->checkoutDb();
+				Json::Int existed = db_conn_->getSchemaCache().exists(*query, buildsql->Tables()[0]) ? 1 : 0;
+				if (expect.isInt() == false || expect.asInt() != existed)
+					result = { false, "assert false" };
+			}
+			catch (const soci::soci_error& e) {
+				result = { false, e.what() };
+			}
+			break;
 		}
 		else if(aseert_condition.isMember("$RowCount")) {
 			// include $RowCount and others 
@@ -3011,7 +3240,7 @@ bool STTx2SQL::assert_result(const soci::rowset<soci::row>& records, const Json:
 	return result;
 }
 
-bool STTx2SQL::check_raw(const Json::Value& raw, const uint16_t optype) {
+bool STTx2SQL::check_raw(const Json::Value& raw, const uint16_t optype, const std::string& tablename) {
 	bool check = true;
 	if (optype == BuildSQL::BUILD_DROPTABLE_SQL 
 		|| optype == BuildSQL::BUILD_RENAMETABLE_SQL
@@ -3047,6 +3276,8 @@ bool STTx2SQL::check_raw(const Json::Value& raw, const uint16_t optype) {
 				break;
 			}
 		}
+		if (check && (optype == BuildSQL::BUILD_INSERT_SQL || optype == BuildSQL::BUILD_UPDATE_SQL))
+			check = check_columns(raw, optype, tablename);
 		break;
 	default:
 		check = false;
@@ -3055,6 +3286,38 @@ bool STTx2SQL::check_raw(const Json::Value& raw, const uint16_t optype) {
 	return check;
 }
 
+// nullptr if the table is unknown
+std::shared_ptr<TableSchema const> STTx2SQL::table_schema(const std::string& tablename) {
+	if (db_conn_ == nullptr)
+		return nullptr;
+
+	try {
+		LockedSociSession sql = db_conn_->checkoutDb();
+		return db_conn_->getSchemaCache().get(*sql, tablename);
+	}
+	catch (soci::soci_error&) {
+		return nullptr;
+	}
+}
+
+// fields to be written must be columns of the table,
+// nothing is checked if the table is unknown and the database reports the error instead
+bool STTx2SQL::check_columns(const Json::Value& raw, const uint16_t optype, const std::string& tablename) {
+	auto schema = table_schema(tablename);
+	if (schema == nullptr)
+		return true;
+
+	// only the first element of an update-raw is fields,others are conditions
+	Json::UInt size = optype == BuildSQL::BUILD_UPDATE_SQL ? 1 : raw.size();
+	for (Json::UInt idx = 0; idx < size; idx++) {
+		for (auto const& field : raw[idx].getMemberNames()) {
+			if (schema->hasColumn(field) == false)
+				return false;
+		}
+	}
+	return true;
+}
+
 std::pair<bool, std::string> STTx2SQL::check_optionalRule(const std::string& optionalRule) {
 	Json::Value rule;
 	if (Json::Reader().parse(optionalRule, rule) == false) {
@@ -3113,10 +3376,17 @@ std::pair<int /*retcode*/, std::string /*sql*/> STTx2SQL::ExecuteSQL(const rippl
 		}
 	}
 
-	std::string sRaw = tx.buildRaw(sOperationRule);
-	Json::Value raw_json;
-	if (sRaw.size()) {
-		if (Json::Reader().parse(sRaw, raw_json) == false) {
+	// the raw parsed once per tx is used as is,
+	// a copy is only built when the operation rule rewrites it
+	std::shared_ptr<Json::Value const> raw_ptr;
+	if (tx.isFieldPresent(sfRaw) && sOperationRule.empty() == false
+		&& isSqlStatementOpType((TableOpType)optype)) {
+		raw_ptr = std::make_shared<Json::Value const>(tx.buildRawJson(sOperationRule));
+	}
+	else if (tx.isFieldPresent(sfRaw)
+		&& static_cast<STBlob const&>(tx.peekAtField(sfRaw)).size()) {
+		raw_ptr = tx.getRawJson();
+		if (raw_ptr == nullptr) {
 			ret = { -1, "parase Raw unsuccessfully." };
 			return ret;
 		}
@@ -3125,8 +3395,10 @@ std::pair<int /*retcode*/, std::string /*sql*/> STTx2SQL::ExecuteSQL(const rippl
 		ret = { -1, "Raw data is empty except delete-sql." };
 		return ret;
 	}
+	Json::Value const empty_raw;
+	Json::Value const& raw_json = raw_ptr ? *raw_ptr : empty_raw;
 
-	if (check_raw(raw_json, optype) == false) {
+	if (check_raw(raw_json, optype, txt_tablename) == false) {
 		ret = { -1, (boost::format("Raw data is malformed. %s") %Json::jsonAsString(raw_json)).str() };
 		return ret;
 	}
@@ -3190,26 +3462,61 @@ std::pair<int /*retcode*/, std::string /*sql*/> STTx2SQL::ExecuteSQL(const rippl
         {
             auto blob = tx.getFieldVL(sfAutoFillField);;
             sAutoFillField.assign(blob.begin(), blob.end());
-            auto sql_str = (boost::format("select * from information_schema.columns WHERE table_name ='%s'AND column_name ='%s'")
-                % txt_tablename
-                % sAutoFillField).str();
-            LockedSociSession sql = db_conn_->checkoutDb();
-            soci::rowset<soci::row> records = ((*sql).prepare << sql_str);
-            bHasAutoField = records.end() != records.begin();
+            try {
+                LockedSociSession sql = db_conn_->checkoutDb();
+                bHasAutoField = db_conn_->getSchemaCache().hasColumn(*sql, txt_tablename, sAutoFillField);
+            }
+            catch (soci::soci_error& e) {
+                return{ -1, e.what() };
+            }
         }
 		
+		// consecutive rows with the same fields are inserted by one multi-row statement,
+		// the number of rows in a statement is bounded by the backend
 		int affected_rows = 0;
-		for (Json::UInt idx = 0; idx < raw_json.size(); idx++) {
-			auto& v = raw_json[idx];
+		size_t batch_rows = 0;
+		std::vector<std::string> batch_fields;
+		auto flush = [&]() {
+			if (batch_rows == 0)
+				return true;
+			std::string batch_sql = buildsql->asString();
+			if (buildsql->execSQL() != 0) {
+				ret = { -1, (boost::format("Executing `%1%` was failure. %2%")
+					%batch_sql 
+					%buildsql->last_error().second).str() };
+				return false;
+			}
+			affected_rows += db_conn_->getSession().get_affected_row_count();
+			db_conn_->getSession().set_affected_row_count(0);
+
+			if (sql.empty() == false)
+				sql += ";";
+			sql += batch_sql;
+
+			buildsql->clear();
+			buildsql->AddTable(txt_tablename);
+			batch_rows = 0;
+			return true;
+		};
+
+		auto insert_row = [&](const Json::Value& v) {
 			if (v.isObject() == false) {
 				//JSON_ASSERT(v.isObject());
 				ret = { -1, "Element of raw may be malformal." };
-				return ret;
+				return false;
+			}
+
+			std::vector<std::string> fields = v.getMemberNames();
+			size_t columns = fields.size() + (bHasAutoField ? 1 : 0);
+			if (batch_rows > 0 
+				&& (fields != batch_fields || batch_rows >= buildsql->max_insert_rows(columns))) {
+				if (flush() == false)
+					return false;
 			}
 
 			if(GenerateInsertSql(v, buildsql.get()) != 0) {
 				ret = { -1, "Insert-sql was generated unssuccessfully,transaction may be malformal." };
-				return ret;
+				return false;
 			}
             if (bHasAutoField)
             {
@@ -3217,24 +3524,20 @@ std::pair<int /*retcode*/, std::string /*sql*/> STTx2SQL::ExecuteSQL(const rippl
                 insert_field.SetFieldValue(to_string(tx.getTransactionID()));
                 buildsql->AddField(insert_field);
             }
-			
-			sql += buildsql->asString();
-			if(buildsql->execSQL() != 0) {
-				//ret = { -1, std::string("Executing SQL was failure.") + sql };
-				ret = { -1, (boost::format("Executing `%1%` was failure. %2%")
-					%sql 
-					%buildsql->last_error().second).str() };
-				return ret;
-			}
-			affected_rows += db_conn_->getSession().get_affected_row_count();
-			db_conn_->getSession().set_affected_row_count(0);
+			buildsql->AddRow();
 
-			buildsql->clear();
-			buildsql->AddTable(txt_tablename);
+			batch_fields = std::move(fields);
+			batch_rows++;
+			return true;
+		};
 
-			if (idx != raw_json.size() - 1)
-				sql += ";";
+		for (Json::UInt idx = 0; idx < raw_json.size(); idx++) {
+			if (insert_row(raw_json[idx]) == false)
+				return ret;
 		}
+		if (flush() == false)
+			return ret;
+
 		if(bVerifyAffectedRows && affected_rows == 0)
 				return{ -1, "insert operation affect 0 rows." };
 		
@@ -3328,6 +3631,26 @@ Json::Value TxStore::txHistory(Json::Value& tx_json) {
     return helper::query_directly(tx_json, databasecon_, buildsql.get());
 }
 
+Json::Value TxStore::txHistory(Json::Value& tx_json, QueryPage& page) {
+    Json::Value obj;
+    if (databasecon_ == nullptr)
+        return rpcError(rpcINTERNAL);
+
+    std::shared_ptr<BuildSQL> buildsql = nullptr;
+    if (boost::iequals(db_type_, "sqlite"))
+        buildsql = std::make_shared<BuildSqlite>(BuildSQL::BUILD_SELECT_SQL, databasecon_);
+    else if(boost::iequals(db_type_, "mycat") || boost::iequals(db_type_, "mysql"))
+        buildsql = std::make_shared<BuildMySQL>(BuildSQL::BUILD_SELECT_SQL, databasecon_);
+
+    if (buildsql == nullptr)
+    {
+        obj[jss::error] = "there is no DB in this node";
+        return obj;
+    }
+
+    return helper::query_directly(tx_json, databasecon_, buildsql.get(), page);
+}
+
 Json::Value TxStore::txHistory(std::string sql) {
     Json::Value obj;
     if (databasecon_ == nullptr)
@@ -34,6 +34,7 @@ namespace ripple {
 
 class BuildSQL;
 class DatabaseCon;
+class TableSchema;
 
 class STTx2SQL {
 public:
@@ -49,6 +50,9 @@ public:
 		const std::string& operationRule = "",
 		bool verifyAffectedRows = false);
 
+	// each expression of `expect` may be satisfied by a different row
+	bool assert_result(const soci::rowset<soci::row>& records, const Json::Value& expect);
+
 private:
 	STTx2SQL() {};
 	int GenerateCreateTableSql(const Json::Value& raw, BuildSQL *buildsql);
@@ -59,9 +63,10 @@ private:
 	int GenerateSelectSql(const Json::Value& raw, BuildSQL *buildsql);
 
 	std::pair<bool, std::string> handle_assert_statement(const Json::Value& raw, BuildSQL *buildsql);
-	bool assert_result(const soci::rowset<soci::row>& records, const Json::Value& expect);
 
-	bool check_raw(const Json::Value& raw, const uint16_t optype);
+	bool check_raw(const Json::Value& raw, const uint16_t optype, const std::string& tablename);
+	bool check_columns(const Json::Value& raw, const uint16_t optype, const std::string& tablename);
+	std::shared_ptr<TableSchema const> table_schema(const std::string& tablename);
 	std::pair<bool, std::string> check_optionalRule(const std::string& optionalRule);
 
 	std::string db_type_;
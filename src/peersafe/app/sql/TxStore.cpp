@@ -22,6 +22,8 @@
 
 #include <peersafe/app/sql/TxStore.h>
 #include <peersafe/app/sql/STTx2SQL.h>
+#include <peersafe/app/sql/SQLSchemaCache.h>
+#include <peersafe/app/sql/SQLStatementCache.h>
 #include <ripple/json/Output.h>
 #include <ripple/protocol/JsonFields.h>
 #include <ripple/protocol/ErrorCodes.h>
@@ -36,8 +38,11 @@ namespace ripple {
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 TxStoreDBConn::TxStoreDBConn(const Config& cfg)
+: TxStoreDBConn(ripple::setup_SyncDatabaseCon(cfg)) {
+}
+
+TxStoreDBConn::TxStoreDBConn(DatabaseCon::Setup const& setup)
 : databasecon_(nullptr) {
-	DatabaseCon::Setup setup = ripple::setup_SyncDatabaseCon(cfg);
 	std::pair<std::string, bool> result_type = setup.sync_db.find("type");
 	std::string database_name, dbType; 
     std::pair<std::string, bool> database = setup.sync_db.find("db");
@@ -89,14 +94,17 @@ TxStoreDBConn::~TxStoreDBConn() {
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 TxStoreTransaction::TxStoreTransaction(TxStoreDBConn* storeDBConn)
+: dbConn_(storeDBConn->GetDBConn())
 {
-    lockSession_ = std::make_shared<LockedSociSession>(storeDBConn->GetDBConn()->checkoutDb());
+    lockSession_ = std::make_shared<LockedSociSession>(dbConn_->checkoutDb());
     tr_ = std::make_shared<soci::transaction>(*(lockSession_->get()));
 }
 
 TxStoreTransaction::~TxStoreTransaction() {
-    if (lockSession_)		lockSession_.reset();
+    // an unfinished transaction rolls back, with the session still locked
 	if (tr_)	    	    tr_.reset();
+    if (!handled_)      dbConn_->rolledBack();
+    if (lockSession_)		lockSession_.reset();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -122,11 +130,13 @@ TxStore::TxStore(DatabaseCon* dbconn, const Config& cfg, const beast::Journal& j
 : cfg_(cfg)
 , db_type_()
 , databasecon_(dbconn)
-, journal_(journal) {
+, journal_(journal)
+, query_rows_max_(0) {
 	const ripple::Section& sync_db = cfg_.section("sync_db");
 	std::pair<std::string, bool> result = sync_db.find("type");
 	if (result.second)
 		db_type_ = result.first;
+	get_if_exists(sync_db, "query_rows_max", query_rows_max_);
 }
 
 TxStore::~TxStore() {
@@ -176,7 +186,9 @@ std::pair<bool, std::string> TxStore::DropTable(const std::string& tablename) {
     {
         std::string sql_str = std::string("drop table t_") + tablename;
         LockedSociSession sql = databasecon_->checkoutDb();
+        databasecon_->getStatementCache().invalidate("t_" + tablename);
         *sql << sql_str;
+        databasecon_->getSchemaCache().invalidate("t_" + tablename);
     }
     else
     {
@@ -20,6 +20,7 @@
 #ifndef RIPPLE_APP_MISC_TXSTORE_H_INCLUDED
 #define RIPPLE_APP_MISC_TXSTORE_H_INCLUDED
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
@@ -35,6 +36,7 @@ namespace ripple {
 class TxStoreDBConn {
 public:
 	TxStoreDBConn(const Config& cfg);
+	TxStoreDBConn(DatabaseCon::Setup const& setup);
 	~TxStoreDBConn();
 
 	DatabaseCon* GetDBConn() {
@@ -60,19 +62,38 @@ public:
 
 	void commit() {
 		tr_->commit();
+		handled_ = true;
 	}
 
     void rollback() {
         tr_->rollback();
+        handled_ = true;
+        dbConn_->rolledBack();
     }
 
 private:
+	DatabaseCon* dbConn_;
 	std::shared_ptr<soci::transaction> tr_;
     std::shared_ptr<LockedSociSession> lockSession_;
+    bool handled_ = false;
 };
 
 class TxStore {
 public:
+	// One page of a select, rows are read from the rowset one at a time so
+	// no more than `limit` rows (or `chunk` rows when streaming) are held.
+	struct QueryPage {
+		size_t offset = 0;
+		// rows in this page, 0 means every row after `offset`
+		size_t limit = 0;
+		// when set, rows are handed to `onChunk` every `chunk` rows
+		// instead of being returned in `lines`
+		size_t chunk = 0;
+		std::function<void(Json::Value const& lines)> onChunk;
+		// out: rows left after this page
+		bool more = false;
+	};
+
 	//TxStore(const Config& cfg);
 	TxStore(DatabaseCon* dbconn, const Config& cfg, const beast::Journal& journal);
 	~TxStore();
@@ -83,14 +104,18 @@ public:
 
 	Json::Value txHistory(RPC::Context& context);
     Json::Value txHistory(Json::Value& tx_json);
+    Json::Value txHistory(Json::Value& tx_json, QueryPage& page);
     Json::Value txHistory(std::string sql);
 
 	DatabaseCon* getDatabaseCon();
+	// most rows a select may hold in memory, 0 for no cap
+	size_t getQueryRowsMax() const { return query_rows_max_; }
 private:
 	const Config& cfg_;
 	std::string db_type_;
 	DatabaseCon* databasecon_;
 	beast::Journal journal_;
+	size_t query_rows_max_;
 };	// class TxStore
 
 }	// namespace ripple
@@ -0,0 +1,152 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <peersafe/app/sql/TxStoreReadPool.h>
+#include <peersafe/app/table/TableStatusDBMySQL.h>
+#include <peersafe/app/table/TableStatusDBSQLite.h>
+#include <ripple/app/main/Application.h>
+#include <ripple/protocol/JsonFields.h>
+#include <boost/algorithm/string.hpp>
+
+namespace ripple {
+
+TxStoreReadPool::TxStoreReadPool(Application& app, Config const& cfg, beast::Journal journal)
+    : journal_(journal)
+    , next_(0)
+    , maxLag_(5)
+    , reads_(0)
+    , fallbacks_(0)
+{
+    if (!cfg.exists("sync_db_read"))
+        return;
+
+    Section const& section = cfg["sync_db_read"];
+    DatabaseCon::Setup setup = ripple::setup_SyncDatabaseCon(cfg);
+    for (auto const& value : section)
+    {
+        if (!boost::iequals(value.first, "type"))
+            setup.sync_db.set(value.first, value.second);
+    }
+
+    std::size_t connections = 2;
+    get_if_exists(section, "connections", connections);
+    get_if_exists(section, "max_lag", maxLag_);
+
+    auto const type = setup.sync_db.find("type").first;
+    bool const sqlite = type.compare("sqlite") == 0;
+    for (std::size_t i = 0; i < connections; ++i)
+    {
+        Conn conn;
+        conn.dbConn = std::make_unique<TxStoreDBConn>(setup);
+        DatabaseCon* db = conn.dbConn->GetDBConn();
+        if (db == nullptr)
+        {
+            JLOG(journal_.error()) << "TxStoreReadPool can't connect to [sync_db_read]";
+            break;
+        }
+        setReadOnly(*db, sqlite);
+
+        conn.txStore = std::make_unique<TxStore>(db, cfg, journal_);
+        if (sqlite)
+            conn.status = std::make_unique<TableStatusDBSQLite>(db, &app, journal_);
+        else
+            conn.status = std::make_unique<TableStatusDBMySQL>(db, &app, journal_);
+        conns_.push_back(std::move(conn));
+    }
+}
+
+TxStoreReadPool::~TxStoreReadPool()
+{
+}
+
+void TxStoreReadPool::setReadOnly(DatabaseCon& db, bool sqlite)
+{
+    try
+    {
+        LockedSociSession sql = db.checkoutDb();
+        if (sqlite)
+        {
+            // the journal mode is kept by the file, it lets the writer
+            // go on while these handles read
+            *sql << "PRAGMA journal_mode=WAL;";
+            *sql << "PRAGMA query_only=1;";
+        }
+        else
+        {
+            *sql << "SET SESSION TRANSACTION READ ONLY";
+        }
+    }
+    catch (soci::soci_error& e)
+    {
+        JLOG(journal_.warn()) << "TxStoreReadPool::setReadOnly " << e.what();
+    }
+}
+
+LedgerIndex TxStoreReadPool::watermark(TableStatusDB& status,
+    std::vector<uint160> const& tables)
+{
+    LedgerIndex mark = 0;
+    bool first = true;
+    LedgerIndex txnseq, seq;
+    uint256 txnhash, hash, txnupdatehash;
+    for (auto const& nameInDB : tables)
+    {
+        seq = 0;
+        if (!status.ReadSyncDB(to_string(nameInDB), txnseq, txnhash, seq, hash, txnupdatehash))
+            return 0;
+        if (first || seq < mark)
+            mark = seq;
+        first = false;
+    }
+    return mark;
+}
+
+TxStoreReadPool::Reader
+TxStoreReadPool::checkout(std::vector<uint160> const& tables, LedgerIndex primary)
+{
+    Reader reader;
+    if (conns_.empty())
+        return reader;
+
+    auto& conn = conns_[next_++ % conns_.size()];
+    auto const mark = watermark(*conn.status, tables);
+    if (mark + maxLag_ < primary)
+    {
+        ++fallbacks_;
+        return reader;
+    }
+
+    ++reads_;
+    reader.txStore = conn.txStore.get();
+    reader.status = conn.status.get();
+    reader.watermark = mark;
+    return reader;
+}
+
+Json::Value TxStoreReadPool::getInfo() const
+{
+    Json::Value ret(Json::objectValue);
+    ret[jss::connections] = Json::UInt(conns_.size());
+    ret[jss::max_lag] = maxLag_;
+    ret[jss::reads] = Json::UInt(reads_.load());
+    ret[jss::fallbacks] = Json::UInt(fallbacks_.load());
+    return ret;
+}
+
+}
@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#ifndef RIPPLE_APP_MISC_TXSTOREREADPOOL_H_INCLUDED
+#define RIPPLE_APP_MISC_TXSTOREREADPOOL_H_INCLUDED
+
+#include <peersafe/app/sql/TxStore.h>
+#include <peersafe/app/table/TableStatusDB.h>
+#include <ripple/basics/base_uint.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace ripple {
+
+class Application;
+
+// Read-only connections that select RPCs are served from, so reporting
+// queries do not queue on the connection TableStorage and TableSync
+// write through.
+//
+// Configured by [sync_db_read], which takes the keys of [sync_db] and
+// falls back to them, e.g. only host and port for a MySQL replica. With
+// sqlite the connections are more handles on the same file, switched to
+// WAL so they read alongside the writer. The type is always the one in
+// [sync_db].
+//
+// A replica is only used while it has synced the queried tables to
+// within max_lag ledgers of the primary.
+class TxStoreReadPool
+{
+public:
+    TxStoreReadPool(Application& app, Config const& cfg, beast::Journal journal);
+    ~TxStoreReadPool();
+
+    bool enabled() const { return !conns_.empty(); }
+
+    struct Reader
+    {
+        TxStore* txStore = nullptr;
+        TableStatusDB* status = nullptr;
+        // the oldest ledger this connection has synced the tables to
+        LedgerIndex watermark = 0;
+
+        explicit operator bool() const { return txStore != nullptr; }
+    };
+
+    // Returns a connection to read the tables from, none if there is
+    // no replica or it lags more than max_lag ledgers behind `primary`.
+    Reader checkout(std::vector<uint160> const& tables, LedgerIndex primary);
+
+    // the oldest ledger that `status` has synced the tables to
+    static LedgerIndex watermark(TableStatusDB& status,
+        std::vector<uint160> const& tables);
+
+    Json::Value getInfo() const;
+
+private:
+    struct Conn
+    {
+        std::unique_ptr<TxStoreDBConn> dbConn;
+        std::unique_ptr<TxStore> txStore;
+        std::unique_ptr<TableStatusDB> status;
+    };
+
+    void setReadOnly(DatabaseCon& db, bool sqlite);
+
+    beast::Journal                      journal_;
+    std::vector<Conn>                   conns_;
+    std::atomic<std::size_t>            next_;
+    LedgerIndex                         maxLag_;
+    std::atomic<std::uint64_t>          reads_;
+    std::atomic<std::uint64_t>          fallbacks_;
+};
+
+}
+
+#endif
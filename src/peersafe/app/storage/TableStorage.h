@@ -20,7 +20,9 @@
 #ifndef RIPPLE_APP_TABLE_TABLESTORAGE_H_INCLUDED
 #define RIPPLE_APP_TABLE_TABLESTORAGE_H_INCLUDED
 
+#include <peersafe/app/storage/TableStorageExecutor.h>
 #include <peersafe/app/storage/TableStorageItem.h>
+#include <peersafe/app/storage/TableStorageGroup.h>
 #include <peersafe/protocol/TableDefines.h>
 
 
@@ -42,9 +44,19 @@ public:
     TER InitItem(STTx const&tx,Transactor& transactor);
     void TableStorageThread();
 
-    TxStore& GetTxStore(uint160 nameInDB);
+    // The TxStore to read a table through. For a first_storage table the
+    // deferred writes are done first and later ones wait for `hold`,
+    // `item` keeps the TxStore while read.
+    TxStore& GetTxStore(uint160 nameInDB, std::shared_ptr<TableStorageItem>& item,
+        TableStorageExecutor::Hold& hold);
     bool isStroageOn();
+    bool isGroupCommit();
+    bool isDeferred();
+    Json::Value getDeferredInfo();
 private:
+    void GroupCommit(LedgerIndex validIndex);
+    bool GroupRollBack(std::set<uint160> tables);
+    void GroupAbort();
     void GetTxParam(STTx const & tx, uint256 &txshash, uint160 &uTxDBName, std::string &sTableName, AccountID &accountID, uint32 &lastLedgerSequence);
     TER TableStorageHandlePut(ChainSqlTx& transactor,uint160 uTxDBName, AccountID accountID, std::string sTableName, uint32 lastLedgerSequence, uint256 txhash, STTx const & tx);
 
@@ -59,6 +71,8 @@ private:
     bool                                                                        m_IsStorageOn;
     bool                                                                        bTableStorageThread_;
 	bool																		bAutoLoadTable_;
+    std::unique_ptr<TableStorageGroup>                                          group_;
+    std::unique_ptr<TableStorageExecutor>                                       executor_;
 };
 
 }
@@ -0,0 +1,129 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#ifndef RIPPLE_APP_TABLE_TABLESTORAGE_EXECUTOR_H_INCLUDED
+#define RIPPLE_APP_TABLE_TABLESTORAGE_EXECUTOR_H_INCLUDED
+
+#include <ripple/basics/base_uint.h>
+#include <ripple/beast/insight/Collector.h>
+#include <ripple/json/json_value.h>
+#include <ripple/protocol/Protocol.h>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+
+namespace ripple {
+
+class JobQueue;
+
+/*
+    Runs the first_storage writes TableStorage defers when [sync_db]
+    deferred_storage=unchecked. Writes are kept per strand, one table or the
+    whole group in group_commit mode, and run on the job queue one job
+    per strand at a time, in ledger order. Different strands proceed
+    concurrently.
+
+    A transactor that needs the outcome of its write, or the connection
+    the strand writes through, waits for the strand first. A strand with
+    no job running yet is then drained by the waiting thread itself.
+    A reader of the connection holds the strand instead, so the writes
+    posted meanwhile wait for the read.
+*/
+class TableStorageExecutor
+{
+public:
+    // Returns false if the write failed.
+    using write_type = std::function <bool ()>;
+
+    TableStorageExecutor (JobQueue& jobQueue,
+        beast::insight::Collector::ptr const& collector);
+
+    TableStorageExecutor (TableStorageExecutor const&) = delete;
+    TableStorageExecutor& operator= (TableStorageExecutor const&) = delete;
+
+    /** Run `f` after the writes of `strand` for ledgers up to `seq` */
+    void post (uint160 const& strand, LedgerIndex seq, write_type f);
+
+    /** Returns true if writes of `strand` are queued or running */
+    bool busy (uint160 const& strand) const;
+
+    /** Return once the writes of `strand` posted so far are done */
+    void wait (uint160 const& strand);
+
+    /** Return once `strand` has no writes and no hold, with `lock` locked.
+        `lock` is released while waiting, a holder may need it meanwhile.
+    */
+    void wait (uint160 const& strand, std::unique_lock <std::mutex>& lock);
+
+    /** Keeps the writes of a strand from running, once those posted
+        before are done. Holds of one strand follow each other.
+    */
+    class Hold
+    {
+    public:
+        Hold () = default;
+        Hold (TableStorageExecutor& executor, uint160 const& strand);
+        Hold (Hold&& other);
+        Hold& operator= (Hold&& other);
+        ~Hold ();
+
+    private:
+        TableStorageExecutor*   executor_ = nullptr;
+        uint160                 strand_;
+    };
+
+    /** Writes queued or running, all strands */
+    std::size_t pending () const;
+
+    Json::Value getInfo () const;
+
+private:
+    struct Strand
+    {
+        std::multimap <LedgerIndex, write_type> queue;
+        bool running = false;
+    };
+
+    void schedule (uint160 const& strand);
+    void run (uint160 const& strand);
+    void drain (std::unique_lock <std::mutex>& lock, uint160 const& strand);
+    void hold (uint160 const& strand);
+    void release (uint160 const& strand);
+
+private:
+    JobQueue&                                   jobQueue_;
+
+    mutable std::mutex                          mutex_;
+    std::condition_variable                     cv_;
+    std::map <uint160, Strand>                  strands_;
+    std::size_t                                 pending_;
+
+    std::uint64_t                               deferred_;
+    std::uint64_t                               failed_;
+    std::uint64_t                               waited_;
+    std::chrono::milliseconds                   waitTime_;
+
+    beast::insight::Gauge                       depth_;
+    beast::insight::Event                       waitEvent_;
+};
+
+}
+#endif
@@ -0,0 +1,110 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#ifndef RIPPLE_APP_TABLE_TABLESTORAGE_GROUP_H_INCLUDED
+#define RIPPLE_APP_TABLE_TABLESTORAGE_GROUP_H_INCLUDED
+
+#include <peersafe/app/sql/TxStore.h>
+#include <peersafe/app/table/TableStatusDB.h>
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <vector>
+
+namespace ripple {
+
+// Database environment shared by every TableStorageItem when
+// [sync_db] group_commit is on: the writes of all tables go through
+// one connection and one transaction. Each write of a chainsql tx
+// follows a savepoint kept until the transaction ends, so the writes
+// from any point on can be undone and those still wanted done again:
+// a failing statement or a diverged table is undone alone, and the
+// validated writes are committed while the others carry over.
+//
+// Not synchronized, callers hold TableStorage's map mutex or run on
+// the executor strand the map waits for.
+class TableStorageGroup
+{
+public:
+    TableStorageGroup(Application& app, Config& cfg, beast::Journal journal);
+    ~TableStorageGroup();
+
+    TxStoreDBConn& getTxStoreDBConn();
+    TxStore& getTxStore();
+    TableStatusDB& getTableStatusDB();
+
+    // A write of a chainsql tx to a table, `redo` does it again.
+    struct Write
+    {
+        uint160                 table;
+        uint256                 txhash;
+        std::string             savepoint;
+        std::function<bool()>   redo;
+    };
+
+    // Opens the group transaction if it is not open yet.
+    void begin();
+    bool isOpen() const { return bOpen_; }
+    void commit();
+    void rollback();
+
+    // Returns the name of the new savepoint, empty if it failed.
+    // Opens the group transaction first.
+    std::string savepoint();
+    bool rollbackTo(std::string const& name);
+    void release(std::string const& name);
+
+    // Records a write done after `savepoint`.
+    void add(uint160 const& table, uint256 const& txhash,
+        std::string const& savepoint, std::function<bool()> redo);
+    std::vector<Write> const& writes() const { return writes_; }
+
+    // Undoes the writes from `index` on and moves them to `undone`,
+    // false if the savepoint is gone, e.g. after a DDL on MySQL.
+    bool undo(std::size_t index, std::vector<Write>& undone);
+    // Does the writes again in order, but those of the tables in `skip`.
+    // A table failing a write is added to `failed`, its later writes
+    // are skipped.
+    void redo(std::vector<Write>& writes, std::set<uint160> const& skip,
+        std::set<uint160>& failed);
+
+    std::uint64_t commits() const { return commits_; }
+    std::uint64_t rollbacks() const { return rollbacks_; }
+
+private:
+    bool execute(std::string const& sql);
+
+private:
+    std::unique_ptr <TxStoreDBConn>                                             conn_;
+    std::unique_ptr <TxStore>                                                   pObjTxStore_;
+    std::unique_ptr <TableStatusDB>                                             pObjTableStatusDB_;
+
+    std::vector<Write>                                                          writes_;
+    bool                                                                        bOpen_;
+    std::uint64_t                                                               savepointSeq_;
+    std::uint64_t                                                               commits_;
+    std::uint64_t                                                               rollbacks_;
+
+    Application&                                                                app_;
+    beast::Journal                                                              journal_;
+    Config&                                                                     cfg_;
+};
+}
+#endif
+
@@ -21,11 +21,15 @@
 #define RIPPLE_APP_TABLE_TABLESTORAGE_ITEM_H_INCLUDED
 
 #include <peersafe/app/sql/TxStore.h>
+#include <atomic>
 namespace ripple {
 class ChainSqlTx;
+class TableStorageExecutor;
+class TableStorageGroup;
 
 class TableStorageItem
 {
+public:
     enum TableStorageDBFlag
     {
         STORAGE_NONE,
@@ -49,14 +53,30 @@ class TableStorageItem
     }txInfo;
 
 public:    
-    TableStorageItem(Application& app, Config& cfg, beast::Journal journal);
+    TableStorageItem(Application& app, Config& cfg, beast::Journal journal, TableStorageGroup* group = nullptr,
+        TableStorageExecutor* executor = nullptr);
     void InitItem(AccountID account ,std::string nameInDB, std::string tableName);
     void SetItemParam(LedgerIndex txnLedgerSeq, uint256 txnHash, LedgerIndex LedgerSeq, uint256 ledgerHash);
     virtual ~TableStorageItem();
     
+    // With deferred writes, the strand is waited for first unless CanDefer.
     TER PutElem(ChainSqlTx& transactor, STTx const& tx, uint256 txhash);
+    static bool CanDefer(ChainSqlTx& transactor, STTx const& tx);
     bool doJob(LedgerIndex CurLedgerVersion);
 
+    // group commit, see TableStorageGroup
+    TableStorageDBFlag CheckJob(LedgerIndex CurLedgerVersion);
+    bool IsValidated(uint256 const& txhash) const;
+    bool IsEmpty() const { return txList_.empty(); }
+    void PrepareCommit();
+    // Publishes the validated txs and drops them, true if none is left.
+    bool OnCommitted();
+    void OnRollBack();
+
+    // deferred writes still queued or running, see TableStorageExecutor
+    bool IsBusy() const;
+    uint160 const& GetStrand() const { return strand_; }
+
     TxStore& getTxStore();
     bool isHaveTx(uint256 txid);
     bool DoUpdateSyncDB(const std::string &Owner, const std::string &TableNameInDB, bool bDel,
@@ -64,7 +84,12 @@ public:
 private: 
     bool rollBack();
     bool commit();
+    void beginTrans();
+    void endTrans(bool bCommit);
     void Put(STTx const& tx, uint256 txhash);
+    TER DeferElem(ChainSqlTx& transactor, STTx const& tx, uint256 txhash);
+    bool Redo(STTx const& tx, std::string const& rule, bool bInsertSync, uint256 const& chainId,
+        LedgerIndex ledgerSeq, uint256 const& ledgerHash);
     bool CheckExistInLedger(LedgerIndex CurLedgerVersion);
     void prehandleTx(STTx const& tx);
     TableStorageItem::TableStorageDBFlag CheckSuccessive(LedgerIndex validatedIndex);
@@ -79,6 +104,7 @@ private:
     std::shared_ptr <TxStoreDBConn>                                             dbconn_;
     std::unique_ptr <TxStoreTransaction>                                        uTxStoreTrans_;
     std::string                                                                 sTableNameInDB_;
+    uint160                                                                     uTableNameInDB_;
     std::string                                                                 sTableName_;
     AccountID                                                                   accountID_;
 
@@ -88,6 +114,12 @@ private:
 
 	bool                                                                        bExistInSyncTable_;
 	bool                                                                        bDropped_; 
+    bool                                                                        bReady_;
+    TableStorageGroup*                                                          group_;
+    TableStorageExecutor*                                                       executor_;
+    uint160                                                                     strand_;
+    std::atomic<bool>                                                           bDeferFailed_;
+    bool                                                                        bTransOpen_;
 
     uint256                                                                    txnHash_;
     LedgerIndex                                                                txnLedgerSeq_;
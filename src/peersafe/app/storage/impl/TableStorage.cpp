@@ -17,6 +17,7 @@
  */
 //==============================================================================
 
+#include <ripple/app/main/CollectorManager.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/core/ConfigSections.h>
 #include <ripple/app/ledger/LedgerMaster.h>
@@ -27,6 +28,7 @@
 #include <peersafe/app/table/TableStatusDBMySQL.h>
 #include <peersafe/app/table/TableStatusDBSQLite.h>
 #include <peersafe/app/storage/TableStorage.h>
+#include <peersafe/app/table/TableDirectory.h>
 #include <peersafe/app/tx/ChainSqlTx.h>
 
 #define MAX_GAP_NOW2VALID  5
@@ -55,6 +57,26 @@ namespace ripple {
                 m_IsStorageOn = false;
         }
 
+        result = setup.sync_db.find("group_commit");
+        if (result.second && result.first.compare("1") == 0)
+            group_ = std::make_unique<TableStorageGroup>(app_, cfg_, journal_);
+
+        // deferred writes give up the tef result of a rejected write, they
+        // are only turned on by naming that explicitly
+        result = setup.sync_db.find("deferred_storage");
+        if (result.second && result.first.compare("unchecked") == 0)
+        {
+            executor_ = std::make_unique<TableStorageExecutor>(app_.getJobQueue(),
+                app_.getCollectorManager().group("table_storage"));
+            JLOG(journal_.warn()) << "deferred_storage=unchecked, row writes "
+                "rejected by the database no longer fail their tx";
+        }
+        else if (result.second)
+        {
+            JLOG(journal_.warn()) << "deferred_storage=" << result.first
+                << " ignored, writes are done in place";
+        }
+
 		auto sync_section = cfg_.section(ConfigSection::autoSync());
 		if (sync_section.values().size() > 0)
 		{
@@ -76,6 +98,21 @@ namespace ripple {
         return m_IsStorageOn;
     }
 
+    bool TableStorage::isGroupCommit()
+    {
+        return group_ != nullptr;
+    }
+
+    bool TableStorage::isDeferred()
+    {
+        return executor_ != nullptr;
+    }
+
+    Json::Value TableStorage::getDeferredInfo()
+    {
+        return executor_->getInfo();
+    }
+
     std::shared_ptr<TableStorageItem> TableStorage::GetItem(uint160 nameInDB)
     {
         std::lock_guard<std::mutex> lock(mutexMap_);
@@ -91,12 +128,21 @@ namespace ripple {
         m_IsHaveStorage = flag;
     }
 
-    TxStore& TableStorage::GetTxStore(uint160 nameInDB)
+    TxStore& TableStorage::GetTxStore(uint160 nameInDB, std::shared_ptr<TableStorageItem>& item,
+        TableStorageExecutor::Hold& hold)
     {
-        std::lock_guard<std::mutex> lock(mutexMap_);
-        auto it = m_map.find(nameInDB);
-        if (it == m_map.end())  return app_.getTxStore();
-        else                    return it->second->getTxStore();
+        {
+            std::lock_guard<std::mutex> lock(mutexMap_);
+            auto it = m_map.find(nameInDB);
+            if (it == m_map.end())  return app_.getTxStore();
+            item = it->second;
+        }
+
+        // the map stays unlocked while held, a put waiting for the strand
+        // may have it locked
+        if (executor_)
+            hold = TableStorageExecutor::Hold(*executor_, item->GetStrand());
+        return item->getTxStore();
     }
 
     void TableStorage::TryTableStorage()
@@ -160,7 +206,15 @@ namespace ripple {
 
 	TER TableStorage::TableStorageHandlePut(ChainSqlTx& transactor,uint160 uTxDBName, AccountID accountID,std::string sTableName,uint32 lastLedgerSequence,uint256 txhash, STTx const & tx)
     {
-        std::lock_guard<std::mutex> lock(mutexMap_);
+        std::unique_lock<std::mutex> lock(mutexMap_);
+
+        // a write whose outcome is needed goes after the earlier writes of
+        // its table, so does a new table in group mode, opening the group
+        // transaction. Writes are posted with the map locked, none is left
+        // once the wait returns.
+        if (executor_ && (!TableStorageItem::CanDefer(transactor, tx) ||
+            (group_ && m_map.find(uTxDBName) == m_map.end())))
+            executor_->wait(group_ ? uint160() : uTxDBName, lock);
 
         auto it = m_map.find(uTxDBName);
         if (it == m_map.end())
@@ -175,7 +229,7 @@ namespace ripple {
             {
                 if (validIndex - LedgerSeq < MAX_GAP_NOW2VALID)  //catch up valid ledger
                 {
-                    auto pItem = std::make_shared<TableStorageItem>(app_, cfg_, journal_);
+                    auto pItem = std::make_shared<TableStorageItem>(app_, cfg_, journal_, group_.get(), executor_.get());
                     auto itRet = m_map.insert(make_pair(uTxDBName, pItem));
                     if (itRet.second)
                     {
@@ -213,21 +267,18 @@ namespace ripple {
                 auto const sleTable = validLedger->read(kTable);
 
                 if (!sleTable) return tefTABLE_STORAGENORMALERROR;
-                STArray tablentries = sleTable->getFieldArray(sfTableEntries);
-
-                auto iter(tablentries.end());
-                iter = std::find_if(tablentries.begin(), tablentries.end(),
-                    [uTxDBName](STObject const &item) {
+                auto const pEntry = findTableEntry(*validLedger, accountID,
+                    [uTxDBName](STEntry const &item) {
                     return item.getFieldH160(sfNameInDB) == uTxDBName;
                 });
 
-                if (iter != tablentries.end())
+                if (pEntry != nullptr)
                 {
                     return tefTABLE_STORAGENORMALERROR;
                 }
                 else
                 {
-                    auto pItem = std::make_shared<TableStorageItem>(app_, cfg_, journal_);
+                    auto pItem = std::make_shared<TableStorageItem>(app_, cfg_, journal_, group_.get(), executor_.get());
                     auto itRet = m_map.insert(make_pair(uTxDBName, pItem));
                     if (itRet.second)
                     {
@@ -251,6 +302,13 @@ namespace ripple {
     void TableStorage::TableStorageThread()
     {
         auto validIndex = app_.getLedgerMaster().getValidLedgerIndex();
+        if (group_)
+        {
+            GroupCommit(validIndex);
+            bTableStorageThread_ = false;
+            return;
+        }
+
         auto mapTmp = m_map;
 
         for(auto item : mapTmp)
@@ -258,6 +316,8 @@ namespace ripple {
             uint160 uTxDBName; //how to get value ?
             {
                 std::lock_guard<std::mutex> lock(mutexMap_);
+                if (item.second->IsBusy())
+                    continue;
                 bool bRet = item.second->doJob(validIndex);
                 if (bRet)
                 {
@@ -267,5 +327,145 @@ namespace ripple {
         }
         bTableStorageThread_ = false;
     }
+
+    // All tables share one transaction, see TableStorageGroup. At each pass
+    // the tables diverged from the validated ledger are undone alone, then
+    // the validated writes in front are committed and the others are done
+    // again in the next transaction.
+    void TableStorage::GroupCommit(LedgerIndex validIndex)
+    {
+        std::lock_guard<std::mutex> lock(mutexMap_);
+        if (m_map.empty())
+            return;
+
+        // deferred writes go through the group connection too
+        for (auto const& item : m_map)
+        {
+            if (item.second->IsBusy())
+                return;
+        }
+
+        std::set<uint160> diverged;
+        for (auto const& item : m_map)
+        {
+            if (item.second->CheckJob(validIndex) == TableStorageItem::STORAGE_ROLLBACK)
+                diverged.insert(item.first);
+        }
+        if (!GroupRollBack(diverged))
+            return;
+
+        auto const& writes = group_->writes();
+        auto const validated = [this](TableStorageGroup::Write const& write)
+        {
+            auto it = m_map.find(write.table);
+            return it != m_map.end() && it->second->IsValidated(write.txhash);
+        };
+
+        // a table is committed with all of its validated writes or none
+        std::size_t end = 0;
+        while (end < writes.size() && validated(writes[end]))
+            end++;
+        for (bool cut = true; cut && end > 0;)
+        {
+            cut = false;
+            for (std::size_t i = end; i < writes.size() && !cut; i++)
+            {
+                if (!validated(writes[i]))
+                    continue;
+                for (std::size_t j = 0; j < end; j++)
+                {
+                    if (writes[j].table == writes[i].table)
+                    {
+                        end = j;
+                        cut = true;
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (end > 0)
+        {
+            std::set<uint160> committed;
+            for (std::size_t i = 0; i < end; i++)
+                committed.insert(writes[i].table);
+
+            std::vector<TableStorageGroup::Write> rest;
+            if (!group_->undo(end, rest))
+            {
+                GroupAbort();
+                return;
+            }
+            for (auto const& table : committed)
+                m_map[table]->PrepareCommit();
+            group_->commit();
+            JLOG(journal_.debug()) << "TableStorage group commit of " << committed.size()
+                << " tables at ledger " << validIndex << ", " << rest.size() << " writes carried over";
+
+            for (auto const& table : committed)
+            {
+                if (m_map[table]->OnCommitted())
+                    m_map.erase(table);
+            }
+
+            std::set<uint160> failed;
+            group_->redo(rest, {}, failed);
+            if (!GroupRollBack(failed))
+                return;
+        }
+
+        // tables left without txs, e.g. when their only one failed
+        for (auto it = m_map.begin(); it != m_map.end();)
+        {
+            if (it->second->IsEmpty() && it->second->OnCommitted())
+                it = m_map.erase(it);
+            else
+                it++;
+        }
+    }
+
+    // Undoes the writes of `tables` and has the tables synced again. Writes
+    // after them are done again, a table failing one is undone as well.
+    bool TableStorage::GroupRollBack(std::set<uint160> tables)
+    {
+        std::set<uint160> dropped;
+        while (!tables.empty())
+        {
+            auto const& writes = group_->writes();
+            std::size_t first = 0;
+            while (first < writes.size() && !tables.count(writes[first].table))
+                first++;
+
+            std::vector<TableStorageGroup::Write> undone;
+            if (!group_->undo(first, undone))
+            {
+                GroupAbort();
+                return false;
+            }
+
+            for (auto const& table : tables)
+            {
+                auto it = m_map.find(table);
+                if (it != m_map.end())
+                {
+                    it->second->OnRollBack();
+                    m_map.erase(it);
+                }
+                dropped.insert(table);
+            }
+
+            tables.clear();
+            group_->redo(undone, dropped, tables);
+        }
+        return true;
+    }
+
+    // A savepoint is gone, every table is rolled back.
+    void TableStorage::GroupAbort()
+    {
+        group_->rollback();
+        for (auto const& each : m_map)
+            each.second->OnRollBack();
+        m_map.clear();
+    }
 }
-  
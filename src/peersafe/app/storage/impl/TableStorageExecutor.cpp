@@ -0,0 +1,245 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <peersafe/app/storage/TableStorageExecutor.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/protocol/JsonFields.h>
+
+namespace ripple {
+
+TableStorageExecutor::TableStorageExecutor (JobQueue& jobQueue,
+        beast::insight::Collector::ptr const& collector)
+    : jobQueue_ (jobQueue)
+    , pending_ (0)
+    , deferred_ (0)
+    , failed_ (0)
+    , waited_ (0)
+    , waitTime_ (0)
+    , depth_ (collector->make_gauge ("pending"))
+    , waitEvent_ (collector->make_event ("wait"))
+{
+}
+
+void TableStorageExecutor::post (uint160 const& strand, LedgerIndex seq,
+    write_type f)
+{
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        auto& s = strands_[strand];
+        bool const idle = s.queue.empty () && !s.running;
+        s.queue.emplace (seq, std::move (f));
+        ++pending_;
+        ++deferred_;
+        depth_ = pending_;
+        if (!idle)
+            return;
+    }
+    schedule (strand);
+}
+
+void TableStorageExecutor::schedule (uint160 const& strand)
+{
+    bool const added = jobQueue_.addJob (jtTABLESTORAGEPUT, "tableStoragePut",
+        [this, strand](Job&)
+        {
+            run (strand);
+        });
+
+    // the job queue is stopping, write here
+    if (!added)
+        run (strand);
+}
+
+void TableStorageExecutor::run (uint160 const& strand)
+{
+    std::unique_lock <std::mutex> lock (mutex_);
+    auto const it = strands_.find (strand);
+
+    // already drained by a waiting thread, or held
+    if (it == strands_.end () || it->second.running)
+        return;
+    drain (lock, strand);
+}
+
+void TableStorageExecutor::drain (std::unique_lock <std::mutex>& lock,
+    uint160 const& strand)
+{
+    auto const it = strands_.find (strand);
+    it->second.running = true;
+    while (!it->second.queue.empty ())
+    {
+        auto const first = it->second.queue.begin ();
+        auto f = std::move (first->second);
+        it->second.queue.erase (first);
+
+        lock.unlock ();
+        bool ok = false;
+        try
+        {
+            ok = f ();
+        }
+        catch (std::exception const&)
+        {
+        }
+        lock.lock ();
+
+        --pending_;
+        if (!ok)
+            ++failed_;
+        depth_ = pending_;
+    }
+    strands_.erase (it);
+    cv_.notify_all ();
+}
+
+bool TableStorageExecutor::busy (uint160 const& strand) const
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    return strands_.count (strand) != 0;
+}
+
+void TableStorageExecutor::wait (uint160 const& strand)
+{
+    using namespace std::chrono;
+
+    std::unique_lock <std::mutex> lock (mutex_);
+    auto const it = strands_.find (strand);
+    if (it == strands_.end ())
+        return;
+
+    auto const start = steady_clock::now ();
+    if (!it->second.running)
+        drain (lock, strand);
+    else
+        cv_.wait (lock, [this, &strand]
+        {
+            return strands_.count (strand) == 0;
+        });
+
+    auto const elapsed = duration_cast <milliseconds> (
+        steady_clock::now () - start);
+    ++waited_;
+    waitTime_ += elapsed;
+    waitEvent_.notify (elapsed);
+}
+
+void TableStorageExecutor::wait (uint160 const& strand,
+    std::unique_lock <std::mutex>& lock)
+{
+    while (busy (strand))
+    {
+        lock.unlock ();
+        wait (strand);
+        lock.lock ();
+    }
+}
+
+// A held strand is marked running, so posts queue up without a job.
+void TableStorageExecutor::hold (uint160 const& strand)
+{
+    std::unique_lock <std::mutex> lock (mutex_);
+    for (;;)
+    {
+        auto const it = strands_.find (strand);
+        if (it == strands_.end ())
+            break;
+        if (!it->second.running)
+            drain (lock, strand);
+        else
+            cv_.wait (lock);
+    }
+    strands_[strand].running = true;
+}
+
+void TableStorageExecutor::release (uint160 const& strand)
+{
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        auto const it = strands_.find (strand);
+        if (it == strands_.end ())
+            return;
+
+        it->second.running = false;
+        if (it->second.queue.empty ())
+        {
+            strands_.erase (it);
+            cv_.notify_all ();
+            return;
+        }
+    }
+    schedule (strand);
+}
+
+TableStorageExecutor::Hold::Hold (TableStorageExecutor& executor,
+        uint160 const& strand)
+    : executor_ (&executor)
+    , strand_ (strand)
+{
+    executor_->hold (strand_);
+}
+
+TableStorageExecutor::Hold::Hold (Hold&& other)
+    : executor_ (other.executor_)
+    , strand_ (other.strand_)
+{
+    other.executor_ = nullptr;
+}
+
+TableStorageExecutor::Hold&
+TableStorageExecutor::Hold::operator= (Hold&& other)
+{
+    if (this != &other)
+    {
+        if (executor_)
+            executor_->release (strand_);
+        executor_ = other.executor_;
+        strand_ = other.strand_;
+        other.executor_ = nullptr;
+    }
+    return *this;
+}
+
+TableStorageExecutor::Hold::~Hold ()
+{
+    if (executor_)
+        executor_->release (strand_);
+}
+
+std::size_t TableStorageExecutor::pending () const
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    return pending_;
+}
+
+Json::Value TableStorageExecutor::getInfo () const
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    Json::Value ret (Json::objectValue);
+    ret[jss::pending] = static_cast <Json::UInt> (pending_);
+    ret[jss::deferred] = static_cast <Json::UInt> (deferred_);
+    ret[jss::failed] = static_cast <Json::UInt> (failed_);
+    ret[jss::waited] = static_cast <Json::UInt> (waited_);
+    // average time a transactor waited for a strand
+    if (waited_ != 0)
+        ret[jss::wait_ms] = static_cast <Json::UInt> (
+            waitTime_.count () / waited_);
+    return ret;
+}
+
+}
@@ -0,0 +1,240 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <ripple/app/main/Application.h>
+#include <peersafe/app/table/TableStatusDBMySQL.h>
+#include <peersafe/app/table/TableStatusDBSQLite.h>
+#include <peersafe/app/storage/TableStorageGroup.h>
+
+namespace ripple {
+
+    TableStorageGroup::TableStorageGroup(Application& app, Config& cfg, beast::Journal journal)
+        : bOpen_(false)
+        , savepointSeq_(0)
+        , commits_(0)
+        , rollbacks_(0)
+        , app_(app)
+        , journal_(journal)
+        , cfg_(cfg)
+    {
+    }
+
+    TableStorageGroup::~TableStorageGroup()
+    {
+        if (bOpen_)
+            rollback();
+    }
+
+    TxStoreDBConn& TableStorageGroup::getTxStoreDBConn()
+    {
+        if (conn_ == NULL)
+        {
+            conn_ = std::make_unique<TxStoreDBConn>(cfg_);
+            if (conn_->GetDBConn() == NULL)
+            {
+                JLOG(journal_.error()) << "TableStorageGroup::getTxStoreDBConn() return null";
+            }
+        }
+        return *conn_;
+    }
+
+    TxStore& TableStorageGroup::getTxStore()
+    {
+        if (pObjTxStore_ == NULL)
+        {
+            auto& conn = getTxStoreDBConn();
+            pObjTxStore_ = std::make_unique<TxStore>(conn.GetDBConn(), cfg_, journal_);
+        }
+        return *pObjTxStore_;
+    }
+
+    TableStatusDB& TableStorageGroup::getTableStatusDB()
+    {
+        if (pObjTableStatusDB_ == NULL)
+        {
+            DatabaseCon::Setup setup = ripple::setup_SyncDatabaseCon(cfg_);
+            std::pair<std::string, bool> result = setup.sync_db.find("type");
+            if (result.first.compare("sqlite") == 0)
+                pObjTableStatusDB_ = std::make_unique<TableStatusDBSQLite>(getTxStoreDBConn().GetDBConn(), &app_, journal_);
+            else
+                pObjTableStatusDB_ = std::make_unique<TableStatusDBMySQL>(getTxStoreDBConn().GetDBConn(), &app_, journal_);
+        }
+
+        return *pObjTableStatusDB_;
+    }
+
+    // The session is only checked out for the statement itself, unlike
+    // TxStoreTransaction the group stays open across ledgers and must not
+    // keep the connection locked to the thread that opened it.
+    void TableStorageGroup::begin()
+    {
+        if (bOpen_ || getTxStoreDBConn().GetDBConn() == NULL)
+            return;
+
+        try
+        {
+            LockedSociSession sql = conn_->GetDBConn()->checkoutDb();
+            sql->begin();
+            bOpen_ = true;
+        }
+        catch (soci::soci_error& e)
+        {
+            JLOG(journal_.error()) << "TableStorageGroup::begin " << e.what();
+        }
+    }
+
+    void TableStorageGroup::commit()
+    {
+        if (!bOpen_)
+            return;
+
+        try
+        {
+            LockedSociSession sql = conn_->GetDBConn()->checkoutDb();
+            sql->commit();
+            commits_++;
+        }
+        catch (soci::soci_error& e)
+        {
+            JLOG(journal_.error()) << "TableStorageGroup::commit " << e.what();
+        }
+        bOpen_ = false;
+        writes_.clear();
+    }
+
+    void TableStorageGroup::rollback()
+    {
+        if (!bOpen_)
+            return;
+
+        try
+        {
+            LockedSociSession sql = conn_->GetDBConn()->checkoutDb();
+            sql->rollback();
+            conn_->GetDBConn()->rolledBack();
+            rollbacks_++;
+        }
+        catch (soci::soci_error& e)
+        {
+            JLOG(journal_.error()) << "TableStorageGroup::rollback " << e.what();
+        }
+        bOpen_ = false;
+        writes_.clear();
+    }
+
+    std::string TableStorageGroup::savepoint()
+    {
+        begin();
+        if (!bOpen_)
+            return "";
+
+        std::string name = "sp_" + std::to_string(++savepointSeq_);
+        if (!execute("SAVEPOINT " + name))
+            return "";
+        return name;
+    }
+
+    bool TableStorageGroup::rollbackTo(std::string const& name)
+    {
+        if (name.empty())
+            return false;
+        if (!execute("ROLLBACK TO SAVEPOINT " + name))
+            return false;
+        conn_->GetDBConn()->rolledBack();
+        return true;
+    }
+
+    // A DDL statement commits implicitly on MySQL and drops the savepoint,
+    // so a failing release is only logged.
+    void TableStorageGroup::release(std::string const& name)
+    {
+        if (!name.empty())
+            execute("RELEASE SAVEPOINT " + name);
+    }
+
+    void TableStorageGroup::add(uint160 const& table, uint256 const& txhash,
+        std::string const& savepoint, std::function<bool()> redo)
+    {
+        writes_.push_back({ table, txhash, savepoint, std::move(redo) });
+    }
+
+    bool TableStorageGroup::undo(std::size_t index, std::vector<Write>& undone)
+    {
+        if (index >= writes_.size())
+            return true;
+        if (!rollbackTo(writes_[index].savepoint))
+            return false;
+
+        undone.insert(undone.end(),
+            std::make_move_iterator(writes_.begin() + index),
+            std::make_move_iterator(writes_.end()));
+        writes_.erase(writes_.begin() + index, writes_.end());
+        return true;
+    }
+
+    void TableStorageGroup::redo(std::vector<Write>& writes, std::set<uint160> const& skip,
+        std::set<uint160>& failed)
+    {
+        for (auto& write : writes)
+        {
+            if (skip.count(write.table) || failed.count(write.table))
+                continue;
+
+            std::string const name = savepoint();
+            bool ok = false;
+            try
+            {
+                ok = write.redo();
+            }
+            catch (std::exception const& e)
+            {
+                JLOG(journal_.warn()) << "TableStorageGroup redo throws: " << e.what();
+            }
+
+            if (ok)
+            {
+                write.savepoint = name;
+                writes_.push_back(std::move(write));
+            }
+            else
+            {
+                JLOG(journal_.warn()) << "TableStorageGroup redo failed, table " << to_string(write.table);
+                rollbackTo(name);
+                release(name);
+                failed.insert(write.table);
+            }
+        }
+        writes.clear();
+    }
+
+    bool TableStorageGroup::execute(std::string const& sql)
+    {
+        try
+        {
+            LockedSociSession session = conn_->GetDBConn()->checkoutDb();
+            *session << sql;
+        }
+        catch (soci::soci_error& e)
+        {
+            JLOG(journal_.warn()) << "TableStorageGroup: " << sql << " " << e.what();
+            return false;
+        }
+        return true;
+    }
+}
@@ -30,18 +30,28 @@
 #include <peersafe/protocol/STEntry.h>
 #include <peersafe/app/storage/TableStorageItem.h>
 #include <peersafe/app/storage/TableStorage.h>
+#include <peersafe/app/storage/TableStorageExecutor.h>
+#include <peersafe/app/storage/TableStorageGroup.h>
+#include <peersafe/app/table/TableDirectory.h>
 #include <peersafe/app/tx/ChainSqlTx.h>
+#include <peersafe/app/tx/OperationRule.h>
 #include <peersafe/app/util/TableSyncUtil.h>
 
 namespace ripple {    
     
-    TableStorageItem::TableStorageItem(Application& app, Config& cfg, beast::Journal journal)
-        : app_(app)
+    TableStorageItem::TableStorageItem(Application& app, Config& cfg, beast::Journal journal, TableStorageGroup* group,
+        TableStorageExecutor* executor)
+        : group_(group)
+        , executor_(executor)
+        , bDeferFailed_(false)
+        , bTransOpen_(false)
+        , app_(app)
         , journal_(journal)
         , cfg_(cfg)
     {       
 		bExistInSyncTable_ = false;
 		bDropped_ = false;
+        bReady_ = false;
 		lastTxTm_ = 0;
     }
 
@@ -53,9 +63,75 @@ namespace ripple {
     {
         accountID_ = account;
         sTableNameInDB_ = nameInDB;
+        uTableNameInDB_.SetHex(nameInDB);
         sTableName_ = tableName;
 
-        getTxStoreTrans();
+        // with deferred writes the group connection is free, see TableStorage
+        if (group_)
+            group_->begin();
+        else
+            beginTrans();
+
+        // a group writes all tables through one connection
+        if (executor_ && !group_)
+            strand_ = uTableNameInDB_;
+    }
+
+    // Deferred writes reach the connection from the executor's jobs, so the
+    // transaction is then checked out per statement as TableStorageGroup
+    // does, TxStoreTransaction keeps it locked to the thread opening it.
+    void TableStorageItem::beginTrans()
+    {
+        if (!executor_)
+        {
+            getTxStoreTrans();
+            return;
+        }
+        if (bTransOpen_ || getTxStoreDBConn().GetDBConn() == NULL)
+            return;
+
+        try
+        {
+            LockedSociSession sql = getTxStoreDBConn().GetDBConn()->checkoutDb();
+            sql->begin();
+            bTransOpen_ = true;
+        }
+        catch (soci::soci_error& e)
+        {
+            JLOG(journal_.error()) << "TableStorageItem::beginTrans " << e.what();
+        }
+    }
+
+    void TableStorageItem::endTrans(bool bCommit)
+    {
+        if (!executor_)
+        {
+            TxStoreTransaction &stTran = getTxStoreTrans();
+            if (bCommit)
+                stTran.commit();
+            else
+                stTran.rollback();
+            return;
+        }
+        if (!bTransOpen_)
+            return;
+
+        try
+        {
+            LockedSociSession sql = getTxStoreDBConn().GetDBConn()->checkoutDb();
+            if (bCommit)
+                sql->commit();
+            else
+            {
+                sql->rollback();
+                getTxStoreDBConn().GetDBConn()->rolledBack();
+            }
+        }
+        catch (soci::soci_error& e)
+        {
+            JLOG(journal_.error()) << "TableStorageItem::endTrans " << e.what();
+        }
+        bTransOpen_ = false;
     }
 
     void TableStorageItem::SetItemParam(LedgerIndex txnLedgerSeq, uint256 txnHash, LedgerIndex LedgerSeq, uint256 ledgerHash)
@@ -89,6 +165,7 @@ namespace ripple {
 		}
 
         txList_.push_back(txInfo_);
+        bReady_ = false;
     }
 
     void  TableStorageItem::prehandleTx(STTx const& tx)
@@ -111,7 +188,22 @@ namespace ripple {
 
 		prehandleTx(tx);
 
+        // otherwise the earlier writes are done, see TableStorage
+        if (executor_ && CanDefer(transactor, tx))
+            return DeferElem(transactor, tx, txhash);
+
 		auto op_type = tx.getFieldU16(sfOpType);
+		// in group mode the writes of this tx follow a savepoint, they are
+		// undone on failure or kept to be done again, see TableStorageGroup
+		std::string savepoint;
+		std::string rule;
+		if (group_)
+		{
+			savepoint = group_->savepoint();
+			if (isSqlStatementOpType((TableOpType)op_type))
+				rule = OperationRule::getOperationRule(transactor.view(), tx);
+		}
+
 		if (!isNotNeedDisposeType((TableOpType)op_type))
 		{
 			auto resultPair = transactor.dispose(getTxStore(),tx);
@@ -147,24 +239,148 @@ namespace ripple {
         if (ret.first)
         {
             JLOG(journal_.trace()) << "Dispose success";
-            if (!bExistInSyncTable_)
+            bool const bInsertSync = !bExistInSyncTable_;
+            uint256 chainId;
+            if (bInsertSync)
             {
+                chainId = TableSyncUtil::GetChainId(&transactor.view());
                 if (!getTableStatusDB().IsExist(accountID_, sTableNameInDB_))
                 {
-					auto chainId = TableSyncUtil::GetChainId(&transactor.view());
                     getTableStatusDB().InsertSnycDB(sTableName_, sTableNameInDB_, to_string(accountID_), LedgerSeq_, ledgerHash_, true, "",chainId);
                 }
                 bExistInSyncTable_ = true;
             }
 
+            if (group_)
+            {
+                auto const ledgerSeq = LedgerSeq_;
+                auto const ledgerHash = ledgerHash_;
+                group_->add(uTableNameInDB_, txhash, savepoint,
+                    [this, tx, rule, bInsertSync, chainId, ledgerSeq, ledgerHash]()
+                    {
+                        return Redo(tx, rule, bInsertSync, chainId, ledgerSeq, ledgerHash);
+                    });
+            }
+
             Put(tx, txhash);
 
             result = tesSUCCESS;
         }
+        else if (group_)
+        {
+            group_->rollbackTo(savepoint);
+            group_->release(savepoint);
+        }
       
         return result;
     }
 
+    // Only called with deferred_storage=unchecked. A write is left to the
+    // executor if no rule of the ledger depends on it: a row change outside
+    // strict mode, on a table without operation rules. The database can
+    // still reject it, that is the check the mode gives up, see DeferElem.
+    bool TableStorageItem::CanDefer(ChainSqlTx& transactor, STTx const& tx)
+    {
+        auto const opType = (TableOpType)tx.getFieldU16(sfOpType);
+        if (opType != R_INSERT && opType != R_UPDATE && opType != R_DELETE)
+            return false;
+        if (tx.isFieldPresent(sfTxCheckHash) || !tx.isFieldPresent(sfOwner))
+            return false;
+
+        auto const& tables = tx.getFieldArray(sfTables);
+        auto const pEntry = readTableEntry(transactor.view(),
+            tx.getAccountID(sfOwner), tables[0].getFieldVL(sfTableName));
+        if (!pEntry || !pEntry->getOperationRule(opType).empty())
+            return false;
+        // deletes keep the count of an insert rule
+        return opType != R_DELETE || pEntry->getOperationRule(R_INSERT).empty();
+    }
+
+    // The tx is taken as disposed: it returns tesSUCCESS instead of a tef
+    // result even if the database rejects the write later, which then has
+    // the table rolled back, with its other pending writes, and synced
+    // again at the next check.
+    TER TableStorageItem::DeferElem(ChainSqlTx& transactor, STTx const& tx, uint256 txhash)
+    {
+        bool const bInsertSync = !bExistInSyncTable_;
+        uint256 chainId;
+        if (bInsertSync)
+            chainId = TableSyncUtil::GetChainId(&transactor.view());
+        bExistInSyncTable_ = true;
+
+        auto const ledgerSeq = LedgerSeq_;
+        auto const ledgerHash = ledgerHash_;
+        executor_->post(strand_, transactor.view().info().seq,
+            [this, tx, txhash, bInsertSync, chainId, ledgerSeq, ledgerHash]()
+            {
+                std::string savepoint;
+                if (group_)
+                    savepoint = group_->savepoint();
+
+                bool const ok = Redo(tx, "", bInsertSync, chainId, ledgerSeq, ledgerHash);
+                if (!ok)
+                {
+                    JLOG(journal_.warn()) << "Deferred dispose error, table " << sTableName_;
+                    bDeferFailed_ = true;
+                    if (group_)
+                    {
+                        group_->rollbackTo(savepoint);
+                        group_->release(savepoint);
+                    }
+                }
+                else if (group_)
+                {
+                    group_->add(uTableNameInDB_, txhash, savepoint,
+                        [this, tx, bInsertSync, chainId, ledgerSeq, ledgerHash]()
+                        {
+                            return Redo(tx, "", bInsertSync, chainId, ledgerSeq, ledgerHash);
+                        });
+                }
+                return ok;
+            });
+
+        Put(tx, txhash);
+        return tesSUCCESS;
+    }
+
+    // The writes of a tx already applied to the ledger: its rows, done with
+    // the operation rule of the table, and the sync state of the table.
+    bool TableStorageItem::Redo(STTx const& tx, std::string const& rule, bool bInsertSync, uint256 const& chainId,
+        LedgerIndex ledgerSeq, uint256 const& ledgerHash)
+    {
+        try
+        {
+            auto const opType = (TableOpType)tx.getFieldU16(sfOpType);
+            if (!isNotNeedDisposeType(opType) && !getTxStore().Dispose(tx, rule, !rule.empty()).first)
+                return false;
+
+            if (opType == T_DROP)
+            {
+                getTableStatusDB().UpdateSyncDB(to_string(accountID_), sTableNameInDB_, true, "");
+            }
+            else if (opType == T_RENAME)
+            {
+                auto tables = tx.getFieldArray(sfTables);
+                if (tables.size() > 0)
+                    getTableStatusDB().RenameRecord(accountID_, sTableNameInDB_, strCopy(tables[0].getFieldVL(sfTableNewName)));
+            }
+
+            if (bInsertSync && !getTableStatusDB().IsExist(accountID_, sTableNameInDB_))
+                getTableStatusDB().InsertSnycDB(sTableName_, sTableNameInDB_, to_string(accountID_), ledgerSeq, ledgerHash, true, "", chainId);
+        }
+        catch (std::exception const& e)
+        {
+            JLOG(journal_.warn()) << "TableStorageItem::Redo throws: " << e.what();
+            return false;
+        }
+        return true;
+    }
+
+    bool TableStorageItem::IsBusy() const
+    {
+        return executor_ && executor_->busy(strand_);
+    }
+
     bool TableStorageItem::CheckExistInLedger(LedgerIndex CurLedgerVersion)
     {
 		auto ledger = app_.getLedgerMaster().getLedgerBySeq(CurLedgerVersion);
@@ -186,6 +402,15 @@ namespace ripple {
         return iter == txList_.end();
     }
 
+    bool TableStorageItem::IsValidated(uint256 const& txhash) const
+    {
+        auto iter = std::find_if(txList_.begin(), txList_.end(),
+            [&txhash](txInfo const& info) {
+            return info.uTxHash == txhash;
+        });
+        return iter != txList_.end() && iter->bCommit;
+    }
+
     bool TableStorageItem::isHaveTx(uint256 txid)
     {
         auto iter(txList_.end());
@@ -213,18 +438,18 @@ namespace ripple {
             auto const sleAccepted = ledger->read(keylet::table(accountID_));
             if (sleAccepted == NULL) continue;            
 			
-            const STEntry * pEntry = NULL;
-            auto aTableEntries = sleAccepted->getFieldArray(sfTableEntries);
-            auto retPair = TableSyncUtil::IsTableSLEChanged(aTableEntries, txnLedgerSeq_, accountID_, sTableNameInDB_,true); 
+            auto retPair = TableSyncUtil::IsTableSLEChanged(*ledger, txnLedgerSeq_, accountID_, sTableNameInDB_,true); 
 			if (retPair.second == NULL)
 			{
 				if (retPair.first)
 					continue;
-				else //deleted
-					return STORAGE_COMMIT;
+				//deleted, nothing left to wait for
+				for (auto& info : txList_)
+					info.bCommit = true;
+				return STORAGE_COMMIT;
 			}				
 			            
-			pEntry = retPair.second;
+			auto const& pEntry = retPair.second;
 			std::vector <uint256> aTx;
 			for (auto const& item : ledger->txMap())
 			{
@@ -290,38 +515,51 @@ namespace ripple {
 
     bool TableStorageItem::rollBack()
     {
-        {
-            TxStoreTransaction &stTran = getTxStoreTrans();
-            stTran.rollback();
-            JLOG(journal_.warn()) << " TableStorageItem::rollBack " << sTableName_;
-        }
-
-        app_.getTableSync().ReStartOneTable(accountID_, sTableNameInDB_, sTableName_, false, false);
+        endTrans(false);
+        OnRollBack();
         return true;
     }
 
+    void TableStorageItem::OnRollBack()
+    {
+        JLOG(journal_.warn()) << " TableStorageItem::rollBack " << sTableName_;
+        app_.getTableSync().ReStartOneTable(accountID_, sTableNameInDB_, sTableName_, false, false);
+    }
 
     bool TableStorageItem::commit()
     {
-        {
-            TxStoreTransaction &stTran = getTxStoreTrans();
-			if(!bDropped_)
-				getTableStatusDB().UpdateSyncDB(to_string(accountID_), sTableNameInDB_, to_string(txnHash_), to_string(txnLedgerSeq_), to_string(ledgerHash_), to_string(LedgerSeq_), txUpdateHash_.isNonZero()?to_string(txUpdateHash_) : "", to_string(lastTxTm_),"");
-            stTran.commit();
-        }
+        PrepareCommit();
+        endTrans(true);
+        OnCommitted();
+        return true;
+    }
 
-        app_.getTableSync().ReStartOneTable(accountID_, sTableNameInDB_, sTableName_, bDropped_, true);
-        
+    void TableStorageItem::PrepareCommit()
+    {
+        if (!bDropped_)
+            getTableStatusDB().UpdateSyncDB(to_string(accountID_), sTableNameInDB_, to_string(txnHash_), to_string(txnLedgerSeq_), to_string(ledgerHash_), to_string(LedgerSeq_), txUpdateHash_.isNonZero()?to_string(txUpdateHash_) : "", to_string(lastTxTm_),"");
+    }
 
+    bool TableStorageItem::OnCommitted()
+    {
 		auto result = std::make_pair("db_success", "");
-		for (auto& info : txList_)
+		for (auto iter = txList_.begin(); iter != txList_.end();)
 		{
-			auto txn = app_.getMasterTransaction().fetch(info.uTxHash, true);
+			if (!iter->bCommit)
+			{
+				iter++;
+				continue;
+			}
+			auto txn = app_.getMasterTransaction().fetch(iter->uTxHash, true);
 			if (txn) {
 				app_.getOPs().pubTableTxs(accountID_, sTableName_, *txn->getSTransaction(), result, false);
 			}
+			iter = txList_.erase(iter);
 		}
+		if (!txList_.empty())
+			return false;
 
+        app_.getTableSync().ReStartOneTable(accountID_, sTableNameInDB_, sTableName_, bDropped_, true);
         return true;
     }
 
@@ -333,6 +571,9 @@ namespace ripple {
 
     TxStoreDBConn& TableStorageItem::getTxStoreDBConn()
     {
+        if (group_)
+            return group_->getTxStoreDBConn();
+
         if (conn_ == NULL)
         {
             conn_ = std::make_unique<TxStoreDBConn>(cfg_);
@@ -355,6 +596,9 @@ namespace ripple {
 
     TxStore& TableStorageItem::getTxStore()
     {
+        if (group_)
+            return group_->getTxStore();
+
         if (pObjTxStore_ == NULL)
         {
             auto& conn = getTxStoreDBConn();
@@ -365,6 +609,9 @@ namespace ripple {
 
     TableStatusDB& TableStorageItem::getTableStatusDB()
     {
+        if (group_)
+            return group_->getTableStatusDB();
+
         if (pObjTableStatusDB_ == NULL)
         {
 			DatabaseCon::Setup setup = ripple::setup_SyncDatabaseCon(cfg_);
@@ -381,7 +628,7 @@ namespace ripple {
     bool TableStorageItem::doJob(LedgerIndex CurLedgerVersion)
     {
         bool bRet = false;
-        bRet = CheckExistInLedger(CurLedgerVersion);
+        bRet = !bDeferFailed_ && CheckExistInLedger(CurLedgerVersion);
         if (!bRet)
         {
             rollBack();
@@ -405,4 +652,21 @@ namespace ripple {
         
         return false;
     }
+
+    // Once found committable the item stays so until a new tx is put.
+    TableStorageItem::TableStorageDBFlag TableStorageItem::CheckJob(LedgerIndex CurLedgerVersion)
+    {
+        if (bDeferFailed_)
+            return STORAGE_ROLLBACK;
+
+        if (bReady_)
+            return STORAGE_COMMIT;
+
+        if (!CheckExistInLedger(CurLedgerVersion))
+            return STORAGE_ROLLBACK;
+
+        auto eType = CheckSuccessive(CurLedgerVersion);
+        bReady_ = eType == STORAGE_COMMIT;
+        return eType;
+    }
 }
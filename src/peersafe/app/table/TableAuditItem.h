@@ -21,6 +21,8 @@
 #define RIPPLE_APP_TABLE_TABLEAUDIT_ITEM_H_INCLUDED
 
 #include <peersafe/app/table/TableDumpItem.h>
+#include <peersafe/app/sql/SQLPredicate.h>
+#include <memory>
 
 namespace ripple {
 
@@ -35,7 +37,9 @@ public:
 
 private:	
     bool isTxNeededOutput(const STTx& tx, std::vector<STTx>& vecTxs);    
-    void ConstructCheckJson();   
+    std::string ConstructCheckRaw();
+    std::pair<bool, std::string> SetCheckRaw(std::string sRaw);
+    bool mayChangeResult(const STTx& tx);
     void issuesAfterStop();
     bool checkSqlValid(std::string sSql);
 
@@ -46,6 +50,8 @@ private:
     std::list <int>                                              aCheckID_;
     std::list <std::string>                                      aCheckField_;
     Json::Value                                                  jsonCheck_;
+    // conditions of jsonCheck_,null if the audit is given in sql
+    std::unique_ptr<SQLPredicate>                                pCheckPredicate_;
 
     Json::Value                                                  jsonLashResult_;
     std::string                                                  sCheckSQL_;
@@ -0,0 +1,74 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#ifndef RIPPLE_APP_TABLE_TABLEBULKLOAD_H_INCLUDED
+#define RIPPLE_APP_TABLE_TABLEBULKLOAD_H_INCLUDED
+
+#include <ripple/basics/Log.h>
+#include <ripple/core/DatabaseCon.h>
+#include <map>
+#include <vector>
+#include <string>
+
+namespace ripple {
+
+// Secondary indexes of a table synchronized in bulk. They are dropped
+// while the table is far behind the validated ledger and created again
+// once it has caught up, so the rows of the initial sync are not indexed
+// one at a time. The definitions are kept in SyncBulkIndex, an interrupted
+// load restores them after a restart.
+//
+// DDL commits implicitly on MySQL, call these outside of a transaction.
+class TableBulkLoad
+{
+public:
+    TableBulkLoad(DatabaseCon* dbconn, bool bSQLite, beast::Journal journal);
+
+    // Drops the non-unique indexes of t_<nameInDB> if not dropped yet.
+    void dropIndexes(std::string const& nameInDB);
+    // Creates the dropped indexes again, returns how many were restored.
+    // The table is still loading while one of them fails.
+    std::size_t restoreIndexes(std::string const& nameInDB);
+    // The table was dropped or created again, its indexes are gone.
+    void forget(std::string const& nameInDB);
+
+    bool isLoading(std::string const& nameInDB);
+
+private:
+    struct Index
+    {
+        std::string name;
+        std::string sql;
+    };
+
+    bool init();
+    std::vector<Index> secondaryIndexes(std::string const& table);
+    bool execute(std::string const& sql);
+
+private:
+    DatabaseCon*                                                 databasecon_;
+    bool                                                         bSQLite_;
+    bool                                                         bInit_;
+    // nameInDB -> indexes dropped
+    std::map<std::string, bool>                                  loading_;
+    beast::Journal                                               journal_;
+};
+
+}
+#endif
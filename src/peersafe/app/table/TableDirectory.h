@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+
+#ifndef RIPPLE_APP_TABLE_TABLEDIRECTORY_H_INCLUDED
+#define RIPPLE_APP_TABLE_TABLEDIRECTORY_H_INCLUDED
+
+#include <ripple/ledger/ApplyView.h>
+#include <ripple/protocol/TER.h>
+#include <peersafe/protocol/STEntry.h>
+#include <functional>
+#include <memory>
+
+namespace ripple {
+
+/*
+    Tables owned by an account.
+
+    Without featureTableDirectory every table is an element of sfTableEntries
+    in the ltTABLELIST of its owner, so a lookup scans the array and a change
+    rewrites all of it. With the amendment every table is an ltTABLE entry
+    keyed by owner and table name and linked from the owner's table directory,
+    ltTABLELIST keeps sfFutureTxHash and the number of tables.
+
+    Tables created before the amendment stay in sfTableEntries until the next
+    table transaction of their owner moves them (migrateTableEntries), so
+    readers look at both places.
+*/
+
+bool
+isTableDirectoryEnabled (ReadView const& view);
+
+/** The entry of a table, nullptr if `owner` has no such table */
+std::shared_ptr<STEntry const>
+readTableEntry (ReadView const& view, AccountID const& owner,
+    Blob const& tableName);
+
+std::shared_ptr<STEntry const>
+readTableEntry (ReadView const& view, AccountID const& owner,
+    std::string const& tableName);
+
+/** Call `f` for every table of `owner` until it returns false */
+void
+forEachTableEntry (ReadView const& view, AccountID const& owner,
+    std::function<bool (STEntry const&)> const& f);
+
+/** The first table of `owner` satisfying `pred`, for lookups by
+    something other than the table name.
+*/
+std::shared_ptr<STEntry const>
+findTableEntry (ReadView const& view, AccountID const& owner,
+    std::function<bool (STEntry const&)> const& pred);
+
+std::size_t
+tableCount (ReadView const& view, AccountID const& owner);
+
+/** A table entry to be modified and the ledger entry holding it,
+    which must be updated in the view after modifying the table.
+*/
+struct TableSle
+{
+    std::shared_ptr<SLE> sle;
+    STEntry* entry = nullptr;
+
+    explicit operator bool () const
+    {
+        return entry != nullptr;
+    }
+};
+
+TableSle
+peekTableEntry (ApplyView& view, AccountID const& owner,
+    Blob const& tableName);
+
+/** Add a table, the ltTABLELIST of `owner` must exist */
+TER
+insertTableEntry (ApplyView& view, AccountID const& owner,
+    STObject const& entry);
+
+TER
+eraseTableEntry (ApplyView& view, AccountID const& owner,
+    Blob const& tableName);
+
+TER
+renameTableEntry (ApplyView& view, AccountID const& owner,
+    Blob const& tableName, Blob const& newName);
+
+/** Move the tables of `owner` out of sfTableEntries, nothing to do
+    if the amendment isn't enabled or they were moved already.
+*/
+TER
+migrateTableEntries (ApplyView& view, AccountID const& owner);
+
+} // ripple
+
+#endif
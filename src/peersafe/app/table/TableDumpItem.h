@@ -21,6 +21,7 @@
 #define RIPPLE_APP_TABLE_TABLEDUMP_ITEM_H_INCLUDED
 
 #include <peersafe/app/table/TableSyncItem.h>
+#include <ripple/protocol/STTx.h>
 
 
 namespace ripple {
@@ -44,7 +45,26 @@ protected:
     std::pair<int, int> GetRightTxEndPos(FILE * fp, bool &bEmptyTx);
     void SetStopInfo(FILE *fileTarget, std::string sMsg);
     void SetErroeInfo2FileEnd(FILE *fileTarget);
-    virtual bool DealWithEveryLedgerData(const std::vector<protocol::TMTableData> &aData);
+    virtual void DecodeLedger(DecodedLedger &ledger);
+    virtual bool DealWithEveryLedgerData(std::vector<DecodedLedger> &aData);
+
+    //locate the write position from <dump>.idx, scan backward for ']' if the index is missing or stale
+    bool LocateTxEnd(FILE *fp, Json::Value *pPos = nullptr);
+    void SaveDumpIndex(FILE *fp, std::string const& sPos);
+    //write sBody at the write position, followed by "\n]\n" and the position info
+    bool WriteTxBody(FILE *fp, std::string const& sBody, bool bStop, std::string const& sMsg);
+
+private:
+    struct DumpTx
+    {
+        std::shared_ptr<STTx>                                    pTx;
+        std::vector<STTx>                                        vecTxs;
+        std::string                                              sTx;
+    };
+
+    //deserialize, decrypt and serialize the txs of all ledgers in aData, helped by jobs for big batches
+    void PrepareTxs(const std::vector<DecodedLedger> &aData, std::vector<std::vector<DumpTx>> &aTxs);
+    std::string GetIndexPath() { return sDumpPath_ + ".idx"; }
 
 private:		
     static Json::Value TransRaw2Json(const STTx & tx);
@@ -60,6 +80,9 @@ protected:
     std::string                                                  sTxHashRecord_;
     LedgerIndex                                                  uLedgerSeqRecord_;
     std::string                                                  sLedgerHashRecord_;
+    //file offset behind the last tx written, -1 if not located yet
+    long                                                         lTxEndPos_;
+    bool                                                         bEmptyTx_;
 
 private:	
 	funDumpCB                                                    funDumpCB_;    
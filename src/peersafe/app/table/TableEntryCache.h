@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#ifndef RIPPLE_APP_TABLE_TABLEENTRYCACHE_H_INCLUDED
+#define RIPPLE_APP_TABLE_TABLEENTRYCACHE_H_INCLUDED
+
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/ledger/ReadView.h>
+#include <peersafe/protocol/STEntry.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace ripple {
+
+/*
+    Table entries of the last validated ledger, keyed by owner and table
+    name, so read RPCs resolve NameInDB, users and operation rules without
+    deserialising the owner's tables.
+
+    Every cached entry remembers the ledger entry it was read from (the ltTABLE
+    of the table, or the owner's ltTABLELIST for tables still kept in
+    sfTableEntries). When a new validated ledger arrives the entries whose
+    ledger entry the ledger modified are dropped, everything else stays valid.
+    If validated ledgers are skipped the whole cache is dropped.
+*/
+class TableEntryCache
+{
+public:
+    explicit
+    TableEntryCache (std::size_t maxSize = 4096);
+
+    /** The entry of a table in `ledger`, nullptr if there is none.
+        The cache is only used if `ledger` is the last validated ledger
+        passed to onValidatedLedger.
+    */
+    std::shared_ptr<STEntry const>
+    fetch (ReadView const& ledger, AccountID const& owner,
+        std::string const& tableName);
+
+    /** Must be called with every new validated ledger, in order. */
+    void
+    onValidatedLedger (ReadView const& ledger);
+
+    void
+    clear ();
+
+    std::size_t
+    size () const;
+
+    std::uint64_t
+    hits () const
+    {
+        return hits_;
+    }
+
+    std::uint64_t
+    misses () const
+    {
+        return misses_;
+    }
+
+    std::uint64_t
+    invalidated () const
+    {
+        return invalidated_;
+    }
+
+private:
+    using Key = std::pair<AccountID, std::string>;
+
+    struct Item
+    {
+        std::shared_ptr<STEntry const> entry;
+        uint256 source;                 // ledger entry holding the table
+    };
+
+    std::size_t const maxSize_;
+
+    mutable std::mutex mutex_;
+    LedgerIndex seq_ = 0;
+    hash_map <Key, Item> items_;
+
+    std::atomic<std::uint64_t> hits_ {0};
+    std::atomic<std::uint64_t> misses_ {0};
+    std::atomic<std::uint64_t> invalidated_ {0};
+};
+
+} // ripple
+
+#endif
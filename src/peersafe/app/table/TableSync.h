@@ -29,6 +29,7 @@
 #include <peersafe/app/table/TableSyncItem.h>
 #include <peersafe/app/table/TableDumpItem.h>
 #include <peersafe/app/table/TableAuditItem.h>
+#include <peersafe/app/table/TableSyncWorkers.h>
 
 
 namespace ripple {
@@ -81,6 +82,10 @@ public:
 
     void SetHaveSyncFlag(bool haveSync);
 
+    TableSyncWorkers& Workers();
+    //workers and per-table lag, for get_counts
+    Json::Value GetSyncInfo();
+
 	std::vector <uint256> getTxsFromDb(uint32 TxnLgrSeq, std::string sAccountID);
 	//press test table name
 	std::string GetPressTableName();
@@ -145,6 +150,8 @@ private:
 	//press test related
 	bool										bPressSwitchOn_;
 	std::string									pressRealName_;
+
+    std::unique_ptr <TableSyncWorkers>          workers_;
 };
 
 }
@@ -29,17 +29,26 @@
 #include <ripple/overlay/Peer.h>
 #include <ripple/protocol/STLedgerEntry.h>
 #include <ripple/protocol/SecretKey.h>
+#include <ripple/protocol/STTx.h>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
 
 namespace ripple {
 
-class STTx;
+class TableBulkLoad;
+class TxStoreTransaction;
 
 //class Peer;
-class TableSyncItem
+// Stages posted to TableSyncWorkers keep the item alive, they may still
+// run after StopSync gives up waiting for them.
+class TableSyncItem : public std::enable_shared_from_this <TableSyncItem>
 {
 public:
     using clock_type = beast::abstract_clock <std::chrono::steady_clock>;
     using sqldata_type = std::pair<LedgerIndex, protocol::TMTableData>;	
+    using sqldata_map = std::map<LedgerIndex, protocol::TMTableData>;
 
     enum TableSyncState
     {        
@@ -140,6 +149,24 @@ public:
         }
     };
 
+    struct DecodedTx
+    {
+        std::shared_ptr<STTx>                                     pTx;
+        std::vector<STTx>                                         vecTxs;
+        // set when the tx could not be split or decrypted
+        std::string                                               sError;
+    };
+
+    // A ledger of TMTableData with its txs decoded ahead of being applied.
+    struct DecodedLedger
+    {
+        protocol::TMTableData                                     data;
+        std::vector<DecodedTx>                                    txs;
+        // txs were split for this name, decoded again if it changed
+        std::string                                               sNameInDB;
+        bool                                                      bDecoded = false;
+    };
+
 public:     
     TableSyncItem(Application& app, beast::Journal journal,Config& cfg, SyncTargetType eTargetType = SyncTarget_db);
     virtual ~TableSyncItem();
@@ -202,16 +229,19 @@ public:
 
     bool IsInFailList(beast::IP::Endpoint& peerAddr);
     
-    void TryOperateSQL();
+    void TryDecode();
     void OperateSQLThread();
 
+    //per-table progress for get_counts, lag is counted from validLedger
+    Json::Value GetSyncInfo(LedgerIndex validLedger);
+
 	// try to decrypt raw field with configuration.
 	void TryDecryptRaw(STTx& tx);
 	void TryDecryptRaw(std::vector<STTx>& vecTxs);
 	std::pair<bool, std::string> InitPassphrase();
 	
     void PushDataToWaitCheckQueue(sqldata_type &sqlData);
-    void DealWithWaitCheckQueue(std::function<bool(sqldata_type const&)>);
+    void DealWithWaitCheckQueue(std::function<bool(sqldata_map::value_type const&)>);
 
     bool GetRightRequestRange(TableSyncItem::BaseInfo &stRange);
     void PushDataToBlockDataQueue(sqldata_type &sqlData);
@@ -219,6 +249,8 @@ public:
 
     void PushDataToWholeDataQueue(sqldata_type &sqlData);
     void PushDataToWholeDataQueue(std::list <sqldata_type>  &aSqlData);
+    // ledgers received but not written yet are past the bound, fetching waits
+    bool IsBacklogFull();
 
     bool IsNameInDBExist(std::string TableName, std::string Owner, bool delCheck, std::string &TableNameInDB);
 
@@ -257,11 +289,23 @@ protected:
 
 private:
     bool GetIsChange();
-    void PushDataByOrder(std::list <sqldata_type> &aData, sqldata_type &sqlData);
+    void TryApply();
+    void DecodeThread();
+    void BeginStage();
+    void EndStage();
 
     void ReSetContex();
     
     TableStatusDB& getTableStatusDB();
+    TableBulkLoad& getTableBulkLoad();
+
+    // far behind the validated ledger a batch is written in one transaction
+    // with the secondary indexes of the table dropped
+    bool isBulkLoad(const std::vector<DecodedLedger> &aData);
+    bool isBulkLoadTx(const std::vector<STTx>& vecTxs);
+    void beginBulkLoad();
+    void commitBulkLoad();
+    void executeBulkLoad(std::string const& sql);
 
 	std::string getOperationRule(const STTx& tx);
 
@@ -269,7 +313,8 @@ private:
 	std::pair<bool, std::string> DealWithTx(const std::vector<STTx>& vecTxs);
 
 	void InsertPressData(const STTx& tx,uint32 ledgerSeq,uint32 ledgerTime);
-	virtual bool DealWithEveryLedgerData(const std::vector<protocol::TMTableData> &aData);
+	virtual void DecodeLedger(DecodedLedger &ledger);
+	virtual bool DealWithEveryLedgerData(std::vector<DecodedLedger> &aData);
 public:
     LedgerIndex                                                  u32SeqLedger_;  //seq of ledger, last syned ledger seq 
     LedgerIndex                                                  uTxSeq_;
@@ -302,16 +347,27 @@ private:
     std::chrono::steady_clock::time_point                        clock_data_;
     std::chrono::steady_clock::time_point                        clock_ledger_;        
 
-    std::list <sqldata_type>                                     aBlockData_;
+    // out of order ledgers, keyed by ledger seq
+    sqldata_map                                                  aBlockData_;
     std::mutex                                                   mutexBlockData_;
 
+    // consecutive ledgers waiting to be decoded
     std::list <sqldata_type>                                     aWholeData_;
     std::mutex                                                   mutexWholeData_;   
 
-    std::list <sqldata_type>                                     aWaitCheckData_;
+    // decoded ledgers waiting to be applied
+    std::deque <DecodedLedger>                                   aDecodedData_;
+    std::mutex                                                   mutexDecodedData_;
+
+    sqldata_map                                                  aWaitCheckData_;
     std::mutex                                                   mutexWaitCheckQueue_;
     
-    bool                                                         bOperateSQL_;
+    std::atomic<bool>                                            bDecode_;
+    std::atomic<bool>                                            bOperateSQL_;
+    // decode and apply jobs running, operateSqlEvent is set when none is
+    int                                                          iStages_;
+    std::mutex                                                   mutexStages_;
+    std::atomic<LedgerIndex>                                     uAppliedSeq_;      //last ledger written to db
 
     bool                                                         bGetLocalData_;
 
@@ -324,6 +380,14 @@ private:
     std::unique_ptr <TxStoreDBConn>                              conn_;
     std::unique_ptr <TxStore>                                    pObjTxStore_;
     std::unique_ptr <TableStatusDB>                              pObjTableStatusDB_;
+    std::unique_ptr <TableBulkLoad>                              pBulkLoad_;
+
+    LedgerIndex                                                  uBulkLoadGap_;
+    std::atomic<bool>                                            bBulkLoad_;
+    std::unique_ptr <TxStoreTransaction>                         pBulkTran_;
+    std::size_t                                                  uBulkTxs_;
+    // results of the txs in pBulkTran_, published once it is committed
+    std::vector<std::pair<STTx, std::pair<std::string, std::string>>> aBulkResults_;
   
     cond                                                         sCond_;    
 
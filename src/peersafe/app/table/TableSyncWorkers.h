@@ -0,0 +1,105 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+
+#ifndef RIPPLE_APP_TABLE_TABLESYNCWORKERS_H_INCLUDED
+#define RIPPLE_APP_TABLE_TABLESYNCWORKERS_H_INCLUDED
+
+#include <ripple/core/Job.h>
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+
+namespace ripple {
+
+class JobQueue;
+
+/*
+    Runs the per-table work of table sync (reading local ledgers, decoding
+    and applying TMTableData to the database) on the job queue. Reads of
+    local ledgers (jtTABLELOCALREAD) run at most `readers` jobs at a time,
+    the decoding and applying at most `workers` jobs at a time, so long
+    reads do not hold up the tables being written. Different tables
+    proceed concurrently, a table never has more than one job of each
+    stage posted at a time so its ledgers are decoded and applied in order.
+
+    The numbers are set by `workers=` and `read_workers=` in [sync_tables].
+*/
+class TableSyncWorkers
+{
+public:
+    TableSyncWorkers (JobQueue& jobQueue, std::size_t workers,
+        std::size_t readers);
+
+    TableSyncWorkers (TableSyncWorkers const&) = delete;
+    TableSyncWorkers& operator= (TableSyncWorkers const&) = delete;
+
+    /** Run `f` as soon as a worker of its kind is free, in the order posted */
+    void post (JobType type, std::string const& name,
+        std::function <void ()> f);
+
+    std::size_t workers () const
+    {
+        return apply_.limit;
+    }
+
+    std::size_t readers () const
+    {
+        return read_.limit;
+    }
+
+    std::size_t active () const;
+    std::size_t queued () const;
+
+private:
+    struct Work
+    {
+        JobType type;
+        std::string name;
+        std::function <void ()> f;
+    };
+
+    struct Lane
+    {
+        explicit Lane (std::size_t limit_)
+            : limit (std::max <std::size_t> (limit_, 1))
+        {
+        }
+
+        std::size_t const limit;
+        std::deque <Work> queue;
+        std::size_t active = 0;
+    };
+
+    Lane& lane (JobType type);
+    void launch (Lane& lane, Work work);
+    void finished (Lane& lane);
+
+private:
+    JobQueue&                                   jobQueue_;
+
+    mutable std::mutex                          mutex_;
+    Lane                                        apply_;
+    Lane                                        read_;
+};
+
+}
+#endif
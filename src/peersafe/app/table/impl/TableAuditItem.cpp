@@ -52,9 +52,8 @@ std::pair<bool, std::string> TableAuditItem::SetAuditPara(std::string sPath, con
 {	    
     aCheckID_ = std::move(idArray);
     aCheckField_ = std::move(fieldArray);
-    ConstructCheckJson();
 
-    return SetAuditPara("", sPath);
+    return SetAuditPara(ConstructCheckRaw(), sPath);
 }
 
 bool TableAuditItem::checkSqlValid(std::string sSql)
@@ -89,12 +88,23 @@ std::pair<bool, std::string> TableAuditItem::SetAuditPara(std::string sSql, std:
     sNickName_ = to_string(uNewTableNameInDB_);
     std::string sRealTableName = "t_" + sNickName_;
 
-    if (!checkSqlValid(sSql))
+    // Raw in json,`[[fields],{conditions}...]`,or sql
+    auto iFirst = sSql.find_first_not_of(" \t\r\n");
+    if (iFirst != std::string::npos && sSql[iFirst] == '[')
     {
-        return std::make_pair(false, "sql error , or table name is different form  the one in first para.");
+        auto retRaw = SetCheckRaw(sSql);
+        if (!retRaw.first)
+            return retRaw;
     }
+    else
+    {
+        if (!checkSqlValid(sSql))
+        {
+            return std::make_pair(false, "sql error , or table name is different form  the one in first para.");
+        }
 
-    sCheckSQL_ = sSql.replace(sSql.find(sTableName_), sTableName_.length(), sRealTableName);
+        sCheckSQL_ = sSql.replace(sSql.find(sTableName_), sTableName_.length(), sRealTableName);
+    }
 
     fs::path sFullPath(sDumpPath_);
     auto filePath = sFullPath.parent_path();
@@ -117,6 +127,8 @@ std::pair<bool, std::string> TableAuditItem::SetAuditPara(std::string sSql, std:
         std::string sWrite = "[\n]\n";
         fwrite(sWrite.c_str(), 1, sWrite.size(), fDump);
         fclose(fDump);
+        lTxEndPos_ = 1;
+        bEmptyTx_ = true;
     }
 
     SetPara("", 0, uint256(0), 0, uint256(0), uint256(0));
@@ -124,18 +136,14 @@ std::pair<bool, std::string> TableAuditItem::SetAuditPara(std::string sSql, std:
     return std::make_pair(true, sNickName_);
 }
 
-void TableAuditItem::ConstructCheckJson()
+std::string TableAuditItem::ConstructCheckRaw()
 {
-    Json::Value aField, aIn, conditionJson,tableJson,rawJson;
+    Json::Value aField, aIn, conditionJson, rawJson;
     for (const auto &fieldItem : aCheckField_)
     {
         aField.append(fieldItem);
     }
 
-    tableJson[jss::Table][jss::TableName] = to_string(uNewTableNameInDB_);
-    tableJson[jss::Table][jss::NameInDB] = to_string(uNewTableNameInDB_);
-    jsonCheck_[jss::Tables].append(tableJson);
-
     rawJson.append(aField);
 
     if (aCheckID_.size() > 1)
@@ -156,11 +164,65 @@ void TableAuditItem::ConstructCheckJson()
     }
     rawJson.append(conditionJson);
 
-    jsonCheck_[jss::Raw] = rawJson.toStyledString();
+    return rawJson.toStyledString();
 }
+
+std::pair<bool, std::string> TableAuditItem::SetCheckRaw(std::string sRaw)
+{
+    Json::Value rawJson;
+    if (!Json::Reader().parse(sRaw, rawJson) || !rawJson.isArray() ||
+        rawJson.size() == 0 || !rawJson[0u].isArray())
+    {
+        return std::make_pair(false, "Raw has a wrong format ,first element must be an array of fields.");
+    }
+
+    Json::Value tableJson;
+    tableJson[jss::Table][jss::TableName] = to_string(uNewTableNameInDB_);
+    tableJson[jss::Table][jss::NameInDB] = to_string(uNewTableNameInDB_);
+    jsonCheck_[jss::Tables].append(tableJson);
+    jsonCheck_[jss::Raw] = sRaw;
+
+    // inserted rows are matched against the conditions in memory,
+    // conditions which can't be compiled ($limit,$order...) are always queried
+    Json::Value conditions(Json::arrayValue);
+    for (Json::UInt idx = 1; idx < rawJson.size(); idx++)
+        conditions.append(rawJson[idx]);
+    if (conditions.size() > 0)
+    {
+        auto pPredicate = std::make_unique<SQLPredicate>();
+        if (SQLPredicate::compile(conditions, *pPredicate).first == 0)
+            pCheckPredicate_ = std::move(pPredicate);
+    }
+
+    return std::make_pair(true, "");
+}
+
+// false if `tx` leaves the rows matching the audit conditions as they were
+bool TableAuditItem::mayChangeResult(const STTx& tx)
+{
+    auto op_type = (TableOpType)tx.getFieldU16(sfOpType);
+    if (isNotNeedDisposeType(op_type) || op_type == T_ASSERT)
+        return false;
+    if (op_type != R_INSERT || !pCheckPredicate_)
+        return true;
+
+    auto const pRaw = tx.getRawJson();
+    if (!pRaw || !pRaw->isArray())
+        return true;
+    Json::Value const& rows = *pRaw;
+    for (Json::UInt idx = 0; idx < rows.size(); idx++)
+    {
+        if (!rows[idx].isObject() ||
+            pCheckPredicate_->evaluate(rows[idx]) != SQLPredicate::False)
+            return true;
+    }
+    return false;
+}
+
 bool TableAuditItem::isTxNeededOutput(const STTx& tx, std::vector<STTx>& vecTxs)
 {
-    //Json::Value  jsonRet1 = getTxStore().txHistory(jsonCheck_);
+    // nothing to compare with before the first query
+    bool bMayChange = jsonLashResult_.isNull();
     for (auto& txItem : vecTxs)
     {
         STArray &tablesTx = txItem.peekFieldArray(sfTables);
@@ -182,9 +244,17 @@ bool TableAuditItem::isTxNeededOutput(const STTx& tx, std::vector<STTx>& vecTxs)
                 JLOG(journal_.trace()) << "table " << sTableName_ << "Dispose error";                
         }
         tableItem.setFieldH160(sfNameInDB, uNameInDBOld);
+        if (!bMayChange)
+            bMayChange = mayChangeResult(txItem);
+    }
+    if (!bMayChange)
+    {
+        JLOG(journal_.trace()) << "table " << sTableName_ << " audited rows unchanged";
+        return false;
     }
-    //Json::Value  jsonRet = getTxStore().txHistory(jsonCheck_);    
-    Json::Value  jsonRet = getTxStore().txHistory(sCheckSQL_);
+
+    Json::Value  jsonRet = sCheckSQL_.empty() ?
+        getTxStore().txHistory(jsonCheck_) : getTxStore().txHistory(sCheckSQL_);
     if (jsonLashResult_ != jsonRet)
     {
         jsonLashResult_ = jsonRet;
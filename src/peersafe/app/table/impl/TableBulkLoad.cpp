@@ -0,0 +1,281 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <peersafe/app/table/TableBulkLoad.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/format.hpp>
+#include <boost/optional.hpp>
+
+namespace ripple {
+
+TableBulkLoad::TableBulkLoad(DatabaseCon* dbconn, bool bSQLite, beast::Journal journal)
+    : databasecon_(dbconn)
+    , bSQLite_(bSQLite)
+    , bInit_(false)
+    , journal_(journal)
+{
+}
+
+bool TableBulkLoad::init()
+{
+    if (bInit_)
+        return true;
+    if (databasecon_ == nullptr)
+        return false;
+
+    bInit_ = execute(
+        "CREATE TABLE IF NOT EXISTS SyncBulkIndex ("
+        "TableNameInDB VARCHAR(64), "
+        "IndexName VARCHAR(128), "
+        "IndexSql TEXT)");
+    return bInit_;
+}
+
+bool TableBulkLoad::isLoading(std::string const& nameInDB)
+{
+    auto it = loading_.find(nameInDB);
+    if (it != loading_.end())
+        return it->second;
+    if (!init())
+        return false;
+
+    bool bLoading = false;
+    try
+    {
+        LockedSociSession sql_session = databasecon_->checkoutDb();
+        std::string sql = boost::str(boost::format(
+            "SELECT IndexName FROM SyncBulkIndex WHERE TableNameInDB = '%s'")
+            % nameInDB);
+
+        boost::optional<std::string> name;
+        soci::statement st = (sql_session->prepare << sql, soci::into(name));
+        st.execute();
+        bLoading = st.fetch();
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(journal_.error()) << "TableBulkLoad::isLoading exception " << e.what();
+        return false;
+    }
+
+    loading_[nameInDB] = bLoading;
+    return bLoading;
+}
+
+// The statements creating them again are built from the catalog, unique
+// keys and the primary key stay so failing rows still fail the same way.
+std::vector<TableBulkLoad::Index> TableBulkLoad::secondaryIndexes(std::string const& table)
+{
+    std::vector<Index> indexes;
+    LockedSociSession sql_session = databasecon_->checkoutDb();
+
+    boost::optional<std::string> name;
+    boost::optional<std::string> def;
+    if (bSQLite_)
+    {
+        std::string sql = boost::str(boost::format(
+            "SELECT name, sql FROM sqlite_master WHERE type = 'index' "
+            "AND tbl_name = '%s' AND sql IS NOT NULL")
+            % table);
+        soci::statement st = (sql_session->prepare << sql,
+            soci::into(name), soci::into(def));
+        st.execute();
+        while (st.fetch())
+        {
+            if (!name || !def || boost::istarts_with(*def, "CREATE UNIQUE"))
+                continue;
+            indexes.push_back({ *name, *def });
+        }
+        return indexes;
+    }
+
+    std::string sql = boost::str(boost::format(
+        "SELECT INDEX_NAME, CONCAT('`', COLUMN_NAME, '`', "
+        "IFNULL(CONCAT('(', SUB_PART, ')'), '')) "
+        "FROM information_schema.STATISTICS WHERE TABLE_SCHEMA = DATABASE() "
+        "AND TABLE_NAME = '%s' AND NON_UNIQUE = 1 "
+        "ORDER BY INDEX_NAME, SEQ_IN_INDEX")
+        % table);
+    soci::statement st = (sql_session->prepare << sql,
+        soci::into(name), soci::into(def));
+    st.execute();
+    while (st.fetch())
+    {
+        if (!name || !def)
+            continue;
+        if (indexes.empty() || indexes.back().name != *name)
+            indexes.push_back({ *name, "" });
+        auto& columns = indexes.back().sql;
+        if (!columns.empty())
+            columns += ",";
+        columns += *def;
+    }
+    for (auto& index : indexes)
+    {
+        index.sql = boost::str(boost::format("CREATE INDEX `%s` ON %s (%s)")
+            % index.name % table % index.sql);
+    }
+    return indexes;
+}
+
+void TableBulkLoad::dropIndexes(std::string const& nameInDB)
+{
+    if (nameInDB.empty() || !init() || isLoading(nameInDB))
+        return;
+
+    std::string const table = "t_" + nameInDB;
+    std::vector<Index> indexes;
+    try
+    {
+        indexes = secondaryIndexes(table);
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(journal_.error()) << "TableBulkLoad::dropIndexes " << table << " " << e.what();
+        return;
+    }
+
+    // Recorded before it is dropped, a record left without the drop only
+    // makes the restore fail on an index that is still there.
+    std::size_t dropped = 0;
+    for (auto const& index : indexes)
+    {
+        try
+        {
+            LockedSociSession sql_session = databasecon_->checkoutDb();
+            *sql_session << "INSERT INTO SyncBulkIndex (TableNameInDB, IndexName, IndexSql) "
+                "VALUES (:nameInDB, :name, :sql)",
+                soci::use(nameInDB), soci::use(index.name), soci::use(index.sql);
+        }
+        catch (std::exception const& e)
+        {
+            JLOG(journal_.error()) << "TableBulkLoad::dropIndexes " << e.what();
+            continue;
+        }
+
+        std::string drop = bSQLite_ ?
+            "DROP INDEX " + index.name :
+            "DROP INDEX `" + index.name + "` ON " + table;
+        if (execute(drop))
+        {
+            dropped++;
+            continue;
+        }
+        // e.g. needed by a foreign key on MySQL, the index is kept
+        execute(boost::str(boost::format(
+            "DELETE FROM SyncBulkIndex WHERE TableNameInDB = '%s' AND IndexName = '%s'")
+            % nameInDB % index.name));
+    }
+
+    loading_[nameInDB] = dropped > 0;
+    if (dropped > 0)
+    {
+        JLOG(journal_.info()) << "bulk load of " << table << ", dropped "
+            << dropped << " indexes";
+    }
+}
+
+std::size_t TableBulkLoad::restoreIndexes(std::string const& nameInDB)
+{
+    if (nameInDB.empty() || !isLoading(nameInDB))
+        return 0;
+
+    std::vector<Index> indexes;
+    try
+    {
+        LockedSociSession sql_session = databasecon_->checkoutDb();
+        std::string sql = boost::str(boost::format(
+            "SELECT IndexName, IndexSql FROM SyncBulkIndex WHERE TableNameInDB = '%s'")
+            % nameInDB);
+
+        boost::optional<std::string> name;
+        boost::optional<std::string> def;
+        soci::statement st = (sql_session->prepare << sql,
+            soci::into(name), soci::into(def));
+        st.execute();
+        while (st.fetch())
+        {
+            if (name && def)
+                indexes.push_back({ *name, *def });
+        }
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(journal_.error()) << "TableBulkLoad::restoreIndexes exception " << e.what();
+        return 0;
+    }
+
+    // A record is kept until its index exists again, the table stays
+    // loading and the next caught up ledger retries the ones that failed.
+    std::size_t restored = 0;
+    for (auto const& index : indexes)
+    {
+        if (!execute(index.sql))
+            continue;
+        restored++;
+        execute(boost::str(boost::format(
+            "DELETE FROM SyncBulkIndex WHERE TableNameInDB = '%s' AND IndexName = '%s'")
+            % nameInDB % index.name));
+    }
+
+    loading_[nameInDB] = restored < indexes.size();
+    if (restored < indexes.size())
+    {
+        JLOG(journal_.warn()) << "bulk load of t_" << nameInDB << " caught up, "
+            << indexes.size() - restored << " of " << indexes.size()
+            << " indexes failed to be restored";
+    }
+    else
+    {
+        JLOG(journal_.info()) << "bulk load of t_" << nameInDB << " caught up, restored "
+            << restored << " indexes";
+    }
+    return restored;
+}
+
+// Only the tables known to be loading have records, no DDL is run here
+// so it can be called inside a transaction.
+void TableBulkLoad::forget(std::string const& nameInDB)
+{
+    auto it = loading_.find(nameInDB);
+    if (it == loading_.end() || !it->second)
+        return;
+
+    execute(boost::str(boost::format(
+        "DELETE FROM SyncBulkIndex WHERE TableNameInDB = '%s'") % nameInDB));
+    loading_[nameInDB] = false;
+}
+
+bool TableBulkLoad::execute(std::string const& sql)
+{
+    try
+    {
+        LockedSociSession sql_session = databasecon_->checkoutDb();
+        *sql_session << sql;
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(journal_.warn()) << "TableBulkLoad: " << sql << " " << e.what();
+        return false;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,325 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <peersafe/app/table/TableDirectory.h>
+#include <ripple/ledger/View.h>
+#include <ripple/protocol/Feature.h>
+#include <ripple/protocol/Indexes.h>
+
+namespace ripple {
+
+template <class Array>
+static auto
+findTable (Array& aTableEntries, Blob const& tableName)
+    -> decltype (&*aTableEntries.begin ())
+{
+    for (auto& table : aTableEntries)
+    {
+        if (table.isFieldPresent (sfTableName) &&
+            table.getFieldVL (sfTableName) == tableName)
+            return &table;
+    }
+    return nullptr;
+}
+
+bool
+isTableDirectoryEnabled (ReadView const& view)
+{
+    return view.rules ().enabled (featureTableDirectory);
+}
+
+std::shared_ptr<STEntry const>
+readTableEntry (ReadView const& view, AccountID const& owner,
+    Blob const& tableName)
+{
+    if (isTableDirectoryEnabled (view))
+    {
+        auto const sle = view.read (keylet::tableEntry (owner, tableName));
+        if (sle)
+            return std::shared_ptr<STEntry const> (sle,
+                (STEntry const*)&sle->getFieldObject (sfTable));
+    }
+
+    auto const tablesle = view.read (keylet::table (owner));
+    if (! tablesle)
+        return nullptr;
+    auto const pEntry = findTable (
+        tablesle->getFieldArray (sfTableEntries), tableName);
+    if (! pEntry)
+        return nullptr;
+    return std::shared_ptr<STEntry const> (tablesle, (STEntry const*)pEntry);
+}
+
+std::shared_ptr<STEntry const>
+readTableEntry (ReadView const& view, AccountID const& owner,
+    std::string const& tableName)
+{
+    return readTableEntry (view, owner, Blob (tableName.begin (), tableName.end ()));
+}
+
+// Calls f(sle, entry) for every table of owner until it returns false,
+// sle is the ledger entry holding the table.
+template <class F>
+static void
+walkTables (ReadView const& view, AccountID const& owner, F&& f)
+{
+    auto const tablesle = view.read (keylet::table (owner));
+    if (! tablesle)
+        return;
+
+    for (auto const& table : tablesle->getFieldArray (sfTableEntries))
+    {
+        if (! f (tablesle, *(STEntry const*)&table))
+            return;
+    }
+
+    if (! isTableDirectoryEnabled (view))
+        return;
+
+    auto const root = keylet::tableDir (owner);
+    auto pos = root;
+    for (;;)
+    {
+        auto const page = view.read (pos);
+        if (! page)
+            return;
+        for (auto const& key : page->getFieldV256 (sfIndexes))
+        {
+            auto const sle = view.read (keylet::tableEntry (key));
+            if (sle && ! f (sle,
+                    *(STEntry const*)&sle->getFieldObject (sfTable)))
+                return;
+        }
+        auto const next = page->getFieldU64 (sfIndexNext);
+        if (! next)
+            return;
+        pos = keylet::page (root, next);
+    }
+}
+
+void
+forEachTableEntry (ReadView const& view, AccountID const& owner,
+    std::function<bool (STEntry const&)> const& f)
+{
+    walkTables (view, owner,
+        [&f](std::shared_ptr<SLE const> const&, STEntry const& entry)
+        {
+            return f (entry);
+        });
+}
+
+std::shared_ptr<STEntry const>
+findTableEntry (ReadView const& view, AccountID const& owner,
+    std::function<bool (STEntry const&)> const& pred)
+{
+    std::shared_ptr<STEntry const> found;
+    walkTables (view, owner,
+        [&](std::shared_ptr<SLE const> const& sle, STEntry const& entry)
+        {
+            if (! pred (entry))
+                return true;
+            found = std::shared_ptr<STEntry const> (sle, &entry);
+            return false;
+        });
+    return found;
+}
+
+std::size_t
+tableCount (ReadView const& view, AccountID const& owner)
+{
+    auto const tablesle = view.read (keylet::table (owner));
+    if (! tablesle)
+        return 0;
+    std::size_t count = tablesle->getFieldArray (sfTableEntries).size ();
+    if (tablesle->isFieldPresent (sfTableCount))
+        count += tablesle->getFieldU32 (sfTableCount);
+    return count;
+}
+
+TableSle
+peekTableEntry (ApplyView& view, AccountID const& owner,
+    Blob const& tableName)
+{
+    TableSle result;
+    if (isTableDirectoryEnabled (view))
+    {
+        result.sle = view.peek (keylet::tableEntry (owner, tableName));
+        if (result.sle)
+        {
+            result.entry = (STEntry*)&result.sle->peekFieldObject (sfTable);
+            return result;
+        }
+    }
+
+    result.sle = view.peek (keylet::table (owner));
+    if (result.sle)
+        result.entry = (STEntry*)findTable (
+            result.sle->peekFieldArray (sfTableEntries), tableName);
+    return result;
+}
+
+// create the ltTABLE of `entry` and link it from the directory of `owner`
+static TER
+createTableSle (ApplyView& view, AccountID const& owner, STObject const& entry)
+{
+    auto const k = keylet::tableEntry (owner, entry.getFieldVL (sfTableName));
+    if (view.exists (k))
+        return tefBAD_LEDGER;
+
+    auto const page = view.dirInsert (keylet::tableDir (owner), k,
+        describeOwnerDir (owner));
+    if (! page)
+        return tecDIR_FULL;
+
+    auto const sle = std::make_shared<SLE> (k);
+    sle->setAccountID (sfAccount, owner);
+    (*sle)[sfOwnerNode] = *page;
+    sle->setFieldObject (sfTable, entry);
+    view.insert (sle);
+    return tesSUCCESS;
+}
+
+static void
+adjustTableCount (ApplyView& view, std::shared_ptr<SLE> const& tablesle,
+    std::int32_t amount)
+{
+    std::int64_t count = 0;
+    if (tablesle->isFieldPresent (sfTableCount))
+        count = tablesle->getFieldU32 (sfTableCount);
+    tablesle->setFieldU32 (sfTableCount, static_cast<std::uint32_t> (
+        std::max<std::int64_t> (count + amount, 0)));
+    view.update (tablesle);
+}
+
+TER
+insertTableEntry (ApplyView& view, AccountID const& owner,
+    STObject const& entry)
+{
+    auto const tablesle = view.peek (keylet::table (owner));
+    if (! tablesle)
+        return tefINTERNAL;
+
+    if (! isTableDirectoryEnabled (view))
+    {
+        tablesle->peekFieldArray (sfTableEntries).push_back (entry);
+        view.update (tablesle);
+        return tesSUCCESS;
+    }
+
+    auto const ter = createTableSle (view, owner, entry);
+    if (ter != tesSUCCESS)
+        return ter;
+    adjustTableCount (view, tablesle, 1);
+    return tesSUCCESS;
+}
+
+TER
+eraseTableEntry (ApplyView& view, AccountID const& owner,
+    Blob const& tableName)
+{
+    auto const tablesle = view.peek (keylet::table (owner));
+    if (! tablesle)
+        return tefINTERNAL;
+
+    if (isTableDirectoryEnabled (view))
+    {
+        auto const sle = view.peek (keylet::tableEntry (owner, tableName));
+        if (sle)
+        {
+            if (! view.dirRemove (keylet::tableDir (owner),
+                    (*sle)[sfOwnerNode], sle->key (), false))
+                return tefBAD_LEDGER;
+            view.erase (sle);
+            adjustTableCount (view, tablesle, -1);
+            return tesSUCCESS;
+        }
+    }
+
+    auto& aTableEntries = tablesle->peekFieldArray (sfTableEntries);
+    auto iter = std::find_if (aTableEntries.begin (), aTableEntries.end (),
+        [&tableName](STObject const& item) {
+            if (! item.isFieldPresent (sfTableName))
+                return false;
+            return item.getFieldVL (sfTableName) == tableName;
+        });
+    if (iter == aTableEntries.end ())
+        return tefTABLE_NOTEXIST;
+    aTableEntries.erase (iter);
+    view.update (tablesle);
+    return tesSUCCESS;
+}
+
+TER
+renameTableEntry (ApplyView& view, AccountID const& owner,
+    Blob const& tableName, Blob const& newName)
+{
+    auto table = peekTableEntry (view, owner, tableName);
+    if (! table)
+        return tefTABLE_NOTEXIST;
+
+    if (table.sle->getType () != ltTABLE)
+    {
+        table.entry->setFieldVL (sfTableName, newName);
+        view.update (table.sle);
+        return tesSUCCESS;
+    }
+
+    // the key of a table is derived from its name, move it to the new key
+    STObject entry = *table.entry;
+    entry.setFieldVL (sfTableName, newName);
+    auto const ter = createTableSle (view, owner, entry);
+    if (ter != tesSUCCESS)
+        return ter;
+    if (! view.dirRemove (keylet::tableDir (owner),
+            (*table.sle)[sfOwnerNode], table.sle->key (), false))
+        return tefBAD_LEDGER;
+    view.erase (table.sle);
+    return tesSUCCESS;
+}
+
+TER
+migrateTableEntries (ApplyView& view, AccountID const& owner)
+{
+    if (! isTableDirectoryEnabled (view))
+        return tesSUCCESS;
+
+    auto const tablesle = view.peek (keylet::table (owner));
+    if (! tablesle)
+        return tesSUCCESS;
+
+    auto const& aTableEntries = tablesle->getFieldArray (sfTableEntries);
+    if (aTableEntries.empty ())
+        return tesSUCCESS;
+
+    for (auto const& table : aTableEntries)
+    {
+        auto const ter = createTableSle (view, owner, table);
+        if (ter != tesSUCCESS)
+            return ter;
+    }
+
+    auto const moved = static_cast<std::int32_t> (aTableEntries.size ());
+    tablesle->setFieldArray (sfTableEntries, STArray ());
+    adjustTableCount (view, tablesle, moved);
+    return tesSUCCESS;
+}
+
+} // ripple
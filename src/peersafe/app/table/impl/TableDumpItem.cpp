@@ -21,8 +21,15 @@
 #include <ripple/protocol/STTx.h>
 #include <ripple/json/json_reader.h>
 #include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/core/JobQueue.h>
 #include <peersafe/app/table/TableDumpItem.h>
+#include <peersafe/gmencrypt/hardencrypt/HardEncryptObj.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
 #include <fstream>
+#include <thread>
 #include <boost/filesystem.hpp>
 
 
@@ -31,6 +38,8 @@ namespace ripple {
 namespace fs = boost::filesystem;
 #define MAX_GAP_NOW2VALID   5
 #define BUFFER_FOR_POSINFO  1024
+#define MAX_DUMP_WORKERS    4
+#define MIN_TXS_PER_WORKER  32
 
 TableDumpItem::~TableDumpItem()
 {
@@ -45,6 +54,8 @@ TableDumpItem::TableDumpItem(Application& app, beast::Journal journal, Config& c
     sTxHashRecord_        = "";
     uLedgerSeqRecord_     = 0;
     sLedgerHashRecord_    = "";
+    lTxEndPos_            = -1;
+    bEmptyTx_             = false;
 }
 
 std::pair<int,int> TableDumpItem::GetRightTxEndPos(FILE * fp, bool &bEmptyTx)
@@ -82,6 +93,90 @@ std::pair<int,int> TableDumpItem::GetRightTxEndPos(FILE * fp, bool &bEmptyTx)
 
 	return std::make_pair(0, 0);
 }
+bool TableDumpItem::LocateTxEnd(FILE *fp, Json::Value *pPos)
+{
+    lTxEndPos_ = -1;
+    if (fp == NULL || fseek(fp, 0, SEEK_END) != 0)  return false;
+    long lFileSize = ftell(fp);
+
+    //the index is only trusted if nothing was written to the dump file behind it
+    Json::Value index;
+    std::ifstream fIndex(GetIndexPath());
+    if (fIndex && Json::Reader().parse(fIndex, index) && index.isObject() &&
+        index["FileSize"].asString() == std::to_string(lFileSize))
+    {
+        try
+        {
+            lTxEndPos_ = std::stol(index["TxEndPos"].asString());
+        }
+        catch (std::exception const&)
+        {
+            lTxEndPos_ = -1;
+        }
+        if (lTxEndPos_ > 0 && lTxEndPos_ < lFileSize)
+        {
+            bEmptyTx_ = index["EmptyTx"].asBool();
+            if (pPos)  Json::Reader().parse(index["Pos"].asString(), *pPos);
+            return true;
+        }
+        lTxEndPos_ = -1;
+    }
+
+    bool bEmptyTx = false;
+    auto posPair = GetRightTxEndPos(fp, bEmptyTx);
+    if (posPair.first >= 0)  return false;
+
+    lTxEndPos_ = lFileSize + posPair.first - posPair.second + 1;
+    bEmptyTx_ = bEmptyTx;
+
+    if (pPos && fseek(fp, posPair.first + posPair.second, SEEK_END) == 0)
+    {
+        char buf[BUFFER_FOR_POSINFO];
+        size_t result = fread(buf, 1, BUFFER_FOR_POSINFO, fp);
+        if (result > 0 && result < BUFFER_FOR_POSINFO)
+            Json::Reader().parse(std::string(buf, result), *pPos);
+    }
+    return true;
+}
+
+void TableDumpItem::SaveDumpIndex(FILE *fp, std::string const& sPos)
+{
+    if (lTxEndPos_ < 0 || fflush(fp) != 0 || fseek(fp, 0, SEEK_END) != 0)  return;
+
+    Json::Value index;
+    index["TxEndPos"] = std::to_string(lTxEndPos_);
+    index["EmptyTx"] = bEmptyTx_;
+    index["FileSize"] = std::to_string(ftell(fp));
+    index["Pos"] = sPos;
+
+    //replace the old index at once, a half written one would be taken as missing
+    std::string sTmpPath = GetIndexPath() + ".tmp";
+    {
+        std::ofstream fIndex(sTmpPath, std::ios::trunc);
+        fIndex << index.toStyledString();
+        if (!fIndex)  return;
+    }
+    boost::system::error_code ec;
+    fs::rename(sTmpPath, GetIndexPath(), ec);
+}
+
+bool TableDumpItem::WriteTxBody(FILE *fp, std::string const& sBody, bool bStop, std::string const& sMsg)
+{
+    if (lTxEndPos_ < 0 && !LocateTxEnd(fp))  return false;
+    if (fseek(fp, lTxEndPos_, SEEK_SET) != 0) return false;
+
+    std::string sPos = GetPosInfo(uTxSeqRecord_, sTxHashRecord_, uLedgerSeqRecord_, sLedgerHashRecord_, bStop, sMsg);
+    std::string sWrite = sBody + "\n]\n" + sPos;
+    if (fwrite(sWrite.c_str(), 1, sWrite.size(), fp) != sWrite.size())
+    {
+        lTxEndPos_ = -1;
+        return false;
+    }
+    lTxEndPos_ += sBody.size();
+    SaveDumpIndex(fp, sPos);
+    return true;
+}
+
 std::pair<bool, std::string> TableDumpItem::SetDumpPara(std::string sPath, funDumpCB funCB)
 {		
 	sDumpPath_ = sPath;
@@ -109,28 +204,10 @@ std::pair<bool, std::string> TableDumpItem::SetDumpPara(std::string sPath, funDu
 		return std::make_pair(false, "fail to open the file.");
 	}
 
-	char buf[BUFFER_FOR_POSINFO];
-	std::string sPosJson;
-	int fRet = 0;
-	bool bEmptyTx = false;
-	auto posPair = GetRightTxEndPos(fDump, bEmptyTx);
-
-	if (posPair.first < 0)
-	{
-		fRet = fseek(fDump, posPair.first + posPair.second, SEEK_END);
-        
-		if (fRet == 0)
-		{    
-			size_t result = fread(buf, 1, BUFFER_FOR_POSINFO, fDump);
-			if(result > 0 && result < BUFFER_FOR_POSINFO)
-				sPosJson = buf;
-		}
-	}	
-	
-	if (sPosJson.length() > 0)//before 1024,if encounter \n,then stop
+	Json::Value pos;
+	if (LocateTxEnd(fDump, &pos))
 	{
-		Json::Value pos;
-		if (Json::Reader().parse(sPosJson, pos) == true)
+		if (pos.isObject())
 		{
             //check first
             if (to_string(accountID_) != pos["Account"].asString())
@@ -160,6 +237,9 @@ std::pair<bool, std::string> TableDumpItem::SetDumpPara(std::string sPath, funDu
 	}
 	else
 	{		
+		fseek(fDump, 0, SEEK_END);
+		long lFileSize = ftell(fDump);
+
 		std::string sWrite = "[\n]\n";
 
 		std::string sPos = GetPosInfo(0, to_string(uint256(0)), 0, to_string(uint256(0)),false, "");
@@ -167,6 +247,10 @@ std::pair<bool, std::string> TableDumpItem::SetDumpPara(std::string sPath, funDu
 		sWrite = sWrite + sPos;
 		fwrite(sWrite.c_str(), 1, sWrite.size(), fDump);
 
+		lTxEndPos_ = lFileSize + 1;
+		bEmptyTx_ = true;
+		SaveDumpIndex(fDump, sPos);
+
 		SetPara("", 0, uint256(0), 0, uint256(0), uint256(0));
 	}
 	fclose(fDump);
@@ -176,12 +260,10 @@ std::pair<bool, std::string> TableDumpItem::SetDumpPara(std::string sPath, funDu
 
 Json::Value TableDumpItem::TransRaw2Json(const STTx & tx)
 {
-	Json::Value jsonRaw;
-	if (tx.isFieldPresent(sfRaw))
-	{		
-		Json::Reader().parse(strCopy(tx.getFieldVL(sfRaw)), jsonRaw);
-	}
-	return jsonRaw;
+	auto const pRaw = tx.getRawJson();
+	if (pRaw)
+		return *pRaw;
+	return Json::Value();
 }
 bool TableDumpItem::UnHexTableName(Json::Value &jsonTx)
 {
@@ -232,7 +314,103 @@ std::string TableDumpItem::ConstructTxStr(std::vector<STTx> &vecTxs, const STTx
 	return "";
 }
 
-bool TableDumpItem::DealWithEveryLedgerData(const std::vector<protocol::TMTableData> &aData)
+void TableDumpItem::PrepareTxs(const std::vector<DecodedLedger> &aData, std::vector<std::vector<DumpTx>> &aTxs)
+{
+    std::vector<std::pair<std::size_t, int>> aNodes;
+    aTxs.resize(aData.size());
+    for (std::size_t i = 0; i < aData.size(); i++)
+    {
+        aTxs[i].resize(aData[i].data.txnodes().size());
+        for (int j = 0; j < aData[i].data.txnodes().size(); j++)
+            aNodes.emplace_back(i, j);
+    }
+
+    auto prepare = [&](std::pair<std::size_t, int> const& node)
+    {
+        auto const& str = aData[node.first].data.txnodes().Get(node.second).nodedata();
+        DumpTx &dumpTx = aTxs[node.first][node.second];
+
+        dumpTx.pTx = std::make_shared<STTx>(SerialIter{ str.data(), str.size() });
+        dumpTx.vecTxs = STTx::getTxs(*dumpTx.pTx, sTableNameInDB_);
+        TryDecryptRaw(dumpTx.vecTxs);
+        dumpTx.sTx = ConstructTxStr(dumpTx.vecTxs, *dumpTx.pTx);
+        while (!dumpTx.sTx.empty() && (dumpTx.sTx.back() == '\n' || dumpTx.sTx.back() == '\r'))
+            dumpTx.sTx.pop_back();
+    };
+
+    //a hardware encrypt device is not known to be safe to share between threads
+    std::size_t workers = 1;
+    if (HardEncryptObj::getInstance() == nullptr)
+    {
+        workers = std::min<std::size_t>(std::thread::hardware_concurrency(), MAX_DUMP_WORKERS);
+        workers = std::min<std::size_t>(workers, aNodes.size() / MIN_TXS_PER_WORKER);
+    }
+    if (workers <= 1)
+    {
+        for (auto const& node : aNodes)
+            prepare(node);
+        return;
+    }
+
+    // The helpers are jobs, the calling thread works as well. A job that
+    // starts after the batch is done returns without touching it, so only
+    // jobs already working are waited for.
+    struct Batch
+    {
+        std::atomic<std::size_t> next{ 0 };
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::size_t running = 0;
+        bool done = false;
+        std::exception_ptr error;
+    };
+    auto batch = std::make_shared<Batch>();
+
+    auto work = [batch, &aNodes, &prepare]()
+    {
+        try
+        {
+            for (std::size_t i = batch->next++; i < aNodes.size(); i = batch->next++)
+                prepare(aNodes[i]);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(batch->mutex);
+            if (!batch->error)  batch->error = std::current_exception();
+            batch->next = aNodes.size();
+        }
+    };
+
+    for (std::size_t i = 1; i < workers; i++)
+    {
+        app_.getJobQueue().addJob(jtTABLEDUMP, "tableDump", [batch, work](Job&)
+        {
+            {
+                std::lock_guard<std::mutex> lock(batch->mutex);
+                if (batch->done)    return;
+                ++batch->running;
+            }
+            work();
+            std::lock_guard<std::mutex> lock(batch->mutex);
+            if (--batch->running == 0)
+                batch->cv.notify_all();
+        });
+    }
+    work();
+
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->done = true;
+    batch->cv.wait(lock, [&batch]() { return batch->running == 0; });
+    if (batch->error)  std::rethrow_exception(batch->error);
+}
+
+// The txs are deserialized along with their output in PrepareTxs.
+void TableDumpItem::DecodeLedger(DecodedLedger &ledger)
+{
+    ledger.bDecoded = true;
+}
+
+bool TableDumpItem::DealWithEveryLedgerData(std::vector<DecodedLedger> &aData)
 {
     std::lock_guard<std::mutex> lock(mutexFileOperate_);
 
@@ -245,93 +423,68 @@ bool TableDumpItem::DealWithEveryLedgerData(const std::vector<protocol::TMTableD
 		SetSyncState(SYNC_STOP);
         return false;
     }
+
+    if (lTxEndPos_ < 0 && !LocateTxEnd(fp))
+    {
+        StopInnerDeal(fp, "");
+        fclose(fp);
+        return false;
+    }
+
+    //the txs are serialized ahead, output decisions are still made in ledger order
+    std::vector<std::vector<DumpTx>> aTxs;
+    PrepareTxs(aData, aTxs);
+
 	LedgerIndex uCurSynPos = 0;
-		
-	
-    for (std::vector<protocol::TMTableData>::const_iterator iter = aData.begin(); iter != aData.end(); ++iter)
-    {     
-		uCurSynPos = iter->ledgerseq();
-
-        std::string sLedgerHash = iter->ledgerhash();
-        std::string sLedgerCheckHash = iter->ledgercheckhash();
-        LedgerIndex uLedgerSeq = iter->ledgerseq();
-        std::string PreviousCommit;
-        
-		int fRet = 0;
-		bool bEmptyTx = false;
-		auto posPair = GetRightTxEndPos(fp, bEmptyTx);
-		if (posPair.first == 0)
-		{            
-            StopInnerDeal(fp, "");
-            fclose(fp);
-			return false;
-		}
+    std::string sBody;
 
-		std::string sWrite = "";
-        //should fseek to file last 
-		fRet = fseek(fp, posPair.first - posPair.second + 1, SEEK_END);
-        if (fRet < 0)
-        {            
-            StopInnerDeal(fp, "");
-            fclose(fp);
-            return false;
-        }
+    for (std::size_t i = 0; i < aData.size(); i++)
+    {     
+        const protocol::TMTableData &data = aData[i].data;
+		uCurSynPos = data.ledgerseq();
 
         //check for jump one seq, check for deadline time and deadline seq
-        CheckConditionState  checkRet = CondFilter(iter->closetime(), iter->ledgerseq(), uint256(0));
+        CheckConditionState  checkRet = CondFilter(data.closetime(), data.ledgerseq(), uint256(0));
         if (checkRet == CHECK_REJECT && GetSyncState() != SYNC_STOP)
         {
+            WriteTxBody(fp, sBody, false, "");
             StopInnerDeal(fp, "catch the condition point.");
             fclose(fp);
             return false;
         }
 
-        if (iter->txnodes().size() > 0)
+        if (data.txnodes().size() > 0)
         {			
-            for (int i = 0; i < iter->txnodes().size(); i++)
+            for (auto &dumpTx : aTxs[i])
             {
-                const protocol::TMLedgerNode &node = iter->txnodes().Get(i);
-
-                auto str = node.nodedata();
-                Blob blob;
-                blob.assign(str.begin(), str.end());
-                STTx tx = std::move((STTx)(SerialIter{ blob.data(), blob.size() }));
-
-				auto vecTxs = STTx::getTxs(tx, sTableNameInDB_);
-                TryDecryptRaw(vecTxs);
-                bool bOutPut = isTxNeededOutput(tx, vecTxs);
+                bool bOutPut = isTxNeededOutput(*dumpTx.pTx, dumpTx.vecTxs);
 
                 //CAUTION, the following code should behidnd the fun isTxNeededOutput
                 //check for jump one tx.
-                if (!isJumpThisTx(tx.getTransactionID()) && checkRet != CHECK_JUMP && bOutPut)
+                if (!isJumpThisTx(dumpTx.pTx->getTransactionID()) && checkRet != CHECK_JUMP && bOutPut)
                 {
-                    std::string sTx = ConstructTxStr(vecTxs, tx);
-
-                    if (bEmptyTx) sWrite += "\n";
-                    else          sWrite += ",\n";
+                    if (bEmptyTx_) sBody += "\n";
+                    else           sBody += ",\n";
 
-                    bEmptyTx = false;
-                    sWrite += sTx;
+                    bEmptyTx_ = false;
+                    sBody += dumpTx.sTx;
                 }
 			}
-			sWrite += "]\n";
-            uTxSeqRecord_ = uLedgerSeq;
-            sTxHashRecord_ = sLedgerCheckHash;
+            uTxSeqRecord_ = data.ledgerseq();
+            sTxHashRecord_ = data.ledgercheckhash();
         }
-		else
-		{
-			sWrite += "\n]\n";
-		}		
-        uLedgerSeqRecord_ = uLedgerSeq;
-        sLedgerHashRecord_ = sLedgerHash;
-		//update the pos info		
-        std::string sPos = GetPosInfo(uTxSeqRecord_, sTxHashRecord_, uLedgerSeqRecord_, sLedgerHashRecord_, false, "");		
-
-		sWrite += sPos;
-		fwrite(sWrite.c_str(), 1, sWrite.size(), fp);
-
+        uLedgerSeqRecord_ = data.ledgerseq();
+        sLedgerHashRecord_ = data.ledgerhash();
     }         
 
+    //one write for the whole batch, the pos info follows the last ledger
+    if (!WriteTxBody(fp, sBody, false, ""))
+    {
+        StopInnerDeal(fp, "");
+        fclose(fp);
+        return false;
+    }
+
 	//stop the dump task
 	auto validIndex = app_.getLedgerMaster().getValidLedgerIndex();
 	if (validIndex - uCurSynPos < MAX_GAP_NOW2VALID && GetSyncState() != SYNC_STOP)
@@ -365,28 +518,10 @@ void TableDumpItem::SetStopInfo(FILE *fileTarget, std::string sMsg)
         }
     }
 
-    std::string sWrite = "";
-
-    bool bEmptyTx = false;
-    auto posPair = TableDumpItem::GetRightTxEndPos(fp, bEmptyTx);
-    if (posPair.first == 0)
-    {
-        return SetErroeInfo2FileEnd(fp);
-    }
-
-
-    //should fseek to file last 
-    int fRet = fseek(fp, posPair.first + posPair.second, SEEK_END);
-    if (fRet < 0)
+    if (!WriteTxBody(fp, "", true, sMsg))
     {
-        return SetErroeInfo2FileEnd(fp);
-
+        SetErroeInfo2FileEnd(fp);
     }
-    //sWrite += "\n";
-    std::string sPos = GetPosInfo(uTxSeqRecord_, sTxHashRecord_, uLedgerSeqRecord_, sLedgerHashRecord_, true, sMsg);
-    sWrite += sPos;
-
-    fwrite(sWrite.c_str(), 1, sWrite.size(), fp);
     if(fileTarget == NULL)       fclose(fp);
 }
 
@@ -402,7 +537,6 @@ void TableDumpItem::SetErroeInfo2FileEnd(FILE *fileTarget)
     sWrite += sError;
 
     fwrite(sWrite.c_str(), 1, sWrite.size(), fp);
-    fclose(fp);
     return;
 }
 
@@ -0,0 +1,140 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <peersafe/app/table/TableEntryCache.h>
+#include <peersafe/app/table/TableDirectory.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/LedgerFormats.h>
+
+namespace ripple {
+
+TableEntryCache::TableEntryCache (std::size_t maxSize)
+    : maxSize_ (maxSize)
+{
+}
+
+std::shared_ptr<STEntry const>
+TableEntryCache::fetch (ReadView const& ledger, AccountID const& owner,
+    std::string const& tableName)
+{
+    auto const seq = ledger.info ().seq;
+    Key key (owner, tableName);
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        if (seq == seq_)
+        {
+            auto const it = items_.find (key);
+            if (it != items_.end ())
+            {
+                ++hits_;
+                return it->second.entry;
+            }
+        }
+    }
+
+    ++misses_;
+    Blob const name (tableName.begin (), tableName.end ());
+    auto entry = readTableEntry (ledger, owner, name);
+    if (! entry)
+        return entry;
+
+    // the ledger entry which changes when this table changes
+    auto const tableKey = keylet::tableEntry (owner, name);
+    auto const source = isTableDirectoryEnabled (ledger) &&
+        ledger.exists (tableKey) ? tableKey.key : keylet::table (owner).key;
+
+    std::lock_guard<std::mutex> lock (mutex_);
+    // a newer ledger may have been validated while reading
+    if (seq == seq_)
+    {
+        if (items_.size () >= maxSize_)
+            items_.erase (items_.begin ());
+        items_[std::move (key)] = Item{ entry, source };
+    }
+    return entry;
+}
+
+void
+TableEntryCache::onValidatedLedger (ReadView const& ledger)
+{
+    auto const seq = ledger.info ().seq;
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        if (seq != seq_ + 1)
+        {
+            invalidated_ += items_.size ();
+            items_.clear ();
+        }
+        if (items_.empty ())
+        {
+            seq_ = seq;
+            return;
+        }
+    }
+
+    hash_set<uint256> modified;
+    for (auto const& item : ledger.txs)
+    {
+        if (! item.second)
+            continue;
+        for (auto const& node : item.second->getFieldArray (sfAffectedNodes))
+        {
+            auto const type = node.getFieldU16 (sfLedgerEntryType);
+            if (type == ltTABLE || type == ltTABLELIST)
+                modified.insert (node.getFieldH256 (sfLedgerIndex));
+        }
+    }
+
+    std::lock_guard<std::mutex> lock (mutex_);
+    if (! modified.empty ())
+    {
+        for (auto it = items_.begin (); it != items_.end ();)
+        {
+            if (modified.count (it->second.source))
+            {
+                it = items_.erase (it);
+                ++invalidated_;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+    seq_ = seq;
+}
+
+void
+TableEntryCache::clear ()
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    items_.clear ();
+    seq_ = 0;
+}
+
+std::size_t
+TableEntryCache::size () const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    return items_.size ();
+}
+
+} // ripple
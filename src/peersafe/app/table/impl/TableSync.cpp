@@ -24,12 +24,14 @@
 #include <boost/optional/optional_io.hpp>
 #include <ripple/core/DatabaseCon.h>
 #include <ripple/json/json_reader.h>
+#include <ripple/protocol/JsonFields.h>
 #include <peersafe/protocol/STEntry.h>
 #include <peersafe/app/table/TableSync.h>
 #include <peersafe/app/table/TableStatusDB.h>
 #include <peersafe/app/sql/TxStore.h>
 #include <peersafe/protocol/TableDefines.h>
 #include <peersafe/app/util/TableSyncUtil.h>
+#include <peersafe/app/table/TableDirectory.h>
 
 namespace ripple {
 TableSync::TableSync(Application& app, Config& cfg, beast::Journal journal)
@@ -66,6 +68,12 @@ TableSync::TableSync(Application& app, Config& cfg, beast::Journal journal)
 	}
 	else
 		bPressSwitchOn_ = false;
+
+    std::size_t workers = 4;
+    std::size_t readers = 2;
+    get_if_exists(cfg_.section(ConfigSection::syncTables()), "workers", workers);
+    get_if_exists(cfg_.section(ConfigSection::syncTables()), "read_workers", readers);
+    workers_ = std::make_unique<TableSyncWorkers>(app_.getJobQueue(), workers, readers);
 }
 
 TableSync::~TableSync()
@@ -77,25 +85,16 @@ void TableSync::GetTxRecordInfo(LedgerIndex iCurSeq, AccountID accountID, std::s
     auto ledger = app_.getLedgerMaster().getLedgerBySeq(iCurSeq);
     if (ledger == NULL)  return;
 
-    auto key = keylet::table(accountID);
-
-    auto const tablesle = ledger->read(key);
-    if (!tablesle)                 return;
-
-    const STArray & aTables = tablesle->getFieldArray(sfTableEntries);
-    if (aTables.size() <= 0)       return ;
-
-    auto iter(aTables.end());
-    iter = std::find_if(aTables.begin(), aTables.end(),
-        [iLastSeq, accountID, sTableName](STObject const &item) {
+    auto const pEntry = findTableEntry(*ledger, accountID,
+        [&sTableName](STEntry const &item) {
         uint160 uTxDBName = item.getFieldH160(sfNameInDB);
         auto sTxDBName = to_string(uTxDBName);
         return sTxDBName == sTableName;
     });
-    if (iter == aTables.end())     return;
+    if (pEntry == nullptr)         return;
 
-    iLastSeq = iter->getFieldU32(sfTxnLgrSeq);
-    hash = iter->getFieldH256(sfTxnLedgerHash);
+    iLastSeq = pEntry->getFieldU32(sfTxnLgrSeq);
+    hash = pEntry->getFieldH256(sfTxnLedgerHash);
 }
 
 std::vector <uint256> TableSync::getTxsFromDb(uint32 TxnLgrSeq, std::string /*sAccountID*/)
@@ -158,35 +157,9 @@ bool TableSync::MakeTableDataReply(std::string sAccountID, bool bStop, uint32_t
             //std::shared_ptr<STTx> pSTTX = std::make_shared<STTx>(SerialIter{ blob.data(), blob.size() });
 
             STTx stTx(SerialIter{ blob.data(), blob.size() });
-            if (!stTx.isChainSqlBaseType())  continue;
-
-            if (stTx.getTxnType() == ttSQLTRANSACTION) {
-                Blob txs_blob = stTx.getFieldVL(sfStatements);
-                std::string txs_str;
-
-                txs_str.assign(txs_blob.begin(), txs_blob.end());
-                Json::Value objs;
-                Json::Reader().parse(txs_str, objs);
-
-				bool bFound = false;
-                for (auto obj : objs)
-                {
-                    auto const & sTxTable = obj["Tables"][0u]["Table"];
-                    if (sNameInDB == sTxTable["NameInDB"].asString())
-                    {
-						bFound = true;
-						break;
-                    }
-                }
-				if (!bFound) continue;;
-            }
-            else {
-                auto const & sTxTables = stTx.getFieldArray(sfTables);
-                if (sNameInDB != to_string(sTxTables[0].getFieldH160(sfNameInDB)))
-                {
-                    continue;
-                }
-            }
+            auto const names = TableSyncUtil::GetTxTableNames(stTx);
+            if (std::find(names.begin(), names.end(), sNameInDB) == names.end())
+                continue;
 
             protocol::TMLedgerNode* node = m.add_txnodes();
             node->set_nodedata(blob.data(),
@@ -280,13 +253,13 @@ void TableSync::SeekTableTxLedger(TableSyncItem::BaseInfo &stItemInfo)
     auto lashTxChecHash = stItemInfo.uTxHash;
 
     auto  lastTxChangeIndex = stItemInfo.uTxSeq;
-    auto key = keylet::table(stItemInfo.accountID);
 
     auto blockCheckIndex = stItemInfo.u32SeqLedger;
     bool bSendEnd = false;
     LedgerIndex curLedgerIndex = 0;
     uint256 curLedgerHash;
     uint32 time = 0;
+    bool bUseIndex = true;
 
     for (int i = stItemInfo.u32SeqLedger + 1; i <= app_.getLedgerMaster().getPublishedLedger()->info().seq; i++)
     {
@@ -298,6 +271,41 @@ void TableSync::SeekTableTxLedger(TableSyncItem::BaseInfo &stItemInfo)
             break;
         }
 
+        //jump to the ledger before the next tx of the table
+        if (bUseIndex)
+        {
+            auto next = TableSyncUtil::NextTableTxLedger(app_, stItemInfo.sTableNameInDB, i, app_.getLedgerMaster().getPublishedLedger()->info().seq);
+            if (!next)
+                bUseIndex = false;
+            else if (*next > i)
+            {
+                LedgerIndex uStopIndex = *next - 1;
+                auto ledger = app_.getLedgerMaster().getLedgerBySeq(uStopIndex);
+                auto retPair = ledger ?
+                    TableSyncUtil::IsTableSLEChanged(*ledger, lastTxChangeIndex, stItemInfo.accountID, stItemInfo.sTableNameInDB, false) :
+                    std::make_pair(false, std::shared_ptr<STEntry const>());
+                if (retPair.second == NULL && retPair.first)
+                {
+                    time = ledger->info().closeTime.time_since_epoch().count();
+                    i = uStopIndex;
+
+                    std::shared_ptr <protocol::TMTableData> pData = std::make_shared<protocol::TMTableData>();
+                    MakeSeekEndReply(uStopIndex, ledger->info().hash, lastLedgerSeq, lastLedgerHash, lashTxChecHash, to_string(stItemInfo.accountID), stItemInfo.sTableNameInDB, stItemInfo.sNickName, time, pItem->TargetType(), *pData);
+                    SendData(pItem, pData);
+
+                    lastLedgerSeq = i;
+                    lastLedgerHash = ledger->info().hash;
+
+                    bSendEnd = true;
+                    JLOG(journal_.debug()) << "in local seekLedger, no tx of the table in index up to ledger : " << uStopIndex
+                        << " nameInDB : " << stItemInfo.sTableNameInDB;
+                    continue;
+                }
+                //index and ledger disagree, seek ledger by ledger
+                bUseIndex = false;
+            }
+        }
+
         //check the 256th first , if no ,continue
         if (i > blockCheckIndex)
         {
@@ -307,17 +315,7 @@ void TableSync::SeekTableTxLedger(TableSyncItem::BaseInfo &stItemInfo)
                 auto ledger = app_.getLedgerMaster().getLedgerBySeq(uStopIndex);
 				if (ledger)
 				{
-					std::pair<bool, STEntry*> retPair;
-
-					auto tablesle = ledger->read(key);
-					if (tablesle)
-					{
-						auto & aTables = tablesle->getFieldArray(sfTableEntries);
-						if (aTables.size() > 0)
-						{
-							retPair = TableSyncUtil::IsTableSLEChanged(aTables, lastTxChangeIndex, stItemInfo.accountID, stItemInfo.sTableNameInDB, false);
-						}
-					}
+					auto retPair = TableSyncUtil::IsTableSLEChanged(*ledger, lastTxChangeIndex, stItemInfo.accountID, stItemInfo.sTableNameInDB, false);
 					time = ledger->info().closeTime.time_since_epoch().count();
 
 					if (retPair.second == NULL && retPair.first)
@@ -357,18 +355,7 @@ void TableSync::SeekTableTxLedger(TableSyncItem::BaseInfo &stItemInfo)
         }
 
 		time = ledger->info().closeTime.time_since_epoch().count();
-		std::pair<bool, STEntry*> retPair;
-       
-        auto tablesle = ledger->read(key);
-       
-        if (tablesle)
-        {
-            auto & aTables = tablesle->getFieldArray(sfTableEntries);
-            if (aTables.size() > 0)
-            {
-				retPair = TableSyncUtil::IsTableSLEChanged(aTables, lastTxChangeIndex, stItemInfo.accountID, stItemInfo.sTableNameInDB, true);
-            }
-        }
+		auto retPair = TableSyncUtil::IsTableSLEChanged(*ledger, lastTxChangeIndex, stItemInfo.accountID, stItemInfo.sTableNameInDB, true);
 
         if (retPair.second != NULL || !retPair.first)
         {
@@ -378,7 +365,7 @@ void TableSync::SeekTableTxLedger(TableSyncItem::BaseInfo &stItemInfo)
 			bool bRet = false;
 			if (retPair.second != NULL)
 			{
-				STEntry* pEntry = retPair.second;
+				auto const& pEntry = retPair.second;
 				auto TxnLgrSeq = pEntry->getFieldU32(sfTxnLgrSeq);
 				auto TxnLgrHash = pEntry->getFieldH256(sfTxnLedgerHash);
 				auto PreviousTxnLgrSeq = pEntry->getFieldU32(sfPreviousTxnLgrSeq);
@@ -477,21 +464,10 @@ void TableSync::SeekTableTxLedger(std::shared_ptr <protocol::TMGetTable> const&
     LedgerIndex iBlockEnd = getCandidateLedger(checkIndex);
     if (stopIndex == 0) stopIndex = iBlockEnd;
 
-    auto key = keylet::table(ownerID);
-
     if (app_.getLedgerMaster().haveLedger(checkIndex, stopIndex))
     {
         auto ledger = app_.getLedgerMaster().getLedgerBySeq(stopIndex);        
-		std::pair<bool, STEntry*> retPair;
-        auto tablesle = ledger->read(key);
-        if (tablesle)
-        {
-            auto & aTables = tablesle->getFieldArray(sfTableEntries);
-            if (aTables.size() > 0)
-            {
-				retPair = TableSyncUtil::IsTableSLEChanged(aTables, lastTxChangeIndex, ownerID, m->tablename(), false);
-            }
-        }
+		auto retPair = TableSyncUtil::IsTableSLEChanged(*ledger, lastTxChangeIndex, ownerID, m->tablename(), false);
         
         if (retPair.second == NULL && retPair.first)
         {
@@ -501,22 +477,35 @@ void TableSync::SeekTableTxLedger(std::shared_ptr <protocol::TMGetTable> const&
         }
     }
         
+    bool bUseIndex = true;
     for (LedgerIndex i = checkIndex; i <= stopIndex; i++)
     {
-        auto ledger = app_.getLedgerMaster().getLedgerBySeq(i);
-        if (!ledger)   break;
-
-		std::pair<bool, STEntry*> retPair;
-        auto tablesle = ledger->read(key);
-        if (tablesle)
+        //jump to the next tx of the table, not past the end of this reply
+        if (bUseIndex)
         {
-            auto & aTables = tablesle->getFieldArray(sfTableEntries);
-            if (aTables.size() > 0)
+            LedgerIndex uEnd = iBlockEnd >= i ? std::min(iBlockEnd, stopIndex) : stopIndex;
+            auto next = TableSyncUtil::NextTableTxLedger(app_, m->tablename(), i, uEnd);
+            LedgerIndex uJump = next ? std::min(*next, uEnd) : i;
+            if (!next)
+                bUseIndex = false;
+            else if (uJump > i)
             {
-				retPair = TableSyncUtil::IsTableSLEChanged(aTables, lastTxChangeIndex, ownerID, m->tablename(), true);
+                auto prev = app_.getLedgerMaster().getLedgerBySeq(uJump - 1);
+                auto retPair = prev ?
+                    TableSyncUtil::IsTableSLEChanged(*prev, lastTxChangeIndex, ownerID, m->tablename(), false) :
+                    std::make_pair(false, std::shared_ptr<STEntry const>());
+                if (retPair.second == NULL && retPair.first)
+                    i = uJump;
+                else
+                    bUseIndex = false;
             }
         }
 
+        auto ledger = app_.getLedgerMaster().getLedgerBySeq(i);
+        if (!ledger)   break;
+
+		auto retPair = TableSyncUtil::IsTableSLEChanged(*ledger, lastTxChangeIndex, ownerID, m->tablename(), true);
+
         auto time = ledger->info().closeTime.time_since_epoch().count();
 		if (retPair.second != NULL)
         {   
@@ -745,7 +734,8 @@ bool TableSync::CreateTableItems()
     try
     {
         auto section = cfg_.section(ConfigSection::syncTables());
-        const std::vector<std::string> lines = section.lines();       
+        //key=value lines such as workers= are settings, not tables
+        const std::vector<std::string> lines = section.values();
 
         //1.read data from config
         for (std::string line : lines)
@@ -857,7 +847,7 @@ bool TableSync::SendData(std::shared_ptr <TableSyncItem> pItem, std::shared_ptr
             {
                 pItem->TransBlock2Whole(ledgerSeq, uhash);
             }
-            pItem->TryOperateSQL();
+            pItem->TryDecode();
         }
         else
         {
@@ -869,7 +859,7 @@ bool TableSync::SendData(std::shared_ptr <TableSyncItem> pItem, std::shared_ptr
         if (data.lastledgerseq() == iCurSeq && data.lastledgerhash() == to_string(iCurHash))
         {
             pItem->PushDataToWholeDataQueue(tmp);
-            pItem->TryOperateSQL();
+            pItem->TryDecode();
         }
         else
         {
@@ -1223,6 +1213,9 @@ void TableSync::TableSyncThread()
 			}            
         }        
         case TableSyncItem::SYNC_BLOCK_STOP:
+            //the decode and apply stages are behind, ask for more later
+            if (pItem->IsBacklogFull())
+                break;
             if (app_.getLedgerMaster().haveLedger(stItem.u32SeqLedger+1) || app_.getLedgerMaster().lastCompleteIndex() <= stItem.u32SeqLedger + 1)
             {
                 pItem->SetSyncState(TableSyncItem::SYNC_WAIT_LOCAL_ACQUIRE);
@@ -1282,7 +1275,7 @@ void TableSync::TableSyncThread()
             if (b256thExist)
             {
                 pItem->SetLedgerState(TableSyncItem::SYNC_GOT_LEDGER);
-                pItem->DealWithWaitCheckQueue([pItem, this](TableSyncItem::sqldata_type const& pairData) {
+                pItem->DealWithWaitCheckQueue([pItem, this](TableSyncItem::sqldata_map::value_type const& pairData) {
                     uint256 ledgerHash = from_hex_text<uint256>(pairData.second.ledgerhash());
                     auto ledgerSeq = pairData.second.ledgerseq();
                     uint256 uLocalHash = GetLocalHash(ledgerSeq);
@@ -1335,13 +1328,40 @@ void TableSync::LocalSyncThread()
         {           
             pItem->SetSyncState(TableSyncItem::SYNC_LOCAL_ACQUIRING);
             pItem->StartLocalLedgerRead();
-            SeekTableTxLedger(stItem);
-            pItem->StopLocalLedgerRead();
+            workers_->post(jtTABLELOCALREAD, "tableLocalRead", [this, pItem, stItem]() mutable {
+                SeekTableTxLedger(stItem);
+                pItem->StopLocalLedgerRead();
+            });
         }
     }  
 	bLocalSyncThread_ = false;
 }
 
+TableSyncWorkers& TableSync::Workers()
+{
+    return *workers_;
+}
+
+Json::Value TableSync::GetSyncInfo()
+{
+    Json::Value ret(Json::objectValue);
+    ret[jss::sync_workers] = static_cast<Json::UInt>(workers_->workers());
+    ret[jss::sync_readers] = static_cast<Json::UInt>(workers_->readers());
+    ret[jss::sync_active] = static_cast<Json::UInt>(workers_->active());
+    ret[jss::sync_queued] = static_cast<Json::UInt>(workers_->queued());
+
+    std::list<std::shared_ptr <TableSyncItem>> tmList;
+    {
+        std::lock_guard<std::mutex> lock(mutexlistTable_);
+        tmList = listTableInfo_;
+    }
+    auto const validLedger = app_.getLedgerMaster().getValidLedgerIndex();
+    Json::Value& tables = (ret[jss::tables] = Json::arrayValue);
+    for (auto const& pItem : tmList)
+        tables.append(pItem->GetSyncInfo(validLedger));
+    return ret;
+}
+
 bool TableSync::Is256thLedgerExist(LedgerIndex index)
 {
     LedgerIndex iDstSeq = getCandidateLedger(index);
@@ -1562,22 +1582,10 @@ std::string TableSync::GetPressTableName()
 	auto pAccount = ripple::parseBase58<AccountID>("zHb9CJAWyB4zj91VRWn96DkukG4bwdtyTh");
 	AccountID account = *pAccount;
 	auto ledger = app_.getLedgerMaster().getValidatedLedger();
-	auto id = keylet::table(account);
-	auto const tablesle = ledger->read(id);
-	if (tablesle == nullptr)
-		return "";
-	auto aTableEntries = tablesle->getFieldArray(sfTableEntries);
 	std::string sCheckName = "press_time";
-	auto iter(aTableEntries.end());
-	iter = std::find_if(aTableEntries.begin(), aTableEntries.end(),
-		[sCheckName](STObject const &item) {
-		if (!item.isFieldPresent(sfTableName))  return false;
-		auto sTableName = strCopy(item.getFieldVL(sfTableName));
-		return sTableName == sCheckName;
-	});
-	if (iter == aTableEntries.end())
+	auto pEntry = readTableEntry(*ledger, account, sCheckName);
+	if (pEntry == nullptr)
 		return "";
-	STEntry* pEntry = (STEntry*)(&(*iter));
 	auto nameInDB = pEntry->getFieldH160(sfNameInDB);
 	pressRealName_ = "t_" + to_string(nameInDB);
 
@@ -25,6 +25,7 @@
 #include <ripple/app/main/Application.h>
 #include <ripple/protocol/RippleAddress.h>
 #include <ripple/json/json_reader.h>
+#include <ripple/protocol/JsonFields.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <peersafe/app/table/TableSyncItem.h>
 #include <peersafe/app/sql/TxStore.h>
@@ -36,12 +37,21 @@
 #include <peersafe/app/table/TableStatusDB.h>
 #include <peersafe/app/table/TableStatusDB.h>
 #include <peersafe/app/table/TableSync.h>
+#include <peersafe/app/table/TableDirectory.h>
+#include <peersafe/app/table/TableBulkLoad.h>
+#include <ripple/core/ConfigSections.h>
 
 
 using namespace std::chrono;
 auto constexpr TABLE_DATA_OVERTM = 30s;
 auto constexpr LEDGER_DATA_OVERTM = 30s;
 auto const TXID_LENGTH = 64;
+// txs written in one bulk load transaction before it is committed
+auto constexpr BULK_LOAD_TXS = 1000;
+// decoded ledgers held ahead of the apply stage
+auto constexpr MAX_DECODED_LEDGERS = 256;
+// ledgers received and not applied yet before no more are requested
+auto constexpr MAX_BACKLOG_LEDGERS = 2048;
 
 #define OPTYPELEN 6
 namespace ripple {
@@ -60,6 +70,9 @@ TableSyncItem::TableSyncItem(Application& app, beast::Journal journal, Config& c
 {   
     eState_               = SYNC_INIT;
     bOperateSQL_          = false;
+    bDecode_              = false;
+    iStages_              = 0;
+    uAppliedSeq_          = 0;
     bIsChange_            = true;
     bGetLocalData_        = false;
     conn_                 = NULL;
@@ -68,6 +81,11 @@ TableSyncItem::TableSyncItem(Application& app, beast::Journal journal, Config& c
     sNickName_            = "";
     uCreateLedgerSequence_ = 0;
 	deleted_			  = false;
+    uBulkLoadGap_         = 1000;
+    bBulkLoad_            = false;
+    uBulkTxs_             = 0;
+
+    get_if_exists(cfg_.section(ConfigSection::syncTables()), "bulk_load", uBulkLoadGap_);
 }
 
 TableSyncItem::cond const & TableSyncItem::GetCondition()
@@ -205,6 +223,19 @@ TableStatusDB& TableSyncItem::getTableStatusDB()
     return *pObjTableStatusDB_;
 }
 
+TableBulkLoad& TableSyncItem::getTableBulkLoad()
+{
+    if (pBulkLoad_ == NULL)
+    {
+        DatabaseCon::Setup setup = ripple::setup_SyncDatabaseCon(cfg_);
+        std::pair<std::string, bool> result = setup.sync_db.find("type");
+        pBulkLoad_ = std::make_unique<TableBulkLoad>(getTxStoreDBConn().GetDBConn(),
+            result.first.compare("sqlite") == 0, journal_);
+    }
+
+    return *pBulkLoad_;
+}
+
 bool TableSyncItem::getAutoSync()
 {
     return bIsAutoSync_;
@@ -228,6 +259,10 @@ void TableSyncItem::ReSetContex()
         std::lock_guard<std::mutex> lock(mutexWholeData_);
         aWholeData_.clear();
     }
+    {
+        std::lock_guard<std::mutex> lock(mutexDecodedData_);
+        aDecodedData_.clear();
+    }
     {
         std::lock_guard<std::mutex> lock(mutexWaitCheckQueue_);
         aWaitCheckData_.clear();
@@ -249,41 +284,7 @@ void TableSyncItem::SetIsDataFromLocal(bool bLocal)
 {
     bGetLocalData_ = bLocal;
 }
-void TableSyncItem::PushDataByOrder(std::list <sqldata_type> &aData, sqldata_type &sqlData)
-{
-    if (aData.size() == 0)
-    {
-        aData.push_back(sqlData);
-        return;
-    }
-    else if (sqlData.first > aData.rbegin()->first)
-    {
-        aData.push_back(sqlData);
-        return;
-    }
-    else
-    {
-        if (aData.size() == 1)
-        {
-            aData.push_front(sqlData);
-            return;
-        }
-        else
-        {
-            for (auto it = aData.begin(); it != aData.end(); it++)
-            {
-                if (sqlData.first == it->first)  return;
-                else if (sqlData.first > it->first)
-                {
-                    aData.insert(it++, sqlData);
-                    return;
-                }
-            }
-        }
-    }
-}
-
-void TableSyncItem::DealWithWaitCheckQueue(std::function<bool (sqldata_type const&)> f)
+void TableSyncItem::DealWithWaitCheckQueue(std::function<bool (sqldata_map::value_type const&)> f)
 {
     std::lock_guard<std::mutex> lock(mutexWaitCheckQueue_);
     for (auto it = aWaitCheckData_.begin(); it != aWaitCheckData_.end(); it++)
@@ -296,13 +297,13 @@ void TableSyncItem::DealWithWaitCheckQueue(std::function<bool (sqldata_type cons
 void TableSyncItem::PushDataToWaitCheckQueue(sqldata_type &sqlData)
 {
     std::lock_guard<std::mutex> lock(mutexWaitCheckQueue_);
-    PushDataByOrder(aWaitCheckData_, sqlData);
+    aWaitCheckData_.emplace(sqlData.first, sqlData.second);
 }
 void TableSyncItem::PushDataToBlockDataQueue(sqldata_type &sqlData)
 {
     std::lock_guard<std::mutex> lock(mutexBlockData_);
     
-    PushDataByOrder(aBlockData_, sqlData);
+    aBlockData_.emplace(sqlData.first, sqlData.second);
 }
 
 bool TableSyncItem::GetRightRequestRange(TableSyncItem::BaseInfo &stRange)
@@ -397,7 +398,7 @@ bool TableSyncItem::TransBlock2Whole(LedgerIndex iSeq, uint256)
             {
                 SetSyncTxLedger(iBegin, uCheckhash);
             }            
-            aWholeData_.push_back(std::move(*it));
+            aWholeData_.emplace_back(it->first, std::move(it->second));
             aBlockData_.erase(it);
         }        
         else
@@ -659,14 +660,40 @@ void  TableSyncItem::SetTableNameInDB(std::string sNameInDB)
     sTableNameInDB_ = sNameInDB;
 }
 
-void TableSyncItem::TryOperateSQL()
+// Ledgers go through two stages, each with at most one job per table so
+// they stay in order: the decode job splits and decrypts the txs of the
+// consecutive ledgers, the apply job writes the decoded ones to the db.
+// Fetching ledger N+k, decoding N+1 and applying N overlap.
+void TableSyncItem::TryDecode()
 {
-    if (bOperateSQL_)    return;
+    if (bDecode_.exchange(true))    return;
 
-    bOperateSQL_ = true;
+    BeginStage();
+    auto self = shared_from_this();
+    app_.getTableSync().Workers().post(jtOPERATESQL, "decodeTableData", [self]() { self->DecodeThread(); });
+}
+
+void TableSyncItem::TryApply()
+{
+    if (bOperateSQL_.exchange(true))    return;
 
-    operateSqlEvent.reset();
-    app_.getJobQueue().addJob(jtOPERATESQL, "operateSQL", [this](Job&) { OperateSQLThread(); });
+    BeginStage();
+    auto self = shared_from_this();
+    app_.getTableSync().Workers().post(jtOPERATESQL, "operateSQL", [self]() { self->OperateSQLThread(); });
+}
+
+void TableSyncItem::BeginStage()
+{
+    std::lock_guard<std::mutex> lock(mutexStages_);
+    if (iStages_++ == 0)
+        operateSqlEvent.reset();
+}
+
+void TableSyncItem::EndStage()
+{
+    std::lock_guard<std::mutex> lock(mutexStages_);
+    if (--iStages_ == 0)
+        operateSqlEvent.signal();
 }
 
 bool TableSyncItem::IsExist(AccountID accountID,  std::string TableNameInDB)
@@ -734,63 +761,59 @@ std::pair<bool, std::string> TableSyncItem::InitPassphrase()
 	{
 		return std::make_pair(false, "can't find account table sle.");
 	}
-	auto aTableEntries = tablesle->getFieldArray(sfTableEntries);
+	auto pEntry = findTableEntry(*ledger, accountID_, [this](STEntry const &table) {
+		if (eSyncTargetType_ == SyncTarget_db) return to_string(table.getFieldH160(sfNameInDB)) == sTableNameInDB_;
+		else                                   return strCopy(table.getFieldVL(sfTableName)) == sTableName_;
+	});
 
 	bool bGetTable = false;
-	for (auto const &table : aTableEntries)
+	if (pEntry)
 	{
-		bool bRightName = false;
-		if (eSyncTargetType_ == SyncTarget_db) bRightName = to_string(table.getFieldH160(sfNameInDB)) == sTableNameInDB_;
-		else                                   bRightName = strCopy(table.getFieldVL(sfTableName)) == sTableName_;;
+		auto const& table = *pEntry;
+		uCreateLedgerSequence_ = table.getFieldU32(sfCreateLgrSeq);
+
+		auto& users = table.getFieldArray(sfUsers);
+		assert(users.size() > 0);
+		bool bConfidential = users[0].isFieldPresent(sfToken);
 		
-		if (bRightName)
+		if (bConfidential)
 		{
-			uCreateLedgerSequence_ = table.getFieldU32(sfCreateLgrSeq);
-
-			auto& users = table.getFieldArray(sfUsers);
-			assert(users.size() > 0);
-			bool bConfidential = users[0].isFieldPresent(sfToken);
-			
-			if (bConfidential)
+			confidential_ = true;
+			if (!user_accountID_) return std::make_pair(false, "user account is null.");;
+			for (auto & user : users)  //check if there same user
 			{
-				confidential_ = true;
-				if (!user_accountID_) return std::make_pair(false, "user account is null.");;
-				for (auto & user : users)  //check if there same user
+				if (user.getAccountID(sfUser) == user_accountID_)
 				{
-					if (user.getAccountID(sfUser) == user_accountID_)
+					auto selectFlags = getFlagFromOptype(R_GET);
+					auto userFlags = user.getFieldU32(sfFlags);
+					if ((userFlags & selectFlags) == 0)
 					{
-						auto selectFlags = getFlagFromOptype(R_GET);
-						auto userFlags = user.getFieldU32(sfFlags);
-						if ((userFlags & selectFlags) == 0)
+						return std::make_pair(false, "no authority.");
+					}
+					else
+					{
+						if (user.isFieldPresent(sfToken))
 						{
-							return std::make_pair(false, "no authority.");
+							auto token = user.getFieldVL(sfToken);
+							//passBlob_ = RippleAddress::decryptPassword(token, *user_secret_);
+							passBlob_ = ripple::decrypt(token, *user_secret_);
+							if(passBlob_.size() > 0)  return std::make_pair(true, "");
+							else                      return std::make_pair(false, "cann't get password for this table.");
 						}
 						else
 						{
-							if (user.isFieldPresent(sfToken))
-							{
-								auto token = user.getFieldVL(sfToken);
-								//passBlob_ = RippleAddress::decryptPassword(token, *user_secret_);
-                                passBlob_ = ripple::decrypt(token, *user_secret_);
-								if(passBlob_.size() > 0)  return std::make_pair(true, "");
-								else                      return std::make_pair(false, "cann't get password for this table.");
-							}
-							else
-							{
-								return std::make_pair(false, "table error");
-							}
+							return std::make_pair(false, "table error");
 						}
 					}
 				}
 			}
-			else
-			{
-				return std::make_pair(true, "");
-			}
-			
-			bGetTable = true;
-			break;
-		}			
+		}
+		else
+		{
+			return std::make_pair(true, "");
+		}
+
+		bGetTable = true;
 	}
 	if (!bGetTable)
 	{
@@ -881,20 +904,13 @@ std::string TableSyncItem::getOperationRule(const STTx& tx)
 	if (tablesle == nullptr)
 		return rule;
 
-	auto aTableEntries = tablesle->getFieldArray(sfTableEntries);
-	STEntry* pEntry = NULL;
-	for (auto const &table : aTableEntries)
-	{
-		bool bRightName = false;
+	auto pEntry = findTableEntry(*ledger, accountID_, [this](STEntry const &table) {
 		if (eSyncTargetType_ == SyncTarget_db) 
-			bRightName = to_string(table.getFieldH160(sfNameInDB)) == sTableNameInDB_;
+			return to_string(table.getFieldH160(sfNameInDB)) == sTableNameInDB_;
 		else                                   
-			bRightName = strCopy(table.getFieldVL(sfTableName)) == sTableName_;;
-
-		if (bRightName)
-			pEntry = (STEntry*)&table;
-	}
-	if (pEntry != NULL)
+			return strCopy(table.getFieldVL(sfTableName)) == sTableName_;
+	});
+	if (pEntry != nullptr)
 		rule = pEntry->getOperationRule((TableOpType)opType);
 	return rule;
 }
@@ -937,6 +953,8 @@ std::pair<bool, std::string> TableSyncItem::DealTranCommonTx(const STTx &tx)
     
 	if (ret.first)
 	{
+		if (T_DROP == op_type || T_CREATE == op_type || T_RECREATE == op_type)
+			getTableBulkLoad().forget(sTableNameInDB_);
 
 		if (T_DROP == op_type)
 		{
@@ -1011,10 +1029,102 @@ void TableSyncItem::InsertPressData(const STTx& tx,uint32 ledger_seq,uint32 ledg
 	}
 }
 
-bool TableSyncItem::DealWithEveryLedgerData(const std::vector<protocol::TMTableData> &aData)
+bool TableSyncItem::isBulkLoad(const std::vector<DecodedLedger> &aData)
+{
+    if (uBulkLoadGap_ == 0 || aData.empty() || sTableNameInDB_.empty() ||
+        eSyncTargetType_ != SyncTarget_db)
+        return false;
+
+    auto validSeq = app_.getLedgerMaster().getValidLedgerIndex();
+    return validSeq > aData.back().data.ledgerseq() + uBulkLoadGap_;
+}
+
+// Creating or dropping the table is DDL, which commits the bulk transaction
+// on MySQL, those txs are written in a transaction of their own.
+bool TableSyncItem::isBulkLoadTx(const std::vector<STTx>& vecTxs)
+{
+    for (auto const& tx : vecTxs)
+    {
+        auto op_type = (TableOpType)tx.getFieldU16(sfOpType);
+        if (!isSqlStatementOpType(op_type) && !isNotNeedDisposeType(op_type))
+            return false;
+    }
+    return true;
+}
+
+void TableSyncItem::beginBulkLoad()
+{
+    if (pBulkTran_)
+        return;
+
+    getTableBulkLoad().dropIndexes(sTableNameInDB_);
+    pBulkTran_ = std::make_unique<TxStoreTransaction>(&getTxStoreDBConn());
+    uBulkTxs_ = 0;
+}
+
+void TableSyncItem::commitBulkLoad()
+{
+    if (!pBulkTran_)
+        return;
+
+    std::string error;
+    try
+    {
+        pBulkTran_->commit();
+    }
+    catch (std::exception const& e)
+    {
+        error = e.what();
+        JLOG(journal_.error()) << "bulk load commit exception " << error;
+        SetSyncState(SYNC_STOP);
+    }
+    pBulkTran_.reset();
+
+    for (auto& item : aBulkResults_)
+    {
+        if (!error.empty())
+            item.second = std::make_pair("db_error", error);
+        app_.getOPs().pubTableTxs(accountID_, sTableName_, item.first, item.second, false);
+    }
+    aBulkResults_.clear();
+    uBulkTxs_ = 0;
+}
+
+void TableSyncItem::executeBulkLoad(std::string const& sql)
 {
-	for (std::vector<protocol::TMTableData>::const_iterator iter = aData.begin(); iter != aData.end(); ++iter)
+    LockedSociSession sql_session = getTxStoreDBConn().GetDBConn()->checkoutDb();
+    *sql_session << sql;
+}
+
+bool TableSyncItem::DealWithEveryLedgerData(std::vector<DecodedLedger> &aData)
+{
+    bool bBulk = isBulkLoad(aData);
+    if (!bBulk && !aData.empty())
+    {
+        commitBulkLoad();
+        getTableBulkLoad().restoreIndexes(sTableNameInDB_);
+    }
+    bBulkLoad_ = bBulk;
+
+	for (auto& ledger : aData)
 	{
+        //decoded before a tx of an earlier ledger changed the table
+        if (!ledger.bDecoded || ledger.sNameInDB != sTableNameInDB_)
+        {
+            try
+            {
+                DecodeLedger(ledger);
+            }
+            catch (std::exception const& e)
+            {
+                JLOG(journal_.error()) << "DecodeLedger exception " << e.what();
+                commitBulkLoad();
+                SetSyncState(SYNC_STOP);
+                return false;
+            }
+        }
+
+        const protocol::TMTableData* iter = &ledger.data;
 		std::string LedgerHash = iter->ledgerhash();
 		std::string LedgerCheckHash = iter->ledgercheckhash();
 		std::string LedgerSeq = to_string(iter->ledgerseq());
@@ -1025,6 +1135,7 @@ bool TableSyncItem::DealWithEveryLedgerData(const std::vector<protocol::TMTableD
         if (checkRet == CHECK_JUMP)     continue;
         else if(checkRet == CHECK_REJECT)
         {
+            commitBulkLoad();
             SetSyncState(SYNC_STOP);
             return false;
         }
@@ -1036,12 +1147,8 @@ bool TableSyncItem::DealWithEveryLedgerData(const std::vector<protocol::TMTableD
 
 			for (int i = 0; i < iter->txnodes().size(); i++)
 			{
-				const protocol::TMLedgerNode &node = iter->txnodes().Get(i);
-
-				auto str = node.nodedata();
-				Blob blob;
-				blob.assign(str.begin(), str.end());
-				STTx tx = std::move((STTx)(SerialIter{ blob.data(), blob.size() }));               
+				DecodedTx &decoded = ledger.txs[i];
+				STTx const& tx = *decoded.pTx;
                 
                 if (!bFindLastSuccessTx)     //if a ledger have many txs,first handles some txs,then stop rippled,next start rippled,must jump those txs  
                 {
@@ -1052,6 +1159,7 @@ bool TableSyncItem::DealWithEveryLedgerData(const std::vector<protocol::TMTableD
                     count++;
                     continue;
                 }
+                bool bBulkTx = false;
                 try {
 					//check for jump one tx.
 					if (isJumpThisTx(tx.getTransactionID()))
@@ -1060,11 +1168,18 @@ bool TableSyncItem::DealWithEveryLedgerData(const std::vector<protocol::TMTableD
 						continue;
 					}
 
-					auto vecTxs = STTx::getTxs(tx, sTableNameInDB_);
+					if (!decoded.sError.empty())
+						Throw<std::runtime_error>(decoded.sError);
+					auto& vecTxs = decoded.vecTxs;
+
+                    bBulkTx = bBulk && isBulkLoadTx(vecTxs);
+                    if (bBulkTx)
+                        beginBulkLoad();
+                    else
+                        commitBulkLoad();
 
 					if (vecTxs.size() > 0)
 					{
-						TryDecryptRaw(vecTxs);
                         for (auto& tx : vecTxs)
                         {
                             if (T_CREATE == tx.getFieldU16(sfOpType))
@@ -1082,27 +1197,35 @@ bool TableSyncItem::DealWithEveryLedgerData(const std::vector<protocol::TMTableD
 						return false;
 					}
 
-					TxStoreTransaction stTran(&getTxStoreDBConn());
+                    // a failing tx only undoes its own statements
+                    std::unique_ptr<TxStoreTransaction> stTran;
+                    if (bBulkTx)
+                        executeBulkLoad("SAVEPOINT bulk_tx");
+                    else
+                        stTran = std::make_unique<TxStoreTransaction>(&getTxStoreDBConn());
 
 					auto ret = DealWithTx(vecTxs);
                     uTxDBUpdateHash_ = tx.getTransactionID();
 
                     if (!ret.first)
                     {
-                        stTran.rollback();
-                        auto updateRet = getTableStatusDB().UpdateSyncDB(to_string(accountID_), sTableNameInDB_, to_string(uTxDBUpdateHash_), PreviousCommit);
-                        if (updateRet == soci_exception) {
-                            JLOG(journal_.error()) << "UpdateSyncDB soci_exception";
-                        }
+                        if (bBulkTx)
+                            executeBulkLoad("ROLLBACK TO SAVEPOINT bulk_tx");
+                        else
+                            stTran->rollback();
                     }
-                    else
+                    if (bBulkTx)
                     {
-                        auto updateRet = getTableStatusDB().UpdateSyncDB(to_string(accountID_), sTableNameInDB_, to_string(uTxDBUpdateHash_), PreviousCommit);
-                        if (updateRet == soci_exception) {
-                            JLOG(journal_.error()) << "UpdateSyncDB soci_exception";
-                        }
-                        stTran.commit();
+                        executeBulkLoad("RELEASE SAVEPOINT bulk_tx");
+                        uBulkTxs_++;
+                    }
+
+                    auto updateRet = getTableStatusDB().UpdateSyncDB(to_string(accountID_), sTableNameInDB_, to_string(uTxDBUpdateHash_), PreviousCommit);
+                    if (updateRet == soci_exception) {
+                        JLOG(journal_.error()) << "UpdateSyncDB soci_exception";
                     }
+                    if (ret.first && stTran)
+                        stTran->commit();
 
 					//press test
 					if (app_.getTableSync().IsPressSwitchOn())
@@ -1117,7 +1240,10 @@ bool TableSyncItem::DealWithEveryLedgerData(const std::vector<protocol::TMTableD
 						result = std::make_pair("db_success", "");
 					else
 						result = std::make_pair("db_error", ret.second);
-					app_.getOPs().pubTableTxs(accountID_, sTableName_, tx, result, false);
+                    if (bBulkTx)
+                        aBulkResults_.emplace_back(tx, result);
+                    else
+                        app_.getOPs().pubTableTxs(accountID_, sTableName_, tx, result, false);
                     count++;
                 }
                 catch (std::exception const& e)
@@ -1125,6 +1251,19 @@ bool TableSyncItem::DealWithEveryLedgerData(const std::vector<protocol::TMTableD
                     JLOG(journal_.info()) <<
                         "Dispose exception" << e.what();
 
+                    // the bulk transaction is left as it was before this tx
+                    if (bBulkTx)
+                    {
+                        try
+                        {
+                            executeBulkLoad("ROLLBACK TO SAVEPOINT bulk_tx");
+                            executeBulkLoad("RELEASE SAVEPOINT bulk_tx");
+                        }
+                        catch (std::exception const&)
+                        {
+                        }
+                    }
+
                     std::pair<std::string, std::string> result = std::make_pair("db_error", e.what());
                     app_.getOPs().pubTableTxs(accountID_, sTableName_, tx, result, false);
                 }
@@ -1143,6 +1282,9 @@ bool TableSyncItem::DealWithEveryLedgerData(const std::vector<protocol::TMTableD
 
 			if (uTxDBUpdateHash_.isNonZero())
 				SetSyncState(SYNC_STOP);
+
+            if (uBulkTxs_ >= BULK_LOAD_TXS)
+                commitBulkLoad();
 		}
 		else
 		{
@@ -1156,32 +1298,178 @@ bool TableSyncItem::DealWithEveryLedgerData(const std::vector<protocol::TMTableD
 	}
 	return true;
 }
-void TableSyncItem::OperateSQLThread()
+
+void TableSyncItem::DecodeLedger(DecodedLedger &ledger)
 {
-    //check the connection is ok
-    getTxStoreDBConn();
+    {
+        std::lock_guard<std::mutex> lock(mutexInfo_);
+        ledger.sNameInDB = sTableNameInDB_;
+    }
 
-	if (GetSyncState() == SYNC_STOP)
-	{
-		bOperateSQL_ = false;
-        return;
+    ledger.txs.clear();
+    ledger.txs.reserve(ledger.data.txnodes().size());
+    for (int i = 0; i < ledger.data.txnodes().size(); i++)
+    {
+        auto const& str = ledger.data.txnodes().Get(i).nodedata();
+        DecodedTx decoded;
+        decoded.pTx = std::make_shared<STTx>(SerialIter{ str.data(), str.size() });
+        try
+        {
+            decoded.vecTxs = STTx::getTxs(*decoded.pTx, ledger.sNameInDB);
+            TryDecryptRaw(decoded.vecTxs);
+        }
+        catch (std::exception const& e)
+        {
+            decoded.sError = e.what();
+        }
+        ledger.txs.push_back(std::move(decoded));
     }
+    ledger.bDecoded = true;
+}
 
-    std::vector<protocol::TMTableData> vec_tmdata;
-    std::list <sqldata_type> list_tmdata;
+void TableSyncItem::DecodeThread()
+{
+    while (GetSyncState() != SYNC_STOP)
     {
-        std::lock_guard<std::mutex> lock(mutexWholeData_);
-        for (std::list<sqldata_type>::iterator iter = aWholeData_.begin(); iter != aWholeData_.end(); ++iter)
         {
-            vec_tmdata.push_back((*iter).second);
+            std::lock_guard<std::mutex> lock(mutexDecodedData_);
+            if (aDecodedData_.size() >= MAX_DECODED_LEDGERS)
+                break;
         }
-        aWholeData_.clear();
+
+        DecodedLedger ledger;
+        {
+            std::lock_guard<std::mutex> lock(mutexWholeData_);
+            if (aWholeData_.empty())
+                break;
+            ledger.data.Swap(&aWholeData_.front().second);
+            aWholeData_.pop_front();
+        }
+
+        try
+        {
+            DecodeLedger(ledger);
+        }
+        catch (std::exception const& e)
+        {
+            // a node that can not be parsed stops the table when it is applied
+            JLOG(journal_.error()) << "DecodeLedger exception " << e.what();
+            ledger.txs.clear();
+            ledger.bDecoded = false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutexDecodedData_);
+            aDecodedData_.push_back(std::move(ledger));
+        }
+        TryApply();
+    }
+
+    bDecode_ = false;
+    EndStage();
+
+    //data pushed after the queue was found empty, a full decoded queue
+    //is left to the apply job, it calls TryDecode once it takes from it
+    bool bMore = false;
+    {
+        std::lock_guard<std::mutex> lock(mutexDecodedData_);
+        if (aDecodedData_.size() >= MAX_DECODED_LEDGERS)
+            return;
     }
+    {
+        std::lock_guard<std::mutex> lock(mutexWholeData_);
+        bMore = !aWholeData_.empty();
+    }
+    if (bMore && GetSyncState() != SYNC_STOP)
+        TryDecode();
+}
 
-	DealWithEveryLedgerData(vec_tmdata);
+void TableSyncItem::OperateSQLThread()
+{
+    //check the connection is ok
+    getTxStoreDBConn();
+
+    //an open bulk transaction is filled with the next decoded ledgers
+    //before it is committed, it can not outlive this job
+    do
+    {
+        if (GetSyncState() == SYNC_STOP)
+            break;
+
+        std::vector<DecodedLedger> vec_tmdata;
+        {
+            std::lock_guard<std::mutex> lock(mutexDecodedData_);
+            vec_tmdata.reserve(aDecodedData_.size());
+            for (auto& ledger : aDecodedData_)
+                vec_tmdata.push_back(std::move(ledger));
+            aDecodedData_.clear();
+        }
+        if (vec_tmdata.empty())
+            break;
+
+        //room for the decode stage again
+        TryDecode();
+
+        DealWithEveryLedgerData(vec_tmdata);
+        uAppliedSeq_ = vec_tmdata.back().data.ledgerseq();
+    } while (pBulkTran_);
+    commitBulkLoad();
 
     bOperateSQL_ = false;
-    operateSqlEvent.signal();
+    EndStage();
+
+    //data decoded while this job was running
+    bool bMore = false;
+    {
+        std::lock_guard<std::mutex> lock(mutexDecodedData_);
+        bMore = !aDecodedData_.empty();
+    }
+    if (bMore && GetSyncState() != SYNC_STOP)
+        TryApply();
+}
+
+Json::Value TableSyncItem::GetSyncInfo(LedgerIndex validLedger)
+{
+    Json::Value info(Json::objectValue);
+    info[jss::owner] = to_string(accountID_);
+    info[jss::TableName] = sTableName_;
+    info[jss::NameInDB] = sTableNameInDB_;
+    info[jss::state] = static_cast<int>(GetSyncState());
+
+    LedgerIndex iSeq;
+    uint256 uHash;
+    GetSyncLedger(iSeq, uHash);
+    info[jss::received_ledger] = iSeq;
+
+    LedgerIndex iApplied = uAppliedSeq_;
+    if (iApplied == 0)
+        iApplied = iSeq;
+    info[jss::applied_ledger] = iApplied;
+    info[jss::lag] = validLedger > iApplied ? validLedger - iApplied : 0;
+    info[jss::bulk_load] = bBulkLoad_.load();
+
+    std::size_t fetch, decode, apply;
+    {
+        std::lock_guard<std::mutex> lock(mutexBlockData_);
+        fetch = aBlockData_.size();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutexWaitCheckQueue_);
+        fetch += aWaitCheckData_.size();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutexWholeData_);
+        decode = aWholeData_.size();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutexDecodedData_);
+        apply = aDecodedData_.size();
+    }
+    info[jss::pending] = static_cast<Json::UInt>(decode + apply);
+    info[jss::fetch_queue] = static_cast<Json::UInt>(fetch);
+    info[jss::decode_queue] = static_cast<Json::UInt>(decode);
+    info[jss::apply_queue] = static_cast<Json::UInt>(apply);
+    return info;
 }
 bool TableSyncItem::isJumpThisTx(uint256 txid)
 {
@@ -1257,6 +1545,20 @@ void TableSyncItem::PushDataToWholeDataQueue(sqldata_type &sqlData)
     }
 }
 
+bool TableSyncItem::IsBacklogFull()
+{
+    std::size_t iSize = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutexWholeData_);
+        iSize = aWholeData_.size();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutexDecodedData_);
+        iSize += aDecodedData_.size();
+    }
+    return iSize >= MAX_BACKLOG_LEDGERS;
+}
+
 bool TableSyncItem::GetIsChange()
 {
     return  bIsChange_;
@@ -1315,15 +1617,18 @@ bool TableSyncItem::StopSync()
         return false;
     }
 
-    int iSize = 0;
+    std::size_t iSize = 0;
     {
         std::lock_guard<std::mutex> lock(mutexWholeData_);
-        aWholeData_.size();
+        iSize = aWholeData_.size();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutexDecodedData_);
+        iSize += aDecodedData_.size();
     }
-    iSize = aWholeData_.size();
     if (iSize > 0)
     {
-        TryOperateSQL();
+        TryDecode();
         bRet = operateSqlEvent.wait(2000);
         if (!bRet)
         {
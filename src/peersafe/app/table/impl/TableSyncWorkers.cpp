@@ -0,0 +1,103 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+
+#include <peersafe/app/table/TableSyncWorkers.h>
+#include <ripple/core/JobQueue.h>
+
+namespace ripple {
+
+TableSyncWorkers::TableSyncWorkers (JobQueue& jobQueue, std::size_t workers,
+        std::size_t readers)
+    : jobQueue_ (jobQueue)
+    , apply_ (workers)
+    , read_ (readers)
+{
+}
+
+TableSyncWorkers::Lane& TableSyncWorkers::lane (JobType type)
+{
+    return type == jtTABLELOCALREAD ? read_ : apply_;
+}
+
+void TableSyncWorkers::post (JobType type, std::string const& name,
+    std::function <void ()> f)
+{
+    auto& l = lane (type);
+    Work work { type, name, std::move (f) };
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        if (l.active >= l.limit)
+        {
+            l.queue.push_back (std::move (work));
+            return;
+        }
+        ++l.active;
+    }
+    launch (l, std::move (work));
+}
+
+void TableSyncWorkers::launch (Lane& l, Work work)
+{
+    auto f = std::move (work.f);
+    bool const added = jobQueue_.addJob (work.type, work.name,
+        [this, &l, f](Job&)
+        {
+            f ();
+            finished (l);
+        });
+
+    // the job queue is stopping, nothing queued will run either
+    if (!added)
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        l.queue.clear ();
+        --l.active;
+    }
+}
+
+void TableSyncWorkers::finished (Lane& l)
+{
+    Work next;
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        if (l.queue.empty ())
+        {
+            --l.active;
+            return;
+        }
+        next = std::move (l.queue.front ());
+        l.queue.pop_front ();
+    }
+    launch (l, std::move (next));
+}
+
+std::size_t TableSyncWorkers::active () const
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    return apply_.active + read_.active;
+}
+
+std::size_t TableSyncWorkers::queued () const
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    return apply_.queue.size () + read_.queue.size ();
+}
+
+}
@@ -107,11 +107,11 @@ TER OperationRule::dealWithTableListSetRule(ApplyContext& ctx, const STTx& tx)
 		auto sOperationRule = strCopy(tx.getFieldVL(sfOperationRule));
 		if (Json::Reader().parse(sOperationRule, jsonRule))
 		{
-			std::string sRaw = strCopy(tx.getFieldVL(sfRaw));
 			// will not dispose if raw is encrypted
-			Json::Value jsonRaw;
-			if (!Json::Reader().parse(sRaw, jsonRaw))
+			auto const pRaw = tx.getRawJson();
+			if (!pRaw)
 				return temBAD_RAW;
+			Json::Value const& jsonRaw = *pRaw;
 
 			std::vector<std::string> vecFields;
 			for (Json::UInt idx = 0; idx < jsonRaw.size(); idx++)
@@ -293,11 +293,10 @@ TER OperationRule::dealWithSqlStatementRule(ApplyContext& ctx, const STTx& tx)
 		Json::Value jsonRule;
 		if (!Json::Reader().parse(sOperationRule, jsonRule))
 			return temBAD_OPERATIONRULE;
-		std::string sRaw = strCopy(tx.getFieldVL(sfRaw));
-
-		Json::Value jsonRaw;
-		if (!Json::Reader().parse(sRaw, jsonRaw))
+		auto const pRaw = tx.getRawJson();
+		if (!pRaw)
 			return temBAD_RAW;
+		Json::Value const& jsonRaw = *pRaw;
 		if (optype == (int)R_INSERT)
 		{
 			//deal with insert condition 
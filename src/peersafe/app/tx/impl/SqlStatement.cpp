@@ -34,6 +34,7 @@
 #include <peersafe/protocol/TableDefines.h>
 #include <peersafe/app/tx/SqlStatement.h>
 #include <peersafe/app/tx/OperationRule.h>
+#include <peersafe/app/table/TableDirectory.h>
 #include <peersafe/rpc/TableUtils.h>
 
 namespace ripple {
@@ -153,8 +154,7 @@ namespace ripple {
 		Blob vTxTableName = sTxTables[0].getFieldVL(sfTableName);
         uint160 uTxDBName = sTxTables[0].getFieldH160(sfNameInDB);
 
-		STArray const & aTableEntries(sleTable->getFieldArray(sfTableEntries));
-		STEntry *pEntry = getTableEntry(aTableEntries, vTxTableName);        
+		auto const pEntry = readTableEntry(view, uOwnerID, vTxTableName);
 		if (pEntry)
 		{
             //checkDBName
@@ -211,12 +211,15 @@ namespace ripple {
 		auto const k = keylet::table(curTxOwnID);
 		SLE::pointer pTableSle = view.peek(k);
 
-		auto &aTableEntries = pTableSle->peekFieldArray(sfTableEntries);
+		TER terResult = migrateTableEntries(view, curTxOwnID);
+		if (!isTesSuccess(terResult))
+			return terResult;
 
 		auto const & sTxTables = tx.getFieldArray(sfTables);
 		Blob vTxTableName = sTxTables[0].getFieldVL(sfTableName);		
 
-		STEntry *pEntry = getTableEntry(aTableEntries, vTxTableName);
+		auto table = peekTableEntry(view, curTxOwnID, vTxTableName);
+		STEntry *pEntry = table.entry;
 		if (pEntry)
 		{
 			uint256 hashNew = sha512Half(makeSlice(strCopy(tx.getFieldVL(sfRaw))), pEntry->getFieldH256(sfTxCheckHash));
@@ -235,9 +238,13 @@ namespace ripple {
 				pEntry->setFieldU32(sfTxnLgrSeq, view.info().seq);
 				pEntry->setFieldH256(sfTxnLedgerHash, view.info().hash);
 			}
+			// only the ledger entry holding the table is rewritten
+			view.update(table.sle);
+		}
+		else if (pTableSle)
+		{
+			view.update(pTableSle);
 		}
-
-		view.update(pTableSle);
 		return tesSUCCESS;
 	}
 
@@ -36,6 +36,7 @@
 #include <peersafe/app/tx/TableListSet.h>
 #include <peersafe/app/tx/impl/Tuning.h>
 #include <peersafe/app/tx/OperationRule.h>
+#include <peersafe/app/table/TableDirectory.h>
 #include <peersafe/rpc/TableUtils.h>
 
 namespace ripple {
@@ -45,14 +46,14 @@ namespace ripple {
 		if (T_GRANT != tx.getFieldU16(sfOpType))  return false;
 		if (!tx.isFieldPresent(sfRaw))            return false;
 		
-		Json::Value jsonRaw;
-		auto sRaw = strCopy(tx.getFieldVL(sfRaw));		
-		if (Json::Reader().parse(sRaw, jsonRaw))
+		auto const pRaw = tx.getRawJson();
+		if (pRaw)
 		{
+			Json::Value const& jsonRaw = *pRaw;
 			if (!jsonRaw.isArray()) return false;
-			for (auto &jsonFlag : jsonRaw)
+			for (auto const& jsonFlag : jsonRaw)
 			{
-				for (Json::Value::iterator it = jsonFlag.begin(); it != jsonFlag.end(); it++)
+				for (Json::Value::const_iterator it = jsonFlag.begin(); it != jsonFlag.end(); it++)
 				{
 					std::string sKey = it.key().asString();
 					TableRoleFlags opType = getOptypeFromString(sKey);
@@ -286,15 +287,14 @@ namespace ripple {
 
             if (tablesle)  //table exist
             {
-                STArray tablentries = tablesle->getFieldArray(sfTableEntries);
-                STEntry const *pEntry = getTableEntry(tablentries, vTableNameStr);
+                auto const pEntry = readTableEntry(view, sourceID, vTableNameStr);
 
                 switch (optype)
                 {
                 case T_CREATE:
                 {
 
-					if (tablentries.size() >= ACCOUNT_OWN_TABLE_COUNT)
+					if (tableCount(view, sourceID) >= ACCOUNT_OWN_TABLE_COUNT)
 						return tefTABLE_COUNTFULL;
 
                     if (pEntry != NULL)                ret = tefTABLE_EXISTANDNOTDEL;
@@ -326,7 +326,7 @@ namespace ripple {
                         break;
                     }
                     Blob vTableNameNewStr = tables[0].getFieldVL(sfTableNewName);
-                    STEntry const *pEntryNew = getTableEntry(tablentries, vTableNameNewStr);
+                    auto const pEntryNew = readTableEntry(view, sourceID, vTableNameNewStr);
 
                     if (pEntry != NULL)
                     {
@@ -343,7 +343,6 @@ namespace ripple {
                 case T_CANCELASSIGN:
                 {
                     //if confidential,for assign operation,tx must contains token field
-                    STEntry const *pEntry = getTableEntry(tablentries, vTableNameStr);
 
                     if (pEntry != NULL)
                     {
@@ -428,8 +427,7 @@ namespace ripple {
 					{
 						return tesSUCCESS;
 					}
-                    STEntry const *pEntry = getTableEntry(tablentries, vTableNameStr);
-                    if (pEntry == NULL)
+                    if (pEntry == nullptr)
                     {
                         return tefTABLE_NOTEXIST;
                     }
@@ -549,12 +547,12 @@ namespace ripple {
 
         // Open a ledger for editing.
         auto id = keylet::table(accountId);
-        auto const tablesle = view.peek(id);
+        auto tablesle = view.peek(id);
 		auto viewJ = app.journal("View");
         if (!tablesle)
 		{
 			//create first table
-            auto const tablesle = std::make_shared<SLE>(
+            tablesle = std::make_shared<SLE>(
                 ltTABLELIST, id.key);
             
             auto result = dirAdd(view, keylet::ownerDir(accountId),
@@ -564,192 +562,190 @@ namespace ripple {
 				return tecDIR_FULL;
 			(*tablesle)[sfOwnerNode] = *result;
 
-			STArray tablentries;
-            STObject obj = generateTableEntry(tx, view);
-            tablentries.push_back(obj);
+			if (!isTableDirectoryEnabled(view))
+			{
+				STArray tablentries;
+				STObject obj = generateTableEntry(tx, view);
+				tablentries.push_back(obj);
 
-            tablesle->setFieldArray(sfTableEntries, tablentries);
+				tablesle->setFieldArray(sfTableEntries, tablentries);
 
-			//add owner count
-			auto const sleAccount = view.peek(keylet::account(accountId));
-			adjustOwnerCount(view, sleAccount, 1, viewJ);
+				//add owner count
+				auto const sleAccount = view.peek(keylet::account(accountId));
+				adjustOwnerCount(view, sleAccount, 1, viewJ);
 
+				view.insert(tablesle);
+				return terResult;
+			}
+
+            tablesle->setFieldArray(sfTableEntries, STArray());
 			view.insert(tablesle);
         }
         else
         {
-            auto &aTableEntries = tablesle->peekFieldArray(sfTableEntries);
-			
-            Blob sTxTableName;
+            terResult = migrateTableEntries(view, accountId);
+            if (!isTesSuccess(terResult))
+                return terResult;
+        }
 
-            auto const & sTxTables = tx.getFieldArray(sfTables);
-            sTxTableName = sTxTables[0].getFieldVL(sfTableName);
+        auto const & sTxTables = tx.getFieldArray(sfTables);
+        Blob vTableNameStr = sTxTables[0].getFieldVL(sfTableName);
 
-            for (auto & table : aTableEntries)
+        auto table = peekTableEntry(view, accountId, vTableNameStr);
+        if (table)
+        {
+            STEntry *pEntry = table.entry;
+            if (pEntry->getFieldU32(sfTxnLgrSeq) != view.info().seq || pEntry->getFieldH256(sfTxnLedgerHash) != view.info().hash)
             {
-                auto str = table.getFieldVL(sfTableName);
-                if (table.getFieldVL(sfTableName) == sTxTableName)
-                {
-                    if (table.getFieldU32(sfTxnLgrSeq) != view.info().seq || table.getFieldH256(sfTxnLedgerHash) != view.info().hash)
-                    {
-                        table.setFieldU32(sfPreviousTxnLgrSeq, table.getFieldU32(sfTxnLgrSeq));
-                        table.setFieldH256(sfPrevTxnLedgerHash, table.getFieldH256(sfTxnLedgerHash));
-                        table.setFieldU32(sfTxnLgrSeq, view.info().seq);
-                        table.setFieldH256(sfTxnLedgerHash, view.info().hash);
-                    }
-                }
+                pEntry->setFieldU32(sfPreviousTxnLgrSeq, pEntry->getFieldU32(sfTxnLgrSeq));
+                pEntry->setFieldH256(sfPrevTxnLedgerHash, pEntry->getFieldH256(sfTxnLedgerHash));
+                pEntry->setFieldU32(sfTxnLgrSeq, view.info().seq);
+                pEntry->setFieldH256(sfTxnLedgerHash, view.info().hash);
             }
+            view.update(table.sle);
+        }
 
-            auto tables = tx.getFieldArray(sfTables);
-            Blob vTableNameStr = tables.begin()->getFieldVL(sfTableName);
-            //add the new tx to the node
-            switch (optype)
-            {
-            case T_CREATE:
-			{
-				//create table (not first one)
-				aTableEntries.push_back(generateTableEntry(tx, view));
+        //add the new tx to the node
+        switch (optype)
+        {
+        case T_CREATE:
+		{
+			terResult = insertTableEntry(view, accountId, generateTableEntry(tx, view));
+			if (!isTesSuccess(terResult))
+				return terResult;
 
-				//add owner count
+			//add owner count
+			auto const sleAccount = view.peek(keylet::account(accountId));
+			adjustOwnerCount(view, sleAccount, 1, viewJ);
+			break;
+		}
+        case T_DROP:
+        {
+			if (isTesSuccess(eraseTableEntry(view, accountId, vTableNameStr)))
+			{
 				auto const sleAccount = view.peek(keylet::account(accountId));
-				adjustOwnerCount(view, sleAccount, 1, viewJ);
-				break;
+				adjustOwnerCount(view, sleAccount, -1, viewJ);
 			}
-            case T_DROP:
-            {
-				auto iter(aTableEntries.end());
-				iter = std::find_if(aTableEntries.begin(), aTableEntries.end(),
-					[vTableNameStr](STObject const &item) {
-					if (!item.isFieldPresent(sfTableName))  return false;
-
-					return item.getFieldVL(sfTableName) == vTableNameStr;
-				});
-
-				if (iter != aTableEntries.end())
-				{
-					aTableEntries.erase(iter);
-
-					auto const sleAccount = view.peek(keylet::account(accountId));
-					adjustOwnerCount(view, sleAccount, -1, viewJ);
-				}
 
-                break;
-            }
-            case  T_RENAME:
+            break;
+        }
+        case  T_RENAME:
+        {
+            if (table)
             {
-				STEntry  *pEntry = getTableEntry(aTableEntries, vTableNameStr);
-                if (pEntry)
+                ripple::Blob tableNewName;
+                if (sTxTables[0].isFieldPresent(sfTableNewName))
                 {
-                    ripple::Blob tableNewName;
-                    if (sTxTables[0].isFieldPresent(sfTableNewName))
-                    {
-                        tableNewName = sTxTables[0].getFieldVL(sfTableNewName);
-                    }
-                    pEntry->setFieldVL(sfTableName, tableNewName);
+                    tableNewName = sTxTables[0].getFieldVL(sfTableNewName);
                 }
-                break;
+                terResult = renameTableEntry(view, accountId, vTableNameStr, tableNewName);
+                if (!isTesSuccess(terResult))
+                    return terResult;
             }
-            case T_ASSIGN:
-            case T_CANCELASSIGN:
-			case T_GRANT:			
+            break;
+        }
+        case T_ASSIGN:
+        case T_CANCELASSIGN:
+		case T_GRANT:			
+        {
+			if (tx.isCrossChainUpload())
+			{
+				return tesSUCCESS;
+			}
+			uint32_t uAdd = 0, uCancel = 0;
+			getGrantFlag(tx, uAdd, uCancel);
+			STEntry  *pEntry = table.entry;
             {
-				if (tx.isCrossChainUpload())
-				{
-					return tesSUCCESS;
-				}
-				uint32_t uAdd = 0, uCancel = 0;
-				getGrantFlag(tx, uAdd, uCancel);
-				STEntry  *pEntry = getTableEntry(aTableEntries, vTableNameStr);
+                if (pEntry->isFieldPresent(sfUsers))
                 {
-                    if (pEntry->isFieldPresent(sfUsers))
+                    auto& users = pEntry->peekFieldArray(sfUsers);
+
+                    if (tx.isFieldPresent(sfUser))
                     {
-                        auto& users = pEntry->peekFieldArray(sfUsers);
+                        auto  addUserID = tx.getAccountID(sfUser);
 
-                        if (tx.isFieldPresent(sfUser))
+                        bool isSameUser = false;
+						uint32_t finalFlag = lsfNone;
+                        for (auto & user : users)  //check if there same user
                         {
-                            auto  addUserID = tx.getAccountID(sfUser);
-
-                            bool isSameUser = false;
-							uint32_t finalFlag = lsfNone;
-                            for (auto & user : users)  //check if there same user
+                            auto userID = user.getAccountID(sfUser);
+                            if (userID == addUserID)
                             {
-                                auto userID = user.getAccountID(sfUser);
-                                if (userID == addUserID)
-                                {
-                                    isSameUser = true;
+                                isSameUser = true;
 
-									auto newFlags = user.getFieldU32(sfFlags);
-                                    if (optype == T_ASSIGN)
-                                    {                                        
-                                        if (tx.isFieldPresent(sfFlags))
-                                        {
-                                            newFlags = newFlags | tx.getFieldU32(sfFlags); //add auth of this user                                            
-                                        }
+								auto newFlags = user.getFieldU32(sfFlags);
+                                if (optype == T_ASSIGN)
+                                {                                        
+                                    if (tx.isFieldPresent(sfFlags))
+                                    {
+                                        newFlags = newFlags | tx.getFieldU32(sfFlags); //add auth of this user                                            
                                     }
-									else if (optype == T_CANCELASSIGN)
-									{										
-										if (tx.isFieldPresent(sfFlags))
-										{
-											newFlags = newFlags & (~tx.getFieldU32(sfFlags));   //cancel auth of this user											
-										}
-									}
-									else   //grant optype
-									{
-										newFlags |= uAdd;
-										newFlags &= ~uCancel;
-									}
-									finalFlag = newFlags;
-									user.setFieldU32(sfFlags, newFlags);
-									break;
                                 }
-                            }
-                            if (!isSameUser)  //mean that there no same user
-                            {
-                                // optype must be Auth(preclaim assure that),just add a new user
-                                STObject obj_user(sfUser);
-                                if (tx.isFieldPresent(sfUser))
-                                    obj_user.setAccountID(sfUser, tx.getAccountID(sfUser));
-								if(optype == T_ASSIGN)
-								{
+								else if (optype == T_CANCELASSIGN)
+								{										
 									if (tx.isFieldPresent(sfFlags))
 									{
-										finalFlag = tx.getFieldU32(sfFlags);										
+										newFlags = newFlags & (~tx.getFieldU32(sfFlags));   //cancel auth of this user											
 									}
 								}
-                                else if (optype == T_CANCELASSIGN)
-                                {
-                                    finalFlag = lsfNone;
-                                }
-								else
+								else   //grant optype
 								{
-									finalFlag = (uAdd & ~uCancel);									
+									newFlags |= uAdd;
+									newFlags &= ~uCancel;
 								}
-                                obj_user.setFieldU32(sfFlags, finalFlag);
-
-								if (tx.isFieldPresent(sfToken))
-									obj_user.setFieldVL(sfToken,tx.getFieldVL(sfToken));
-                                users.push_back(obj_user);
-							}
+								finalFlag = newFlags;
+								user.setFieldU32(sfFlags, newFlags);
+								break;
+                            }
                         }
+                        if (!isSameUser)  //mean that there no same user
+                        {
+                            // optype must be Auth(preclaim assure that),just add a new user
+                            STObject obj_user(sfUser);
+                            if (tx.isFieldPresent(sfUser))
+                                obj_user.setAccountID(sfUser, tx.getAccountID(sfUser));
+							if(optype == T_ASSIGN)
+							{
+								if (tx.isFieldPresent(sfFlags))
+								{
+									finalFlag = tx.getFieldU32(sfFlags);										
+								}
+							}
+                            else if (optype == T_CANCELASSIGN)
+                            {
+                                finalFlag = lsfNone;
+                            }
+							else
+							{
+								finalFlag = (uAdd & ~uCancel);									
+							}
+                            obj_user.setFieldU32(sfFlags, finalFlag);
+
+							if (tx.isFieldPresent(sfToken))
+								obj_user.setFieldVL(sfToken,tx.getFieldVL(sfToken));
+                            users.push_back(obj_user);
+						}
                     }
                 }
-                break;
-            }
-            case T_RECREATE:
-            {
-                STEntry  *pEntry = getTableEntry(aTableEntries, vTableNameStr);
-                LedgerIndex createLgrSeq = view.info().seq; createLgrSeq--;
-                ripple::uint256 createdLedgerHash = view.info().hash; createdLedgerHash--;
-                ripple::uint256 createdTxnHash = tx.getTransactionID();
-                UpdateTableSle(pEntry, createLgrSeq, createdLedgerHash, createdTxnHash);
-                break;
             }
-            default:
-                break;
-            }
-           
-			view.update(tablesle);
+            view.update(table.sle);
+            break;
+        }
+        case T_RECREATE:
+        {
+            STEntry  *pEntry = table.entry;
+            LedgerIndex createLgrSeq = view.info().seq; createLgrSeq--;
+            ripple::uint256 createdLedgerHash = view.info().hash; createdLedgerHash--;
+            ripple::uint256 createdTxnHash = tx.getTransactionID();
+            UpdateTableSle(pEntry, createLgrSeq, createdLedgerHash, createdTxnHash);
+            view.update(table.sle);
+            break;
         }
+        default:
+            break;
+        }
+       
+		view.update(tablesle);
         return terResult;
     }
 
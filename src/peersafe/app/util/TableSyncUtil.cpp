@@ -1,5 +1,12 @@
 
 #include <peersafe/app/util/TableSyncUtil.h>
+#include <peersafe/app/table/TableDirectory.h>
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/PendingSaves.h>
+#include <ripple/app/main/Application.h>
+#include <ripple/core/DatabaseCon.h>
+#include <ripple/core/SociDB.h>
+#include <ripple/json/json_reader.h>
 namespace ripple{
 
 uint256 TableSyncUtil::GetChainId(const ReadView * pView)
@@ -14,12 +21,11 @@ uint256 TableSyncUtil::GetChainId(const ReadView * pView)
 	return chainId;
 }
 
-std::pair<bool, STEntry*> TableSyncUtil::IsTableSLEChanged(const STArray& aTables, LedgerIndex iLastSeq, AccountID accountID, std::string sTableName, bool bStrictEqual)
+std::pair<bool, std::shared_ptr<STEntry const>> TableSyncUtil::IsTableSLEChanged(ReadView const& view, LedgerIndex iLastSeq, AccountID accountID, std::string sTableName, bool bStrictEqual)
 {
-	auto iter(aTables.end());
 	bool bTableFound = false;
-	iter = std::find_if(aTables.begin(), aTables.end(),
-		[iLastSeq, accountID, sTableName, bStrictEqual, &bTableFound](STObject const &item) {
+	auto pEntry = findTableEntry(view, accountID,
+		[iLastSeq, &sTableName, bStrictEqual, &bTableFound](STEntry const &item) {
 		uint160 uTxDBName = item.getFieldH160(sfNameInDB);
 		if (to_string(uTxDBName) == sTableName) {
 			bTableFound = true;
@@ -29,9 +35,80 @@ std::pair<bool, STEntry*> TableSyncUtil::IsTableSLEChanged(const STArray& aTable
 		}
 		return false;
 	});
-	if (iter == aTables.end())
-		return std::make_pair(bTableFound, nullptr);
-	else
-		return std::make_pair(bTableFound, (STEntry*)(&(*iter)));
+	return std::make_pair(bTableFound, pEntry);
+}
+
+std::vector<std::string> TableSyncUtil::GetTxTableNames(STTx const& tx)
+{
+	std::vector<std::string> names;
+	if (!tx.isChainSqlBaseType())
+		return names;
+
+	if (tx.getTxnType() == ttSQLTRANSACTION)
+	{
+		Blob txs_blob = tx.getFieldVL(sfStatements);
+		std::string txs_str(txs_blob.begin(), txs_blob.end());
+		Json::Value objs;
+		Json::Reader().parse(txs_str, objs);
+
+		for (auto const& obj : objs)
+		{
+			auto const& sTxTable = obj["Tables"][0u]["Table"];
+			if (!sTxTable.isObject() || !sTxTable.isMember("NameInDB"))
+				continue;
+			// same form as the sfTables branch, hex case may differ in the json
+			uint160 uNameInDB;
+			if (!uNameInDB.SetHexExact(sTxTable["NameInDB"].asString()))
+				continue;
+			auto sName = to_string(uNameInDB);
+			if (std::find(names.begin(), names.end(), sName) == names.end())
+				names.push_back(sName);
+		}
+	}
+	else if (tx.isFieldPresent(sfTables))
+	{
+		auto const& tables = tx.getFieldArray(sfTables);
+		if (!tables.empty() && tables[0].isFieldPresent(sfNameInDB))
+			names.push_back(to_string(tables[0].getFieldH160(sfNameInDB)));
+	}
+	return names;
+}
+
+// Ledgers saved before the index existed are not in it, it is only used
+// from the first ledger saved with it. A ledger still being saved may not
+// be in it yet either, the answer stops short of it.
+boost::optional<LedgerIndex> TableSyncUtil::NextTableTxLedger(Application& app, std::string const& sNameInDB, LedgerIndex iFrom, LedgerIndex iTo)
+{
+	if (iFrom > iTo)
+		return boost::none;
+
+	boost::optional<std::uint64_t> startSeq;
+	boost::optional<std::uint64_t> nextSeq;
+	{
+		auto db = app.getTxnDB().checkoutDb();
+		*db << "SELECT StartSeq FROM TableTxIndexState;", soci::into(startSeq);
+		if (!startSeq || iFrom < *startSeq)
+			return boost::none;
+
+		std::uint64_t from = iFrom;
+		std::uint64_t to = iTo;
+		*db << "SELECT MIN(LedgerSeq) FROM TableTransactions "
+			"WHERE NameInDB = :name AND LedgerSeq >= :from AND LedgerSeq <= :to;",
+			soci::use(sNameInDB), soci::use(from), soci::use(to),
+			soci::into(nextSeq);
+	}
+
+	LedgerIndex iNext = nextSeq ? static_cast<LedgerIndex>(*nextSeq) : iTo + 1;
+	for (auto const& save : app.pendingSaves().getSnapshot())
+	{
+		if (save.first >= iFrom && save.first < iNext)
+		{
+			iNext = save.first;
+			break;
+		}
+	}
+	if (iNext > iFrom && !app.getLedgerMaster().haveLedger(iFrom, iNext - 1))
+		return boost::none;
+	return iNext;
+}
 }
-}
\ No newline at end of file
@@ -20,14 +20,26 @@ along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
 #define RIPPLE_RPC_TABLE_SYNC_UTIL_H_INCLUDED
 
 #include <ripple/ledger/ReadView.h>
+#include <ripple/protocol/STTx.h>
 #include <peersafe/protocol/STEntry.h>
+#include <boost/optional.hpp>
+#include <memory>
+#include <vector>
 
 namespace ripple {
+	class Application;
+
 	//table sync tool class
 	class TableSyncUtil {
 	public:
 		static uint256 GetChainId(const ReadView * pView);
-		static std::pair<bool, STEntry*> IsTableSLEChanged(const STArray& aTables, LedgerIndex iLastSeq, AccountID accountID, std::string sTableName, bool bStrictEqual);
+		static std::pair<bool, std::shared_ptr<STEntry const>> IsTableSLEChanged(ReadView const& view, LedgerIndex iLastSeq, AccountID accountID, std::string sTableName, bool bStrictEqual);
+
+		//nameInDB of the tables a chainsql tx is synchronized with
+		static std::vector<std::string> GetTxTableNames(STTx const& tx);
+		//first ledger in [iFrom, iTo] with a tx of the table in TableTransactions,
+		//iTo + 1 if there is none, boost::none if the index does not cover iFrom
+		static boost::optional<LedgerIndex> NextTableTxLedger(Application& app, std::string const& sNameInDB, LedgerIndex iFrom, LedgerIndex iTo);
 	};
 }
 
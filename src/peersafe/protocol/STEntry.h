@@ -52,9 +52,9 @@ namespace ripple {
 
 		std::string getOperationRule(TableOpType opType) const;
 
-		bool hasAuthority(const AccountID& account, TableRoleFlags flag);
+		bool hasAuthority(const AccountID& account, TableRoleFlags flag) const;
 
-		bool isConfidential();
+		bool isConfidential() const;
 
         STBase*
             copy(std::size_t n, void* buf) const override
@@ -118,7 +118,7 @@ namespace ripple {
 		return ret;
 	}
 
-	bool STEntry::hasAuthority(const AccountID& account, TableRoleFlags flag)
+	bool STEntry::hasAuthority(const AccountID& account, TableRoleFlags flag) const
 	{
 		//check the authority
 		auto const & aUsers(getFieldArray(sfUsers));
@@ -142,7 +142,7 @@ namespace ripple {
 		return bAllGrant;
 	}
 
-	bool STEntry::isConfidential()
+	bool STEntry::isConfidential() const
 	{
 		auto const & aUsers(getFieldArray(sfUsers));
 		if (aUsers.size() > 0 && aUsers[0].isFieldPresent(sfToken))
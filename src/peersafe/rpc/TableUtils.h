@@ -23,6 +23,8 @@
 
 #include <ripple/json/json_value.h>
 #include <peersafe/protocol/STEntry.h>
+#include <boost/optional.hpp>
+#include <tuple>
 
 namespace ripple {
 
@@ -31,6 +33,11 @@ namespace ripple {
 	STEntry *getTableEntry(ApplyView& view, const STTx& tx);
 	STEntry *getTableEntry(const STArray & aTables, Blob& vCheckName);
 	bool isChainSqlBaseType(const std::string& transactionType);
+
+	// The marker of the next page of an r_get: the row offset, the hash of the
+	// query and the ledger position of its tables, to catch a changed table.
+	Json::Value makeRecordMarker(std::size_t offset, uint256 const& queryHash, LedgerIndex position);
+	boost::optional<std::tuple<std::size_t, uint256, LedgerIndex>> parseRecordMarker(Json::Value const& marker);
 }
 
 #endif
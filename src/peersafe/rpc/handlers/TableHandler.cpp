@@ -29,9 +29,13 @@
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/json/json_reader.h>
 #include <ripple/protocol/SecretKey.h>
+#include <ripple/protocol/Serializer.h>
+#include <ripple/protocol/digest.h>
+#include <ripple/basics/StringUtilities.h>
 #include <ripple/app/main/Application.h>
 #include <peersafe/app/storage/TableStorage.h> 
 #include <peersafe/app/sql/TxStore.h>
+#include <peersafe/app/sql/TxStoreReadPool.h>
 #include <peersafe/rpc/impl/TableAssistant.h>
 #include <peersafe/rpc/TableUtils.h>
 #include <peersafe/app/table/TableStatusDB.h>
@@ -42,7 +46,11 @@ namespace ripple {
 
 #define MAX_DIFF_TOLERANCE 3
 
+// rows in one websocket message of a streamed r_get
+static std::size_t const STREAM_CHUNK_ROWS = 256;
+
 void buildRaw(Json::Value& condition, std::string& rule);
+LedgerIndex getTxnPosition(TableStatusDB* pStatus, const std::vector<ripple::uint160>& vec);
 int getDiff(RPC::Context& context, const std::vector<ripple::uint160>& vec);
 
 //from rpc or http
@@ -170,9 +178,14 @@ Json::Value doGetRecord(RPC::Context&  context)
 	JLOG(j.debug())
 		<< "get record from tables: " << tx_json.toStyledString();
 
+    // table entries come from the cache of the validated ledger
+    auto ledger = context.ledgerMaster.getValidatedLedger();
+    auto& tableEntries = context.ledgerMaster.getTableEntryCache();
+
     uint160 nameInDB;
 	std::vector<ripple::uint160> vecNameInDB;
     std::list<std::string> listTableName;
+    std::shared_ptr<STEntry const> pFirstEntry;
 	for (Json::UInt idx = 0; idx < tables_json.size(); idx++) {
 		Json::Value& e = tables_json[idx];
         if (!e.isObject()) 
@@ -195,13 +208,20 @@ Json::Value doGetRecord(RPC::Context&  context)
             return ret;
         }
 
-		auto nameInDBGot = context.ledgerMaster.getNameInDB(context.ledgerMaster.getValidLedgerIndex(), *ownerID, v["TableName"].asString());
+		std::shared_ptr<STEntry const> pEntry;
+		if (ledger)
+			pEntry = tableEntries.fetch(*ledger, *ownerID, tn.asString());
+		ripple::uint160 nameInDBGot;
+		if (pEntry)
+			nameInDBGot = pEntry->getFieldH160(sfNameInDB);
 		if (!nameInDBGot)
 		{
 			ret[jss::error] = "can't get TableName in DB ,please check field tablename!";
 			return ret;
 		}
         listTableName.push_back(v["TableName"].asString());
+        if (!pFirstEntry)
+            pFirstEntry = pEntry;
         // NameInDB is optional
 		if (v.isMember("NameInDB")) 
 		{
@@ -244,12 +264,8 @@ Json::Value doGetRecord(RPC::Context&  context)
     }
 
 	std::string rule;
-	auto ledger = context.ledgerMaster.getValidatedLedger();
 	if (ledger)
 	{
-		auto id = keylet::table(*ownerID);
-		auto const tablesle = ledger->read(id);
-
 		//judge if account is activated
 		auto key = keylet::account(*accountID);
 		if (!ledger->exists(key))
@@ -258,13 +274,8 @@ Json::Value doGetRecord(RPC::Context&  context)
 			return ret;
 		}
 
-		if (tablesle)
-		{
-			auto aTableEntries = tablesle->getFieldArray(sfTableEntries);
-			STEntry* pEntry = getTableEntry(aTableEntries,listTableName.front());
-			if (pEntry)
-				rule = pEntry->getOperationRule(R_GET);
-		}
+		if (pFirstEntry)
+			rule = pFirstEntry->getOperationRule(R_GET);
 	}
 	if (rule != "") 
 	{
@@ -334,15 +345,113 @@ Json::Value doGetRecord(RPC::Context&  context)
 
 	Json::Value result;
 	TxStore* pTxStore = &context.app.getTxStore();
+	std::shared_ptr<TableStorageItem> pItem;
+	TableStorageExecutor::Hold hold;
 	if (tables_json.size() == 1)//getTableStorage first_storage related
-		pTxStore = &context.app.getTableStorage().GetTxStore(nameInDB);
+		pTxStore = &context.app.getTableStorage().GetTxStore(nameInDB, pItem, hold);
 
 	//db connection is null
 	if (pTxStore->getDatabaseCon() == nullptr)
 		return rpcError(rpcNODB);
 
-	result = pTxStore->txHistory(context);
+	// tables under first_storage are read through the transaction holding
+	// their writes, the others may go to a replica that is not too stale
+	TableStatusDB* pStatus = nullptr;
+	LedgerIndex watermark = 0;
+	if (context.app.getTxStoreDBConn().GetDBConn() != nullptr &&
+		context.app.getTxStoreDBConn().GetDBConn()->getSession().get_backend() != nullptr)
+	{
+		pStatus = &context.app.getTableStatusDB();
+		watermark = TxStoreReadPool::watermark(*pStatus, vecNameInDB);
+		if (pTxStore == &context.app.getTxStore())
+		{
+			auto const reader = context.app.getTxStoreReadPool().checkout(
+				vecNameInDB, watermark);
+			if (reader)
+			{
+				pTxStore = reader.txStore;
+				pStatus = reader.status;
+				watermark = reader.watermark;
+			}
+		}
+	}
+
+	TxStore::QueryPage page;
+	auto const rowsMax = pTxStore->getQueryRowsMax();
+	bool const bStream = context.params[jss::stream].asBool();
+	if (bStream && !context.infoSub)
+	{
+		ret[jss::error] = "field stream is only supported by websocket!";
+		return ret;
+	}
+	if (context.params.isMember(jss::limit))
+	{
+		Json::Value const& limit = context.params[jss::limit];
+		if (!limit.isIntegral() || limit.asInt() <= 0)
+		{
+			ret[jss::error] = "field limit is not a positive integer!";
+			return ret;
+		}
+		page.limit = limit.asUInt();
+	}
+	// rows are held in memory only a chunk at a time when streaming
+	if (!bStream && rowsMax > 0 && (page.limit == 0 || page.limit > rowsMax))
+		page.limit = rowsMax;
+
+	// the marker is only good for the same query against the same
+	// ledger position of the tables
+	std::string sQuery = tx_json["Owner"].asString() + tx_json["Account"].asString();
+	for (auto const& nameInDB : vecNameInDB)
+		sQuery += to_string(nameInDB);
+	sQuery += tx_json["Raw"].asString();
+	uint256 const queryHash = sha512Half(makeSlice(sQuery));
+	LedgerIndex const position = getTxnPosition(pStatus, vecNameInDB);
+	if (context.params.isMember(jss::marker))
+	{
+		auto const marker = parseRecordMarker(context.params[jss::marker]);
+		if (!marker)
+		{
+			ret[jss::error] = "field marker is not valid!";
+			return ret;
+		}
+		if (std::get<1>(*marker) != queryHash)
+		{
+			ret[jss::error] = "field marker does not belong to this query!";
+			return ret;
+		}
+		if (std::get<2>(*marker) != position)
+		{
+			ret[jss::error] = "field marker is out of date, the table has been changed!";
+			return ret;
+		}
+		page.offset = std::get<0>(*marker);
+	}
+
+	if (bStream)
+	{
+		page.chunk = rowsMax > 0 ? std::min(rowsMax, STREAM_CHUNK_ROWS) : STREAM_CHUNK_ROWS;
+		page.onChunk = [&context](Json::Value const& lines)
+		{
+			Json::Value jvObj(Json::objectValue);
+			jvObj[jss::type] = "table_rows";
+			if (context.params.isMember(jss::id))
+				jvObj[jss::id] = context.params[jss::id];
+			jvObj[jss::lines] = lines;
+			context.infoSub->send(jvObj, true);
+		};
+	}
+
+	result = pTxStore->txHistory(tx_json, page);
+	if (page.limit > 0 && !result.isMember(jss::error))
+		result[jss::limit] = Json::UInt(page.limit);
+	if (page.more)
+	{
+		result[jss::marker] = makeRecordMarker(
+			page.offset + page.limit, queryHash, position);
+	}
 
+	//the ledger the rows are consistent with
+	result[jss::watermark] = watermark;
 	//diff between the latest ledgerseq in db and the real newest ledgerseq
 	result[jss::diff] = getDiff(context, vecNameInDB);;
 
@@ -503,4 +612,52 @@ int getDiff(RPC::Context& context, const std::vector<ripple::uint160>& vec)
 	return diff <= MAX_DIFF_TOLERANCE ? 0 : diff;
 }
 
+// the newest ledger that changed any of the tables in db
+LedgerIndex getTxnPosition(TableStatusDB* pStatus, const std::vector<ripple::uint160>& vec)
+{
+	LedgerIndex position = 0;
+	LedgerIndex txnseq, seq;
+	uint256 txnhash, hash, txnupdatehash;
+	if (pStatus == nullptr)
+		return position;
+	for (auto iter = vec.begin(); iter != vec.end(); iter++)
+	{
+		if (pStatus->ReadSyncDB(to_string(*iter), txnseq, txnhash, seq, hash, txnupdatehash))
+			position = std::max(position, txnseq);
+	}
+	return position;
+}
+
+Json::Value makeRecordMarker(std::size_t offset, uint256 const& queryHash, LedgerIndex position)
+{
+	Serializer s;
+	s.add64(offset);
+	s.add256(queryHash);
+	s.add32(position);
+	return strHex(s.peekData());
+}
+
+boost::optional<std::tuple<std::size_t, uint256, LedgerIndex>> parseRecordMarker(Json::Value const& marker)
+{
+	if (!marker.isString())
+		return boost::none;
+	auto const data = strUnHex(marker.asString());
+	if (!data.second)
+		return boost::none;
+	try
+	{
+		SerialIter sit(makeSlice(data.first));
+		auto const offset = sit.get64();
+		auto const queryHash = sit.get256();
+		auto const position = sit.get32();
+		if (!sit.empty())
+			return boost::none;
+		return std::make_tuple(static_cast<std::size_t>(offset), queryHash, position);
+	}
+	catch (std::exception const&)
+	{
+		return boost::none;
+	}
+}
+
 } // ripple
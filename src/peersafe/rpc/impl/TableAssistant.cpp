@@ -59,11 +59,18 @@ TableAssistant::TableAssistant(Application& app, Config& cfg, beast::Journal jou
 	bTableCheckHashThread_ = false;
 }
 
+TableAssistant::checkStripe& TableAssistant::GetStripe(uint160 const& nameInDB)
+{
+	//nameInDB is a hash,its first byte spreads tables evenly
+	return stripes_[*nameInDB.begin() % checkStripes];
+}
+
 uint256 TableAssistant::getCheckHash(uint160 nameInDB)
 {	
-	std::lock_guard<std::mutex> lock(mutexMap_);
-	auto it = m_map.find(nameInDB);
-	if (it != m_map.end())
+	auto& stripe = GetStripe(nameInDB);
+	std::lock_guard<std::mutex> lock(stripe.mutex);
+	auto it = stripe.map.find(nameInDB);
+	if (it != stripe.map.end())
 		return it->second->uTxCheckHash;
 	else
 		return beast::zero;
@@ -180,15 +187,15 @@ bool TableAssistant::PutOne(STTx const& tx, const uint256 &uHash)
 
 	pTx->bStrictMode = tx.isFieldPresent(sfTxCheckHash);
 
-	std::lock_guard<std::mutex> lock(mutexMap_);
-
 	uint256 hashNew;
     if (tx.isFieldPresent(sfTables))
     {
         auto const & sTxTables = tx.getFieldArray(sfTables);
         uint160 uTxDBName = sTxTables[0].getFieldH160(sfNameInDB);
-        auto it = m_map.find(uTxDBName);
-        if (it == m_map.end())
+        auto& stripe = GetStripe(uTxDBName);
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        auto it = stripe.map.find(uTxDBName);
+        if (it == stripe.map.end())
         {
             std::string sTxTableName = strCopy(sTxTables[0].getFieldVL(sfTableName));
             ripple::AccountID ownerID;
@@ -217,7 +224,7 @@ bool TableAssistant::PutOne(STTx const& tx, const uint256 &uHash)
             pTx->uTxCheckHash = hashNew;
             pCheck->listTx.push_back(pTx);
 
-            auto iter_pair = m_map.insert(std::make_pair(uTxDBName, pCheck));
+            auto iter_pair = stripe.map.insert(std::make_pair(uTxDBName, pCheck));
             assert(iter_pair.second);
             return iter_pair.second;
         }
@@ -247,17 +254,25 @@ void TableAssistant::TryTableCheckHash()
 
 void TableAssistant::TableCheckHashThread()
 {
-	std::lock_guard<std::mutex> lock(mutexMap_);
+	//one stripe at a time,Put on the others goes on meanwhile
+	for (auto& stripe : stripes_)
+		CheckStripe(stripe);
+	bTableCheckHashThread_ = false;
+}
+
+void TableAssistant::CheckStripe(checkStripe& stripe)
+{
+	std::lock_guard<std::mutex> lock(stripe.mutex);
 	auto ledger = app_.getLedgerMaster().getValidatedLedger();
-	auto iter = m_map.begin();
-	while (iter != m_map.end())
+	auto iter = stripe.map.begin();
+	while (iter != stripe.map.end())
 	{
 		auto sleHashRet = app_.getLedgerMaster().getLatestTxCheckHash(iter->second->accountID, iter->second->sTableName);
 		auto &uCheckHash = sleHashRet.first;
 
         if (uCheckHash.isZero())
         {
-            iter = m_map.erase(iter);
+            iter = stripe.map.erase(iter);
             continue;
         }
 
@@ -319,7 +334,7 @@ void TableAssistant::TableCheckHashThread()
 			duration_type time_span = std::chrono::duration_cast<duration_type>(now - iter->second->timer);
 			if (time_span.count() > EXPIRE_TIME)
 			{
-				iter = m_map.erase(iter);
+				iter = stripe.map.erase(iter);
 			}
 			else
 			{				
@@ -327,7 +342,6 @@ void TableAssistant::TableCheckHashThread()
 			}
 		}
 	}
-	bTableCheckHashThread_ = false;
 }
 
 }
@@ -25,11 +25,14 @@
 #include <ripple/protocol/Protocol.h>
 #include <ripple/protocol/AccountID.h>
 #include <ripple/beast/utility/Journal.h>
+#include <ripple/basics/UnorderedContainers.h>
+#include <array>
 #include <utility>
 #include <string>
 #include <map>
 #include <list>
 #include <chrono>
+#include <mutex>
 
 namespace ripple {
 
@@ -76,8 +79,20 @@ namespace ripple {
 
 		uint256 getCheckHash(uint160 nameInDB);
 	private:
+		//tables are spread over stripes with a lock each,
+		//so that Put on different tables doesn't contend
+		static std::size_t const checkStripes = 16;
+		typedef struct
+		{
+			std::mutex											mutex;
+			//key:nameInDB
+			hash_map<uint160, std::shared_ptr<checkInfo>>		map;
+		}checkStripe;
+
 		bool PutOne(STTx const& tx, const uint256 &uHash);
 		void TableCheckHashThread();
+		void CheckStripe(checkStripe& stripe);
+		checkStripe& GetStripe(uint160 const& nameInDB);
         Config& GetConfig() {return cfg_;}
 
 	private:
@@ -85,10 +100,7 @@ namespace ripple {
 		beast::Journal										journal_;
 		Config&												cfg_;
 
-		//key:nameInDB
-		std::map<uint160, std::shared_ptr<checkInfo>>		m_map;
-
-		std::mutex											mutexMap_;
+		std::array<checkStripe, checkStripes>				stripes_;
 		bool												bTableCheckHashThread_;
 
 	};
@@ -20,6 +20,7 @@
 #include <ripple/protocol/JsonFields.h>
 #include <ripple/basics/StringUtilities.h>
 #include <peersafe/rpc/TableUtils.h>
+#include <peersafe/app/table/TableDirectory.h>
 
 namespace ripple {
 
@@ -88,19 +89,12 @@ namespace ripple {
 			account = tx.getAccountID(sfAccount);
 		else
 			return NULL;
-		auto const k = keylet::table(account);
-		SLE::pointer pTableSle = view.peek(k);
-		if (pTableSle == NULL)
-			return NULL;
-
-		auto &aTableEntries = pTableSle->peekFieldArray(sfTableEntries);
-
 		if (!tx.isFieldPresent(sfTables))
 			return NULL;
 		auto const & sTxTables = tx.getFieldArray(sfTables);
 		Blob vTxTableName = sTxTables[0].getFieldVL(sfTableName);
-		uint160 uTxDBName = sTxTables[0].getFieldH160(sfNameInDB);
-		return getTableEntry(aTableEntries, vTxTableName);
+		// the entry stays valid while the view holds the ledger entry
+		return peekTableEntry(view, account, vTxTableName).entry;
 	}
 
 	bool isChainSqlBaseType(const std::string& transactionType) {
@@ -31,6 +31,7 @@
 #include <peersafe/rpc/impl/TableAssistant.h>
 #include <peersafe/rpc/TableUtils.h>
 #include <peersafe/app/table/TableSync.h>
+#include <peersafe/app/table/TableDirectory.h>
 
 namespace ripple {
 TxPrepareBase::TxPrepareBase(Application& app, const std::string& secret, const std::string& publickey, Json::Value& tx_json, getCheckHashFunc func, bool ws):
@@ -744,14 +745,8 @@ bool TxPrepareBase::checkConfidentialBase(const AccountID& owner, const std::str
 	auto ledger = app_.getLedgerMaster().getValidatedLedger();
 	if (ledger == NULL)  return false;
 
-	auto id = keylet::table(owner);
-	auto const tablesle = ledger->read(id);
-	if (tablesle == nullptr)
-		return false;
-	auto aTableEntries = tablesle->getFieldArray(sfTableEntries);
-
-	STEntry const *pEntry = getTableEntry(aTableEntries, tableName);
-	if (pEntry != NULL)
+	auto pEntry = readTableEntry(*ledger, owner, tableName);
+	if (pEntry != nullptr)
 	{
 		if (pEntry->isFieldPresent(sfUsers))
 		{
@@ -2,4 +2,8 @@
 
 #include <peersafe/app/sql/SQLConditionTree.cpp>
 #include <peersafe/app/sql/STTx2SQL.cpp>
-#include <peersafe/app/sql/TxStore.cpp>
\ No newline at end of file
+#include <peersafe/app/sql/SQLSchemaCache.cpp>
+#include <peersafe/app/sql/SQLStatementCache.cpp>
+#include <peersafe/app/sql/TxStore.cpp>
+#include <peersafe/app/sql/TxStoreReadPool.cpp>
+#include <peersafe/app/sql/SQLPredicate.cpp>
\ No newline at end of file
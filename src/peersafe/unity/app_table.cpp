@@ -7,6 +7,12 @@
 #include <peersafe/app/table/impl/TableDumpItem.cpp>
 #include <peersafe/app/table/impl/TableAuditItem.cpp>
 #include <peersafe/app/table/impl/TableSync.cpp>
+#include <peersafe/app/table/impl/TableSyncWorkers.cpp>
+#include <peersafe/app/table/impl/TableDirectory.cpp>
+#include <peersafe/app/table/impl/TableEntryCache.cpp>
+#include <peersafe/app/table/impl/TableBulkLoad.cpp>
 #include <peersafe/app/util/TableSyncUtil.cpp>
+#include <peersafe/app/storage/impl/TableStorageExecutor.cpp>
+#include <peersafe/app/storage/impl/TableStorageGroup.cpp>
 #include <peersafe/app/storage/impl/TableStorageItem.cpp>
 #include <peersafe/app/storage/impl/TableStorage.cpp>
\ No newline at end of file
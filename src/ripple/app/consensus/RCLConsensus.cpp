@@ -84,6 +84,9 @@ RCLConsensus::Adaptor::Adaptor(
         , valPublic_{validatorKeys.publicKey}
         , valSecret_{validatorKeys.secretKey}
 {
+    if (app_.config().PARALLEL_APPLY > 1)
+        speculative_ = std::make_unique<SpeculativeApply>(
+            app_, static_cast<int>(app_.config().PARALLEL_APPLY), j_);
 }
 
 boost::optional<RCLCxLedger>
@@ -650,6 +653,7 @@ RCLConsensus::Adaptor::notify(
   @param set            set of transactions to apply
   @param view           ledger to apply to
   @param txFilter       callback, return false to reject txn
+  @param speculative    applies each pass on several threads, or nullptr
   @return               retriable transactions
 */
 
@@ -658,7 +662,8 @@ applyTransactions(
     Application& app,
     RCLTxSet const& cSet,
     OpenView& view,
-    std::function<bool(uint256 const&)> txFilter)
+    std::function<bool(uint256 const&)> txFilter,
+    SpeculativeApply* speculative)
 {
     auto j = app.journal("LedgerConsensus");
 
@@ -692,14 +697,20 @@ applyTransactions(
                         << (certainRetry ? " retriable" : " final");
         int changes = 0;
 
-        auto it = retriableTxs.begin();
-
-        while (it != retriableTxs.end())
+        if (speculative)
         {
-            try
+            std::vector<std::shared_ptr<STTx const>> txs;
+            txs.reserve(retriableTxs.size());
+            for (auto const& item : retriableTxs)
+                txs.push_back(item.second);
+
+            auto const results = speculative->apply(
+                view, txs, certainRetry, tapNO_CHECK_SIGN);
+
+            auto it = retriableTxs.begin();
+            for (auto const result : results)
             {
-                switch (applyTransaction(
-                    app, view, *it->second, certainRetry, tapNO_CHECK_SIGN, j))
+                switch (result)
                 {
                     case ApplyResult::Success:
                         it = retriableTxs.erase(it);
@@ -714,10 +725,41 @@ applyTransactions(
                         ++it;
                 }
             }
-            catch (std::exception const&)
+        }
+        else
+        {
+            auto it = retriableTxs.begin();
+
+            while (it != retriableTxs.end())
             {
-                JLOG(j.warn()) << "Transaction throws";
-                it = retriableTxs.erase(it);
+                try
+                {
+                    switch (applyTransaction(
+                        app,
+                        view,
+                        *it->second,
+                        certainRetry,
+                        tapNO_CHECK_SIGN,
+                        j))
+                    {
+                        case ApplyResult::Success:
+                            it = retriableTxs.erase(it);
+                            ++changes;
+                            break;
+
+                        case ApplyResult::Fail:
+                            it = retriableTxs.erase(it);
+                            break;
+
+                        case ApplyResult::Retry:
+                            ++it;
+                    }
+                }
+                catch (std::exception const&)
+                {
+                    JLOG(j.warn()) << "Transaction throws";
+                    it = retriableTxs.erase(it);
+                }
             }
         }
 
@@ -798,9 +840,13 @@ RCLConsensus::Adaptor::buildLCL(
         {
             // Normal case, we are not replaying a ledger close
             retriableTxs = applyTransactions(
-                app_, set, accum, [&buildLCL](uint256 const& txID) {
+                app_,
+                set,
+                accum,
+                [&buildLCL](uint256 const& txID) {
                     return !buildLCL->txExists(txID);
-                });
+                },
+                speculative_.get());
         }
         // Update fee computations.
         app_.getTxQ().processClosedLedger(app_, accum, roundTime > 5s);
@@ -22,6 +22,7 @@
 #include <ripple/app/ledger/AcceptedLedger.h>
 #include <ripple/app/ledger/InboundLedgers.h>
 #include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/LedgerSaveQueue.h>
 #include <ripple/consensus/LedgerTiming.h>
 #include <ripple/app/ledger/LedgerToJson.h>
 #include <ripple/app/ledger/OrderBookDB.h>
@@ -46,8 +47,10 @@
 #include <ripple/protocol/PublicKey.h>
 #include <ripple/protocol/SecretKey.h>
 #include <ripple/protocol/HashPrefix.h>
+#include <ripple/protocol/TxFormats.h>
 #include <ripple/protocol/types.h>
 #include <ripple/beast/core/LexicalCast.h>
+#include <peersafe/app/util/TableSyncUtil.h>
 #include <boost/optional.hpp>
 #include <cassert>
 #include <utility>
@@ -805,32 +808,49 @@ void Ledger::updateSkipList ()
         rawReplace(sle);
 }
 
-static bool saveValidatedLedger (
-    Application& app,
-    std::shared_ptr<Ledger const> const& ledger,
-    bool current)
+namespace {
+
+// A ledger of a save batch, with its transactions
+struct LedgerToSave
 {
-    auto j = app.journal ("Ledger");
+    std::shared_ptr<Ledger const> ledger;
+    AcceptedLedger::pointer aLedger;
+    bool current;
+};
 
-    if (! app.pendingSaves().startWork (ledger->info().seq))
+// Calls f(first, last) for each run of consecutive sequences
+template <class F>
+void
+forEachSeqRange (std::vector<LedgerToSave> const& batch, F&& f)
+{
+    std::size_t i = 0;
+    while (i < batch.size ())
     {
-        // The save was completed synchronously
-        JLOG (j.debug()) << "Save aborted";
-        return true;
+        auto const first = batch[i].ledger->info().seq;
+        auto last = first;
+        while (++i < batch.size () &&
+            batch[i].ledger->info().seq == last + 1)
+        {
+            ++last;
+        }
+        f (first, last);
     }
+}
+
+} // namespace
 
-    // TODO(tom): Fix this hard-coded SQL!
+// Checks a ledger, stores its header in the node store and gets its
+// accepted transactions. Returns false if the ledger can't be saved.
+static bool prepareLedgerSave (
+    Application& app,
+    std::shared_ptr<Ledger const> const& ledger,
+    bool current,
+    AcceptedLedger::pointer& aLedger,
+    beast::Journal j)
+{
     JLOG (j.trace())
         << "saveValidatedLedger "
         << (current ? "" : "fromAcquire ") << ledger->info().seq;
-    static boost::format deleteLedger (
-        "DELETE FROM Ledgers WHERE LedgerSeq = %u;");
-    static boost::format deleteTrans1 (
-        "DELETE FROM Transactions WHERE LedgerSeq = %u;");
-    static boost::format deleteTrans2 (
-        "DELETE FROM AccountTransactions WHERE LedgerSeq = %u;");
-    static boost::format deleteAcctTrans (
-        "DELETE FROM AccountTransactions WHERE TransID = '%s';");
 
     auto seq = ledger->info().seq;
 
@@ -861,8 +881,6 @@ static bool saveValidatedLedger (
             hotLEDGER, std::move (s.modData ()), ledger->info().hash);
     }
 
-
-    AcceptedLedger::pointer aLedger;
     try
     {
         aLedger = app.getAcceptedLedgerCache().fetch (ledger->info().hash);
@@ -876,75 +894,115 @@ static bool saveValidatedLedger (
     {
         JLOG (j.warn()) << "An accepted ledger was missing nodes";
         app.getLedgerMaster().failedSave(seq, ledger->info().hash);
-        // Clients can now trust the database for information about this
-        // ledger sequence.
-        app.pendingSaves().finishWork(seq);
         return false;
     }
+    return true;
+}
 
+// Writes the transactions of a batch with one database transaction.
+static void saveLedgerTransactions (
+    Application& app,
+    std::vector<LedgerToSave> const& batch,
+    beast::Journal j)
+{
+    static std::string const deleteAcctTrans (
+        "DELETE FROM AccountTransactions WHERE TransID = :transID;");
+    static std::string const addAcctTrans (
+        R"sql(INSERT INTO AccountTransactions
+            (TransID, Account, LedgerSeq, TxnSeq)
+        VALUES
+            (:transID, :account, :ledgerSeq, :txnSeq);)sql");
+    static std::string const addTrans (
+        R"sql(INSERT OR REPLACE INTO Transactions
+            (TransID, TransType, FromAcct, FromSeq, LedgerSeq, Status,
+            RawTxn, TxnMeta)
+        VALUES
+            (:transID, :transType, :fromAcct, :fromSeq, :ledgerSeq,
+            :status, :rawTxn, :txnMeta);)sql");
+    static std::string const addTableTrans (
+        R"sql(INSERT INTO TableTransactions
+            (NameInDB, LedgerSeq, TxnSeq, TransID)
+        VALUES
+            (:nameInDB, :ledgerSeq, :txnSeq, :transID);)sql");
+
+    // Rows of the per account and per table indexes, bound as
+    // vectors and written with one execute per table.
+    std::vector<std::string> txnIDs;
+    std::vector<std::string> acctTxnIDs;
+    std::vector<std::string> acctAccounts;
+    std::vector<std::uint32_t> acctLedgerSeqs;
+    std::vector<std::uint32_t> acctTxnSeqs;
+    std::vector<std::string> tableNames;
+    std::vector<std::uint32_t> tableLedgerSeqs;
+    std::vector<std::uint32_t> tableTxnSeqs;
+    std::vector<std::string> tableTxnIDs;
+
+    auto db = app.getTxnDB ().checkoutDb ();
+
+    soci::transaction tr(*db);
+
+    forEachSeqRange (batch,
+        [&db](LedgerIndex first, LedgerIndex last)
+        {
+            *db << "DELETE FROM Transactions WHERE LedgerSeq >= :first "
+                "AND LedgerSeq <= :last;", soci::use (first), soci::use (last);
+            *db << "DELETE FROM AccountTransactions WHERE LedgerSeq >= :first "
+                "AND LedgerSeq <= :last;", soci::use (first), soci::use (last);
+            *db << "DELETE FROM TableTransactions WHERE LedgerSeq >= :first "
+                "AND LedgerSeq <= :last;", soci::use (first), soci::use (last);
+        });
+
+    std::string transID;
+    std::string transType;
+    std::string fromAcct;
+    std::uint32_t fromSeq = 0;
+    LedgerIndex seq = 0;
+    std::string const status (1, TXN_SQL_VALIDATED);
+    soci::blob rawTxn (*db);
+    soci::blob txnMeta (*db);
+    soci::statement st = (db->prepare << addTrans,
+        soci::use (transID),
+        soci::use (transType),
+        soci::use (fromAcct),
+        soci::use (fromSeq),
+        soci::use (seq),
+        soci::use (status),
+        soci::use (rawTxn),
+        soci::use (txnMeta));
+
+    boost::optional<LedgerIndex> startSeq;
+    for (auto const& save : batch)
     {
-        auto db = app.getLedgerDB ().checkoutDb();
-        *db << boost::str (deleteLedger % seq);
-    }
-
-    {
-        auto db = app.getTxnDB ().checkoutDb ();
-
-        soci::transaction tr(*db);
-
-        *db << boost::str (deleteTrans1 % seq);
-        *db << boost::str (deleteTrans2 % seq);
-
-        std::string const ledgerSeq (std::to_string (seq));
+        seq = save.ledger->info().seq;
+        // ledgers saved before the table index are all older than
+        // the first validated ledger saved with it
+        if (save.current && ! startSeq)
+            startSeq = seq;
 
-        for (auto const& vt : aLedger->getMap ())
+        for (auto const& vt : save.aLedger->getMap ())
         {
+            auto const& txn = vt.second->getTxn ();
             uint256 transactionID = vt.second->getTransactionID ();
 
             app.getMasterTransaction ().inLedger (
                 transactionID, seq);
 
-            std::string const txnId (to_string (transactionID));
-            std::string const txnSeq (std::to_string (vt.second->getTxnSeq ()));
-
-            *db << boost::str (deleteAcctTrans % transactionID);
+            transID = to_string (transactionID);
+            auto const txnSeq = vt.second->getTxnSeq ();
+            txnIDs.push_back (transID);
 
             auto const& accts = vt.second->getAffected ();
 
             if (!accts.empty ())
             {
-                std::string sql (
-                    "INSERT INTO AccountTransactions "
-                    "(TransID, Account, LedgerSeq, TxnSeq) VALUES ");
-
-                // Try to make an educated guess on how much space we'll need
-                // for our arguments. In argument order we have:
-                // 64 + 34 + 10 + 10 = 118 + 10 extra = 128 bytes
-                sql.reserve (sql.length () + (accts.size () * 128));
-
-                bool first = true;
                 for (auto const& account : accts)
                 {
-                    if (!first)
-                        sql += ", ('";
-                    else
-                    {
-                        sql += "('";
-                        first = false;
-                    }
-
-                    sql += txnId;
-                    sql += "','";
-                    sql += app.accountIDCache().toBase58(account);
-                    sql += "',";
-                    sql += ledgerSeq;
-                    sql += ",";
-                    sql += txnSeq;
-                    sql += ")";
+                    acctTxnIDs.push_back (transID);
+                    acctAccounts.push_back (
+                        app.accountIDCache().toBase58(account));
+                    acctLedgerSeqs.push_back (seq);
+                    acctTxnSeqs.push_back (txnSeq);
                 }
-                sql += ";";
-                JLOG (j.trace()) << "ActTx: " << sql;
-                *db << sql;
             }
             else
             {
@@ -952,34 +1010,93 @@ static bool saveValidatedLedger (
                     << "Transaction in ledger " << seq
                     << " affects no accounts";
                 JLOG (j.warn())
-                    << vt.second->getTxn()->getJson(0);
+                    << txn->getJson(0);
+            }
+
+            for (auto& name : TableSyncUtil::GetTxTableNames (*txn))
+            {
+                tableNames.push_back (std::move (name));
+                tableLedgerSeqs.push_back (seq);
+                tableTxnSeqs.push_back (txnSeq);
+                tableTxnIDs.push_back (transID);
             }
 
-            *db <<
-               (STTx::getMetaSQLInsertReplaceHeader () +
-                vt.second->getTxn ()->getMetaSQL (
-                    seq, vt.second->getEscMeta ()) + ";");
+            auto const format =
+                TxFormats::getInstance ().findByType (txn->getTxnType ());
+            assert (format != nullptr);
+            transType = format->getName ();
+            fromAcct = app.accountIDCache().toBase58(
+                txn->getAccountID (sfAccount));
+            fromSeq = txn->getSequence ();
+
+            Serializer s;
+            txn->add (s);
+            // a blob keeps its length when written shorter data
+            rawTxn.trim (0);
+            convert (s.peekData (), rawTxn);
+            txnMeta.trim (0);
+            convert (vt.second->getRawMeta (), txnMeta);
+
+            st.execute (true);
         }
+    }
+
+    if (!txnIDs.empty ())
+        *db << deleteAcctTrans, soci::use (txnIDs);
 
-        tr.commit ();
+    if (!acctTxnIDs.empty ())
+    {
+        JLOG (j.trace()) << "ActTx: " << acctTxnIDs.size () << " rows";
+        *db << addAcctTrans,
+            soci::use (acctTxnIDs),
+            soci::use (acctAccounts),
+            soci::use (acctLedgerSeqs),
+            soci::use (acctTxnSeqs);
     }
 
+    if (!tableNames.empty ())
     {
-        static std::string addLedger(
-            R"sql(INSERT OR REPLACE INTO Ledgers
-                (LedgerHash,LedgerSeq,PrevHash,TotalCoins,ClosingTime,PrevClosingTime,
-                CloseTimeRes,CloseFlags,AccountSetHash,TransSetHash)
-            VALUES
-                (:ledgerHash,:ledgerSeq,:prevHash,:totalCoins,:closingTime,:prevClosingTime,
-                :closeTimeRes,:closeFlags,:accountSetHash,:transSetHash);)sql");
-        static std::string updateVal(
-            R"sql(UPDATE Validations SET LedgerSeq = :ledgerSeq, InitialSeq = :initialSeq
-                WHERE LedgerHash = :ledgerHash;)sql");
+        *db << addTableTrans,
+            soci::use (tableNames),
+            soci::use (tableLedgerSeqs),
+            soci::use (tableTxnSeqs),
+            soci::use (tableTxnIDs);
+    }
 
-        auto db (app.getLedgerDB ().checkoutDb ());
+    if (startSeq)
+    {
+        *db << "INSERT INTO TableTxIndexState (StartSeq) SELECT :seq "
+            "WHERE NOT EXISTS (SELECT 1 FROM TableTxIndexState);",
+            soci::use (*startSeq);
+    }
 
-        soci::transaction tr(*db);
+    tr.commit ();
+}
 
+// Writes the headers of a batch with one database transaction.
+static void saveLedgerHeaders (
+    Application& app,
+    std::vector<LedgerToSave> const& batch)
+{
+    static std::string addLedger(
+        R"sql(INSERT OR REPLACE INTO Ledgers
+            (LedgerHash,LedgerSeq,PrevHash,TotalCoins,ClosingTime,PrevClosingTime,
+            CloseTimeRes,CloseFlags,AccountSetHash,TransSetHash)
+        VALUES
+            (:ledgerHash,:ledgerSeq,:prevHash,:totalCoins,:closingTime,:prevClosingTime,
+            :closeTimeRes,:closeFlags,:accountSetHash,:transSetHash);)sql");
+    static std::string updateVal(
+        R"sql(UPDATE Validations SET LedgerSeq = :ledgerSeq, InitialSeq = :initialSeq
+            WHERE LedgerHash = :ledgerHash;)sql");
+
+    auto db (app.getLedgerDB ().checkoutDb ());
+
+    soci::transaction tr(*db);
+
+    for (auto const& save : batch)
+    {
+        auto const& ledger = save.ledger;
+        auto const seq = ledger->info().seq;
         auto const hash = to_string (ledger->info().hash);
         auto const parentHash = to_string (ledger->info().parentHash);
         auto const drops = to_string (ledger->info().drops);
@@ -1010,14 +1127,93 @@ static bool saveValidatedLedger (
             soci::use(seq),
             soci::use(seq),
             soci::use(hash);
+    }
+
+    tr.commit();
+}
 
-        tr.commit();
+/** Save a batch of validated ledgers.
+
+    Each stage handles the whole batch: the ledgers are prepared, then
+    their transactions and their headers are written with one database
+    transaction each. Returns false if a ledger could not be saved.
+*/
+static bool saveValidatedLedgers (
+    Application& app,
+    std::vector<LedgerSaveQueue::Item> const& items)
+{
+    using namespace std::chrono;
+    auto j = app.journal ("Ledger");
+    auto const start = steady_clock::now ();
+
+    bool ret = true;
+    std::vector<LedgerToSave> batch;
+    batch.reserve (items.size ());
+    for (auto const& item : items)
+    {
+        auto const seq = item.ledger->info().seq;
+        if (! app.pendingSaves().startWork (seq))
+        {
+            // The save was completed synchronously
+            JLOG (j.debug()) << "Save aborted";
+            continue;
+        }
+
+        AcceptedLedger::pointer aLedger;
+        if (! prepareLedgerSave (app, item.ledger, item.current, aLedger, j))
+        {
+            // Clients can now trust the database for information about
+            // this ledger sequence.
+            app.pendingSaves().finishWork(seq);
+            ret = false;
+            continue;
+        }
+        batch.push_back ({item.ledger, std::move (aLedger), item.current});
+    }
+    if (batch.empty ())
+        return ret;
+
+    auto const prepared = steady_clock::now ();
+
+    {
+        auto db = app.getLedgerDB ().checkoutDb();
+        forEachSeqRange (batch,
+            [&db](LedgerIndex first, LedgerIndex last)
+            {
+                *db << "DELETE FROM Ledgers WHERE LedgerSeq >= :first "
+                    "AND LedgerSeq <= :last;",
+                    soci::use (first), soci::use (last);
+            });
     }
 
+    saveLedgerTransactions (app, batch, j);
+    auto const txnsSaved = steady_clock::now ();
+
+    saveLedgerHeaders (app, batch);
+    auto const headersSaved = steady_clock::now ();
+
     // Clients can now trust the database for
-    // information about this ledger sequence.
-    app.pendingSaves().finishWork(seq);
-    return true;
+    // information about these ledger sequences.
+    for (auto const& save : batch)
+        app.pendingSaves().finishWork(save.ledger->info().seq);
+
+    app.getLedgerSaveQueue ().onBatch (batch.size (),
+        duration_cast<milliseconds> (prepared - start),
+        duration_cast<milliseconds> (txnsSaved - prepared),
+        duration_cast<milliseconds> (headersSaved - txnsSaved));
+    return ret;
+}
+
+// Saves the queued ledgers of a kind until their queue is drained.
+static void saveQueuedLedgers (Application& app, bool isCurrent)
+{
+    for (;;)
+    {
+        auto const batch = app.getLedgerSaveQueue ().take (isCurrent);
+        if (batch.empty ())
+            return;
+        saveValidatedLedgers (app, batch);
+    }
 }
 
 /** Save, or arrange to save, a fully-validated ledger
@@ -1061,18 +1257,25 @@ bool pendSaveValidated (
     char const* const jobName {
         isCurrent ? "Ledger::pendSave" : "Ledger::pendOldSave"};
 
+    if (isSynchronous)
+        return saveValidatedLedgers(app, {{ledger, isCurrent}});
+
+    // One job per kind saves what is queued, see if we have to start it.
+    if (! app.getLedgerSaveQueue().add (ledger, isCurrent))
+        return true;
+
     // See if we can use the JobQueue.
-    if (!isSynchronous &&
-        app.getJobQueue().addJob (jobType, jobName,
-        [&app, ledger, isCurrent] (Job&) {
-            saveValidatedLedger(app, ledger, isCurrent);
+    if (app.getJobQueue().addJob (jobType, jobName,
+        [&app, isCurrent] (Job&) {
+            saveQueuedLedgers(app, isCurrent);
         }))
     {
         return true;
     }
 
     // The JobQueue won't do the Job.  Do the save synchronously.
-    return saveValidatedLedger(app, ledger, isCurrent);
+    saveQueuedLedgers(app, isCurrent);
+    return true;
 }
 
 void
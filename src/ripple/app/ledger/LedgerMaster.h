@@ -38,6 +38,7 @@
 #include <ripple/beast/utility/PropertyStream.h>
 #include <mutex>
 #include <peersafe/protocol/TableDefines.h>
+#include <peersafe/app/table/TableEntryCache.h>
 #include <ripple/protocol/Protocol.h>
 
 #include "ripple.pb.h"
@@ -92,6 +93,13 @@ public:
    ripple::uint160
     getNameInDB(LedgerIndex index, AccountID accountID, std::string sTableName);
 
+    /** Table entries of the validated ledger, for read RPCs */
+    TableEntryCache&
+    getTableEntryCache()
+    {
+        return mTableEntries;
+    }
+
     table_BaseInfo
     getTableBaseInfo(LedgerIndex index, AccountID accountID, std::string sTableName);
 
@@ -332,6 +340,8 @@ private:
 
     LedgerHistory mLedgerHistory;
 
+    TableEntryCache mTableEntries;
+
     CanonicalTXSet mHeldTransactions {uint256()};
 
     // A set of transactions to replay during the next close
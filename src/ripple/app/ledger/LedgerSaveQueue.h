@@ -0,0 +1,130 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+
+#ifndef RIPPLE_APP_LEDGER_LEDGERSAVEQUEUE_H_INCLUDED
+#define RIPPLE_APP_LEDGER_LEDGERSAVEQUEUE_H_INCLUDED
+
+#include <ripple/beast/insight/Collector.h>
+#include <ripple/json/json_value.h>
+#include <ripple/protocol/Protocol.h>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+class Ledger;
+
+/** Validated ledgers waiting to be written to the SQL databases.
+
+    pendSaveValidated queues ledgers here instead of posting a job for
+    each. One job at a time takes consecutive ledgers from the queue, up
+    to batchSize, and writes them with one transaction per database.
+
+    Current ledgers and old ones (backfill) are queued apart, each with
+    its own job, so a long backfill never delays the ledgers just
+    validated and a current ledger never runs at the old job priority.
+*/
+class LedgerSaveQueue
+{
+public:
+    struct Item
+    {
+        std::shared_ptr<Ledger const> ledger;
+        bool current;
+    };
+
+    static std::size_t const batchSize = 32;
+
+    explicit
+    LedgerSaveQueue (beast::insight::Collector::ptr const& collector);
+
+    /** Queue a ledger, an old ledger queued again as current moves to
+        the current queue.
+
+        @return true if no job is saving the queue of this kind, the
+                caller must start one.
+    */
+    bool
+    add (std::shared_ptr<Ledger const> const& ledger, bool current);
+
+    /** Take the lowest ledger queued of a kind and those following it.
+
+        An empty batch means the queue is drained and its saving job
+        ends, the next add of that kind asks for a new one.
+    */
+    std::vector<Item>
+    take (bool current);
+
+    /** Record the time a batch spent in each stage of the save. */
+    void
+    onBatch (std::size_t ledgers,
+        std::chrono::milliseconds prepare,
+        std::chrono::milliseconds txnDB,
+        std::chrono::milliseconds ledgerDB);
+
+    /** Ledgers queued and not taken by the saving job yet. */
+    std::size_t
+    pending () const;
+
+    Json::Value
+    getInfo () const;
+
+private:
+    struct Queue
+    {
+        std::map<LedgerIndex, Item> items;
+        bool saving = false;
+    };
+
+    Queue&
+    queue (bool current)
+    {
+        return current ? current_ : old_;
+    }
+
+    std::size_t
+    size () const
+    {
+        return current_.items.size () + old_.items.size ();
+    }
+
+    mutable std::mutex mutex_;
+    Queue current_;
+    Queue old_;
+
+    std::uint64_t batches_ = 0;
+    std::uint64_t ledgers_ = 0;
+    std::chrono::milliseconds prepare_ {0};
+    std::chrono::milliseconds txnDB_ {0};
+    std::chrono::milliseconds ledgerDB_ {0};
+
+    beast::insight::Gauge depth_;
+    beast::insight::Event batchLedgers_;
+    beast::insight::Event prepareTime_;
+    beast::insight::Event txnDBTime_;
+    beast::insight::Event ledgerDBTime_;
+};
+
+} // ripple
+
+#endif
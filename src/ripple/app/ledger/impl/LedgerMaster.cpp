@@ -49,6 +49,7 @@
 #include <peersafe/app/storage/TableStorage.h>
 #include <peersafe/rpc/impl/TableAssistant.h>
 #include <peersafe/protocol/STEntry.h>
+#include <peersafe/app/table/TableDirectory.h>
 #include <peersafe/app/sql/TxStore.h>
 #include <algorithm>
 #include <cassert>
@@ -222,6 +223,7 @@ LedgerMaster::setValidLedger(
     app_.getOPs().updateLocalTx (*l);
     app_.getSHAMapStore().onLedgerClosed (getValidatedLedger());
     mLedgerHistory.validatedLedger (l);
+    mTableEntries.onValidatedLedger (*l);
     app_.getAmendmentTable().doValidatedLedger (l);
     if (!app_.getOPs().isAmendmentBlocked() &&
         app_.getAmendmentTable().hasUnsupportedEnabled ())
@@ -824,23 +826,9 @@ ripple::uint160 LedgerMaster::getNameInDB(
     auto ledger = getLedgerBySeq(index);
     if (ledger)
     {
-        auto id = keylet::table(accountID);
-        auto const tablesle = ledger->read(id);
-       
-        if (tablesle)
-        {
-            auto aTableEntries = tablesle->getFieldArray(sfTableEntries);
-
-            for (auto const &table : aTableEntries)
-            {
-                ripple::Blob blob = table.getFieldVL(sfTableName);
-                std::string tableName = std::string(blob.begin(), blob.end());
-				if (sTableName.compare(tableName) == 0)
-				{
-					name = table.getFieldH160(sfNameInDB);
-				}
-            }
-        }
+        auto const pEntry = mTableEntries.fetch(*ledger, accountID, sTableName);
+        if (pEntry)
+            name = pEntry->getFieldH160(sfNameInDB);
     }
 	return name;
 }
@@ -853,33 +841,22 @@ LedgerMaster::getTableBaseInfo(LedgerIndex index, AccountID accountID, std::stri
     auto ledger = getLedgerBySeq(index);
     if (ledger)
     {
-        auto id = keylet::table(accountID);
-        auto const tablesle = ledger->read(id);
-
-        if (tablesle)
+        auto const pEntry = readTableEntry(*ledger, accountID, sTableName);
+        if (pEntry)
         {
-            auto aTableEntries = tablesle->getFieldArray(sfTableEntries);
-
-            for (auto const &table : aTableEntries)
-            {
-                ripple::Blob blob = table.getFieldVL(sfTableName);
-                std::string tableName = std::string(blob.begin(), blob.end());
-                if (sTableName.compare(tableName) == 0)
-                {
-                    if (table.isFieldPresent(sfNameInDB))
-						ret_baseInfo.nameInDB = table.getFieldH160(sfNameInDB);
-                    if (table.isFieldPresent(sfCreateLgrSeq))
-						ret_baseInfo.createLgrSeq = table.getFieldU32(sfCreateLgrSeq);
-                    if (table.isFieldPresent(sfCreatedLedgerHash))
-						ret_baseInfo.createdLedgerHash = table.getFieldH256(sfCreatedLedgerHash);
-                    if (table.isFieldPresent(sfCreatedTxnHash))
-                        ret_baseInfo.createdTxnHash = table.getFieldH256(sfCreatedTxnHash);
-                    if (table.isFieldPresent(sfPreviousTxnLgrSeq))
-                        ret_baseInfo.previousTxnLgrSeq = table.getFieldU32(sfPreviousTxnLgrSeq);
-                    if (table.isFieldPresent(sfPrevTxnLedgerHash))
-                        ret_baseInfo.prevTxnLedgerHash = table.getFieldH256(sfPrevTxnLedgerHash);
-                }
-            }
+            auto const& table = *pEntry;
+            if (table.isFieldPresent(sfNameInDB))
+				ret_baseInfo.nameInDB = table.getFieldH160(sfNameInDB);
+            if (table.isFieldPresent(sfCreateLgrSeq))
+				ret_baseInfo.createLgrSeq = table.getFieldU32(sfCreateLgrSeq);
+            if (table.isFieldPresent(sfCreatedLedgerHash))
+				ret_baseInfo.createdLedgerHash = table.getFieldH256(sfCreatedLedgerHash);
+            if (table.isFieldPresent(sfCreatedTxnHash))
+                ret_baseInfo.createdTxnHash = table.getFieldH256(sfCreatedTxnHash);
+            if (table.isFieldPresent(sfPreviousTxnLgrSeq))
+                ret_baseInfo.previousTxnLgrSeq = table.getFieldU32(sfPreviousTxnLgrSeq);
+            if (table.isFieldPresent(sfPrevTxnLedgerHash))
+                ret_baseInfo.prevTxnLedgerHash = table.getFieldH256(sfPrevTxnLedgerHash);
         }
     }
     return ret_baseInfo;
@@ -893,23 +870,9 @@ std::pair<ripple::uint256, std::string> LedgerMaster::getLatestTxCheckHash(Accou
 	auto ledger = getValidatedLedger();
 	if (ledger)
 	{
-		auto id = keylet::table(accountID);
-		auto const tablesle = ledger->read(id);
-
-		if (tablesle)
-		{
-			auto aTableEntries = tablesle->getFieldArray(sfTableEntries);
-
-			for (auto const &table : aTableEntries)
-			{
-				ripple::Blob blob = table.getFieldVL(sfTableName);
-				std::string tableName = std::string(blob.begin(), blob.end());
-				if (sTableName.compare(tableName) == 0)
-				{
-					uTxCheckHash = table.getFieldH256(sfTxCheckHash);
-				}
-			}
-		}
+		auto const pEntry = readTableEntry(*ledger, accountID, sTableName);
+		if (pEntry)
+			uTxCheckHash = pEntry->getFieldH256(sfTxCheckHash);
 	}
 	if (uTxCheckHash.isZero())
 	{
@@ -931,30 +894,20 @@ LedgerMaster::isAuthorityValid(AccountID accountID, AccountID ownerID, std::list
     auto ledger = getValidatedLedger();
     if (ledger)
     {
-        auto id = keylet::table(ownerID);
-        auto const tablesle = ledger->read(id);
-
-        if (tablesle)
+        if (ledger->exists(keylet::table(ownerID)))
         {
-            auto aTableEntries = tablesle->getFieldArray(sfTableEntries);
             for (auto const &sCheckName : aTableName)
             {
                 bool bValid = false;
 				bool bTableFound = false;
-                for (auto const &table : aTableEntries)
+                auto const pTableEntry = mTableEntries.fetch(*ledger, ownerID, sCheckName);
+                if (pTableEntry)
                 {
-                    ripple::Blob blob = table.getFieldVL(sfTableName);
-                    std::string sTableName = std::string(blob.begin(), blob.end());
-                    if (sCheckName.compare(sTableName) == 0)
-                    {
-						bTableFound = true;
-						STEntry* pTableEntry = (STEntry*)(&table);
-						if (pTableEntry->hasAuthority(accountID, roles))
-						{
-							bValid = true;
-						}
-                        break;
-                    }
+					bTableFound = true;
+					if (pTableEntry->hasAuthority(accountID, roles))
+					{
+						bValid = true;
+					}
                 }
                 if (!bValid)
                 {
@@ -983,46 +936,39 @@ LedgerMaster::getUserToken(AccountID accountID, AccountID ownerID, std::string s
 		auto const tablesle = ledger->read(id);
 		bool tableFound = false;
 
-		if (tablesle)
+		auto const pEntry = tablesle ?
+			readTableEntry(*ledger, ownerID, sTableName) : nullptr;
+		if (pEntry)
 		{
-			auto aTableEntries = tablesle->getFieldArray(sfTableEntries);
-			for (auto const &table : aTableEntries)
+			auto const& table = *pEntry;
+			tableFound = true;
+			assert(table.isFieldPresent(sfUsers));
+			auto& users = table.getFieldArray(sfUsers);
+			assert(users.size() > 0);
+			bool bNeedToken = users[0].isFieldPresent(sfToken);
+			if (!bNeedToken)
+			{
+				return std::make_tuple(true, Blob(), "token is not needed");
+			}
+			else
 			{
-				ripple::Blob blob = table.getFieldVL(sfTableName);
-				std::string tableName = std::string(blob.begin(), blob.end());
-				if (sTableName.compare(tableName) == 0)
+				for (auto & user : users)  //check if there same user
 				{
-					tableFound = true;
-					assert(table.isFieldPresent(sfUsers));
-					auto& users = table.getFieldArray(sfUsers);
-					assert(users.size() > 0);
-					bool bNeedToken = users[0].isFieldPresent(sfToken);
-					if (!bNeedToken)
+					if (user.getAccountID(sfUser) == accountID)
 					{
-						return std::make_tuple(true, Blob(), "token is not needed");
-					}
-					else
-					{
-						for (auto & user : users)  //check if there same user
+						if (user.isFieldPresent(sfToken))
 						{
-							if (user.getAccountID(sfUser) == accountID)
-							{
-								if (user.isFieldPresent(sfToken))
-								{
-									ripple::Blob passBlob = user.getFieldVL(sfToken);
-									//std::string sPass = std::string(passBlob.begin(), passBlob.end());
-									return std::make_tuple(true, passBlob, "");
-								}
-								else
-								{
-									return std::make_tuple(false, Blob(), "Missing 'Token' field in sle of the corresponding user!");
-								}
-							}
+							ripple::Blob passBlob = user.getFieldVL(sfToken);
+							//std::string sPass = std::string(passBlob.begin(), passBlob.end());
+							return std::make_tuple(true, passBlob, "");
+						}
+						else
+						{
+							return std::make_tuple(false, Blob(), "Missing 'Token' field in sle of the corresponding user!");
 						}
-						return std::make_tuple(false, Blob(), "no authority to the table.");
 					}
-					break;
 				}
+				return std::make_tuple(false, Blob(), "no authority to the table.");
 			}
 		}
 		if(!tableFound)
@@ -1103,19 +1049,9 @@ bool LedgerMaster::isConfidentialUnit(const STTx& tx)
 		auto ledger = getValidatedLedger();
 		if (ledger == NULL)  return false;
 
-		auto id = keylet::table(owner);
-		auto const tablesle = ledger->read(id);
-		if (tablesle == nullptr)
-			return false;
-		auto aTableEntries = tablesle->getFieldArray(sfTableEntries);
-
-		for (auto & table : aTableEntries)
-		{
-			if (strCopy(table.getFieldVL(sfTableName)) == sTxTableName) {
-				STEntry* pEntry = (STEntry*)&table;
-				return pEntry->isConfidential();
-			}
-		}
+		auto const pEntry = readTableEntry(*ledger, owner, sTxTableName);
+		if (pEntry)
+			return pEntry->isConfidential();
 	}
 
 	return false;
@@ -0,0 +1,128 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/LedgerSaveQueue.h>
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/protocol/JsonFields.h>
+
+namespace ripple {
+
+LedgerSaveQueue::LedgerSaveQueue (
+        beast::insight::Collector::ptr const& collector)
+    : depth_ (collector->make_gauge ("pending"))
+    , batchLedgers_ (collector->make_event ("batch_ledgers"))
+    , prepareTime_ (collector->make_event ("prepare"))
+    , txnDBTime_ (collector->make_event ("txn_db"))
+    , ledgerDBTime_ (collector->make_event ("ledger_db"))
+{
+}
+
+bool
+LedgerSaveQueue::add (
+    std::shared_ptr<Ledger const> const& ledger, bool current)
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    auto const seq = ledger->info().seq;
+    if (current)
+        old_.items.erase (seq);
+    else if (current_.items.count (seq))
+        current = true;
+
+    auto& q = queue (current);
+    q.items[seq] = {ledger, current};
+    depth_ = size ();
+
+    if (q.saving)
+        return false;
+    q.saving = true;
+    return true;
+}
+
+std::vector<LedgerSaveQueue::Item>
+LedgerSaveQueue::take (bool current)
+{
+    std::vector<Item> batch;
+    std::lock_guard<std::mutex> lock (mutex_);
+    auto& q = queue (current);
+    auto it = q.items.begin ();
+    while (it != q.items.end () && batch.size () < batchSize &&
+        (batch.empty () ||
+            it->first == batch.back ().ledger->info().seq + 1))
+    {
+        batch.push_back (std::move (it->second));
+        it = q.items.erase (it);
+    }
+    depth_ = size ();
+
+    if (batch.empty ())
+        q.saving = false;
+    return batch;
+}
+
+void
+LedgerSaveQueue::onBatch (std::size_t ledgers,
+    std::chrono::milliseconds prepare,
+    std::chrono::milliseconds txnDB,
+    std::chrono::milliseconds ledgerDB)
+{
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        ++batches_;
+        ledgers_ += ledgers;
+        prepare_ += prepare;
+        txnDB_ += txnDB;
+        ledgerDB_ += ledgerDB;
+    }
+    batchLedgers_.notify (
+        static_cast<beast::insight::Event::value_type> (ledgers));
+    prepareTime_.notify (prepare);
+    txnDBTime_.notify (txnDB);
+    ledgerDBTime_.notify (ledgerDB);
+}
+
+std::size_t
+LedgerSaveQueue::pending () const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    return size ();
+}
+
+Json::Value
+LedgerSaveQueue::getInfo () const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    Json::Value ret (Json::objectValue);
+    ret[jss::pending] = static_cast<Json::UInt> (size ());
+    ret[jss::batches] = static_cast<Json::UInt> (batches_);
+    ret[jss::ledgers_saved] = static_cast<Json::UInt> (ledgers_);
+    // average time of a batch in each stage
+    if (batches_ != 0)
+    {
+        ret[jss::prepare_ms] = static_cast<Json::UInt> (
+            prepare_.count () / batches_);
+        ret[jss::txn_db_ms] = static_cast<Json::UInt> (
+            txnDB_.count () / batches_);
+        ret[jss::ledger_db_ms] = static_cast<Json::UInt> (
+            ledgerDB_.count () / batches_);
+    }
+    return ret;
+}
+
+} // ripple
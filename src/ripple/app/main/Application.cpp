@@ -29,6 +29,7 @@
 #include <ripple/app/ledger/LedgerToJson.h>
 #include <ripple/app/ledger/OpenLedger.h>
 #include <ripple/app/ledger/OrderBookDB.h>
+#include <ripple/app/ledger/LedgerSaveQueue.h>
 #include <ripple/app/ledger/PendingSaves.h>
 #include <ripple/app/ledger/InboundTransactions.h>
 #include <ripple/app/ledger/TransactionMaster.h>
@@ -37,6 +38,7 @@
 #include <ripple/app/main/NodeStoreScheduler.h>
 #include <ripple/app/misc/AmendmentTable.h>
 #include <ripple/app/misc/HashRouter.h>
+#include <ripple/app/misc/SigVerifier.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/app/misc/SHAMapStore.h>
@@ -58,6 +60,7 @@
 #include <ripple/beast/asio/io_latency_probe.h>
 #include <ripple/beast/core/LexicalCast.h>
 #include <peersafe/app/sql/TxStore.h>
+#include <peersafe/app/sql/TxStoreReadPool.h>
 #include <peersafe/app/storage/TableStorage.h>
 #include <peersafe/rpc/impl/TableAssistant.h>
 #include <peersafe/app/table/TableSync.h>
@@ -341,11 +344,14 @@ public:
     std::unique_ptr <AmendmentTable> m_amendmentTable;
     std::unique_ptr <LoadFeeTrack> mFeeTrack;
     std::unique_ptr <HashRouter> mHashRouter;
+    std::unique_ptr <SigVerifier> mSigVerifier;
+    std::unique_ptr <LedgerSaveQueue> mLedgerSaveQueue;
 	RCLValidations mValidations;
     std::unique_ptr <LoadManager> m_loadManager;
     std::unique_ptr <TxQ> txQ_;
 	std::unique_ptr <TxStoreDBConn> m_pTxStoreDBConn;
     std::unique_ptr <TxStore> m_pTxStore;
+    std::unique_ptr <TxStoreReadPool> m_pTxStoreReadPool;
     std::unique_ptr <TableStatusDB> m_pTableStatusDB;
     std::unique_ptr <TableSync> m_pTableSync;
     std::unique_ptr <TableStorage> m_pTableStorage;
@@ -492,6 +498,13 @@ public:
             stopwatch(), HashRouter::getDefaultHoldTime (),
             HashRouter::getDefaultRecoverLimit ()))
 
+        , mSigVerifier (std::make_unique<SigVerifier>(*mHashRouter,
+            std::max (1, static_cast<int>(
+                std::thread::hardware_concurrency ()) / 2)))
+
+        , mLedgerSaveQueue (std::make_unique<LedgerSaveQueue>(
+            m_collectorManager->group ("ledger_save")))
+
         , mValidations (ValidationParms(),stopwatch(), logs_->journal("Validations"),
             *this)
 
@@ -503,6 +516,8 @@ public:
 
         , m_pTxStore(std::make_unique<TxStore>(m_pTxStoreDBConn->GetDBConn(), *config_, logs_->journal("TxStore")))		
 
+        , m_pTxStoreReadPool(std::make_unique<TxStoreReadPool>(*this, *config_, logs_->journal("TxStore")))
+
         , m_pTableSync(std::make_unique<TableSync>(*this, *config_, logs_->journal("TableSync")))
 
         , m_pTableStorage(std::make_unique<TableStorage>(*this, *config_, logs_->journal("TableStorage")))
@@ -610,6 +625,11 @@ public:
 		return *m_pTxStore;
 	}
 
+    TxStoreReadPool& getTxStoreReadPool() override
+    {
+        return *m_pTxStoreReadPool;
+    }
+
     TableStatusDB& getTableStatusDB() override
 	{
 		return *m_pTableStatusDB;
@@ -739,6 +759,11 @@ public:
         return *mHashRouter;
     }
 
+    SigVerifier& getSigVerifier () override
+    {
+        return *mSigVerifier;
+    }
+
     RCLValidations& getValidations () override
     {
         return mValidations;
@@ -779,6 +804,11 @@ public:
         return pendingSaves_;
     }
 
+    LedgerSaveQueue& getLedgerSaveQueue() override
+    {
+        return *mLedgerSaveQueue;
+    }
+
     AccountIDCache const&
     accountIDCache() const override
     {
@@ -44,6 +44,7 @@ class CachedSLEs;
 class CollectorManager;
 class Family;
 class HashRouter;
+class SigVerifier;
 class Logs;
 class LoadFeeTrack;
 class JobQueue;
@@ -51,6 +52,7 @@ class InboundLedgers;
 class InboundTransactions;
 class AcceptedLedger;
 class LedgerMaster;
+class LedgerSaveQueue;
 class LoadManager;
 class ManifestCache;
 class NetworkOPs;
@@ -71,6 +73,7 @@ class ValidatorSite;
 class Cluster;
 class TxStoreDBConn;
 class TxStore;
+class TxStoreReadPool;
 class TableStatusDB;
 class TableSync;
 class TableStorage;
@@ -133,6 +136,7 @@ public:
     virtual CachedSLEs&             cachedSLEs() = 0;
     virtual AmendmentTable&         getAmendmentTable() = 0;
     virtual HashRouter&             getHashRouter () = 0;
+    virtual SigVerifier&            getSigVerifier () = 0;
     virtual LoadFeeTrack&           getFeeTrack () = 0;
     virtual LoadManager&            getLoadManager () = 0;
     virtual Overlay&                overlay () = 0;
@@ -154,6 +158,7 @@ public:
     virtual TransactionMaster&      getMasterTransaction () = 0;
 	virtual TxStoreDBConn&			getTxStoreDBConn() = 0;
 	virtual TxStore&                getTxStore() = 0;
+    virtual TxStoreReadPool&        getTxStoreReadPool() = 0;
     virtual TableStatusDB&          getTableStatusDB() = 0;
     virtual TableSync&              getTableSync() = 0;
     virtual TableStorage&           getTableStorage() = 0;
@@ -169,6 +174,7 @@ public:
     virtual PathRequests&           getPathRequests () = 0;
     virtual SHAMapStore&            getSHAMapStore () = 0;
     virtual PendingSaves&           pendingSaves() = 0;
+    virtual LedgerSaveQueue&        getLedgerSaveQueue() = 0;
     virtual AccountIDCache const&   accountIDCache() const = 0;
     virtual OpenLedger&             openLedger() = 0;
     virtual OpenLedger const&       openLedger() const = 0;
@@ -63,6 +63,23 @@ const char* TxnDBInit[] =
     "CREATE INDEX IF NOT EXISTS AcctLgrIndex ON               \
         AccountTransactions(LedgerSeq, Account, TransID);",
 
+    // Chainsql txs by the table they touch, used by table sync to
+    // skip ledgers without txs of a table. StartSeq is the first
+    // ledger saved with the index.
+    "CREATE TABLE IF NOT EXISTS TableTransactions (           \
+        NameInDB    CHARACTER(40),              \
+        LedgerSeq   BIGINT UNSIGNED,            \
+        TxnSeq      INTEGER,                    \
+        TransID     CHARACTER(64)               \
+    );",
+    "CREATE INDEX IF NOT EXISTS TableTxIndex ON               \
+        TableTransactions(NameInDB, LedgerSeq, TxnSeq);",
+    "CREATE INDEX IF NOT EXISTS TableTxLgrIndex ON            \
+        TableTransactions(LedgerSeq);",
+    "CREATE TABLE IF NOT EXISTS TableTxIndexState (           \
+        StartSeq    BIGINT UNSIGNED             \
+    );",
+
     "END TRANSACTION;"
 };
 
@@ -38,6 +38,7 @@
 #include <ripple/app/main/LoadManager.h>
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
+#include <ripple/app/misc/TableSubscriptions.h>
 #include <ripple/app/misc/Transaction.h>
 #include <ripple/app/misc/TxQ.h>
 #include <ripple/app/misc/ValidatorList.h>
@@ -219,6 +220,7 @@ public:
             validatorKeys,
             app_.logs().journal("LedgerConsensus"))
         , m_ledgerMaster (ledgerMaster)
+        , mTableSubs (job_queue, app_.logs().journal("TableSubscriptions"))
         , m_job_queue (job_queue)
         , m_standalone (standalone)
         , m_network_quorum (start_valid ? 0 : network_quorum)
@@ -434,14 +436,15 @@ public:
         STValidation::ref val) override;
 
 	void TryCheckSubTx() override;
+	Json::Value getTableSubsJson() override;
 
 	void pubTableTxs(const AccountID& ownerId, const std::string& sTableName,
 		const STTx& stTxn, const std::pair<std::string, std::string>& disposRes,bool bVaidated) override;
 	//publish results for chain-sql txs
-	void pubChainSqlTxResult(const STTx& stTxn,
+	void pubChainSqlTxResult(PublishedTx& tx,
 		const std::pair<std::string, std::string>& disposRes,bool validated);
 	void pubChainSqlTableTxs(const AccountID& ownerId, const std::string& sTableName, 
-		const STTx& stTxn, const std::pair<std::string, std::string>& disposRes);
+		PublishedTx& tx, const std::pair<std::string, std::string>& disposRes);
     //--------------------------------------------------------------------------
     //
     // InfoSub::Source.
@@ -540,10 +543,8 @@ private:
     void processHeartbeatTimer ();
     void processClusterTimer ();
 
-	void processSubTxTimer();
+	void processSubTxTimer(std::chrono::steady_clock::time_point queued);
 
-	using SubTxMapType = hash_map<uint256, std::pair<InfoSub::wptr, int>>;
-	void processSubTx(SubTxMapType& subTx, const std::string& status);
 
     void setMode (OperatingMode);
 
@@ -569,7 +570,6 @@ private:
     using SubMapType = hash_map <std::uint64_t, InfoSub::wptr>;
     using SubInfoMapType = hash_map <AccountID, SubMapType>;
     using subRpcMapType = hash_map<std::string, InfoSub::pointer>;
-	using SubTableMapType = hash_map<AccountID,hash_map<std::string, SubMapType >> ;
 
     // XXX Split into more locks.
     using ScopedLockType = std::lock_guard <std::recursive_mutex>;
@@ -601,9 +601,8 @@ private:
 
     subRpcMapType mRpcSubMap;
 
-	 SubTableMapType mSubTable;		  // 
-	 SubTxMapType	mSubTx;			  // All chain-sql related transactions.
-	 SubTxMapType	mValidatedSubTx;
+    // Chainsql tables and single txs, not guarded by mSubLock.
+    TableSubscriptions mTableSubs;
 
     // SubMapType mSubLedger;            // Accepted ledgers.
     // SubMapType mSubManifests;         // Received validator manifests.
@@ -815,53 +814,26 @@ void NetworkOPsImp::processHeartbeatTimer ()
 
 void NetworkOPsImp::TryCheckSubTx()
 {
-	if (!m_bCheckTxThread && (mSubTx.size() > 0 || mValidatedSubTx.size() > 0))
+	if (!m_bCheckTxThread &&
+		mTableSubs.expiresBy(app_.getLedgerMaster().getValidLedgerIndex()))
 	{
 		m_bCheckTxThread = true;
+		auto const queued = std::chrono::steady_clock::now();
 		m_job_queue.addJob(jtCheckSubTx, "NetOPs.processSubTx",
-			[this](Job&) { processSubTxTimer(); });
+			[this, queued](Job&) { processSubTxTimer(queued); });
 	}
 }
 
-void NetworkOPsImp::processSubTxTimer()
+void NetworkOPsImp::processSubTxTimer(std::chrono::steady_clock::time_point queued)
 {
-	ScopedLockType sl(mSubLock);
-
-	processSubTx(mSubTx,"validate_timeout");
-	processSubTx(mValidatedSubTx, "db_timeout");
+	mTableSubs.expireTxs(app_.getLedgerMaster().getValidLedgerIndex(), queued);
 
 	m_bCheckTxThread = false;
 }
 
-void NetworkOPsImp::processSubTx(SubTxMapType&subTx, const std::string& status)
+Json::Value NetworkOPsImp::getTableSubsJson()
 {
-	auto iter = subTx.begin();
-	while (iter != subTx.end())
-	{
-		//auto now = std::chrono::steady_clock::now();
-		//using duration_type = std::chrono::duration<double>;
-		//duration_type time_span = std::chrono::duration_cast<duration_type>(now - iter->second.second);
-		//if (time_span.count() >= EXPIRE_TIME)
-		if(app_.getLedgerMaster().getValidLedgerIndex() > iter->second.second)
-		{
-			//notify time out
-			InfoSub::pointer p = iter->second.first.lock();
-			if (p)
-			{
-				Json::Value jvObj(Json::objectValue);
-				jvObj[jss::type] = "singleTransaction";
-				jvObj[jss::transaction][jss::hash] = to_string(iter->first);
-				jvObj[jss::status] = status;
-				p->send(jvObj, true);
-			}
-
-			iter = subTx.erase(iter);
-		}
-		else
-		{
-			iter++;
-		}
-	}
+	return mTableSubs.getInfo();
 }
 
 void NetworkOPsImp::processClusterTimer ()
@@ -2284,6 +2256,8 @@ Json::Value NetworkOPsImp::getServerInfo (bool human, bool admin)
     info[jss::io_latency_ms] = static_cast<Json::UInt> (
         app_.getIOLatency().count());
 
+    info[jss::table_subs] = mTableSubs.getInfo();
+
     if (admin)
     {
         if (!app_.getValidationPublicKey().empty())
@@ -2718,6 +2692,7 @@ void NetworkOPsImp::pubValidatedTransaction (
 void NetworkOPsImp::PubValidatedTxForTable(const STTx& tx)
 {
 	auto res = std::make_pair(std::string("validate_success"), std::string(""));
+	PublishedTx ptx(tx);
 	auto vecTxs = STTx::getTxs(const_cast<STTx&>(tx));
 	if (vecTxs.size() > 1)
 	{
@@ -2747,11 +2722,11 @@ void NetworkOPsImp::PubValidatedTxForTable(const STTx& tx)
 		}
 		for (auto item : listPair)
 		{
-			pubChainSqlTableTxs(item.first, item.second, tx, res);
+			pubChainSqlTableTxs(item.first, item.second, ptx, res);
 		}
 		if (listPair.size() > 0)
 		{
-			pubChainSqlTxResult(tx, res, true);
+			pubChainSqlTxResult(ptx, res, true);
 		}
 	}
 	else
@@ -2772,7 +2747,7 @@ void NetworkOPsImp::PubValidatedTxForTable(const STTx& tx)
 		else
 		{
 			//ripple original tx
-			pubChainSqlTxResult(tx, res, true);
+			pubChainSqlTxResult(ptx, res, true);
 		}
 	}
 }
@@ -2861,90 +2836,30 @@ void NetworkOPsImp::pubAccountTransaction (
 void NetworkOPsImp::pubTableTxs(const AccountID& owner, const std::string& sTableName,
 	const STTx& stTxn, const std::pair<std::string, std::string>& res,bool bValidated)
 {
+	PublishedTx ptx(stTxn);
 	//db_success come,but validate_success not processed
-	if (!bValidated && mSubTx.find(stTxn.getTransactionID()) != mSubTx.end())
+	if (!bValidated && mTableSubs.waitsValidation(stTxn.getTransactionID()))
 	{
 		auto result = std::make_pair("validate_success", "");
-		pubChainSqlTxResult(stTxn, result, true);
+		pubChainSqlTxResult(ptx, result, true);
 	}
 
-	pubChainSqlTxResult(stTxn, res, bValidated);
-	pubChainSqlTableTxs(owner, sTableName, stTxn, res);
+	pubChainSqlTxResult(ptx, res, bValidated);
+	pubChainSqlTableTxs(owner, sTableName, ptx, res);
 }
 
 //publish results for chain-sql txs
-void NetworkOPsImp::pubChainSqlTxResult(const STTx& stTxn,
+void NetworkOPsImp::pubChainSqlTxResult(PublishedTx& tx,
 	const std::pair<std::string, std::string>& disposRes,bool bValidated)
 {
-	ScopedLockType sl(mSubLock);
-	auto& subTx = bValidated ? mSubTx : mValidatedSubTx;
-	if (!subTx.empty())
-	{
-		auto simiIt	= subTx.find(stTxn.getTransactionID());
-		if (simiIt != subTx.end())
-		{
-			InfoSub::pointer p = simiIt->second.first.lock();
-			if (p)
-			{
-				Json::Value jvObj(Json::objectValue);
-				jvObj[jss::type] = "singleTransaction";
-				jvObj[jss::transaction] = stTxn.getJson(0);
-				jvObj[jss::status] = disposRes.first;
-				if (disposRes.second.size() != 0)
-					jvObj[jss::error_message] = disposRes.second;
-
-				p->send(jvObj, true);
-				//for chainsql type,subscribe db event
-				if (stTxn.isChainSqlBaseType() && bValidated)
-				{
-					mValidatedSubTx[simiIt->first] = make_pair(p, app_.getLedgerMaster().getValidLedgerIndex() + 5);
-				}
-			}
-
-			subTx.erase(simiIt);
-		}
-	}
+	mTableSubs.pubTxResult(tx, disposRes, bValidated,
+		app_.getLedgerMaster().getValidLedgerIndex());
 }
 
 void NetworkOPsImp::pubChainSqlTableTxs(const AccountID& ownerId, const std::string& sTableName, 
-	const STTx& stTxn,const std::pair<std::string,std::string>& disposRes)
+	PublishedTx& tx,const std::pair<std::string,std::string>& disposRes)
 {
-	ScopedLockType sl(mSubLock);
-	if (mSubTable.find(ownerId) != mSubTable.end() &&
-		mSubTable[ownerId].find(sTableName) != mSubTable[ownerId].end())
-	{
-		Json::Value jvObj(Json::objectValue);
-		jvObj[jss::type] = "table";
-		jvObj[jss::tablename] = sTableName;
-		jvObj[jss::owner] = to_string(ownerId);
-		jvObj[jss::transaction] = stTxn.getJson(0);
-		jvObj[jss::status] = disposRes.first;
-		if (disposRes.second.size() != 0)
-			jvObj[jss::error_message] = disposRes.second;
-
-		auto iter = mSubTable[ownerId][sTableName].begin();
-		while (iter != mSubTable[ownerId][sTableName].end())
-		{
-			InfoSub::pointer p = iter->second.lock();
-
-			if (p)
-			{
-				p->send(jvObj, true);
-				++iter;
-			}
-			else
-			{
-				iter = mSubTable[ownerId][sTableName].erase(iter);
-				if (mSubTable[ownerId][sTableName].size() == 0)
-				{
-					mSubTable[ownerId].erase(sTableName);
-					if (mSubTable[ownerId].size() == 0)
-						mSubTable.erase(ownerId);
-					break;
-				}
-			}
-		}
-	}
+	mTableSubs.pubTableTx(ownerId, sTableName, tx, disposRes);
 }
 //
 // Monitoring
@@ -3099,69 +3014,22 @@ bool NetworkOPsImp::unsubLedger (std::uint64_t uSeq)
 //for all txs which changes the table
 void NetworkOPsImp::subTable(InfoSub::ref isrListener, AccountID const& accountID, std::string const& sTableName)
 {
-	ScopedLockType sl(mSubLock);
-
-	auto simIterator = mSubTable.find(accountID);
-	if (simIterator == mSubTable.end())
-	{
-		hash_map<std::string, SubMapType> map;
-		// Not found, note that account has a new single listner.
-		SubMapType  usisElement;
-		usisElement[isrListener->getSeq()] = isrListener;
-		map[sTableName] = usisElement;
-		mSubTable.insert(simIterator,
-			make_pair(accountID, map));
-	}
-	else
-	{
-		// Found owner, not found table
-		auto iter = simIterator->second.find(sTableName);
-		if (iter == simIterator->second.end())
-		{
-			SubMapType  usisElement;
-			usisElement[isrListener->getSeq()] = isrListener;
-			simIterator->second.insert(iter, make_pair(sTableName, usisElement));
-		}
-		else
-		{
-			//owner and table both found
-			simIterator->second[sTableName][isrListener->getSeq()] = isrListener;
-		}
-		
-	}
+	mTableSubs.subTable(isrListener, accountID, sTableName);
 }
 void NetworkOPsImp::unsubTable(InfoSub::ref isplistener, AccountID const& accountID, std::string const& sTableName)
 {
-	ScopedLockType sl(mSubLock);
-	if (mSubTable.find(accountID) != mSubTable.end())
-	{
-		if (mSubTable[accountID].find(sTableName) != mSubTable[accountID].end())
-		{
-			mSubTable[accountID][sTableName].erase(isplistener->getSeq());
-			if (mSubTable[accountID][sTableName].size() == 0)
-			{
-				mSubTable[accountID].erase(sTableName);
-			}
-		}
-		if (mSubTable[accountID].size() == 0)
-		{
-			mSubTable.erase(accountID);
-		}
-	}
+	mTableSubs.unsubTable(isplistener->getSeq(), accountID, sTableName);
 }
 
 //for a single tx
 void NetworkOPsImp::subTransaction(InfoSub::ref isrListener, uint256 const& uTxId, const int lastLedgerSeq)
 {
-	ScopedLockType sl(mSubLock);
-	
-	mSubTx[uTxId] = make_pair(isrListener, lastLedgerSeq);
+	mTableSubs.subTx(isrListener, uTxId, lastLedgerSeq, m_ledgerMaster.getValidLedgerIndex());
 }
 
 void NetworkOPsImp::unsubTransaction(InfoSub::ref ispListener, uint256 const& uTxId)
 {
-	ScopedLockType sl(mSubLock);
-	mSubTx.erase(uTxId);
+	mTableSubs.unsubTx(uTxId);
 }
 
 // <-- bool: true=added, false=already there
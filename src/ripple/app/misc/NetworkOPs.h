@@ -237,6 +237,7 @@ namespace ripple {
 		virtual void pubTableTxs(const AccountID& ownerId, const std::string& sTableName,
 			const STTx& stTxn, const std::pair<std::string, std::string>& disposRes, bool bValidated) = 0;
 		virtual void TryCheckSubTx() = 0;
+		virtual Json::Value getTableSubsJson() = 0;
 	};
 
 	//------------------------------------------------------------------------------
@@ -730,6 +730,12 @@ SHAMapStoreImp::clearPrior (LedgerIndex lastRotated)
         "DELETE FROM AccountTransactions WHERE LedgerSeq < %u;");
     if (health())
         return;
+
+    clearSql (*transactionDb_, lastRotated,
+        "SELECT MIN(LedgerSeq) FROM TableTransactions;",
+        "DELETE FROM TableTransactions WHERE LedgerSeq < %u;");
+    if (health())
+        return;
 }
 
 SHAMapStoreImp::Health
@@ -0,0 +1,100 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#ifndef RIPPLE_APP_MISC_SIGVERIFIER_H_INCLUDED
+#define RIPPLE_APP_MISC_SIGVERIFIER_H_INCLUDED
+
+#include <ripple/core/impl/Workers.h>
+#include <ripple/json/json_value.h>
+#include <ripple/protocol/STTx.h>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+class HashRouter;
+
+/** Verifies transaction signatures in batches on its own threads.
+
+    Transactions received from peers are queued here before they go to
+    the job queue. A verify thread takes what piled up while the threads
+    were busy, up to batchSize signatures at a time, and caches each
+    result in the HashRouter. checkValidity then finds the result there
+    and does not verify again.
+*/
+class SigVerifier : private Workers::Callback
+{
+public:
+    /** Called from a verify thread, with true if the signature is good. */
+    using done_type = std::function<void(bool)>;
+
+    static std::size_t const batchSize = 64;
+
+    SigVerifier (HashRouter& router, int threads);
+
+    /** Queue the signature check of a transaction. */
+    void
+    add (std::shared_ptr<STTx const> const& tx,
+        bool allowMultiSign, done_type done);
+
+    /** Check the signatures of txs on the verify threads and wait.
+
+        @return The number of good signatures.
+    */
+    std::size_t
+    verify (std::vector<std::shared_ptr<STTx const>> const& txs,
+        bool allowMultiSign);
+
+    /** Signatures queued and not taken by a verify thread yet. */
+    std::size_t
+    pending () const;
+
+    Json::Value
+    getInfo () const;
+
+private:
+    struct Item
+    {
+        std::shared_ptr<STTx const> tx;
+        bool allowMultiSign;
+        done_type done;
+    };
+
+    void
+    processTask () override;
+
+    HashRouter& router_;
+
+    mutable std::mutex mutex_;
+    std::deque<Item> queue_;
+
+    std::atomic<std::uint64_t> verified_;
+    std::atomic<std::uint64_t> batches_;
+
+    // Last, so the threads are gone before the queue is destroyed.
+    Workers workers_;
+};
+
+} // ripple
+
+#endif
@@ -0,0 +1,202 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#ifndef RIPPLE_APP_MISC_TABLESUBSCRIPTIONS_H_INCLUDED
+#define RIPPLE_APP_MISC_TABLESUBSCRIPTIONS_H_INCLUDED
+
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/json/json_value.h>
+#include <ripple/net/InfoSub.h>
+#include <ripple/protocol/Protocol.h>
+#include <ripple/protocol/STTx.h>
+#include <boost/optional.hpp>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+class JobQueue;
+
+/** The json of a published tx.
+
+    Built the first time an event needs it and shared by every event
+    the tx is published in.
+*/
+class PublishedTx
+{
+public:
+    explicit
+    PublishedTx (STTx const& tx)
+        : tx_ (tx)
+    {
+    }
+
+    STTx const&
+    tx () const
+    {
+        return tx_;
+    }
+
+    Json::Value const&
+    json ();
+
+private:
+    STTx const& tx_;
+    boost::optional<Json::Value> json_;
+};
+
+/** Subscriptions to chainsql tables and to single txs.
+
+    Subscriptions are spread over shards, each with its own lock, by
+    owner and table name or by tx hash. Publishing only holds the lock
+    of one shard while it collects the listeners. The event is then
+    written once into a shared buffer and fanned out to the listeners
+    by a job, so a hot table does not hold up ledger acceptance.
+
+    Events of one shard are sent in the order they were published, so
+    the events of one table or one tx keep their order.
+*/
+class TableSubscriptions
+{
+public:
+    /** Dispose status and error message of a tx. */
+    using TxResult = std::pair<std::string, std::string>;
+
+    TableSubscriptions (JobQueue& jobQueue, beast::Journal journal,
+        std::size_t shards = 16);
+
+    void
+    subTable (InfoSub::ref listener, AccountID const& owner,
+        std::string const& table);
+
+    void
+    unsubTable (std::uint64_t seq, AccountID const& owner,
+        std::string const& table);
+
+    /** Ledgers past the validated one a tx subscription may wait for */
+    static LedgerIndex const maxTxWait = 256;
+
+    /** Subscribe to `txId` until ledger `lastLedgerSeq`, at most
+        `maxTxWait` ledgers after `validIndex`.
+    */
+    void
+    subTx (InfoSub::ref listener, uint256 const& txId,
+        LedgerIndex lastLedgerSeq, LedgerIndex validIndex);
+
+    void
+    unsubTx (uint256 const& txId);
+
+    /** Whether a listener still waits for `txId` to be validated. */
+    bool
+    waitsValidation (uint256 const& txId);
+
+    /** Whether a tx subscription expires once ledger `validIndex`
+        is validated.
+    */
+    bool
+    expiresBy (LedgerIndex validIndex);
+
+    /** Publish the result of a tx to the listener subscribed to it.
+
+        On validation a chainsql tx stays subscribed until its db result,
+        at most until ledger `validIndex` + 5.
+    */
+    void
+    pubTxResult (PublishedTx& tx, TxResult const& result,
+        bool validated, LedgerIndex validIndex);
+
+    /** Publish a tx to the listeners of a table. */
+    void
+    pubTableTx (AccountID const& owner, std::string const& table,
+        PublishedTx& tx, TxResult const& result);
+
+    /** Tell the listeners of txs which were not validated, or not
+        written to db, by ledger `validIndex` that they timed out.
+
+        Only the subscriptions expiring before `validIndex` are looked
+        at. `since` is when the expiry was due, for the latency
+        reported by getInfo.
+    */
+    void
+    expireTxs (LedgerIndex validIndex,
+        std::chrono::steady_clock::time_point since);
+
+    Json::Value
+    getInfo ();
+
+private:
+    using SubMapType = hash_map <std::uint64_t, InfoSub::wptr>;
+    using SubTxMapType = hash_map <uint256, std::pair<InfoSub::wptr, LedgerIndex>>;
+    using TableKey = std::pair<AccountID, std::string>;
+
+    struct Event
+    {
+        std::vector<InfoSub::pointer> listeners;
+        Json::Value json;
+        std::shared_ptr<std::string const> text;
+    };
+
+    struct Shard
+    {
+        std::mutex mutex;
+        hash_map <TableKey, SubMapType> tables;
+        SubTxMapType txs;           // waiting for validation
+        SubTxMapType validatedTxs;  // validated, waiting for db
+        // tx hashes by the ledger they expire after, the ledger a
+        // subscription is kept with in txs or validatedTxs
+        std::map<LedgerIndex, std::vector<uint256>> expiry;
+        std::deque<Event> events;
+        bool dispatching = false;
+    };
+
+    Shard&
+    tableShard (AccountID const& owner, std::string const& table);
+
+    Shard&
+    txShard (uint256 const& txId);
+
+    static void
+    unindex (Shard& shard, uint256 const& txId, LedgerIndex seq);
+
+    void
+    publish (Shard& shard, std::vector<InfoSub::pointer> listeners,
+        Json::Value json);
+
+    void
+    dispatch (Shard& shard);
+
+    JobQueue& jobQueue_;
+    beast::Journal j_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<std::uint64_t> published_;
+    std::atomic<std::uint64_t> sent_;
+    std::atomic<std::uint64_t> expired_;
+    std::atomic<std::uint64_t> expiryLatency_;  // microseconds, last pass
+};
+
+} // ripple
+
+#endif
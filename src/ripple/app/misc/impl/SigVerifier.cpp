@@ -0,0 +1,131 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/misc/SigVerifier.h>
+#include <ripple/app/misc/HashRouter.h>
+#include <ripple/app/tx/apply.h>
+#include <ripple/protocol/JsonFields.h>
+#include <condition_variable>
+
+namespace ripple {
+
+SigVerifier::SigVerifier (HashRouter& router, int threads)
+    : router_ (router)
+    , verified_ (0)
+    , batches_ (0)
+    , workers_ (*this, "SigVerify", threads)
+{
+}
+
+void
+SigVerifier::add (std::shared_ptr<STTx const> const& tx,
+    bool allowMultiSign, done_type done)
+{
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        queue_.push_back ({ tx, allowMultiSign, std::move (done) });
+    }
+    workers_.addTask ();
+}
+
+std::size_t
+SigVerifier::verify (std::vector<std::shared_ptr<STTx const>> const& txs,
+    bool allowMultiSign)
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::size_t remaining = txs.size ();
+    std::size_t good = 0;
+
+    for (auto const& tx : txs)
+    {
+        add (tx, allowMultiSign,
+            [&](bool valid)
+            {
+                std::lock_guard<std::mutex> lock (mutex);
+                if (valid)
+                    ++good;
+                if (--remaining == 0)
+                    cv.notify_one ();
+            });
+    }
+
+    std::unique_lock<std::mutex> lock (mutex);
+    cv.wait (lock, [&] { return remaining == 0; });
+    return good;
+}
+
+std::size_t
+SigVerifier::pending () const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    return queue_.size ();
+}
+
+Json::Value
+SigVerifier::getInfo () const
+{
+    Json::Value ret (Json::objectValue);
+    ret[jss::threads] = workers_.getNumberOfThreads ();
+    ret[jss::pending] = static_cast<Json::UInt> (pending ());
+    ret[jss::verified] = static_cast<Json::UInt> (verified_.load ());
+    ret[jss::batches] = static_cast<Json::UInt> (batches_.load ());
+    return ret;
+}
+
+void
+SigVerifier::processTask ()
+{
+    // Every add posts a task, so a thread often finds the
+    // signatures already taken by an earlier batch.
+    std::vector<Item> batch;
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        auto const n = std::min (batchSize, queue_.size ());
+        batch.reserve (n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            batch.push_back (std::move (queue_.front ()));
+            queue_.pop_front ();
+        }
+    }
+    if (batch.empty ())
+        return;
+
+    ++batches_;
+    for (auto& item : batch)
+    {
+        bool valid = false;
+        try
+        {
+            valid = checkSignature (router_,
+                *item.tx, item.allowMultiSign).first;
+        }
+        catch (std::exception const&)
+        {
+            // left unknown, checkValidity will run into it again
+        }
+        ++verified_;
+        if (item.done)
+            item.done (valid);
+    }
+}
+
+} // ripple
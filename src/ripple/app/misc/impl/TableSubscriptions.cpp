@@ -0,0 +1,362 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/misc/TableSubscriptions.h>
+#include <ripple/beast/hash/uhash.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/protocol/JsonFields.h>
+#include <algorithm>
+
+namespace ripple {
+
+Json::Value const&
+PublishedTx::json ()
+{
+    if (! json_)
+        json_ = tx_.getJson (0);
+    return *json_;
+}
+
+//------------------------------------------------------------------------------
+
+TableSubscriptions::TableSubscriptions (JobQueue& jobQueue,
+        beast::Journal journal, std::size_t shards)
+    : jobQueue_ (jobQueue)
+    , j_ (journal)
+    , published_ (0)
+    , sent_ (0)
+    , expired_ (0)
+    , expiryLatency_ (0)
+{
+    shards_.reserve (shards);
+    for (std::size_t i = 0; i < shards; ++i)
+        shards_.push_back (std::make_unique<Shard> ());
+}
+
+TableSubscriptions::Shard&
+TableSubscriptions::tableShard (AccountID const& owner,
+    std::string const& table)
+{
+    return *shards_[beast::uhash<> () (TableKey (owner, table)) %
+        shards_.size ()];
+}
+
+TableSubscriptions::Shard&
+TableSubscriptions::txShard (uint256 const& txId)
+{
+    return *shards_[beast::uhash<> () (txId) % shards_.size ()];
+}
+
+void
+TableSubscriptions::subTable (InfoSub::ref listener,
+    AccountID const& owner, std::string const& table)
+{
+    auto& shard = tableShard (owner, table);
+    std::lock_guard<std::mutex> lock (shard.mutex);
+    shard.tables[TableKey (owner, table)][listener->getSeq ()] = listener;
+}
+
+void
+TableSubscriptions::unsubTable (std::uint64_t seq,
+    AccountID const& owner, std::string const& table)
+{
+    auto& shard = tableShard (owner, table);
+    std::lock_guard<std::mutex> lock (shard.mutex);
+    auto const it = shard.tables.find (TableKey (owner, table));
+    if (it == shard.tables.end ())
+        return;
+    it->second.erase (seq);
+    if (it->second.empty ())
+        shard.tables.erase (it);
+}
+
+// Called with the shard locked, drops one entry of `txId` from the
+// expiry bucket of ledger `seq`.
+void
+TableSubscriptions::unindex (Shard& shard, uint256 const& txId,
+    LedgerIndex seq)
+{
+    auto const bucket = shard.expiry.find (seq);
+    if (bucket == shard.expiry.end ())
+        return;
+    auto& ids = bucket->second;
+    auto const it = std::find (ids.begin (), ids.end (), txId);
+    if (it != ids.end ())
+        ids.erase (it);
+    if (ids.empty ())
+        shard.expiry.erase (bucket);
+}
+
+void
+TableSubscriptions::subTx (InfoSub::ref listener, uint256 const& txId,
+    LedgerIndex lastLedgerSeq, LedgerIndex validIndex)
+{
+    lastLedgerSeq = std::min (lastLedgerSeq, validIndex + maxTxWait);
+
+    auto& shard = txShard (txId);
+    std::lock_guard<std::mutex> lock (shard.mutex);
+    auto const it = shard.txs.find (txId);
+    if (it != shard.txs.end ())
+        unindex (shard, txId, it->second.second);
+    shard.txs[txId] = std::make_pair (listener, lastLedgerSeq);
+    shard.expiry[lastLedgerSeq].push_back (txId);
+}
+
+void
+TableSubscriptions::unsubTx (uint256 const& txId)
+{
+    auto& shard = txShard (txId);
+    std::lock_guard<std::mutex> lock (shard.mutex);
+    auto const it = shard.txs.find (txId);
+    if (it == shard.txs.end ())
+        return;
+    unindex (shard, txId, it->second.second);
+    shard.txs.erase (it);
+}
+
+bool
+TableSubscriptions::waitsValidation (uint256 const& txId)
+{
+    auto& shard = txShard (txId);
+    std::lock_guard<std::mutex> lock (shard.mutex);
+    return shard.txs.find (txId) != shard.txs.end ();
+}
+
+bool
+TableSubscriptions::expiresBy (LedgerIndex validIndex)
+{
+    for (auto& shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock (shard->mutex);
+        if (! shard->expiry.empty () &&
+                shard->expiry.begin ()->first < validIndex)
+            return true;
+    }
+    return false;
+}
+
+void
+TableSubscriptions::pubTxResult (PublishedTx& tx, TxResult const& result,
+    bool validated, LedgerIndex validIndex)
+{
+    auto const txId = tx.tx ().getTransactionID ();
+    auto& shard = txShard (txId);
+    InfoSub::pointer p;
+    {
+        std::lock_guard<std::mutex> lock (shard.mutex);
+        auto& subTx = validated ? shard.txs : shard.validatedTxs;
+        auto const it = subTx.find (txId);
+        if (it == subTx.end ())
+            return;
+        p = it->second.first.lock ();
+        unindex (shard, txId, it->second.second);
+        subTx.erase (it);
+        //for chainsql type,subscribe db event
+        if (p && validated && tx.tx ().isChainSqlBaseType ())
+        {
+            auto const old = shard.validatedTxs.find (txId);
+            if (old != shard.validatedTxs.end ())
+                unindex (shard, txId, old->second.second);
+            shard.validatedTxs[txId] = std::make_pair (p, validIndex + 5);
+            shard.expiry[validIndex + 5].push_back (txId);
+        }
+    }
+    if (! p)
+        return;
+
+    Json::Value jvObj (Json::objectValue);
+    jvObj[jss::type] = "singleTransaction";
+    jvObj[jss::transaction] = tx.json ();
+    jvObj[jss::status] = result.first;
+    if (! result.second.empty ())
+        jvObj[jss::error_message] = result.second;
+    publish (shard, { p }, std::move (jvObj));
+}
+
+void
+TableSubscriptions::pubTableTx (AccountID const& owner,
+    std::string const& table, PublishedTx& tx, TxResult const& result)
+{
+    auto& shard = tableShard (owner, table);
+    std::vector<InfoSub::pointer> listeners;
+    {
+        std::lock_guard<std::mutex> lock (shard.mutex);
+        auto const it = shard.tables.find (TableKey (owner, table));
+        if (it == shard.tables.end ())
+            return;
+        auto& subMap = it->second;
+        listeners.reserve (subMap.size ());
+        for (auto iter = subMap.begin (); iter != subMap.end ();)
+        {
+            if (auto p = iter->second.lock ())
+            {
+                listeners.push_back (std::move (p));
+                ++iter;
+            }
+            else
+                iter = subMap.erase (iter);
+        }
+        if (subMap.empty ())
+            shard.tables.erase (it);
+    }
+    if (listeners.empty ())
+        return;
+
+    Json::Value jvObj (Json::objectValue);
+    jvObj[jss::type] = "table";
+    jvObj[jss::tablename] = table;
+    jvObj[jss::owner] = to_string (owner);
+    jvObj[jss::transaction] = tx.json ();
+    jvObj[jss::status] = result.first;
+    if (! result.second.empty ())
+        jvObj[jss::error_message] = result.second;
+    publish (shard, std::move (listeners), std::move (jvObj));
+}
+
+void
+TableSubscriptions::expireTxs (LedgerIndex validIndex,
+    std::chrono::steady_clock::time_point since)
+{
+    std::vector<std::pair<InfoSub::pointer, Json::Value>> expired;
+    auto expire = [&expired](SubTxMapType& subTx, uint256 const& txId,
+        LedgerIndex seq, char const* status)
+    {
+        auto const iter = subTx.find (txId);
+        if (iter == subTx.end () || iter->second.second != seq)
+            return false;
+        //notify time out
+        if (auto p = iter->second.first.lock ())
+        {
+            Json::Value jvObj (Json::objectValue);
+            jvObj[jss::type] = "singleTransaction";
+            jvObj[jss::transaction][jss::hash] = to_string (txId);
+            jvObj[jss::status] = status;
+            expired.emplace_back (std::move (p), std::move (jvObj));
+        }
+        subTx.erase (iter);
+        return true;
+    };
+
+    for (auto& shard : shards_)
+    {
+        {
+            std::lock_guard<std::mutex> lock (shard->mutex);
+            auto& expiry = shard->expiry;
+            while (! expiry.empty () && expiry.begin ()->first < validIndex)
+            {
+                auto const seq = expiry.begin ()->first;
+                for (auto const& txId : expiry.begin ()->second)
+                {
+                    if (expire (shard->txs, txId, seq, "validate_timeout"))
+                        ++expired_;
+                    if (expire (shard->validatedTxs, txId, seq, "db_timeout"))
+                        ++expired_;
+                }
+                expiry.erase (expiry.begin ());
+            }
+        }
+        for (auto& e : expired)
+            publish (*shard, { std::move (e.first) }, std::move (e.second));
+        expired.clear ();
+    }
+
+    using namespace std::chrono;
+    expiryLatency_ = duration_cast<microseconds> (
+        steady_clock::now () - since).count ();
+}
+
+void
+TableSubscriptions::publish (Shard& shard,
+    std::vector<InfoSub::pointer> listeners, Json::Value json)
+{
+    // written once here, the listeners only share the buffer
+    std::string text;
+    Json::stream (json, [&text](void const* data, std::size_t n)
+    {
+        text.append (static_cast<char const*> (data), n);
+    });
+
+    std::lock_guard<std::mutex> lock (shard.mutex);
+    shard.events.push_back ({ std::move (listeners), std::move (json),
+        std::make_shared<std::string const> (std::move (text)) });
+    ++published_;
+    dispatch (shard);
+}
+
+// Called with the shard locked. One job at a time sends the events of a
+// shard, so they go out in the order they were published.
+void
+TableSubscriptions::dispatch (Shard& shard)
+{
+    if (shard.dispatching)
+        return;
+    shard.dispatching = true;
+
+    auto const added = jobQueue_.addJob (jtPUBTABLE, "TableSubscriptions::dispatch",
+        [this, &shard](Job&)
+        {
+            std::unique_lock<std::mutex> lock (shard.mutex);
+            while (! shard.events.empty ())
+            {
+                auto event = std::move (shard.events.front ());
+                shard.events.pop_front ();
+                lock.unlock ();
+                for (auto const& p : event.listeners)
+                    p->sendShared (event.json, event.text, true);
+                sent_ += event.listeners.size ();
+                lock.lock ();
+            }
+            shard.dispatching = false;
+        });
+    if (! added)
+    {
+        // shutting down
+        JLOG (j_.debug ()) << "dropped " << shard.events.size () <<
+            " table subscription events";
+        shard.events.clear ();
+        shard.dispatching = false;
+    }
+}
+
+Json::Value
+TableSubscriptions::getInfo ()
+{
+    std::size_t tables = 0, txs = 0, queued = 0;
+    for (auto& shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock (shard->mutex);
+        tables += shard->tables.size ();
+        txs += shard->txs.size () + shard->validatedTxs.size ();
+        queued += shard->events.size ();
+    }
+
+    Json::Value ret (Json::objectValue);
+    ret[jss::shards] = Json::UInt (shards_.size ());
+    ret[jss::tables] = Json::UInt (tables);
+    ret[jss::txs] = Json::UInt (txs);
+    ret[jss::queued] = Json::UInt (queued);
+    ret[jss::published] = Json::UInt (published_.load ());
+    ret[jss::sent] = Json::UInt (sent_.load ());
+    ret[jss::expired] = Json::UInt (expired_.load ());
+    ret[jss::expiry_latency_us] = Json::UInt (expiryLatency_.load ());
+    return ret;
+}
+
+} // ripple
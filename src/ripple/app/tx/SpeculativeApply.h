@@ -0,0 +1,119 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+
+#ifndef RIPPLE_APP_TX_SPECULATIVEAPPLY_H_INCLUDED
+#define RIPPLE_APP_TX_SPECULATIVEAPPLY_H_INCLUDED
+
+#include <ripple/app/tx/apply.h>
+#include <ripple/core/impl/Workers.h>
+#include <ripple/ledger/OpenView.h>
+#include <ripple/protocol/STTx.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+class Application;
+
+/** Applies transactions to a closed ledger view on several threads.
+
+    The transactions go in waves of waveSize per thread. Each one that
+    canSpeculate is applied on a worker thread to its own view over the
+    state before the wave, recording the ledger entries it looked at.
+    The views are then applied to the ledger view in the given order.
+    A transaction that looked at an entry changed earlier in the wave
+    is applied again, so the result is exactly that of applying the
+    transactions one after the other.
+*/
+class SpeculativeApply : private Workers::Callback
+{
+public:
+    static std::size_t const waveSize = 8;
+
+    SpeculativeApply (Application& app, int threads,
+        beast::Journal journal);
+
+    /** Apply txs to view, in order.
+
+        Not to be called by two threads at once.
+
+        @return The result of each transaction, as applyTransaction.
+    */
+    std::vector<ApplyResult>
+    apply (OpenView& view,
+        std::vector<std::shared_ptr<STTx const>> const& txs,
+        bool retryAssured, ApplyFlags flags);
+
+    /** Returns true if the tx only changes the ledger.
+
+        Chainsql and offer transactions also touch the table
+        storage or the order books, so they are applied in turn.
+    */
+    static bool
+    canSpeculate (STTx const& tx);
+
+    /** Transactions whose speculative result was kept. */
+    std::uint64_t
+    committed () const
+    {
+        return committed_;
+    }
+
+    /** Transactions speculated and then applied again. */
+    std::uint64_t
+    reapplied () const
+    {
+        return reapplied_;
+    }
+
+private:
+    struct Run;
+
+    void
+    processTask () override;
+
+    void
+    speculate (Run& run);
+
+    Application& app_;
+    beast::Journal j_;
+
+    // The wave being speculated.
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<Run*> tasks_;
+    std::size_t remaining_ = 0;
+    OpenView const* view_ = nullptr;
+    bool retryAssured_ = false;
+    ApplyFlags flags_ = tapNONE;
+
+    std::atomic<std::uint64_t> committed_;
+    std::atomic<std::uint64_t> reapplied_;
+
+    // Last, so the threads are gone before the wave state.
+    Workers workers_;
+};
+
+} // ripple
+
+#endif
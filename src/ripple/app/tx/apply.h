@@ -65,6 +65,19 @@ checkValidity(HashRouter& router,
     STTx const& tx, Rules const& rules,
         Config const& config);
 
+/** Checks the transaction signature only.
+
+    The result is cached the same way as in checkValidity,
+    so a later checkValidity does not verify it again.
+
+    @return `std::pair`, where `.first` is `true` if the
+            signature is good, and `.second` is the reason
+            if it is not.
+*/
+std::pair<bool, std::string>
+checkSignature(HashRouter& router,
+    STTx const& tx, bool allowMultiSign);
+
 
 /** Sets the validity of a given transaction in the cache.
 
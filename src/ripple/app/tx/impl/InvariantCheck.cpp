@@ -263,6 +263,7 @@ LedgerEntryTypesMatch::visitEntry(
 		case ltTABLELIST:
 		case ltINSERTMAP:
 		case ltCHAINID:
+		case ltTABLE:
             break;
         default:
             invalidTypeAdded_ = true;
@@ -0,0 +1,401 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/tx/SpeculativeApply.h>
+#include <ripple/basics/Log.h>
+#include <ripple/protocol/TxFormats.h>
+#include <boost/optional.hpp>
+#include <algorithm>
+#include <set>
+
+namespace ripple {
+
+namespace detail {
+
+// Forwards to a view and records what was looked at.
+class RecordingView : public ReadView
+{
+private:
+    ReadView const& base_;
+
+    // Entries read or tested for, and the intervals searched by succ.
+    mutable std::set<key_type> keys_;
+    mutable std::vector<std::pair<key_type,
+        boost::optional<key_type>>> ranges_;
+    mutable std::set<key_type> txs_;
+    // Iterated over the state or the tx map.
+    mutable bool all_ = false;
+
+public:
+    explicit
+    RecordingView (ReadView const& base)
+        : base_ (base)
+    {
+    }
+
+    /** Returns true if a change to entries or txs was looked at. */
+    bool
+    saw (std::set<key_type> const& entries,
+        std::set<key_type> const& txs) const
+    {
+        if (all_)
+            return true;
+        for (auto const& key : keys_)
+            if (entries.count (key))
+                return true;
+        for (auto const& range : ranges_)
+        {
+            auto const iter = entries.upper_bound (range.first);
+            if (iter != entries.end () &&
+                    (! range.second || *iter < *range.second))
+                return true;
+        }
+        for (auto const& key : txs_)
+            if (txs.count (key))
+                return true;
+        return false;
+    }
+
+    LedgerInfo const&
+    info() const override
+    {
+        return base_.info();
+    }
+
+    bool
+    open() const override
+    {
+        return base_.open();
+    }
+
+    Fees const&
+    fees() const override
+    {
+        return base_.fees();
+    }
+
+    Rules const&
+    rules() const override
+    {
+        return base_.rules();
+    }
+
+    bool
+    exists (Keylet const& k) const override
+    {
+        keys_.insert (k.key);
+        return base_.exists (k);
+    }
+
+    boost::optional<key_type>
+    succ (key_type const& key, boost::optional<
+        key_type> const& last = boost::none) const override
+    {
+        ranges_.emplace_back (key, last);
+        return base_.succ (key, last);
+    }
+
+    std::shared_ptr<SLE const>
+    read (Keylet const& k) const override
+    {
+        keys_.insert (k.key);
+        return base_.read (k);
+    }
+
+    STAmount
+    balanceHook (AccountID const& account,
+        AccountID const& issuer,
+            STAmount const& amount) const override
+    {
+        return base_.balanceHook (account, issuer, amount);
+    }
+
+    std::uint32_t
+    ownerCountHook (AccountID const& account,
+        std::uint32_t count) const override
+    {
+        return base_.ownerCountHook (account, count);
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesBegin() const override
+    {
+        all_ = true;
+        return base_.slesBegin();
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesEnd() const override
+    {
+        all_ = true;
+        return base_.slesEnd();
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesUpperBound (key_type const& key) const override
+    {
+        all_ = true;
+        return base_.slesUpperBound (key);
+    }
+
+    std::unique_ptr<txs_type::iter_base>
+    txsBegin() const override
+    {
+        all_ = true;
+        return base_.txsBegin();
+    }
+
+    std::unique_ptr<txs_type::iter_base>
+    txsEnd() const override
+    {
+        all_ = true;
+        return base_.txsEnd();
+    }
+
+    bool
+    txExists (key_type const& key) const override
+    {
+        txs_.insert (key);
+        return base_.txExists (key);
+    }
+
+    tx_type
+    txRead (key_type const& key) const override
+    {
+        all_ = true;
+        return base_.txRead (key);
+    }
+};
+
+// Forwards changes to a view and records what was changed.
+class RecordingRawView : public TxsRawView
+{
+private:
+    OpenView& to_;
+    std::set<uint256>& entries_;
+    std::set<uint256>& txs_;
+
+public:
+    RecordingRawView (OpenView& to,
+            std::set<uint256>& entries, std::set<uint256>& txs)
+        : to_ (to)
+        , entries_ (entries)
+        , txs_ (txs)
+    {
+    }
+
+    void
+    rawErase (std::shared_ptr<SLE> const& sle) override
+    {
+        entries_.insert (sle->key());
+        to_.rawErase (sle);
+    }
+
+    void
+    rawInsert (std::shared_ptr<SLE> const& sle) override
+    {
+        entries_.insert (sle->key());
+        to_.rawInsert (sle);
+    }
+
+    void
+    rawReplace (std::shared_ptr<SLE> const& sle) override
+    {
+        entries_.insert (sle->key());
+        to_.rawReplace (sle);
+    }
+
+    void
+    rawDestroyZXC (ZXCAmount const& fee) override
+    {
+        to_.rawDestroyZXC (fee);
+    }
+
+    void
+    rawTxInsert (ReadView::key_type const& key,
+        std::shared_ptr<Serializer const> const& txn,
+            std::shared_ptr<Serializer const> const& metaData) override
+    {
+        txs_.insert (key);
+        to_.rawTxInsert (key, txn, metaData);
+    }
+};
+
+} // detail
+
+struct SpeculativeApply::Run
+{
+    std::shared_ptr<STTx const> tx;
+    // The tx count of the view if all earlier txs of the wave apply.
+    std::size_t txCount = 0;
+    std::unique_ptr<detail::RecordingView> reads;
+    boost::optional<OpenView> view;
+    ApplyResult result = ApplyResult::Retry;
+};
+
+SpeculativeApply::SpeculativeApply (Application& app, int threads,
+        beast::Journal journal)
+    : app_ (app)
+    , j_ (journal)
+    , committed_ (0)
+    , reapplied_ (0)
+    , workers_ (*this, "SpecApply", threads)
+{
+}
+
+std::vector<ApplyResult>
+SpeculativeApply::apply (OpenView& view,
+    std::vector<std::shared_ptr<STTx const>> const& txs,
+        bool retryAssured, ApplyFlags flags)
+{
+    std::vector<ApplyResult> results;
+    results.reserve (txs.size ());
+
+    std::size_t const threads = std::max (1,
+        workers_.getNumberOfThreads ());
+    std::size_t const size = waveSize * threads;
+    for (std::size_t first = 0; first < txs.size (); first += size)
+    {
+        std::vector<Run> wave (std::min (size, txs.size () - first));
+        std::size_t tasks;
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            for (std::size_t i = 0; i < wave.size (); ++i)
+            {
+                wave[i].tx = txs[first + i];
+                wave[i].txCount = view.txCount () + i;
+                if (canSpeculate (*wave[i].tx))
+                    tasks_.push_back (&wave[i]);
+            }
+            std::reverse (tasks_.begin (), tasks_.end ());
+            tasks = remaining_ = tasks_.size ();
+            view_ = &view;
+            retryAssured_ = retryAssured;
+            flags_ = flags;
+        }
+        for (std::size_t i = 0; i < std::min (threads, tasks); ++i)
+            workers_.addTask ();
+        {
+            std::unique_lock<std::mutex> lock (mutex_);
+            cv_.wait (lock, [this] { return remaining_ == 0; });
+        }
+
+        // Commit in order, applying again what was
+        // speculated on a state that has changed since.
+        std::set<uint256> entries;
+        std::set<uint256> txIDs;
+        detail::RecordingRawView to (view, entries, txIDs);
+        for (auto& run : wave)
+        {
+            try
+            {
+                if (run.view && ! run.reads->saw (entries, txIDs) &&
+                    (run.result != ApplyResult::Success ||
+                        run.txCount == view.txCount ()))
+                {
+                    run.view->apply (to);
+                    ++committed_;
+                    results.push_back (run.result);
+                    continue;
+                }
+                if (run.view)
+                    ++reapplied_;
+
+                OpenView redo (batch_view, &view, view.txCount ());
+                auto const result = applyTransaction (app_, redo,
+                    *run.tx, retryAssured, flags, j_);
+                redo.apply (to);
+                results.push_back (result);
+            }
+            catch (std::exception const&)
+            {
+                JLOG (j_.warn()) << "Transaction throws";
+                results.push_back (ApplyResult::Fail);
+            }
+        }
+    }
+    return results;
+}
+
+bool
+SpeculativeApply::canSpeculate (STTx const& tx)
+{
+    switch (tx.getTxnType ())
+    {
+    case ttPAYMENT:
+    case ttACCOUNT_SET:
+    case ttREGULAR_KEY_SET:
+    case ttTRUST_SET:
+    case ttOFFER_CANCEL:
+    case ttSIGNER_LIST_SET:
+    case ttESCROW_CREATE:
+    case ttESCROW_FINISH:
+    case ttESCROW_CANCEL:
+    case ttPAYCHAN_CREATE:
+    case ttPAYCHAN_FUND:
+    case ttPAYCHAN_CLAIM:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void
+SpeculativeApply::processTask ()
+{
+    for (;;)
+    {
+        Run* run;
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            if (tasks_.empty ())
+                return;
+            run = tasks_.back ();
+            tasks_.pop_back ();
+        }
+
+        speculate (*run);
+
+        std::lock_guard<std::mutex> lock (mutex_);
+        if (--remaining_ == 0)
+            cv_.notify_all ();
+    }
+}
+
+void
+SpeculativeApply::speculate (Run& run)
+{
+    run.reads = std::make_unique<detail::RecordingView> (*view_);
+    run.view.emplace (batch_view, run.reads.get (), run.txCount);
+    try
+    {
+        // Quiet, the outcome may be thrown away.
+        run.result = applyTransaction (app_, *run.view, *run.tx,
+            retryAssured_, flags_, beast::Journal ());
+    }
+    catch (std::exception const&)
+    {
+        // applied again in turn
+        run.view = boost::none;
+    }
+}
+
+} // ripple
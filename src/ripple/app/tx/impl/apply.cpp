@@ -51,13 +51,9 @@ checkValidity(HashRouter& router,
     if (!(flags & SF_SIGGOOD))
     {
         // Don't know signature state. Check it.
-        auto const sigVerify = tx.checkSign(allowMultiSign);
+        auto const sigVerify = checkSignature(router, tx, allowMultiSign);
         if (! sigVerify.first)
-        {
-            router.setFlags(id, SF_SIGBAD);
             return {Validity::SigBad, sigVerify.second};
-        }
-        router.setFlags(id, SF_SIGGOOD);
     }
 
     // Signature is now known good
@@ -82,6 +78,22 @@ checkValidity(HashRouter& router,
     return {Validity::Valid, ""};
 }
 
+std::pair<bool, std::string>
+checkSignature(HashRouter& router,
+    STTx const& tx, bool allowMultiSign)
+{
+    auto const id = tx.getTransactionID();
+    auto const flags = router.getFlags(id);
+    if (flags & SF_SIGBAD)
+        return {false, "Transaction has bad signature."};
+    if (flags & SF_SIGGOOD)
+        return {true, ""};
+
+    auto const sigVerify = tx.checkSign(allowMultiSign);
+    router.setFlags(id, sigVerify.first ? SF_SIGGOOD : SF_SIGBAD);
+    return sigVerify;
+}
+
 void
 forceValidity(HashRouter& router, uint256 const& txid,
     Validity validity)
@@ -0,0 +1,226 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#ifndef BEAST_CRYPTO_SM3_CONTEXT_H_INCLUDED
+#define BEAST_CRYPTO_SM3_CONTEXT_H_INCLUDED
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace beast {
+namespace detail {
+
+// SM3 cryptographic hash, GB/T 32905-2016.
+// The context lives on the caller's stack and holds no
+// handle or lock, so any number of threads can hash at once.
+
+struct sm3_context
+{
+    static unsigned int const block_size = 64;
+    static unsigned int const digest_size = 32;
+
+    std::uint64_t tot_len;
+    unsigned int len;
+    unsigned char block[block_size];
+    std::uint32_t h[8];
+};
+
+#define BEAST_SM3_ROTL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+#define BEAST_SM3_P0(x) ((x) ^ BEAST_SM3_ROTL((x),  9) ^ BEAST_SM3_ROTL((x), 17))
+#define BEAST_SM3_P1(x) ((x) ^ BEAST_SM3_ROTL((x), 15) ^ BEAST_SM3_ROTL((x), 23))
+#define BEAST_SM3_FF0(x, y, z) ((x) ^ (y) ^ (z))
+#define BEAST_SM3_FF1(x, y, z) (((x) & (y)) | (((x) | (y)) & (z)))
+#define BEAST_SM3_GG0(x, y, z) ((x) ^ (y) ^ (z))
+#define BEAST_SM3_GG1(x, y, z) ((z) ^ ((x) & ((y) ^ (z))))
+
+// One round. Instead of shifting the eight words every round the
+// caller rotates the argument order: after a round the new A is in D
+// and the new E is in H, see sm3_transform.
+#define BEAST_SM3_ROUND(A, B, C, D, E, F, G, H, K, W, WP, FF, GG) \
+{                                                   \
+    std::uint32_t const a12 = BEAST_SM3_ROTL(A, 12);\
+    std::uint32_t const ss1 =                       \
+        BEAST_SM3_ROTL(a12 + (E) + (K), 7);         \
+    std::uint32_t const tt1 =                       \
+        FF(A, B, C) + (D) + (ss1 ^ a12) + (WP);     \
+    std::uint32_t const tt2 =                       \
+        GG(E, F, G) + (H) + ss1 + (W);              \
+    B = BEAST_SM3_ROTL(B, 9);                       \
+    D = tt1;                                        \
+    F = BEAST_SM3_ROTL(F, 19);                      \
+    H = BEAST_SM3_P0(tt2);                          \
+}
+
+//------------------------------------------------------------------------------
+
+template <class = void>
+void sm3_transform (sm3_context& ctx,
+    unsigned char const* message,
+        std::size_t block_nb) noexcept
+{
+    // T(j) rotated left by j mod 32
+    static std::uint32_t const K[64] = {
+        0x79cc4519, 0xf3988a32, 0xe7311465, 0xce6228cb,
+        0x9cc45197, 0x3988a32f, 0x7311465e, 0xe6228cbc,
+        0xcc451979, 0x988a32f3, 0x311465e7, 0x6228cbce,
+        0xc451979c, 0x88a32f39, 0x11465e73, 0x228cbce6,
+        0x9d8a7a87, 0x3b14f50f, 0x7629ea1e, 0xec53d43c,
+        0xd8a7a879, 0xb14f50f3, 0x629ea1e7, 0xc53d43ce,
+        0x8a7a879d, 0x14f50f3b, 0x29ea1e76, 0x53d43cec,
+        0xa7a879d8, 0x4f50f3b1, 0x9ea1e762, 0x3d43cec5,
+        0x7a879d8a, 0xf50f3b14, 0xea1e7629, 0xd43cec53,
+        0xa879d8a7, 0x50f3b14f, 0xa1e7629e, 0x43cec53d,
+        0x879d8a7a, 0x0f3b14f5, 0x1e7629ea, 0x3cec53d4,
+        0x79d8a7a8, 0xf3b14f50, 0xe7629ea1, 0xcec53d43,
+        0x9d8a7a87, 0x3b14f50f, 0x7629ea1e, 0xec53d43c,
+        0xd8a7a879, 0xb14f50f3, 0x629ea1e7, 0xc53d43ce,
+        0x8a7a879d, 0x14f50f3b, 0x29ea1e76, 0x53d43cec,
+        0xa7a879d8, 0x4f50f3b1, 0x9ea1e762, 0x3d43cec5
+    };
+    std::uint32_t w[68];
+    for (std::size_t i = 0; i < block_nb; i++)
+    {
+        unsigned char const* sub_block = message + (i << 6);
+        for (int j = 0; j < 16; j++)
+            w[j] =
+                ((std::uint32_t) sub_block[(j << 2) + 0] << 24)
+              | ((std::uint32_t) sub_block[(j << 2) + 1] << 16)
+              | ((std::uint32_t) sub_block[(j << 2) + 2] <<  8)
+              | ((std::uint32_t) sub_block[(j << 2) + 3]      );
+        for (int j = 16; j < 68; j++)
+            w[j] = BEAST_SM3_P1(w[j - 16] ^ w[j - 9] ^
+                BEAST_SM3_ROTL(w[j - 3], 15)) ^
+                    BEAST_SM3_ROTL(w[j - 13], 7) ^ w[j - 6];
+
+        std::uint32_t a = ctx.h[0];
+        std::uint32_t b = ctx.h[1];
+        std::uint32_t c = ctx.h[2];
+        std::uint32_t d = ctx.h[3];
+        std::uint32_t e = ctx.h[4];
+        std::uint32_t f = ctx.h[5];
+        std::uint32_t g = ctx.h[6];
+        std::uint32_t h = ctx.h[7];
+
+#define BEAST_SM3_ROUNDS4(j, FF, GG)                                            \
+        BEAST_SM3_ROUND(a, b, c, d, e, f, g, h, K[j    ], w[j    ], w[j    ] ^ w[j + 4], FF, GG) \
+        BEAST_SM3_ROUND(d, a, b, c, h, e, f, g, K[j + 1], w[j + 1], w[j + 1] ^ w[j + 5], FF, GG) \
+        BEAST_SM3_ROUND(c, d, a, b, g, h, e, f, K[j + 2], w[j + 2], w[j + 2] ^ w[j + 6], FF, GG) \
+        BEAST_SM3_ROUND(b, c, d, a, f, g, h, e, K[j + 3], w[j + 3], w[j + 3] ^ w[j + 7], FF, GG)
+
+        for (int j = 0; j < 16; j += 4)
+        {
+            BEAST_SM3_ROUNDS4(j, BEAST_SM3_FF0, BEAST_SM3_GG0)
+        }
+        for (int j = 16; j < 64; j += 4)
+        {
+            BEAST_SM3_ROUNDS4(j, BEAST_SM3_FF1, BEAST_SM3_GG1)
+        }
+
+#undef BEAST_SM3_ROUNDS4
+
+        ctx.h[0] ^= a;
+        ctx.h[1] ^= b;
+        ctx.h[2] ^= c;
+        ctx.h[3] ^= d;
+        ctx.h[4] ^= e;
+        ctx.h[5] ^= f;
+        ctx.h[6] ^= g;
+        ctx.h[7] ^= h;
+    }
+}
+
+template <class = void>
+void init (sm3_context& ctx) noexcept
+{
+    ctx.len = 0;
+    ctx.tot_len = 0;
+    ctx.h[0] = 0x7380166f;
+    ctx.h[1] = 0x4914b2b9;
+    ctx.h[2] = 0x172442d7;
+    ctx.h[3] = 0xda8a0600;
+    ctx.h[4] = 0xa96f30bc;
+    ctx.h[5] = 0x163138aa;
+    ctx.h[6] = 0xe38dee4d;
+    ctx.h[7] = 0xb0fb0e4e;
+}
+
+template <class = void>
+void update (sm3_context& ctx,
+    void const* message, std::size_t size) noexcept
+{
+    auto pm = reinterpret_cast<
+        unsigned char const*>(message);
+    ctx.tot_len += size;
+    if (ctx.len > 0)
+    {
+        std::size_t const n = std::min<std::size_t>(
+            sm3_context::block_size - ctx.len, size);
+        std::memcpy(&ctx.block[ctx.len], pm, n);
+        ctx.len += n;
+        pm += n;
+        size -= n;
+        if (ctx.len < sm3_context::block_size)
+            return;
+        sm3_transform(ctx, ctx.block, 1);
+        ctx.len = 0;
+    }
+    // full blocks are hashed straight from the message
+    std::size_t const block_nb = size / sm3_context::block_size;
+    sm3_transform(ctx, pm, block_nb);
+    pm += block_nb * sm3_context::block_size;
+    size -= block_nb * sm3_context::block_size;
+    std::memcpy(ctx.block, pm, size);
+    ctx.len = size;
+}
+
+template <class = void>
+void finish (sm3_context& ctx,
+    void* digest) noexcept
+{
+    auto const pd = reinterpret_cast<
+        unsigned char*>(digest);
+    std::uint64_t const len_b = ctx.tot_len << 3;
+    ctx.block[ctx.len++] = 0x80;
+    if (ctx.len > sm3_context::block_size - 8)
+    {
+        std::memset(ctx.block + ctx.len, 0,
+            sm3_context::block_size - ctx.len);
+        sm3_transform(ctx, ctx.block, 1);
+        ctx.len = 0;
+    }
+    std::memset(ctx.block + ctx.len, 0,
+        sm3_context::block_size - 8 - ctx.len);
+    for (int i = 0; i < 8; i++)
+        ctx.block[sm3_context::block_size - 1 - i] =
+            (std::uint8_t) (len_b >> (i << 3));
+    sm3_transform(ctx, ctx.block, 1);
+    for (int i = 0; i < 8; i++)
+    {
+        pd[(i << 2) + 0] = (std::uint8_t) (ctx.h[i] >> 24);
+        pd[(i << 2) + 1] = (std::uint8_t) (ctx.h[i] >> 16);
+        pd[(i << 2) + 2] = (std::uint8_t) (ctx.h[i] >>  8);
+        pd[(i << 2) + 3] = (std::uint8_t) (ctx.h[i]      );
+    }
+}
+
+} // detail
+} // beast
+
+#endif
@@ -0,0 +1,37 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+ 
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+ 
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#ifndef BEAST_CRYPTO_SM3_H_INCLUDED
+#define BEAST_CRYPTO_SM3_H_INCLUDED
+
+#include <ripple/beast/crypto/detail/mac_facade.h>
+#include <ripple/beast/crypto/detail/sm3_context.h>
+
+namespace beast {
+
+using sm3_hasher = detail::mac_facade<
+    detail::sm3_context, false>;
+
+// secure version
+using sm3_hasher_s = detail::mac_facade<
+    detail::sm3_context, true>;
+
+}
+
+#endif
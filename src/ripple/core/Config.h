@@ -171,6 +171,9 @@ public:
     // Thread pool configuration
     std::size_t                 WORKERS = 0;
 
+    // Threads applying the consensus set, 0 or 1 applies it in turn
+    std::size_t                 PARALLEL_APPLY = 0;
+
     // These override the command line client settings
     boost::optional<boost::asio::ip::address_v4> rpc_ip;
     boost::optional<std::uint16_t> rpc_port;
@@ -33,6 +33,9 @@ namespace soci {
 
 namespace ripple {
 
+class SQLStatementCache;
+class SQLSchemaCache;
+
 template<class T, class TMutex>
 class LockedPointer
 {
@@ -89,6 +92,7 @@ public:
                  std::string const& name,
                  const char* initString[],
                  int countInit, std::string sDBType = "sqlite");
+    ~DatabaseCon ();
 
     soci::session& getSession()
     {
@@ -100,12 +104,30 @@ public:
         return LockedSociSession (&session_, lock_);
     }
 
+    // prepared statements of this connection, use with checkoutDb held
+    SQLStatementCache& getStatementCache ()
+    {
+        return *statementCache_;
+    }
+
+    // metadata of tables, shared with other connections to the same database
+    SQLSchemaCache& getSchemaCache ()
+    {
+        return *schemaCache_;
+    }
+
+    // must be called after a transaction of this connection rolled back
+    void rolledBack ();
+
     void setupCheckpointing (JobQueue*, Logs&);
 
 private:
     LockedSociSession::mutex lock_;
 
     soci::session session_;
+    // destroyed before session_, statements are bound to it
+    std::unique_ptr<SQLStatementCache> statementCache_;
+    std::shared_ptr<SQLSchemaCache> schemaCache_;
     std::unique_ptr<Checkpointer> checkpointer_;
 };
 
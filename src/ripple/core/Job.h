@@ -69,9 +69,13 @@ enum JobType
     jtTABLESTORAGE,  // storage tables
 	jtTableCheckHash,// check tx hash
 	jtCheckSubTx,	 // check subscribe tx
+    jtPUBTABLE,      // Send table and tx subscription events
     jtSKIPNODE,      // skip node 
     jtTABLELOCALSYNC,// local synchronize tables
     jtOPERATESQL,    // write table sync info
+    jtTABLELOCALREAD,// read one table's txs from local ledgers
+    jtTABLESTORAGEPUT,// deferred first_storage writes of one table
+    jtTABLEDUMP,     // serialize the txs of a table dump
 
     // Special job types which are not dispatched by the job pool
     jtPEER          ,
@@ -66,8 +66,12 @@ add(    jtTABLESYNC,     "tableSync",               1,        false, 0,     0);
 add(    jtTABLESTORAGE,  "tableStorage",            1,        false, 0,     0);
 add(	jtTableCheckHash, "tableCheckHash",			1,		  false, 0,		0);
 add(	jtCheckSubTx,	  "checkSubTx",				1,		  false, 0,		0);
+add(    jtPUBTABLE,      "publishTable",            maxLimit, false, 0,     0);
 add(    jtTABLELOCALSYNC,"tableLocalSync",          1,        false, 0,     0);
-add(    jtOPERATESQL,    "operateSQL",              10,        false, 0,     0);
+add(    jtOPERATESQL,    "operateSQL",              maxLimit, false, 0,     0);
+add(    jtTABLELOCALREAD,"tableLocalRead",          maxLimit, false, 0,     0);
+add(    jtTABLESTORAGEPUT,"tableStoragePut",        maxLimit, false, 0,     0);
+add(    jtTABLEDUMP,     "tableDump",               maxLimit, false, 0,     0);
 add(    jtTABLE_REQ,     "tableRequest",            2,        false, 0,     0);
 add(    jtTABLE_DATA,    "tableData",               2,        false, 0,     0);
 add(    jtSKIPNODE,      "skipnode",                2,        false, 0,     0);
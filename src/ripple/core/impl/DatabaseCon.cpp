@@ -22,6 +22,8 @@
 #include <ripple/core/SociDB.h>
 #include <ripple/basics/contract.h>
 #include <ripple/basics/Log.h>
+#include <peersafe/app/sql/SQLSchemaCache.h>
+#include <peersafe/app/sql/SQLStatementCache.h>
 #include <memory>
 
 #include <boost/format.hpp>
@@ -34,6 +36,7 @@ DatabaseCon::DatabaseCon (
     std::string const& strName,
     const char* initStrings[],
     int initCount, std::string sDBType)
+    : statementCache_ (std::make_unique<SQLStatementCache> ())
 {	
 	if (sDBType.compare("sqlite") == 0) {
         auto const useTempFiles  // Use temporary files or regular DB files?
@@ -45,6 +48,10 @@ DatabaseCon::DatabaseCon (
             ? "" : (setup.dataDir / strName);
 
         open(session_, "sqlite", pPath.string());
+        // a temporary database is private to this connection
+        schemaCache_ = useTempFiles
+            ? std::make_shared<SQLSchemaCache> ()
+            : SQLSchemaCache::forDatabase ("sqlite:" + pPath.string ());
 	} else {  
         //connect to mycat server 
         std::pair<std::string, bool> type = setup.sync_db.find("type");
@@ -100,6 +107,8 @@ DatabaseCon::DatabaseCon (
 		}
 
         open(session_, back_end, connectionstring);
+        schemaCache_ = SQLSchemaCache::forDatabase (
+            back_end + ":" + connectionstring + ":" + strName);
 		if (boost::iequals(back_end, "mycat")) {
 			session_.autocommit_after_transaction(true);
 		}
@@ -124,6 +133,20 @@ DatabaseCon::DatabaseCon (
 	}
 }
 
+DatabaseCon::~DatabaseCon ()
+{
+    // statements must be released before the session they belong to
+    statementCache_.reset ();
+}
+
+void DatabaseCon::rolledBack ()
+{
+    // sqlite undoes DDL with the transaction, so the tables cached since
+    // may be gone or have other columns. MySQL commits DDL at once.
+    if (session_.get_backend_name () == "sqlite3")
+        schemaCache_->clear ();
+}
+
 DatabaseCon::Setup setup_DatabaseCon (Config const& c)
 {
 	DatabaseCon::Setup setup;
@@ -39,6 +39,15 @@ namespace ripple {
 struct open_ledger_t {};
 extern open_ledger_t const open_ledger;
 
+/** Batch construction tag.
+
+    Views constructed with this tag number their
+    transactions after those already in the base,
+    so they can be built apart and applied to it.
+*/
+struct batch_view_t {};
+extern batch_view_t const batch_view;
+
 //------------------------------------------------------------------------------
 
 /** Writable ledger view that accumulates state and tx changes.
@@ -67,6 +76,7 @@ private:
     detail::RawStateTable items_;
     std::shared_ptr<void const> hold_;
     bool open_ = true;
+    std::size_t baseTxCount_ = 0;
 
 public:
     OpenView() = delete;
@@ -135,6 +145,15 @@ public:
     OpenView (ReadView const* base,
         std::shared_ptr<void const> hold = nullptr);
 
+    /** Construct a view to be applied to a batch.
+
+        As above, except that txCount() starts at
+        `baseTxCount`, the number of tx the view
+        this one will be applied to holds by then.
+    */
+    OpenView (batch_view_t, ReadView const* base,
+        std::size_t baseTxCount);
+
     /** Returns true if this reflects an open ledger. */
     bool
     open() const override
@@ -144,6 +163,7 @@ public:
 
     /** Return the number of tx inserted since creation.
 
+        For a batch view, the base tx count is added.
         This is used to set the "apply ordinal"
         when calculating transaction metadata.
     */
@@ -623,6 +623,7 @@ ApplyStateTable::threadOwners (ReadView const& base,
         break;
     }
     case ltTABLELIST:
+    case ltTABLE:
     {
        // Nothing to do
        break;
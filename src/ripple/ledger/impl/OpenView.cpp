@@ -24,6 +24,7 @@
 namespace ripple {
 
 open_ledger_t const open_ledger {};
+batch_view_t const batch_view {};
 
 class OpenView::txs_iter_impl
     : public txs_type::iter_base
@@ -111,10 +112,17 @@ OpenView::OpenView (ReadView const* base,
 {
 }
 
+OpenView::OpenView (batch_view_t,
+    ReadView const* base, std::size_t baseTxCount)
+    : OpenView (base)
+{
+    baseTxCount_ = baseTxCount;
+}
+
 std::size_t
 OpenView::txCount() const
 {
-    return txs_.size();
+    return baseTxCount_ + txs_.size();
 }
 
 void
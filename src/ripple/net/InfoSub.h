@@ -26,7 +26,9 @@
 #include <ripple/resource/Consumer.h>
 #include <ripple/protocol/Book.h>
 #include <ripple/core/Stoppable.h>
+#include <memory>
 #include <mutex>
+#include <string>
 
 namespace ripple {
 
@@ -136,6 +138,12 @@ public:
 
     virtual void send (Json::Value const& jvObj, bool broadcast) = 0;
 
+    /** Send an event written once for all its listeners.
+        `text` is `jvObj` as written by Json::stream.
+    */
+    virtual void sendShared (Json::Value const& jvObj,
+        std::shared_ptr<std::string const> const& text, bool broadcast);
+
     std::uint64_t getSeq ();
 
     void onSendEmpty ();
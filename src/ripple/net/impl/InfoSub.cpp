@@ -87,6 +87,12 @@ std::uint64_t InfoSub::getSeq ()
     return mSeq;
 }
 
+void InfoSub::sendShared (Json::Value const& jvObj,
+    std::shared_ptr<std::string const> const&, bool broadcast)
+{
+    send (jvObj, broadcast);
+}
+
 void InfoSub::onSendEmpty ()
 {
 }
@@ -27,6 +27,7 @@
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/app/misc/SigVerifier.h>
 #include <ripple/app/misc/Transaction.h>
 #include <ripple/app/misc/ValidatorList.h>
 #include <ripple/app/tx/apply.h>
@@ -35,6 +36,7 @@
 #include <ripple/beast/core/SemanticVersion.h>
 #include <ripple/overlay/Cluster.h>
 #include <ripple/protocol/digest.h>
+#include <ripple/protocol/Feature.h>
 #include <peersafe/app/table/TableSync.h>
 
 #include <boost/algorithm/string/predicate.hpp>
@@ -1093,7 +1095,8 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMTransaction> const& m)
 
         // The maximum number of transactions to have in the job queue.
         constexpr int max_transactions = 250;
-        if (app_.getJobQueue().getJobCount(jtTRANSACTION) > max_transactions)
+        if (app_.getJobQueue().getJobCount(jtTRANSACTION) +
+            app_.getSigVerifier().pending() > max_transactions)
         {
             JLOG(p_journal_.info()) << "Transaction queue is full";
         }
@@ -1103,14 +1106,27 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMTransaction> const& m)
         }
         else
         {
-            app_.getJobQueue ().addJob (
-                jtTRANSACTION, "recvTransaction->checkTransaction",
-                [weak = std::weak_ptr<PeerImp>(shared_from_this()),
-                flags, checkSignature, stx] (Job&) {
-                    if (auto peer = weak.lock())
-                        peer->checkTransaction(flags,
-                            checkSignature, stx);
-                });
+            auto queueCheck = [weak = std::weak_ptr<PeerImp>(shared_from_this()),
+                flags, checkSignature, stx, &jobQueue = app_.getJobQueue ()] ()
+            {
+                jobQueue.addJob (
+                    jtTRANSACTION, "recvTransaction->checkTransaction",
+                    [weak, flags, checkSignature, stx] (Job&) {
+                        if (auto peer = weak.lock())
+                            peer->checkTransaction(flags,
+                                checkSignature, stx);
+                    });
+            };
+
+            // The signature is verified in a batch first, checkTransaction
+            // then finds the result cached in the HashRouter.
+            if (checkSignature)
+                app_.getSigVerifier ().add (stx,
+                    app_.getLedgerMaster ().getValidatedRules ().enabled (
+                        featureMultiSign),
+                    [queueCheck] (bool) { queueCheck (); });
+            else
+                queueCheck ();
         }
     }
     catch (std::exception const&)
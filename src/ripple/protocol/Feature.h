@@ -73,7 +73,8 @@ class FeatureCollections
         "fix1201",
         "fix1512",
         "fix1523",
-        "fix1528"
+        "fix1528",
+        "TableDirectory"
     };
 
     std::vector<uint256> features;
@@ -172,6 +173,7 @@ extern uint256 const fix1201;
 extern uint256 const fix1512;
 extern uint256 const fix1523;
 extern uint256 const fix1528;
+extern uint256 const featureTableDirectory;
 
 } // ripple
 
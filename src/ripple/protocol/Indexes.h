@@ -90,6 +90,12 @@ getRippleStateIndex (AccountID const& a, Issue const& issue);
 uint256
 getSignerListIndex (AccountID const& account);
 
+uint256
+getTableEntryIndex (AccountID const& account, Blob const& tableName);
+
+uint256
+getTableDirIndex (AccountID const& account);
+
 //------------------------------------------------------------------------------
 
 /* VFALCO TODO
@@ -127,6 +133,18 @@ struct table_t
 };
 static table_t const table{};
 
+/** A table of an account, with featureTableDirectory */
+struct tableEntry_t
+{
+    Keylet operator()(AccountID const& id, Blob const& tableName) const;
+
+    Keylet operator()(uint256 const& key) const
+    {
+        return{ ltTABLE, key };
+    }
+};
+static tableEntry_t const tableEntry{};
+
 struct insertlimit_t
 {
 	Keylet operator()(AccountID const& id) const;
@@ -249,6 +267,9 @@ Keylet unchecked(uint256 const& key);
 /** The root page of an account's directory */
 Keylet ownerDir (AccountID const& id);
 
+/** The root page of the directory of an account's tables */
+Keylet tableDir (AccountID const& id);
+
 /** A page in a directory */
 /** @{ */
 Keylet page (uint256 const& root, std::uint64_t index);
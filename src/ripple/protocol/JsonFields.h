@@ -113,6 +113,8 @@ JSS ( alternatives );               // out: PathRequest, RipplePathFind
 JSS ( amendment_blocked );          // out: NetworkOPs
 JSS ( amendments );                 // in: AccountObjects, out: NetworkOPs
 JSS ( amount );                     // out: AccountChannels
+JSS ( applied_ledger );             // out: GetCounts
+JSS ( apply_queue );                // out: GetCounts
 JSS ( asks );                       // out: Subscribe
 JSS ( assets );                     // out: GatewayBalances
 JSS ( authorized );                 // out: AccountLines
@@ -124,6 +126,7 @@ JSS ( balances );                   // out: GatewayBalances
 JSS ( base );                       // out: LogLevel
 JSS ( base_fee );                   // out: NetworkOPs
 JSS ( base_fee_zxc );               // out: NetworkOPs
+JSS ( batches );                    // out: GetCounts
 JSS ( bids );                       // out: Subscribe
 JSS ( binary );                     // in: AccountTX, LedgerEntry,
                                     //     AccountTxOld, Tx LedgerData
@@ -132,6 +135,7 @@ JSS ( both );                       // in: Subscribe, Unsubscribe
 JSS ( both_sides );                 // in: Subscribe, Unsubscribe
 JSS ( build_path );                 // in: TransactionSign
 JSS ( build_version );              // out: NetworkOPs
+JSS ( bulk_load );                  // out: GetCounts
 JSS ( cancel_after );               // out: AccountChannels
 JSS ( can_delete );                 // out: CanDelete
 JSS ( channel_id );                 // out: AccountChannels
@@ -153,6 +157,7 @@ JSS ( code );                       // out: errors
 JSS ( command );                    // in: RPCHandler
 JSS ( complete );                   // out: NetworkOPs, InboundLedger
 JSS ( complete_ledgers );           // out: NetworkOPs, PeerImp
+JSS ( connections );                // out: GetCounts
 JSS ( consensus );                  // out: NetworkOPs, LedgerConsensus
 JSS ( converge_time );              // out: NetworkOPs
 JSS ( converge_time_s );            // out: NetworkOPs
@@ -168,6 +173,8 @@ JSS ( dbKBLedger );                 // out: getCounts
 JSS ( dbKBTotal );                  // out: getCounts
 JSS ( dbKBTransaction );            // out: getCounts
 JSS ( debug_signing );              // in: TransactionSign
+JSS ( decode_queue );               // out: GetCounts
+JSS ( deferred );                   // out: GetCounts
 JSS ( delivered_amount );           // out: addPaymentDeliveredAmount
 JSS ( deprecated );                 // out: WalletSeed
 JSS ( descending );                 // in: AccountTx*
@@ -194,10 +201,13 @@ JSS ( error_message );              // out: error
 JSS ( expand );                     // in: handler/Ledger
 JSS ( expected_ledger_size );       // out: TxQ
 JSS ( expiration );                 // out: AccountOffers, AccountChannels
+JSS ( expired );                    // out: GetCounts, NetworkOPs
+JSS ( expiry_latency_us );          // out: GetCounts, NetworkOPs
 JSS ( fail_hard );                  // in: Sign, Submit
 JSS	( diff );						// out: diff
 JSS ( escrow );                     // in: LedgerEntry
-JSS ( failed );                     // out: InboundLedger
+JSS ( failed );                     // out: InboundLedger, GetCounts
+JSS ( fallbacks );                  // out: GetCounts
 JSS ( feature );                    // in: Feature
 JSS ( features );                   // out: Feature
 JSS ( fee );                        // out: NetworkOPs, Peers
@@ -207,6 +217,7 @@ JSS ( fee_level );                  // out: AccountInfo
 JSS ( fee_mult_max );               // in: TransactionSign
 JSS ( fee_ref );                    // out: NetworkOPs
 JSS ( fetch_pack );                 // out: NetworkOPs
+JSS ( fetch_queue );                // out: GetCounts
 JSS ( first );                      // out: rpc/Version
 JSS ( fix_txns );                   // in: LedgerCleaner
 JSS ( flags );                      // out: paths/Node, AccountOffers,
@@ -248,6 +259,7 @@ JSS ( issuer );                     // in: RipplePathFind, Subscribe,
 JSS ( jsonrpc );                    // json version
 JSS ( key );                        // out: WalletSeed
 JSS ( key_type );                   // in/out: WalletPropose, TransactionSign
+JSS ( lag );                        // out: GetCounts
 JSS ( latency );                    // out: PeerImp
 JSS ( last );                       // out: RPCVersion
 JSS ( last_close );                 // out: NetworkOPs
@@ -259,6 +271,7 @@ JSS ( ledger );                     // in: NetworkOPs, LedgerCleaner,
 JSS ( ledger_current_index );       // out: NetworkOPs, RPCHelpers,
                                     //      LedgerCurrent, LedgerAccept
 JSS ( ledger_data );                // out: LedgerHeader
+JSS ( ledger_db_ms );               // out: GetCounts
 JSS ( ledger_hash );                // in: RPCHelpers, LedgerRequest,
                                     //     RipplePathFind, TransactionEntry,
                                     //     handlers/Ledger
@@ -270,7 +283,9 @@ JSS ( ledger_index_max );           // in, out: AccountTx*
 JSS ( ledger_index_min );           // in, out: AccountTx*
 JSS ( ledger_max );                 // in, out: AccountTx*
 JSS ( ledger_min );                 // in, out: AccountTx*
+JSS ( ledger_save );                // out: GetCounts
 JSS ( ledger_time );                // out: NetworkOPs
+JSS ( ledgers_saved );              // out: GetCounts
 JSS ( levels );                     // LogLevels
 JSS ( limit );                      // in/out: AccountTx*, AccountOffers,
                                     //         AccountLines, AccountObjects
@@ -302,6 +317,7 @@ JSS ( master_key );                 // out: WalletPropose
 JSS ( master_seed );                // out: WalletPropose
 JSS ( master_seed_hex );            // out: WalletPropose
 JSS ( master_signature );           // out: pubManifest
+JSS ( max_lag );                    // out: GetCounts
 JSS ( max_ledger );                 // in/out: LedgerCleaner
 JSS ( max_queue_size );             // out: TxQ
 JSS ( max_spend_drops );            // out: AccountInfo
@@ -357,7 +373,9 @@ JSS ( peer );                       // in: AccountLines
 JSS ( peer_authorized );            // out: AccountLines
 JSS ( peer_id );                    // out: LedgerProposal
 JSS ( peers );                      // out: InboundLedger, handlers/Peers, Overlay
+JSS ( pending );                    // out: GetCounts
 JSS ( port );                       // in: Connect
+JSS ( prepare_ms );                 // out: GetCounts
 JSS ( previous_ledger );            // out: LedgerPropose
 JSS ( private_key );                // out: OverlayImpl, PeerImp, WalletPropose
 JSS ( payment_channel );            // in: LedgerEntry
@@ -370,6 +388,7 @@ JSS ( pubkey_publisher );           // out: ValidatorList
 JSS ( pubkey_validator );           // out: NetworkOPs, ValidatorList
 JSS ( public_key );                 // out: OverlayImpl, PeerImp, WalletPropose
 JSS ( public_key_hex );             // out: WalletPropose
+JSS ( published );                  // out: GetCounts
 JSS ( published_ledger );           // out: NetworkOPs
 JSS ( publisher_lists );            // out: ValidatorList
 JSS ( quality );                    // out: NetworkOPs
@@ -377,9 +396,13 @@ JSS ( quality_in );                 // out: AccountLines
 JSS ( quality_out );                // out: AccountLines
 JSS ( queue );                      // in: AccountInfo
 JSS ( queue_data );                 // out: AccountInfo
+JSS ( queued );                     // out: GetCounts
 JSS ( random );                     // out: Random
 JSS ( raw_meta );                   // out: AcceptedLedgerTx
+JSS ( read_pool );                  // out: GetCounts
+JSS ( reads );                      // out: GetCounts
 JSS ( receive_currencies );         // out: AccountCurrencies
+JSS ( received_ledger );            // out: GetCounts
 JSS ( reference_level );            // out: TxQ
 JSS ( refresh_interval_min );       // out: ValidatorSites
 JSS ( regular_seed );               // in/out: LedgerEntry
@@ -405,6 +428,7 @@ JSS ( seed );                       // in: WalletAccounts, out: WalletSeed
 JSS ( seed_hex );                   // in: WalletPropose, TransactionSign
 JSS ( send_currencies );            // out: AccountCurrencies
 JSS ( send_max );                   // in: PathRequest, RipplePathFind
+JSS ( sent );                       // out: GetCounts
 JSS ( seq );                        // in: LedgerEntry;
                                     // out: NetworkOPs, RPCSub, AccountOffers,
                                     //      ValidatorList
@@ -413,6 +437,8 @@ JSS ( server_state );               // out: NetworkOPs
 JSS ( server_status );              // out: NetworkOPs
 JSS ( settle_delay );               // out: AccountChannels
 JSS ( severity );                   // in: LogLevel
+JSS ( shards );                     // out: GetCounts
+JSS ( sig_verify );                 // out: GetCounts
 JSS ( signature );                  // out: NetworkOPs, ChannelAuthorize
 JSS ( signature_verified );         // out: ChannelVerify
 JSS ( signing_key );                // out: NetworkOPs
@@ -425,6 +451,11 @@ JSS ( source_account );             // in: PathRequest, RipplePathFind
 JSS ( source_amount );              // in: PathRequest, RipplePathFind
 JSS ( source_currencies );          // in: PathRequest, RipplePathFind
 JSS ( source_tag );                 // out: AccountChannels
+JSS ( sql_schema_cache_hits );      // out: GetCounts
+JSS ( sql_schema_cache_misses );    // out: GetCounts
+JSS ( sql_stmt_cache_hits );        // out: GetCounts
+JSS ( sql_stmt_cache_misses );      // out: GetCounts
+JSS ( sql_stmt_cache_size );        // out: GetCounts
 JSS ( stand_alone );                // out: NetworkOPs
 JSS ( start );                      // in: TxHistory
 JSS ( state );                      // out: Logic.h, ServerState, LedgerData
@@ -432,19 +463,33 @@ JSS ( state_accounting );           // out: NetworkOPs
 JSS ( state_now );                  // in: Subscribe
 JSS ( status );                     // error
 JSS ( stop );                       // in: LedgerCleaner
+JSS ( stream );                     // in: GetRecord
 JSS ( streams );                    // in: Subscribe, Unsubscribe
 JSS ( strict );                     // in: AccountCurrencies, AccountInfo
 JSS ( sub_index );                  // in: LedgerEntry
 JSS ( subcommand );                 // in: PathFind
 JSS ( success );                    // rpc
 JSS ( supported );                  // out: AmendmentTableImpl
+JSS ( sync_active );                // out: GetCounts
+JSS ( sync_queued );                // out: GetCounts
+JSS ( sync_readers );               // out: GetCounts
+JSS ( sync_workers );               // out: GetCounts
 JSS ( system_time_offset );         // out: NetworkOPs
+JSS ( table_entry );                // in: LedgerData, Ledger
+JSS ( table_entry_cache_hits );     // out: GetCounts
+JSS ( table_entry_cache_misses );   // out: GetCounts
+JSS ( table_entry_cache_size );     // out: GetCounts
+JSS ( table_storage );              // out: GetCounts
+JSS ( table_subs );                 // out: GetCounts, NetworkOPs
+JSS ( table_sync );                 // out: GetCounts
+JSS ( tables );                     // out: GetCounts
 JSS ( tag );                        // out: Peers
 JSS ( taker );                      // in: Subscribe, BookOffers
 JSS ( taker_gets );                 // in: Subscribe, Unsubscribe, BookOffers
 JSS ( taker_gets_funded );          // out: NetworkOPs
 JSS ( taker_pays );                 // in: Subscribe, Unsubscribe, BookOffers
 JSS ( taker_pays_funded );          // out: NetworkOPs
+JSS ( threads );                    // out: GetCounts
 JSS ( threshold );                  // in: Blacklist
 JSS ( table );
 JSS ( ticket );                     // in: AccountObjects
@@ -474,6 +519,7 @@ JSS ( tx_json );                    // in/out: TransactionSign
 JSS ( tx_signing_hash );            // out: TransactionSign
 JSS ( tx_unsigned );                // out: TransactionSign
 JSS ( txn_count );                  // out: NetworkOPs
+JSS ( txn_db_ms );                  // out: GetCounts
 JSS ( txs );                        // out: TxHistory
 JSS ( type );                       // in: AccountObjects
                                     // out: NetworkOPs
@@ -501,10 +547,14 @@ JSS ( validation_seed );            // out: ValidationCreate, ValidationSeed
 JSS ( validations );                // out: AmendmentTableImpl
 JSS ( validator_sites );            // out: ValidatorSites
 JSS ( value );                      // out: STAmount
+JSS ( verified );                   // out: GetCounts
 JSS ( version );                    // out: RPCVersion
 JSS ( vetoed );                     // out: AmendmentTableImpl
 JSS ( vote );                       // in: Feature
+JSS ( wait_ms );                    // out: GetCounts
+JSS ( waited );                     // out: GetCounts
 JSS ( warning );                    // rpc:
+JSS ( watermark );                  // out: GetRecord
 JSS ( write_load );                 // out: GetCounts
 JSS (memos);                        // out: memos
 JSS ( lastLedgerSequence );			//
@@ -94,6 +94,10 @@ enum LedgerEntryType
 	ltINSERTMAP			= 'i',
 
 	ltCHAINID			= 'b',
+
+	// One table of an account, replaces the entry in ltTABLELIST
+	// once featureTableDirectory is enabled
+	ltTABLE				= 't',
 };
 
 /**
@@ -106,6 +110,8 @@ enum LedgerNameSpace
 	spaceTableList		= 'l',
 	spaceInsertLimit	= 'i',
 	spaceChainId		= 'b',
+	spaceTable			= 't',  // Entry for a table.
+	spaceTableDir		= 'L',  // Directory of tables owned by an account.
     spaceDirNode        = 'd',
     spaceGenerator      = 'g',
     spaceRipple         = 'r',
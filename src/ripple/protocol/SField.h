@@ -356,6 +356,7 @@ extern SF_U32 const sfWalletSize;
 extern SF_U32 const sfOwnerCount;
 extern SF_U32 const sfDestinationTag;
 extern SF_U32 const sfNeedVerify;
+extern SF_U32 const sfTableCount;
 extern SF_U32 const sfTxnLgrSeq;
 extern SF_U32 const sfCreateLgrSeq;
 
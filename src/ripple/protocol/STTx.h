@@ -53,7 +53,7 @@ public:
     STTx() = delete;
     STTx& operator= (STTx const& other) = delete;
 
-    STTx (STTx const& other) = default;
+    STTx (STTx const& other);
 
     explicit STTx (SerialIter& sit);
     explicit STTx (SerialIter&& sit) : STTx(sit) {}
@@ -115,6 +115,17 @@ public:
 	bool isCrossChainUpload() const;
 
 	std::string buildRaw(std::string sOperationRule) const;
+	Json::Value buildRawJson(std::string sOperationRule) const;
+
+    /** Returns sfRaw parsed as JSON.
+
+        The raw is parsed on first use and kept with the transaction, so
+        every consumer shares a single parse. A changed sfRaw is parsed
+        again.
+
+        @return nullptr if sfRaw is absent or is not valid JSON.
+    */
+    std::shared_ptr<Json::Value const> getRawJson () const;
 
     Blob getSigningPubKey () const
     {
@@ -171,8 +182,17 @@ private:
 
 	void buildRaw(Json::Value& condition, std::string& rule) const;
 
+    struct ParsedRaw
+    {
+        Blob raw;
+        std::shared_ptr<Json::Value const> json;
+    };
+
     uint256 tid_;
     TxType tx_type_;
+    // accessed with the atomic shared_ptr functions, the same
+    // transaction is read from several threads
+    mutable std::shared_ptr<ParsedRaw const> parsedRaw_;
 };
 
 bool passesLocalChecks (STObject const& st, std::string&);
@@ -23,6 +23,7 @@
 #include <ripple/basics/base_uint.h>
 #include <ripple/beast/crypto/ripemd.h>
 #include <ripple/beast/crypto/sha2.h>
+#include <ripple/beast/crypto/sm3.h>
 #include <ripple/beast/hash/endian.h>
 #include <peersafe/gmencrypt/hardencrypt/HardEncryptObj.h>
 #include <algorithm>
@@ -251,6 +252,43 @@ using sha512_half_hasher_s =
 
 //------------------------------------------------------------------------------
 
+/** SM3 digest, used in place of SHA512-Half in GM mode.
+
+    Hashes on the caller's stack, so unlike HardEncrypt::SM3Hash
+    it takes no device handle or lock.
+*/
+struct sm3_hasher
+{
+private:
+    beast::sm3_hasher h_;
+
+public:
+    static beast::endian const endian =
+        beast::endian::big;
+
+    using result_type = uint256;
+
+    void
+    operator()(void const* data,
+        std::size_t size) noexcept
+    {
+        h_(data, size);
+    }
+
+    explicit
+    operator result_type() noexcept
+    {
+        auto const digest =
+            beast::sm3_hasher::result_type(h_);
+        result_type result;
+        std::copy(digest.begin(),
+            digest.end(), result.begin());
+        return result;
+    }
+};
+
+//------------------------------------------------------------------------------
+
 #ifdef _MSC_VER
 // Call from main to fix magic statics pre-VS2015
 inline
@@ -270,10 +308,12 @@ sha512Half (Args const&... args)
 {
     using beast::hash_append;
     HardEncrypt* hEObj = HardEncryptObj::getInstance();
-    HardEncrypt::SM3Hash objSM3(hEObj);//refObjSM3 = hEObj->getSM3Obj();
 
     if (nullptr != hEObj)
     {
+#ifdef SD_KEY_SWITCH
+        // the sd key computes SM3 on the device, one hash at a time
+        HardEncrypt::SM3Hash objSM3(hEObj);
         unsigned char hashData[128] = {0};
         int HashDataLen = 0;
         objSM3.SM3HashInitFun();
@@ -283,6 +323,12 @@ sha512Half (Args const&... args)
         sha512_half_hasher::result_type result;
         std::copy(hashData, hashData + 32, result.begin());
         return result;
+#else
+        sm3_hasher h;
+        hash_append(h, args...);
+        return static_cast<typename
+            sm3_hasher::result_type>(h);
+#endif
     }
     else
     {
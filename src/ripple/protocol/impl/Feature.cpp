@@ -120,5 +120,6 @@ uint256 const fix1201 = *getRegisteredFeature("fix1201");
 uint256 const fix1512 = *getRegisteredFeature("fix1512");
 uint256 const fix1523 = *getRegisteredFeature("fix1523");
 uint256 const fix1528 = *getRegisteredFeature("fix1528");
+uint256 const featureTableDirectory = *getRegisteredFeature("TableDirectory");
 
 } // ripple
@@ -89,6 +89,25 @@ getTableIndex(AccountID const& account)
     return static_cast<uint256>(h);
 }
 
+uint256
+getTableEntryIndex (AccountID const& account, Blob const& tableName)
+{
+    sha512_half_hasher h;
+    using beast::hash_append;
+    hash_append(h, std::uint16_t(spaceTable));
+    hash_append(h, account);
+    h(tableName.data(), tableName.size());
+    return static_cast<uint256>(h);
+}
+
+uint256
+getTableDirIndex (AccountID const& account)
+{
+    return sha512Half(
+        std::uint16_t(spaceTableDir),
+        account);
+}
+
 uint256
 getGeneratorIndex (AccountID const& uGeneratorID)
 {
@@ -239,6 +258,13 @@ Keylet table_t::operator()(AccountID const& id) const
         getTableIndex(id) };
 }
 
+Keylet tableEntry_t::operator()(AccountID const& id,
+    Blob const& tableName) const
+{
+    return{ ltTABLE,
+        getTableEntryIndex(id, tableName) };
+}
+
 Keylet insertlimit_t::operator ()(AccountID const& id)const
 {
 	return{ ltINSERTMAP,
@@ -342,6 +368,12 @@ Keylet ownerDir(AccountID const& id)
         getOwnerDirIndex(id) };
 }
 
+Keylet tableDir(AccountID const& id)
+{
+    return { ltDIR_NODE,
+        getTableDirIndex(id) };
+}
+
 Keylet page(uint256 const& key,
     std::uint64_t index)
 {
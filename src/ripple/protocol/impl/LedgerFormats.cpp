@@ -164,6 +164,15 @@ LedgerFormats::LedgerFormats ()
         << SOElement(sfPreviousTxnLgrSeq, SOE_REQUIRED)
 		<< SOElement(sfTableEntries, SOE_REQUIRED)
         << SOElement(sfFutureTxHash, SOE_OPTIONAL)
+        << SOElement(sfTableCount, SOE_OPTIONAL)
+        ;
+
+    add("Table", ltTABLE)
+        << SOElement(sfAccount, SOE_REQUIRED)
+        << SOElement(sfOwnerNode, SOE_REQUIRED)
+        << SOElement(sfPreviousTxnID, SOE_REQUIRED)
+        << SOElement(sfPreviousTxnLgrSeq, SOE_REQUIRED)
+        << SOElement(sfTable, SOE_REQUIRED)
         ;
 
 	add("InsertLimt", ltINSERTMAP)
@@ -340,7 +340,15 @@ verify (PublicKey const& publicKey,
 
             HardEncrypt* hEObj = HardEncryptObj::getInstance();
             std::pair<unsigned char*, int> pub4Verify = std::make_pair((unsigned char*)publicKey.data(), publicKey.size());
+#ifdef SD_KEY_SWITCH
             hEObj->SM3HashTotal((unsigned char*)m.data(), m.size(), hashData, &hashDataLen);
+#else
+            // plain SM3, no need to share the device session for it
+            sm3_hasher h;
+            h(m.data(), m.size());
+            auto const digest = static_cast<sm3_hasher::result_type>(h);
+            std::copy(digest.begin(), digest.end(), hashData);
+#endif
             rv = hEObj->SM2ECCVerify(pub4Verify, hashData, hashDataLen, (unsigned char*)sig.data(), sig.size());
             if (rv)
             {
@@ -34,6 +34,7 @@
 #include <ripple/basics/StringUtilities.h>
 #include <ripple/json/to_string.h>
 #include <boost/format.hpp>
+#include <algorithm>
 #include <array>
 #include <memory>
 #include <type_traits>
@@ -59,6 +60,15 @@ auto getTxFormat (TxType type)
     return format;
 }
 
+STTx::STTx (STTx const& other)
+    : STObject (other)
+    , CountedObject <STTx> (other)
+    , tid_ (other.tid_)
+    , tx_type_ (other.tx_type_)
+    , parsedRaw_ (std::atomic_load (&other.parsedRaw_))
+{
+}
+
 STTx::STTx (STObject&& object)
     : STObject (std::move (object))
 {
@@ -165,6 +175,30 @@ bool STTx::isCrossChainUpload() const
 	return false;
 }
 
+std::shared_ptr<Json::Value const> STTx::getRawJson () const
+{
+	if (!isFieldPresent(sfRaw))
+		return nullptr;
+
+	auto const& raw = static_cast<STBlob const&>(peekAtField(sfRaw));
+	auto cached = std::atomic_load(&parsedRaw_);
+	if (cached && cached->raw.size() == raw.size() &&
+		std::equal(cached->raw.begin(), cached->raw.end(), raw.data()))
+		return cached->json;
+
+	auto parsed = std::make_shared<ParsedRaw>();
+	parsed->raw.assign(raw.data(), raw.data() + raw.size());
+	Json::Value json;
+	auto const begin = reinterpret_cast<char const*>(parsed->raw.data());
+	if (Json::Reader().parse(begin, begin + parsed->raw.size(), json))
+		parsed->json = std::make_shared<Json::Value const>(std::move(json));
+
+	auto result = parsed->json;
+	std::atomic_store(&parsedRaw_,
+		std::shared_ptr<ParsedRaw const>(std::move(parsed)));
+	return result;
+}
+
 std::string STTx::buildRaw(std::string sOperationRule) const
 {
 	std::string sRaw;
@@ -172,21 +206,27 @@ std::string STTx::buildRaw(std::string sOperationRule) const
 	{
 		return sRaw;
 	}
-	ripple::Blob raw;
-	raw = getFieldVL(sfRaw);
-	sRaw = std::string(raw.begin(), raw.end());
 	TableOpType optype = (TableOpType)getFieldU16(sfOpType);
-	if (!isSqlStatementOpType(optype))
-		return sRaw;
-	if (sOperationRule.empty())
+	if (!isSqlStatementOpType(optype) || sOperationRule.empty())
 	{
-		return sRaw;
+		ripple::Blob raw = getFieldVL(sfRaw);
+		return std::string(raw.begin(), raw.end());
 	}
+	return buildRawJson(sOperationRule).toStyledString();
+}
+
+Json::Value STTx::buildRawJson(std::string sOperationRule) const
+{
+	auto const parsed = getRawJson();
+	Json::Value raw_json = parsed ? *parsed : Json::Value();
+	TableOpType optype = (TableOpType)getFieldU16(sfOpType);
+	if (!isFieldPresent(sfRaw) || !isSqlStatementOpType(optype) ||
+		sOperationRule.empty())
+		return raw_json;
+
 	using MapRule = std::map<std::string, Json::Value>;
 
 	Json::Value finalRaw;
-	Json::Value raw_json;
-	Json::Reader().parse(sRaw, raw_json);
 	switch (optype)
 	{
 	case R_INSERT:
@@ -264,7 +304,7 @@ std::string STTx::buildRaw(std::string sOperationRule) const
 	default:
 		break;
 	}
-	return finalRaw.toStyledString();
+	return finalRaw;
 }
 
 void STTx::buildRaw(Json::Value& condition, std::string& rule) const
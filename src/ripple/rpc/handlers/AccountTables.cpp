@@ -24,6 +24,7 @@
 #include <ripple/rpc/handlers/Handlers.h>
 #include <ripple/rpc/impl/RPCHelpers.h>
 #include <peersafe/rpc/impl/TableAssistant.h>
+#include <peersafe/app/table/TableDirectory.h>
 
 namespace ripple {
 Json::Value doGetAccountTables(RPC::Context&  context)
@@ -53,11 +54,10 @@ Json::Value doGetAccountTables(RPC::Context&  context)
     auto tablesle = ledger->read(key);
     if (tablesle)
     {
-        auto & aTables = tablesle->getFieldArray(sfTableEntries);
-        if (aTables.size() > 0)
+        if (tableCount(*ledger, ownerID) > 0)
         {
             ret[jss::status] = "success";
-            for (auto table : aTables)
+            forEachTableEntry(*ledger, ownerID, [&ret](STEntry const& table)
             {
 				Json::Value tmp(Json::objectValue);
 				tmp[jss::NameInDB] = to_string(table.getFieldH160(sfNameInDB));
@@ -65,7 +65,8 @@ Json::Value doGetAccountTables(RPC::Context&  context)
 				std::string str(blob.begin(), blob.end());
 				tmp[jss::TableName] = str;
 				ret["tx_json"].append(tmp);
-            }
+				return true;
+            });
         }
         else
         {
@@ -21,8 +21,10 @@
 #include <ripple/app/ledger/AcceptedLedger.h>
 #include <ripple/app/ledger/InboundLedgers.h>
 #include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/LedgerSaveQueue.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/app/misc/SigVerifier.h>
 #include <ripple/basics/UptimeTimer.h>
 #include <ripple/core/DatabaseCon.h>
 #include <ripple/json/json_value.h>
@@ -32,6 +34,11 @@
 #include <ripple/protocol/ErrorCodes.h>
 #include <ripple/protocol/JsonFields.h>
 #include <ripple/rpc/Context.h>
+#include <peersafe/app/sql/SQLSchemaCache.h>
+#include <peersafe/app/sql/SQLStatementCache.h>
+#include <peersafe/app/sql/TxStoreReadPool.h>
+#include <peersafe/app/storage/TableStorage.h>
+#include <peersafe/app/table/TableSync.h>
 
 namespace ripple {
 
@@ -125,6 +132,35 @@ Json::Value doGetCounts (RPC::Context& context)
     ret[jss::node_written_bytes] = context.app.getNodeStore().getStoreSize();
     ret[jss::node_read_bytes] = context.app.getNodeStore().getFetchSize();
 
+    ret[jss::sql_stmt_cache_hits] = static_cast<Json::UInt>(
+        SQLStatementCache::totalHits());
+    ret[jss::sql_stmt_cache_misses] = static_cast<Json::UInt>(
+        SQLStatementCache::totalMisses());
+    ret[jss::sql_stmt_cache_size] = static_cast<Json::UInt>(
+        SQLStatementCache::totalSize());
+    ret[jss::sql_schema_cache_hits] = static_cast<Json::UInt>(
+        SQLSchemaCache::totalHits());
+    ret[jss::sql_schema_cache_misses] = static_cast<Json::UInt>(
+        SQLSchemaCache::totalMisses());
+
+    auto const& tableEntries = context.ledgerMaster.getTableEntryCache();
+    ret[jss::table_entry_cache_hits] = static_cast<Json::UInt>(
+        tableEntries.hits());
+    ret[jss::table_entry_cache_misses] = static_cast<Json::UInt>(
+        tableEntries.misses());
+    ret[jss::table_entry_cache_size] = static_cast<Json::UInt>(
+        tableEntries.size());
+
+    ret[jss::table_sync] = context.app.getTableSync().GetSyncInfo();
+    ret[jss::sig_verify] = context.app.getSigVerifier().getInfo();
+    ret[jss::ledger_save] = context.app.getLedgerSaveQueue().getInfo();
+    if (context.app.getTableStorage().isDeferred())
+        ret[jss::table_storage] =
+            context.app.getTableStorage().getDeferredInfo();
+    ret[jss::table_subs] = context.app.getOPs().getTableSubsJson();
+    if (context.app.getTxStoreReadPool().enabled())
+        ret[jss::read_pool] = context.app.getTxStoreReadPool().getInfo();
+
     return ret;
 }
 
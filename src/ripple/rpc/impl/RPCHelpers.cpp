@@ -695,7 +695,7 @@ chooseLedgerEntryType(Json::Value const& params)
     if (params.isMember(jss::type))
     {
         static
-            std::array<std::pair<char const *, LedgerEntryType>, 12> const types
+            std::array<std::pair<char const *, LedgerEntryType>, 13> const types
         { {
             { jss::account,         ltACCOUNT_ROOT },
             { jss::amendments,      ltAMENDMENTS },
@@ -708,7 +708,8 @@ chooseLedgerEntryType(Json::Value const& params)
             { jss::ticket,          ltTICKET },
             { jss::escrow,          ltESCROW },
 			{ jss::payment_channel, ltPAYCHAN },
-			{ jss::table,			ltTABLELIST }
+			{ jss::table,			ltTABLELIST },
+			{ jss::table_entry,		ltTABLE }
             } };
 
         auto const& p = params[jss::type];
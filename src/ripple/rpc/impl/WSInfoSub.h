@@ -86,6 +86,16 @@ public:
                 std::move(sb));
         sp->send(m);
     }
+
+    void
+    sendShared(Json::Value const&,
+        std::shared_ptr<std::string const> const& text, bool) override
+    {
+        auto sp = ws_.lock();
+        if(! sp)
+            return;
+        sp->send(std::make_shared<SharedWSMsg>(text));
+    }
 };
 
 } // ripple
@@ -30,6 +30,7 @@
 #include <algorithm>
 #include <functional>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -106,6 +107,34 @@ public:
     }
 };
 
+/** A message whose text is shared with other sessions. */
+class SharedWSMsg : public WSMsg
+{
+    std::shared_ptr<std::string const> text_;
+    std::size_t pos_ = 0;
+    std::size_t n_ = 0;
+
+public:
+    explicit
+    SharedWSMsg(std::shared_ptr<std::string const> text)
+        : text_(std::move(text))
+    {
+    }
+
+    std::pair<boost::tribool,
+        std::vector<boost::asio::const_buffer>>
+    prepare(std::size_t bytes,
+        std::function<void(void)>) override
+    {
+        pos_ += n_;
+        if (pos_ >= text_->size())
+            return{true, {}};
+        n_ = std::min(bytes, text_->size() - pos_);
+        boost::tribool const done = pos_ + n_ >= text_->size();
+        return{done, {boost::asio::buffer(text_->data() + pos_, n_)}};
+    }
+};
+
 struct WSSession
 {
     std::shared_ptr<void> appDefined;
@@ -24,6 +24,7 @@
 #include <ripple/app/ledger/impl/InboundTransactions.cpp>
 #include <ripple/app/ledger/impl/LedgerCleaner.cpp>
 #include <ripple/app/ledger/impl/LedgerMaster.cpp>
+#include <ripple/app/ledger/impl/LedgerSaveQueue.cpp>
 #include <ripple/app/ledger/impl/LocalTxs.cpp>
 #include <ripple/app/ledger/impl/OpenLedger.cpp>
 #include <ripple/app/ledger/impl/LedgerToJson.cpp>
@@ -23,6 +23,8 @@
 #include <ripple/app/misc/impl/AmendmentTable.cpp>
 #include <ripple/app/misc/impl/LoadFeeTrack.cpp>
 #include <ripple/app/misc/impl/Manifest.cpp>
+#include <ripple/app/misc/impl/SigVerifier.cpp>
+#include <ripple/app/misc/impl/TableSubscriptions.cpp>
 #include <ripple/app/misc/impl/Transaction.cpp>
 #include <ripple/app/misc/impl/TxQ.cpp>
 #include <ripple/app/misc/impl/ValidatorList.cpp>
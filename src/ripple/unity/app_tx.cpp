@@ -37,6 +37,7 @@
 #include <ripple/app/tx/impl/SetSignerList.cpp>
 #include <ripple/app/tx/impl/SetTrust.cpp>
 #include <ripple/app/tx/impl/SignerEntries.cpp>
+#include <ripple/app/tx/impl/SpeculativeApply.cpp>
 #include <ripple/app/tx/impl/Taker.cpp>
 #include <ripple/app/tx/impl/ApplyContext.cpp>
 #include <ripple/app/tx/impl/Transactor.cpp>
@@ -0,0 +1,298 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <peersafe/app/sql/SQLPredicate.h>
+#include <peersafe/app/sql/STTx2SQL.h>
+#include <ripple/core/SociDB.h>
+#include <ripple/json/json_reader.h>
+#include <ripple/beast/unit_test.h>
+#include <chrono>
+
+namespace ripple {
+
+// filters of audits and asserts
+static char const* const auditFilters[] = {
+    "[{\"id\":{\"$in\":[3,17,28,41,56,73,88,99,120,151]}}]",
+    "[{\"age\":{\"$ge\":20,\"$le\":60},\"name\":{\"$regex\":\"/^peer/\"}}]",
+    "[{\"$or\":[{\"status\":\"closed\"},{\"$and\":[{\"age\":{\"$gt\":70}},{\"id\":{\"$lt\":100}}]}]}]",
+    "[{\"status\":{\"$nin\":[\"open\",\"closed\"]}},{\"name\":{\"$regex\":\"/safe_1/\"}}]",
+    "[{\"id\":{\"$ne\":5},\"name\":{\"$gt\":\"peersafe_5\"}}]",
+};
+
+static Json::Value
+parse (std::string const& s)
+{
+    Json::Value v;
+    Json::Reader ().parse (s, v);
+    return v;
+}
+
+static Json::Value
+makeRow (int i)
+{
+    static char const* const status[] = { "open", "closed", "pending" };
+    Json::Value row;
+    row["id"] = i;
+    row["age"] = (i * 37) % 90;
+    row["name"] = (i % 3 ? "peersafe_" : "zongxiang_") + std::to_string (i);
+    if (i % 7)
+        row["status"] = status[i % 3];
+    else
+        row["status"] = Json::nullValue;
+    return row;
+}
+
+static void
+insertRow (soci::session& s, Json::Value const& row)
+{
+    std::string status = "NULL";
+    if (row["status"].isString ())
+        status = "'" + row["status"].asString () + "'";
+    s << "INSERT INTO t_audit (id, age, name, status) VALUES (" <<
+        row["id"].asInt () << "," << row["age"].asInt () << ",'" <<
+        row["name"].asString () << "'," << status << ");";
+}
+
+class SQLPredicate_test : public beast::unit_test::suite
+{
+    SQLPredicate::Result
+    match (std::string const& conditions, std::string const& row)
+    {
+        SQLPredicate predicate;
+        auto const result = SQLPredicate::compile (parse (conditions), predicate);
+        BEAST_EXPECT(result.first == 0);
+        return predicate.evaluate (parse (row));
+    }
+
+    void testExpressions ()
+    {
+        testcase ("expressions");
+
+        BEAST_EXPECT(match ("[{\"id\":1}]", "{\"id\":1}") == SQLPredicate::True);
+        BEAST_EXPECT(match ("[{\"id\":1}]", "{\"id\":2}") == SQLPredicate::False);
+        BEAST_EXPECT(match ("[{\"id\":{\"$ge\":1}}]", "{\"id\":1.5}") == SQLPredicate::True);
+        BEAST_EXPECT(match ("[{\"id\":{\"$lt\":1}}]", "{\"id\":\"0\"}") == SQLPredicate::True);
+        BEAST_EXPECT(match ("[{\"name\":{\"$ne\":\"a\"}}]", "{\"name\":\"b\"}") == SQLPredicate::True);
+        BEAST_EXPECT(match ("[{\"id\":{\"$in\":[1,2]}}]", "{\"id\":2}") == SQLPredicate::True);
+        BEAST_EXPECT(match ("[{\"id\":{\"$nin\":[1,2]}}]", "{\"id\":2}") == SQLPredicate::False);
+        BEAST_EXPECT(match ("[{\"name\":{\"$regex\":\"/eer/\"}}]", "{\"name\":\"PEERSAFE\"}") == SQLPredicate::True);
+        BEAST_EXPECT(match ("[{\"name\":{\"$regex\":\"/^safe/\"}}]", "{\"name\":\"peersafe\"}") == SQLPredicate::True);
+        BEAST_EXPECT(match ("[{\"name\":{\"$regex\":\"p_er%\"}}]", "{\"name\":\"peersafe\"}") == SQLPredicate::True);
+
+        // NULL matches nothing
+        BEAST_EXPECT(match ("[{\"id\":{\"$ne\":1}}]", "{\"id\":null}") == SQLPredicate::False);
+        BEAST_EXPECT(match ("[{\"id\":{\"$nin\":[1]}}]", "{\"id\":null}") == SQLPredicate::False);
+
+        // a column the row doesn't have,or text compared with a number
+        BEAST_EXPECT(match ("[{\"id\":1}]", "{\"name\":\"a\"}") == SQLPredicate::Unknown);
+        BEAST_EXPECT(match ("[{\"id\":1}]", "{\"id\":\"a\"}") == SQLPredicate::Unknown);
+
+        // text the collations of sqlite and mysql may order differently
+        BEAST_EXPECT(match ("[{\"name\":\"abc\"}]", "{\"name\":\"ABC\"}") == SQLPredicate::Unknown);
+        BEAST_EXPECT(match ("[{\"name\":{\"$lt\":\"b\"}}]", "{\"name\":\"A\"}") == SQLPredicate::True);
+        BEAST_EXPECT(match ("[{\"name\":{\"$lt\":\"B\"}}]", "{\"name\":\"a\"}") == SQLPredicate::Unknown);
+        BEAST_EXPECT(match ("[{\"name\":{\"$lt\":\"a_\"}}]", "{\"name\":\"aa\"}") == SQLPredicate::Unknown);
+        BEAST_EXPECT(match ("[{\"name\":{\"$gt\":\"ab\"}}]", "{\"name\":\"abc\"}") == SQLPredicate::True);
+        BEAST_EXPECT(match ("[{\"name\":\"ab\"}]", "{\"name\":\"ab \"}") == SQLPredicate::Unknown);
+        BEAST_EXPECT(match ("[{\"name\":\"caf\xc3\xa9\"}]", "{\"name\":\"cafe\"}") == SQLPredicate::Unknown);
+        BEAST_EXPECT(match ("[{\"name\":{\"$regex\":\"/\xc3\xa9/\"}}]", "{\"name\":\"cafe\"}") == SQLPredicate::Unknown);
+
+        SQLPredicate predicate;
+        BEAST_EXPECT(SQLPredicate::compile (parse ("[{\"id\":{\"$foo\":1}}]"), predicate).first != 0);
+    }
+
+    void testLogical ()
+    {
+        testcase ("logical");
+
+        std::string const both = "[{\"id\":1,\"name\":\"a\"}]";
+        BEAST_EXPECT(match (both, "{\"id\":1,\"name\":\"a\"}") == SQLPredicate::True);
+        BEAST_EXPECT(match (both, "{\"id\":1,\"name\":\"b\"}") == SQLPredicate::False);
+        BEAST_EXPECT(match (both, "{\"id\":2}") == SQLPredicate::False);
+        BEAST_EXPECT(match (both, "{\"id\":1}") == SQLPredicate::Unknown);
+
+        std::string const either = "[{\"id\":1},{\"name\":\"a\"}]";
+        BEAST_EXPECT(match (either, "{\"id\":2,\"name\":\"a\"}") == SQLPredicate::True);
+        BEAST_EXPECT(match (either, "{\"id\":1}") == SQLPredicate::True);
+        BEAST_EXPECT(match (either, "{\"id\":2}") == SQLPredicate::Unknown);
+        BEAST_EXPECT(match (either, "{\"id\":2,\"name\":\"b\"}") == SQLPredicate::False);
+
+        SQLPredicate predicate;
+        SQLPredicate::compile (parse (auditFilters[2]), predicate);
+        BEAST_EXPECT(predicate.columns ().size () == 3);
+    }
+
+    // the same rows as sqlite selects with the sql of the tree
+    void testSqlite ()
+    {
+        testcase ("sqlite");
+
+        soci::session s;
+        open (s, "sqlite", ":memory:");
+        s << "CREATE TABLE t_audit (id INTEGER, age INTEGER, name TEXT, status TEXT);";
+        int const rows = 200;
+        for (int i = 0; i < rows; ++i)
+            insertRow (s, makeRow (i));
+
+        for (auto filter : auditFilters)
+        {
+            auto conditions = parse (filter);
+            auto root = conditionTree::createRoot (conditions);
+            if (! BEAST_EXPECT(root.first == 0))
+                continue;
+            conditionParse::parse_conditions (conditions, root.second);
+            SQLPredicate predicate;
+            if (! BEAST_EXPECT(SQLPredicate::compile (root.second, predicate).first == 0))
+                continue;
+
+            std::string const where = root.second.asString ();
+            int selected = 0;
+            s << "SELECT count(*) FROM t_audit WHERE " << where,
+                soci::into (selected);
+
+            int matched = 0;
+            for (int i = 0; i < rows; ++i)
+            {
+                auto const result = predicate.evaluate (makeRow (i));
+                BEAST_EXPECT(result != SQLPredicate::Unknown);
+                if (result == SQLPredicate::True)
+                    ++matched;
+            }
+            BEAST_EXPECTS(matched == selected, where);
+        }
+    }
+
+    // asserts on values match each expression against any row,
+    // where a predicate needs one row matching all of them
+    void testAssert ()
+    {
+        testcase ("assert");
+
+        soci::session s;
+        open (s, "sqlite", ":memory:");
+        s << "CREATE TABLE t_assert (id INTEGER, name TEXT);";
+        s << "INSERT INTO t_assert (id, name) VALUES (1, 'a');";
+        s << "INSERT INTO t_assert (id, name) VALUES (2, 'b');";
+
+        STTx2SQL tx2sql ("sqlite");
+        auto check = [&](std::string const& expect)
+        {
+            soci::rowset<soci::row> records =
+                (s.prepare << "SELECT id, name FROM t_assert");
+            return tx2sql.assert_result (records, parse (expect));
+        };
+        BEAST_EXPECT(check ("{\"id\":1,\"name\":\"b\"}"));
+        BEAST_EXPECT(check ("{\"id\":{\"$in\":[2,3]},\"name\":\"a\"}"));
+        BEAST_EXPECT(check ("{\"id\":{\"$nin\":[2]}}"));
+        BEAST_EXPECT(! check ("{\"id\":3,\"name\":\"a\"}"));
+        // the first row in the list fails $nin
+        BEAST_EXPECT(! check ("{\"id\":{\"$nin\":[1]}}"));
+
+        BEAST_EXPECT(match ("[{\"id\":1,\"name\":\"b\"}]",
+            "{\"id\":1,\"name\":\"a\"}") == SQLPredicate::False);
+        BEAST_EXPECT(match ("[{\"id\":1,\"name\":\"b\"}]",
+            "{\"id\":2,\"name\":\"b\"}") == SQLPredicate::False);
+    }
+
+public:
+    void run ()
+    {
+        testExpressions ();
+        testLogical ();
+        testSqlite ();
+        testAssert ();
+    }
+};
+
+// An audit checks every inserted row against its filter: re-running the
+// filter in sqlite after each insert, rendering the filter again from
+// json for each row, or evaluating the compiled filter on the row.
+class SQLPredicateBench_test : public beast::unit_test::suite
+{
+public:
+    void run ()
+    {
+        using namespace std::chrono;
+        int const rows = 2000;
+
+        for (auto filter : auditFilters)
+        {
+            testcase (filter);
+            auto const conditions = parse (filter);
+            std::vector<Json::Value> inserted;
+            for (int i = 0; i < rows; ++i)
+                inserted.push_back (makeRow (i));
+
+            auto root = conditionTree::createRoot (conditions);
+            conditionParse::parse_conditions (conditions, root.second);
+            std::string const where = root.second.asString ();
+
+            soci::session s;
+            open (s, "sqlite", ":memory:");
+            s << "CREATE TABLE t_audit (id INTEGER, age INTEGER, name TEXT, status TEXT);";
+            int selected = 0;
+            auto start = steady_clock::now ();
+            for (auto const& row : inserted)
+            {
+                insertRow (s, row);
+                s << "SELECT count(*) FROM t_audit WHERE " << where,
+                    soci::into (selected);
+            }
+            auto const sqlTime = steady_clock::now () - start;
+
+            start = steady_clock::now ();
+            std::size_t length = 0;
+            for (std::size_t i = 0; i < inserted.size (); ++i)
+            {
+                auto tree = conditionTree::createRoot (conditions);
+                conditionParse::parse_conditions (conditions, tree.second);
+                length += tree.second.asConditionString ().second.size ();
+            }
+            auto const renderTime = steady_clock::now () - start;
+
+            start = steady_clock::now ();
+            SQLPredicate predicate;
+            SQLPredicate::compile (conditions, predicate);
+            int matched = 0;
+            for (auto const& row : inserted)
+            {
+                if (predicate.evaluate (row) == SQLPredicate::True)
+                    ++matched;
+            }
+            auto const compiledTime = steady_clock::now () - start;
+
+            BEAST_EXPECT(matched == selected);
+            BEAST_EXPECT(length > 0);
+            log <<
+                "    " << rows << " rows: sql " <<
+                duration_cast<microseconds> (sqlTime).count () / rows <<
+                " us/row, render " <<
+                duration_cast<nanoseconds> (renderTime).count () / rows <<
+                " ns/row, compiled " <<
+                duration_cast<nanoseconds> (compiledTime).count () / rows <<
+                " ns/row" << std::endl;
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SQLPredicate,app,ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(SQLPredicateBench,app,ripple);
+
+}  // ripple
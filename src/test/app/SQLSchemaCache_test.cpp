@@ -0,0 +1,131 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <peersafe/app/sql/SQLSchemaCache.h>
+#include <ripple/core/DatabaseCon.h>
+#include <ripple/core/SociDB.h>
+#include <ripple/beast/unit_test.h>
+
+namespace ripple {
+
+class SQLSchemaCache_test : public beast::unit_test::suite
+{
+    void testColumns ()
+    {
+        testcase ("columns");
+
+        soci::session s;
+        open (s, "sqlite", ":memory:");
+        s << "CREATE TABLE t_schema (id INTEGER, Name TEXT);";
+
+        SQLSchemaCache cache;
+        auto schema = cache.get (s, "t_schema");
+        if (! BEAST_EXPECT(schema))
+            return;
+        BEAST_EXPECT(schema->hasColumn ("id"));
+        // column names are case insensitive
+        BEAST_EXPECT(schema->hasColumn ("name"));
+        BEAST_EXPECT(schema->hasColumn ("NAME"));
+        BEAST_EXPECT(! schema->hasColumn ("age"));
+        BEAST_EXPECT(schema->columnType ("id") == "integer");
+        BEAST_EXPECT(schema->columnType ("age").empty ());
+
+        BEAST_EXPECT(cache.exists (s, "t_schema"));
+        BEAST_EXPECT(cache.hasColumn (s, "t_schema", "id"));
+        BEAST_EXPECT(cache.size () == 1);
+
+        // a table which doesn't exist is not cached
+        BEAST_EXPECT(! cache.exists (s, "t_missing"));
+        BEAST_EXPECT(cache.size () == 1);
+        s << "CREATE TABLE t_missing (id INTEGER);";
+        BEAST_EXPECT(cache.exists (s, "t_missing"));
+        BEAST_EXPECT(cache.size () == 2);
+    }
+
+    void testInvalidate ()
+    {
+        testcase ("invalidate");
+
+        soci::session s;
+        open (s, "sqlite", ":memory:");
+        s << "CREATE TABLE t_schema (id INTEGER, name TEXT);";
+
+        SQLSchemaCache cache;
+        BEAST_EXPECT(cache.hasColumn (s, "t_schema", "name"));
+
+        s << "DROP TABLE t_schema;";
+        s << "CREATE TABLE t_schema (id INTEGER, age INTEGER);";
+        // cached until the table is invalidated
+        BEAST_EXPECT(cache.hasColumn (s, "t_schema", "name"));
+        cache.invalidate ("t_schema");
+        BEAST_EXPECT(! cache.hasColumn (s, "t_schema", "name"));
+        BEAST_EXPECT(cache.hasColumn (s, "t_schema", "age"));
+
+        cache.clear ();
+        BEAST_EXPECT(cache.size () == 0);
+    }
+
+    void testRollback ()
+    {
+        testcase ("rollback");
+
+        DatabaseCon::Setup setup;
+        setup.standAlone = true;
+        DatabaseCon db (setup, "schema_rollback", nullptr, 0, "sqlite");
+        auto& cache = db.getSchemaCache ();
+
+        {
+            LockedSociSession sql = db.checkoutDb ();
+            soci::transaction tr (*sql);
+            *sql << "CREATE TABLE t_schema (id INTEGER);";
+            BEAST_EXPECT(cache.exists (*sql, "t_schema"));
+            tr.rollback ();
+            db.rolledBack ();
+
+            // sqlite undid the create table
+            BEAST_EXPECT(cache.size () == 0);
+            BEAST_EXPECT(! cache.exists (*sql, "t_schema"));
+        }
+    }
+
+    void testShared ()
+    {
+        testcase ("shared");
+
+        auto a = SQLSchemaCache::forDatabase ("sqlite:a.db");
+        auto b = SQLSchemaCache::forDatabase ("sqlite:a.db");
+        auto c = SQLSchemaCache::forDatabase ("sqlite:c.db");
+        BEAST_EXPECT(a == b);
+        BEAST_EXPECT(a != c);
+    }
+
+public:
+    void run ()
+    {
+        testColumns ();
+        testInvalidate ();
+        testRollback ();
+        testShared ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SQLSchemaCache,app,ripple);
+
+}  // ripple
@@ -0,0 +1,155 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <peersafe/app/sql/SQLStatementCache.h>
+#include <ripple/core/SociDB.h>
+#include <ripple/beast/unit_test.h>
+
+namespace ripple {
+
+class SQLStatementCache_test : public beast::unit_test::suite
+{
+    static int countRows (soci::session& s)
+    {
+        int count = 0;
+        s << "SELECT count(*) FROM t_cache;", soci::into (count);
+        return count;
+    }
+
+    void testReuse ()
+    {
+        testcase ("reuse");
+
+        soci::session s;
+        open (s, "sqlite", ":memory:");
+        s << "CREATE TABLE t_cache (id INTEGER, name TEXT);";
+
+        SQLStatementCache cache;
+        std::string const sql = "insert into t_cache (id,name) values (:1,:2)";
+        for (int i = 0; i < 10; ++i)
+        {
+            BindValue id (i);
+            BindValue name (std::string ("name") + std::to_string (i));
+            BEAST_EXPECT(cache.execute (s, "t_cache", sql, {&id, &name}) == 1);
+        }
+        BEAST_EXPECT(cache.misses () == 1);
+        BEAST_EXPECT(cache.hits () == 9);
+        BEAST_EXPECT(cache.size () == 1);
+        BEAST_EXPECT(countRows (s) == 10);
+
+        // same text with other types of values is another statement
+        {
+            BindValue id (10);
+            BindValue name (1.5);
+            BEAST_EXPECT(cache.execute (s, "t_cache", sql, {&id, &name}) == 1);
+            BEAST_EXPECT(cache.misses () == 2);
+            BEAST_EXPECT(cache.size () == 2);
+        }
+
+        // multi-row insert reports every inserted row
+        {
+            BindValue id1 (11), id2 (12);
+            BindValue name1 (std::string ("a")), name2 (std::string ("b"));
+            BEAST_EXPECT(cache.execute (s, "t_cache",
+                "insert into t_cache (id,name) values (:1,:2),(:3,:4)",
+                {&id1, &name1, &id2, &name2}) == 2);
+        }
+
+        // update and delete bind conditions the same way
+        {
+            BindValue name (std::string ("renamed"));
+            BindValue id (3);
+            BEAST_EXPECT(cache.execute (s, "t_cache",
+                "update t_cache set name=:1 where id=:2", {&name, &id}) == 1);
+            BindValue id2 (4);
+            BEAST_EXPECT(cache.execute (s, "t_cache",
+                "delete from t_cache where id=:1", {&id2}) == 1);
+        }
+        BEAST_EXPECT(countRows (s) == 12);
+
+        cache.invalidate ("t_other");
+        BEAST_EXPECT(cache.size () == 5);
+        cache.invalidate ("t_cache");
+        BEAST_EXPECT(cache.size () == 0);
+
+        // statements are prepared again after invalidation
+        {
+            BindValue id (20);
+            BindValue name (std::string ("again"));
+            BEAST_EXPECT(cache.execute (s, "t_cache", sql, {&id, &name}) == 1);
+            BEAST_EXPECT(cache.size () == 1);
+        }
+        cache.clear ();
+        BEAST_EXPECT(cache.size () == 0);
+    }
+
+    void testCapacity ()
+    {
+        testcase ("capacity");
+
+        soci::session s;
+        open (s, "sqlite", ":memory:");
+        s << "CREATE TABLE t_cache (id INTEGER, name TEXT);";
+
+        SQLStatementCache cache (2);
+        BindValue id (1);
+        cache.execute (s, "t_cache", "delete from t_cache where id=:1", {&id});
+        cache.execute (s, "t_cache", "delete from t_cache where id>:1", {&id});
+        cache.execute (s, "t_cache", "delete from t_cache where id<:1", {&id});
+        BEAST_EXPECT(cache.size () == 2);
+        // the least recently used statement was evicted
+        cache.execute (s, "t_cache", "delete from t_cache where id=:1", {&id});
+        BEAST_EXPECT(cache.misses () == 4);
+    }
+
+    void testFailure ()
+    {
+        testcase ("failure");
+
+        soci::session s;
+        open (s, "sqlite", ":memory:");
+
+        SQLStatementCache cache;
+        BindValue id (1);
+        try
+        {
+            cache.execute (s, "t_missing",
+                "delete from t_missing where id=:1", {&id});
+            fail ("missing table must throw");
+        }
+        catch (soci::soci_error const&)
+        {
+            pass ();
+        }
+        BEAST_EXPECT(cache.size () == 0);
+    }
+
+public:
+    void run ()
+    {
+        testReuse ();
+        testCapacity ();
+        testFailure ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SQLStatementCache,app,ripple);
+
+}  // ripple
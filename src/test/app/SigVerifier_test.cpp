@@ -0,0 +1,185 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/misc/HashRouter.h>
+#include <ripple/app/misc/SigVerifier.h>
+#include <ripple/app/tx/apply.h>
+#include <ripple/basics/chrono.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/JsonFields.h>
+#include <ripple/protocol/SecretKey.h>
+#include <ripple/protocol/STTx.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace ripple {
+namespace test {
+
+static std::shared_ptr<STTx const>
+makeTx (std::pair<PublicKey, SecretKey> const& keypair,
+    std::uint32_t seq, bool good = true)
+{
+    auto tx = std::make_shared<STTx> (ttACCOUNT_SET,
+        [&keypair, seq](auto& obj)
+        {
+            obj.setAccountID (sfAccount, calcAccountID (keypair.first));
+            obj.setFieldU32 (sfSequence, seq);
+            obj.setFieldVL (sfSigningPubKey, keypair.first.slice ());
+        });
+    tx->sign (keypair.first, keypair.second);
+    if (good)
+        return tx;
+
+    auto sig = tx->getFieldVL (sfTxnSignature);
+    sig.back () ^= 0x01;
+    tx->setFieldVL (sfTxnSignature, sig);
+
+    // reparse so the transaction ID covers the broken signature
+    Serializer s;
+    tx->add (s);
+    SerialIter sit (s.slice ());
+    return std::make_shared<STTx const> (sit);
+}
+
+class SigVerifier_test : public beast::unit_test::suite
+{
+    void testVerify ()
+    {
+        testcase ("verify");
+        using namespace std::chrono_literals;
+
+        TestStopwatch stopwatch;
+        HashRouter router (stopwatch, 2s, 2);
+        SigVerifier verifier (router, 2);
+        auto const keypair = randomKeyPair (KeyType::secp256k1);
+
+        std::vector<std::shared_ptr<STTx const>> txs;
+        for (std::uint32_t i = 0; i < 200; ++i)
+            txs.push_back (makeTx (keypair, i + 1, i % 10 != 0));
+
+        BEAST_EXPECT(verifier.verify (txs, false) == 180);
+        BEAST_EXPECT(verifier.pending () == 0);
+
+        // the results are cached for checkValidity
+        for (std::size_t i = 0; i < txs.size (); ++i)
+        {
+            auto const ret = checkSignature (router, *txs[i], false);
+            BEAST_EXPECT(ret.first == (i % 10 != 0));
+            if (! ret.first)
+                BEAST_EXPECT(ret.second == "Transaction has bad signature.");
+        }
+
+        auto const info = verifier.getInfo ();
+        BEAST_EXPECT(info[jss::verified].asUInt () == 200);
+        BEAST_EXPECT(info[jss::threads].asInt () == 2);
+    }
+
+    void testAdd ()
+    {
+        testcase ("add");
+        using namespace std::chrono_literals;
+
+        TestStopwatch stopwatch;
+        HashRouter router (stopwatch, 2s, 2);
+        SigVerifier verifier (router, 1);
+        auto const keypair = randomKeyPair (KeyType::secp256k1);
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<bool> results;
+        for (std::uint32_t i = 0; i < 4; ++i)
+        {
+            verifier.add (makeTx (keypair, i + 1, i != 2), false,
+                [&](bool valid)
+                {
+                    std::lock_guard<std::mutex> lock (mutex);
+                    results.push_back (valid);
+                    cv.notify_one ();
+                });
+        }
+
+        std::unique_lock<std::mutex> lock (mutex);
+        cv.wait (lock, [&] { return results.size () == 4; });
+        // one verify thread, so the order is kept
+        BEAST_EXPECT(results == std::vector<bool>({ true, true, false, true }));
+    }
+
+public:
+    void run () override
+    {
+        testVerify ();
+        testAdd ();
+    }
+};
+
+// Signatures per second, checked one by one on the calling
+// thread and in batches by a SigVerifier with 1, 2, 4 and 8 threads.
+class SigVerifierBench_test : public beast::unit_test::suite
+{
+public:
+    void run () override
+    {
+        using namespace std::chrono;
+        using namespace std::chrono_literals;
+        std::size_t const count = 4000;
+
+        for (auto const type : { KeyType::secp256k1, KeyType::ed25519 })
+        {
+            testcase (type == KeyType::secp256k1 ? "secp256k1" : "ed25519");
+            auto const keypair = randomKeyPair (type);
+            std::vector<std::shared_ptr<STTx const>> txs;
+            for (std::uint32_t i = 0; i < count; ++i)
+                txs.push_back (makeTx (keypair, i + 1));
+
+            auto rate = [count](steady_clock::duration d)
+            {
+                return count * 1000 /
+                    std::max<std::int64_t> (1,
+                        duration_cast<milliseconds> (d).count ());
+            };
+
+            auto start = steady_clock::now ();
+            for (auto const& tx : txs)
+                BEAST_EXPECT(tx->checkSign (false).first);
+            log << "    one by one: " <<
+                rate (steady_clock::now () - start) << " sigs/s" << std::endl;
+
+            for (int threads : { 1, 2, 4, 8 })
+            {
+                TestStopwatch stopwatch;
+                HashRouter router (stopwatch, 2s, 2);
+                SigVerifier verifier (router, threads);
+
+                start = steady_clock::now ();
+                BEAST_EXPECT(verifier.verify (txs, false) == count);
+                log << "    " << threads << " threads: " <<
+                    rate (steady_clock::now () - start) << " sigs/s" <<
+                    std::endl;
+            }
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SigVerifier,app,ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(SigVerifierBench,app,ripple);
+
+} // test
+} // ripple
@@ -0,0 +1,212 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/OpenLedger.h>
+#include <ripple/app/misc/CanonicalTXSet.h>
+#include <ripple/app/tx/SpeculativeApply.h>
+#include <ripple/consensus/LedgerTiming.h>
+#include <test/jtx.h>
+
+namespace ripple {
+namespace test {
+
+class SpeculativeApply_test : public beast::unit_test::suite
+{
+    // Builds the ledger following the last closed one from txs,
+    // over retry passes in canonical order as consensus does.
+    std::shared_ptr<Ledger const>
+    buildLedger (jtx::Env& env,
+        std::vector<std::shared_ptr<STTx const>> const& txs,
+            SpeculativeApply* speculative)
+    {
+        auto const parent =
+            env.app ().getLedgerMaster ().getClosedLedger ();
+        auto const closeTime = parent->info ().closeTime +
+            parent->info ().closeTimeResolution;
+        auto ledger = std::make_shared<Ledger> (*parent, closeTime);
+
+        CanonicalTXSet set (parent->info ().hash);
+        for (auto const& tx : txs)
+            set.insert (tx);
+
+        {
+            OpenView accum (&*ledger);
+            bool certainRetry = true;
+            for (int pass = 0; pass < LEDGER_TOTAL_PASSES; ++pass)
+            {
+                std::vector<std::shared_ptr<STTx const>> pending;
+                for (auto const& item : set)
+                    pending.push_back (item.second);
+
+                std::vector<ApplyResult> results;
+                if (speculative)
+                    results = speculative->apply (accum, pending,
+                        certainRetry, tapNO_CHECK_SIGN);
+                else
+                    for (auto const& tx : pending)
+                        results.push_back (applyTransaction (env.app (),
+                            accum, *tx, certainRetry, tapNO_CHECK_SIGN,
+                                env.journal));
+                BEAST_EXPECT(results.size () == pending.size ());
+
+                int changes = 0;
+                auto it = set.begin ();
+                for (auto const result : results)
+                {
+                    if (result == ApplyResult::Retry)
+                    {
+                        ++it;
+                        continue;
+                    }
+                    if (result == ApplyResult::Success)
+                        ++changes;
+                    it = set.erase (it);
+                }
+
+                if (! changes && ! certainRetry)
+                    break;
+                if (! changes || pass >= LEDGER_RETRY_PASSES)
+                    certainRetry = false;
+            }
+            accum.apply (*ledger);
+        }
+
+        ledger->updateSkipList ();
+        ledger->setAccepted (closeTime, ledgerDefaultTimeResolution, true,
+            env.app ().config ());
+        return ledger;
+    }
+
+    void testSameLedger (int threads)
+    {
+        testcase ("same ledger, " + std::to_string (threads) + " threads");
+
+        using namespace jtx;
+        Env env (*this);
+        Account const gw ("gateway");
+        auto const USD = gw["USD"];
+        std::vector<Account> accounts;
+        for (int i = 0; i < 40; ++i)
+            accounts.emplace_back ("acct" + std::to_string (i));
+        env.fund (ZXC (100000), gw);
+        for (auto const& account : accounts)
+            env.fund (ZXC (10000), account);
+        env.close ();
+        env (trust (accounts[0], USD (1000)));
+        env.close ();
+
+        std::vector<std::shared_ptr<STTx const>> txs;
+        auto add = [&](JTx const& jt)
+        {
+            txs.push_back (jt.stx);
+        };
+
+        // Payments between disjoint accounts
+        for (int i = 10; i < 30; ++i)
+            add (env.jt (pay (accounts[i], accounts[i + 10], ZXC (10)),
+                seq (env.seq (accounts[i]))));
+
+        // A chain of payments, each spending what the last one sent
+        for (int i = 1; i < 5; ++i)
+            add (env.jt (pay (accounts[i], accounts[i + 1], ZXC (5000)),
+                seq (env.seq (accounts[i]))));
+
+        // Runs of sequence numbers from one account
+        for (std::uint32_t i = 0; i < 4; ++i)
+        {
+            add (env.jt (noop (accounts[6]), seq (env.seq (accounts[6]) + i)));
+            add (env.jt (pay (accounts[7], gw, ZXC (1)),
+                seq (env.seq (accounts[7]) + i)));
+        }
+
+        // Spends from an account created in the same ledger, which
+        // retries if it comes first in canonical order
+        Account const carol ("carol");
+        add (env.jt (pay (accounts[8], carol, ZXC (1000)),
+            seq (env.seq (accounts[8]))));
+        add (env.jt (pay (carol, accounts[9], ZXC (100)), seq (1)));
+
+        // Trust lines and issued currency
+        add (env.jt (trust (accounts[9], USD (100)),
+            seq (env.seq (accounts[9]))));
+        add (env.jt (pay (gw, accounts[9], USD (10)), seq (env.seq (gw))));
+        add (env.jt (pay (gw, accounts[0], USD (10)), seq (env.seq (gw) + 1)));
+
+        // Applied in turn
+        add (env.jt (offer (accounts[5], USD (10), ZXC (10)),
+            seq (env.seq (accounts[5]))));
+
+        auto const serial = buildLedger (env, txs, nullptr);
+
+        SpeculativeApply speculative (env.app (), threads, env.journal);
+        auto const parallel = buildLedger (env, txs, &speculative);
+
+        BEAST_EXPECT(serial->info ().hash == parallel->info ().hash);
+        BEAST_EXPECT(serial->info ().txHash == parallel->info ().txHash);
+        BEAST_EXPECT(serial->info ().accountHash ==
+            parallel->info ().accountHash);
+        BEAST_EXPECT(speculative.committed () > 0);
+        BEAST_EXPECT(speculative.reapplied () > 0);
+
+        // Carol's payment made it in on a later pass
+        BEAST_EXPECT(parallel->exists (keylet::account (carol.id ())));
+    }
+
+    void testCanSpeculate ()
+    {
+        testcase ("can speculate");
+
+        using namespace jtx;
+        Env env (*this);
+        Account const alice ("alice");
+        Account const bob ("bob");
+        env.fund (ZXC (10000), alice, bob);
+        env.close ();
+
+        BEAST_EXPECT(SpeculativeApply::canSpeculate (
+            *env.jt (pay (alice, bob, ZXC (10))).stx));
+        BEAST_EXPECT(SpeculativeApply::canSpeculate (
+            *env.jt (noop (alice)).stx));
+        BEAST_EXPECT(! SpeculativeApply::canSpeculate (
+            *env.jt (offer (alice, bob["USD"] (10), ZXC (10))).stx));
+        BEAST_EXPECT(! SpeculativeApply::canSpeculate (STTx (ttSQLSTATEMENT,
+            [&alice](auto& obj)
+            {
+                obj.setAccountID (sfAccount, alice.id ());
+            })));
+    }
+
+public:
+    void run () override
+    {
+        testSameLedger (1);
+        testSameLedger (4);
+        testSameLedger (8);
+        testCanSpeculate ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SpeculativeApply,app,ripple);
+
+} // test
+} // ripple
@@ -0,0 +1,179 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <peersafe/app/table/TableBulkLoad.h>
+#include <ripple/beast/unit_test.h>
+#include <boost/optional.hpp>
+
+namespace ripple {
+namespace test {
+
+class TableBulkLoad_test : public beast::unit_test::suite
+{
+    static int
+    count (DatabaseCon& db, std::string const& sql)
+    {
+        int n = 0;
+        auto session = db.checkoutDb ();
+        *session << sql, soci::into (n);
+        return n;
+    }
+
+    static int
+    indexCount (DatabaseCon& db, std::string const& name)
+    {
+        return count (db, "SELECT COUNT(*) FROM sqlite_master "
+            "WHERE type = 'index' AND name = '" + name + "'");
+    }
+
+    void
+    testDropRestore ()
+    {
+        testcase ("drop and restore");
+
+        DatabaseCon::Setup setup;
+        setup.standAlone = true;
+        DatabaseCon db (setup, "bulk", nullptr, 0, "sqlite");
+        {
+            auto session = db.checkoutDb ();
+            *session << "CREATE TABLE t_abc (id INTEGER PRIMARY KEY, "
+                "name TEXT, v INTEGER)";
+            *session << "CREATE INDEX idx_name ON t_abc (name)";
+            *session << "CREATE UNIQUE INDEX uq_v ON t_abc (v)";
+        }
+
+        beast::Journal j;
+        {
+            TableBulkLoad bulk (&db, true, j);
+            BEAST_EXPECT(! bulk.isLoading ("abc"));
+            bulk.dropIndexes ("abc");
+            BEAST_EXPECT(bulk.isLoading ("abc"));
+            BEAST_EXPECT(indexCount (db, "idx_name") == 0);
+            // unique indexes still reject the same rows
+            BEAST_EXPECT(indexCount (db, "uq_v") == 1);
+
+            auto session = db.checkoutDb ();
+            *session << "INSERT INTO t_abc (name, v) VALUES ('a', 1)";
+            *session << "INSERT INTO t_abc (name, v) VALUES ('b', 2)";
+        }
+
+        // the dropped indexes survive a restart
+        TableBulkLoad bulk (&db, true, j);
+        BEAST_EXPECT(bulk.isLoading ("abc"));
+        BEAST_EXPECT(bulk.restoreIndexes ("abc") == 1);
+        BEAST_EXPECT(! bulk.isLoading ("abc"));
+        BEAST_EXPECT(indexCount (db, "idx_name") == 1);
+        BEAST_EXPECT(count (db, "SELECT COUNT(*) FROM SyncBulkIndex") == 0);
+        BEAST_EXPECT(bulk.restoreIndexes ("abc") == 0);
+
+        // a table without secondary indexes is not loading
+        BEAST_EXPECT(count (db, "SELECT COUNT(*) FROM t_abc "
+            "WHERE name = 'b'") == 1);
+        bulk.dropIndexes ("xyz");
+        BEAST_EXPECT(! bulk.isLoading ("xyz"));
+    }
+
+    void
+    testForget ()
+    {
+        testcase ("forget");
+
+        DatabaseCon::Setup setup;
+        setup.standAlone = true;
+        DatabaseCon db (setup, "bulk", nullptr, 0, "sqlite");
+        {
+            auto session = db.checkoutDb ();
+            *session << "CREATE TABLE t_abc (id INTEGER PRIMARY KEY, "
+                "name TEXT)";
+            *session << "CREATE INDEX idx_name ON t_abc (name)";
+        }
+
+        beast::Journal j;
+        TableBulkLoad bulk (&db, true, j);
+        bulk.dropIndexes ("abc");
+        BEAST_EXPECT(bulk.isLoading ("abc"));
+
+        // the table is created again with its own indexes
+        bulk.forget ("abc");
+        BEAST_EXPECT(! bulk.isLoading ("abc"));
+        BEAST_EXPECT(count (db, "SELECT COUNT(*) FROM SyncBulkIndex") == 0);
+        BEAST_EXPECT(bulk.restoreIndexes ("abc") == 0);
+        BEAST_EXPECT(indexCount (db, "idx_name") == 0);
+    }
+
+    void
+    testRestoreFails ()
+    {
+        testcase ("restore fails");
+
+        DatabaseCon::Setup setup;
+        setup.standAlone = true;
+        DatabaseCon db (setup, "bulk", nullptr, 0, "sqlite");
+        {
+            auto session = db.checkoutDb ();
+            *session << "CREATE TABLE t_abc (id INTEGER PRIMARY KEY, "
+                "name TEXT, v INTEGER)";
+            *session << "CREATE INDEX idx_name ON t_abc (name)";
+            *session << "CREATE INDEX idx_v ON t_abc (v)";
+        }
+
+        beast::Journal j;
+        TableBulkLoad bulk (&db, true, j);
+        bulk.dropIndexes ("abc");
+        BEAST_EXPECT(bulk.isLoading ("abc"));
+        BEAST_EXPECT(count (db, "SELECT COUNT(*) FROM SyncBulkIndex") == 2);
+
+        // the name is taken, CREATE INDEX idx_v fails
+        {
+            auto session = db.checkoutDb ();
+            *session << "CREATE INDEX idx_v ON t_abc (name)";
+        }
+        BEAST_EXPECT(bulk.restoreIndexes ("abc") == 1);
+        BEAST_EXPECT(indexCount (db, "idx_name") == 1);
+        BEAST_EXPECT(bulk.isLoading ("abc"));
+        BEAST_EXPECT(count (db, "SELECT COUNT(*) FROM SyncBulkIndex "
+            "WHERE IndexName = 'idx_v'") == 1);
+        BEAST_EXPECT(count (db, "SELECT COUNT(*) FROM SyncBulkIndex") == 1);
+
+        // the next try only creates the missing one
+        {
+            auto session = db.checkoutDb ();
+            *session << "DROP INDEX idx_v";
+        }
+        BEAST_EXPECT(bulk.restoreIndexes ("abc") == 1);
+        BEAST_EXPECT(! bulk.isLoading ("abc"));
+        BEAST_EXPECT(indexCount (db, "idx_v") == 1);
+        BEAST_EXPECT(count (db, "SELECT COUNT(*) FROM SyncBulkIndex") == 0);
+    }
+
+public:
+    void
+    run () override
+    {
+        testDropRestore ();
+        testForget ();
+        testRestoreFails ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TableBulkLoad,app,ripple);
+
+} // test
+} // ripple
@@ -0,0 +1,306 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <test/jtx.h>
+#include <peersafe/app/table/TableDirectory.h>
+#include <peersafe/protocol/TableDefines.h>
+#include <ripple/basics/StringUtilities.h>
+#include <ripple/ledger/Sandbox.h>
+#include <ripple/protocol/Feature.h>
+#include <ripple/protocol/JsonFields.h>
+#include <chrono>
+
+namespace ripple {
+namespace test {
+
+static Blob
+tableName (std::size_t i)
+{
+    auto const name = "table_" + std::to_string (i);
+    return Blob (name.begin (), name.end ());
+}
+
+static STObject
+makeTable (std::size_t i)
+{
+    STObject table (sfEntry);
+    table.setFieldVL (sfTableName, tableName (i));
+    table.setFieldH160 (sfNameInDB, uint160 (i + 1));
+    table.setFieldU32 (sfCreateLgrSeq, 1);
+    return table;
+}
+
+static void
+createTableList (ApplyView& view, AccountID const& owner)
+{
+    auto const tablesle = std::make_shared<SLE> (keylet::table (owner));
+    tablesle->setFieldArray (sfTableEntries, STArray ());
+    view.insert (tablesle);
+}
+
+static Json::Value
+tableListSet (jtx::Account const& account, TableOpType opType,
+    std::size_t i)
+{
+    Json::Value table;
+    table["TableName"] = strHex (tableName (i));
+    table["NameInDB"] = to_string (uint160 (i + 1));
+
+    Json::Value jv;
+    jv[jss::Account] = account.human ();
+    jv[jss::TransactionType] = "TableListSet";
+    jv["OpType"] = std::to_string (opType);
+    jv["Tables"][0u]["Table"] = table;
+    return jv;
+}
+
+class TableDirectory_test : public beast::unit_test::suite
+{
+    void testLayout (bool enabled)
+    {
+        testcase (enabled ? "indexed layout" : "array layout");
+
+        using namespace jtx;
+        Env env (*this, enabled ? all_amendments () :
+            all_features_except (featureTableDirectory));
+        AccountID const owner = Account ("alice").id ();
+
+        Sandbox sb (&*env.current (), tapNONE);
+        createTableList (sb, owner);
+        for (std::size_t i = 0; i < 3; ++i)
+            BEAST_EXPECT(insertTableEntry (sb, owner, makeTable (i)) ==
+                tesSUCCESS);
+
+        BEAST_EXPECT(tableCount (sb, owner) == 3);
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            auto const entry = readTableEntry (sb, owner, tableName (i));
+            if (BEAST_EXPECT(entry))
+                BEAST_EXPECT(entry->getFieldH160 (sfNameInDB) ==
+                    uint160 (i + 1));
+            BEAST_EXPECT(sb.exists (keylet::tableEntry (owner,
+                tableName (i))) == enabled);
+        }
+        BEAST_EXPECT(! readTableEntry (sb, owner, tableName (3)));
+
+        auto const tablesle = sb.read (keylet::table (owner));
+        BEAST_EXPECT(tablesle->getFieldArray (sfTableEntries).size () ==
+            (enabled ? 0 : 3));
+
+        std::size_t visited = 0;
+        forEachTableEntry (sb, owner, [&visited](STEntry const&)
+        {
+            ++visited;
+            return true;
+        });
+        BEAST_EXPECT(visited == 3);
+
+        BEAST_EXPECT(renameTableEntry (sb, owner, tableName (0),
+            tableName (10)) == tesSUCCESS);
+        BEAST_EXPECT(! readTableEntry (sb, owner, tableName (0)));
+        BEAST_EXPECT(readTableEntry (sb, owner, tableName (10)));
+
+        BEAST_EXPECT(eraseTableEntry (sb, owner, tableName (1)) ==
+            tesSUCCESS);
+        BEAST_EXPECT(eraseTableEntry (sb, owner, tableName (1)) ==
+            tefTABLE_NOTEXIST);
+        BEAST_EXPECT(tableCount (sb, owner) == 2);
+
+        auto const found = findTableEntry (sb, owner,
+            [](STEntry const& table)
+            {
+                return table.getFieldH160 (sfNameInDB) == uint160 (3);
+            });
+        if (BEAST_EXPECT(found))
+            BEAST_EXPECT(found->getFieldVL (sfTableName) == tableName (2));
+    }
+
+    void testMigrate ()
+    {
+        testcase ("migrate");
+
+        using namespace jtx;
+        Env env (*this);
+        AccountID const owner = Account ("alice").id ();
+
+        // tables created before the amendment
+        Sandbox sb (&*env.current (), tapNONE);
+        {
+            auto const tablesle = std::make_shared<SLE> (keylet::table (owner));
+            STArray tables;
+            for (std::size_t i = 0; i < 3; ++i)
+                tables.push_back (makeTable (i));
+            tablesle->setFieldArray (sfTableEntries, tables);
+            sb.insert (tablesle);
+        }
+        BEAST_EXPECT(readTableEntry (sb, owner, tableName (1)));
+        BEAST_EXPECT(tableCount (sb, owner) == 3);
+
+        BEAST_EXPECT(migrateTableEntries (sb, owner) == tesSUCCESS);
+        auto const tablesle = sb.read (keylet::table (owner));
+        BEAST_EXPECT(tablesle->getFieldArray (sfTableEntries).empty ());
+        BEAST_EXPECT(tablesle->getFieldU32 (sfTableCount) == 3);
+        BEAST_EXPECT(tableCount (sb, owner) == 3);
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            BEAST_EXPECT(sb.exists (keylet::tableEntry (owner,
+                tableName (i))));
+            BEAST_EXPECT(readTableEntry (sb, owner, tableName (i)));
+        }
+
+        // nothing left to move
+        BEAST_EXPECT(migrateTableEntries (sb, owner) == tesSUCCESS);
+        BEAST_EXPECT(tableCount (sb, owner) == 3);
+    }
+
+    // create, rename and drop a table through the TableListSet transactor
+    void testTransactor (bool enabled)
+    {
+        testcase (enabled ? "transactor indexed" : "transactor array");
+
+        using namespace jtx;
+        Env env (*this, enabled ? all_amendments () :
+            all_features_except (featureTableDirectory));
+        Account const alice ("alice");
+        env.fund (ZXC (10000), alice);
+        env.close ();
+
+        // chainsql transactions pay for their raw on top of the base fee
+        auto create = tableListSet (alice, T_CREATE, 0);
+        create["Raw"] = strHex (std::string (
+            R"([{"field":"id","type":"int"}])"));
+        env (create, fee (ZXC (1)));
+        env.close ();
+
+        BEAST_EXPECT(tableCount (*env.current (), alice.id ()) == 1);
+        BEAST_EXPECT(readTableEntry (*env.current (), alice.id (),
+            tableName (0)));
+        BEAST_EXPECT(static_cast<bool> (env.le (keylet::tableEntry (
+            alice.id (), tableName (0)))) == enabled);
+        auto const tablesle = env.le (keylet::table (alice.id ()));
+        if (BEAST_EXPECT(tablesle))
+            BEAST_EXPECT(tablesle->getFieldArray (sfTableEntries).size () ==
+                (enabled ? 0 : 1));
+
+        auto rename = tableListSet (alice, T_RENAME, 0);
+        rename["Tables"][0u]["Table"]["TableNewName"] =
+            strHex (tableName (1));
+        env (rename, fee (ZXC (1)));
+        env.close ();
+
+        BEAST_EXPECT(tableCount (*env.current (), alice.id ()) == 1);
+        BEAST_EXPECT(! readTableEntry (*env.current (), alice.id (),
+            tableName (0)));
+        auto const renamed = readTableEntry (*env.current (), alice.id (),
+            tableName (1));
+        if (BEAST_EXPECT(renamed))
+            BEAST_EXPECT(renamed->getFieldH160 (sfNameInDB) == uint160 (1));
+        BEAST_EXPECT(static_cast<bool> (env.le (keylet::tableEntry (
+            alice.id (), tableName (1)))) == enabled);
+
+        // the renamed table is dropped by its new name
+        auto drop = tableListSet (alice, T_DROP, 1);
+        drop["Tables"][0u]["Table"]["NameInDB"] = to_string (uint160 (1));
+        env (drop, fee (ZXC (1)));
+        env.close ();
+
+        BEAST_EXPECT(tableCount (*env.current (), alice.id ()) == 0);
+        BEAST_EXPECT(! readTableEntry (*env.current (), alice.id (),
+            tableName (1)));
+        BEAST_EXPECT(! env.le (keylet::tableEntry (alice.id (),
+            tableName (1))));
+
+        // dropping it again fails in preclaim
+        env (drop, fee (ZXC (1)), ter (tefTABLE_NOTEXIST));
+    }
+
+public:
+    void run () override
+    {
+        testLayout (false);
+        testLayout (true);
+        testMigrate ();
+        testTransactor (false);
+        testTransactor (true);
+    }
+};
+
+// Compares both layouts for an owner of 10, 1k and 10k tables:
+// lookups by name and the size of the ledger entry rewritten
+// when a single table is modified.
+class TableDirectoryBench_test : public beast::unit_test::suite
+{
+    void bench (bool enabled, std::size_t count)
+    {
+        using namespace jtx;
+        using namespace std::chrono;
+
+        Env env (*this, enabled ? all_amendments () :
+            all_features_except (featureTableDirectory));
+        AccountID const owner = Account ("alice").id ();
+        Sandbox sb (&*env.current (), tapNONE);
+        createTableList (sb, owner);
+
+        auto start = steady_clock::now ();
+        for (std::size_t i = 0; i < count; ++i)
+            insertTableEntry (sb, owner, makeTable (i));
+        auto const insertTime = steady_clock::now () - start;
+
+        std::size_t const lookups = 1000;
+        start = steady_clock::now ();
+        for (std::size_t i = 0; i < lookups; ++i)
+            BEAST_EXPECT(readTableEntry (sb, owner,
+                tableName ((i * 7919) % count)));
+        auto const lookupTime = steady_clock::now () - start;
+
+        auto const table = peekTableEntry (sb, owner, tableName (count / 2));
+        if (! BEAST_EXPECT(table))
+            return;
+        table.entry->setFieldU32 (sfTxnLgrSeq, 2);
+        sb.update (table.sle);
+        Serializer s;
+        table.sle->add (s);
+
+        log <<
+            (enabled ? "    indexed " : "    array   ") <<
+            count << " tables: insert " <<
+            duration_cast<microseconds> (insertTime).count () / count <<
+            " us/table, lookup " <<
+            duration_cast<nanoseconds> (lookupTime).count () / lookups <<
+            " ns, rewrite " << s.size () << " bytes" << std::endl;
+    }
+
+public:
+    void run () override
+    {
+        for (std::size_t count : { 10, 1000, 10000 })
+        {
+            testcase ("tables " + std::to_string (count));
+            bench (false, count);
+            bench (true, count);
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TableDirectory,app,ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(TableDirectoryBench,app,ripple);
+
+} // test
+} // ripple
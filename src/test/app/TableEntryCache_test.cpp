@@ -0,0 +1,137 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <test/jtx.h>
+#include <peersafe/app/table/TableDirectory.h>
+#include <peersafe/app/table/TableEntryCache.h>
+#include <ripple/ledger/OpenView.h>
+#include <ripple/ledger/Sandbox.h>
+#include <ripple/protocol/Feature.h>
+
+namespace ripple {
+namespace test {
+
+class TableEntryCache_test : public beast::unit_test::suite
+{
+    static void
+    addTables (OpenView& view, AccountID const& owner)
+    {
+        Sandbox sb (&view, tapNONE);
+        auto const tablesle = std::make_shared<SLE> (keylet::table (owner));
+        tablesle->setFieldArray (sfTableEntries, STArray ());
+        sb.insert (tablesle);
+        for (std::size_t i = 0; i < 2; ++i)
+        {
+            auto const name = "table_" + std::to_string (i);
+            STObject table (sfEntry);
+            table.setFieldVL (sfTableName, Blob (name.begin (), name.end ()));
+            table.setFieldH160 (sfNameInDB, uint160 (i + 1));
+            table.setFieldU32 (sfCreateLgrSeq, 1);
+            insertTableEntry (sb, owner, table);
+        }
+        sb.apply (view);
+    }
+
+    // a transaction whose metadata says it modified `k`
+    static void
+    addModified (OpenView& view, STTx const& tx, Keylet const& k)
+    {
+        STObject node (sfModifiedNode);
+        node.setFieldU16 (sfLedgerEntryType, k.type);
+        node.setFieldH256 (sfLedgerIndex, k.key);
+        STArray nodes (sfAffectedNodes);
+        nodes.push_back (node);
+        STObject meta (sfMetadata);
+        meta.setFieldArray (sfAffectedNodes, nodes);
+
+        auto txn = std::make_shared<Serializer> ();
+        tx.add (*txn);
+        auto metaData = std::make_shared<Serializer> ();
+        meta.add (*metaData);
+        view.rawTxInsert (tx.getTransactionID (), txn, metaData);
+    }
+
+    void testCache (bool enabled)
+    {
+        testcase (enabled ? "indexed layout" : "array layout");
+
+        using namespace jtx;
+        Env env (*this, enabled ? all_amendments () :
+            all_features_except (featureTableDirectory));
+        Account const alice ("alice");
+        env.fund (ZXC (10000), alice);
+        env.close ();
+
+        OpenView v1 (&*env.current ());
+        addTables (v1, alice.id ());
+
+        TableEntryCache cache;
+        cache.onValidatedLedger (v1);
+        auto const entry = cache.fetch (v1, alice.id (), "table_0");
+        if (BEAST_EXPECT(entry))
+            BEAST_EXPECT(entry->getFieldH160 (sfNameInDB) == uint160 (1));
+        BEAST_EXPECT(cache.fetch (v1, alice.id (), "table_0") == entry);
+        BEAST_EXPECT(cache.fetch (v1, alice.id (), "table_1"));
+        BEAST_EXPECT(cache.hits () == 1);
+        BEAST_EXPECT(cache.misses () == 2);
+        BEAST_EXPECT(cache.size () == 2);
+
+        // a table which doesn't exist is not cached
+        BEAST_EXPECT(! cache.fetch (v1, alice.id (), "table_2"));
+        BEAST_EXPECT(cache.size () == 2);
+
+        // a view which isn't the validated ledger bypasses the cache
+        OpenView other (&*env.closed ());
+        BEAST_EXPECT(! cache.fetch (other, alice.id (), "table_0"));
+
+        // the next ledger modifies table_0
+        OpenView v2 (open_ledger, &v1, v1.rules ());
+        auto const name = std::string ("table_0");
+        addModified (v2, *env.jt (noop (alice)).stx, enabled ?
+            keylet::tableEntry (alice.id (), Blob (name.begin (), name.end ())) :
+            keylet::table (alice.id ()));
+        cache.onValidatedLedger (v2);
+        // with the array layout all tables of the owner are dropped
+        BEAST_EXPECT(cache.size () == (enabled ? 1 : 0));
+        BEAST_EXPECT(cache.invalidated () == (enabled ? 1 : 2));
+        BEAST_EXPECT(cache.fetch (v2, alice.id (), "table_0"));
+        BEAST_EXPECT(cache.fetch (v2, alice.id (), "table_1"));
+        BEAST_EXPECT(cache.hits () == (enabled ? 2 : 1));
+        BEAST_EXPECT(cache.size () == 2);
+
+        // ledgers were skipped
+        OpenView v3 (open_ledger, &v2, v2.rules ());
+        OpenView v4 (open_ledger, &v3, v3.rules ());
+        cache.onValidatedLedger (v4);
+        BEAST_EXPECT(cache.size () == 0);
+    }
+
+public:
+    void run () override
+    {
+        testCache (false);
+        testCache (true);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TableEntryCache,app,ripple);
+
+} // test
+} // ripple
@@ -0,0 +1,188 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <peersafe/app/sql/TxStore.h>
+#include <peersafe/rpc/TableUtils.h>
+#include <ripple/basics/StringUtilities.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/core/Config.h>
+#include <ripple/core/DatabaseCon.h>
+#include <ripple/protocol/JsonFields.h>
+#include <ripple/protocol/digest.h>
+
+namespace ripple {
+namespace test {
+
+class TableRecordPage_test : public beast::unit_test::suite
+{
+    static Json::Value
+    select (std::string const& raw)
+    {
+        Json::Value table (Json::objectValue);
+        table["Table"]["TableName"] = "page";
+        Json::Value tx_json (Json::objectValue);
+        tx_json["Tables"].append (table);
+        tx_json["Raw"] = raw;
+        return tx_json;
+    }
+
+    // the ids of the rows returned, the page of `offset` and `limit`
+    static std::vector<int>
+    query (TxStore& store, std::string const& raw, std::size_t offset,
+        std::size_t limit, bool& more)
+    {
+        TxStore::QueryPage page;
+        page.offset = offset;
+        page.limit = limit;
+        auto tx_json = select (raw);
+        auto const result = store.txHistory (tx_json, page);
+        more = page.more;
+
+        std::vector<int> ids;
+        for (auto const& line : result[jss::lines])
+            ids.push_back (line["id"].asInt ());
+        return ids;
+    }
+
+    void testPage ()
+    {
+        testcase ("page");
+
+        DatabaseCon::Setup setup;
+        setup.standAlone = true;
+        DatabaseCon db (setup, "page", nullptr, 0, "sqlite");
+        {
+            auto s = db.checkoutDb ();
+            *s << "CREATE TABLE t_page (id INTEGER);";
+            for (int id = 1; id <= 10; ++id)
+                *s << "INSERT INTO t_page (id) VALUES (" +
+                    std::to_string (id) + ");";
+        }
+
+        Config cfg;
+        cfg["sync_db"].set ("type", "sqlite");
+        TxStore store (&db, cfg, beast::Journal ());
+        // unpaged requests are not cut short unless configured
+        BEAST_EXPECT(store.getQueryRowsMax () == 0);
+
+        std::string const ordered = "[[],{\"$order\":[{\"id\":1}]}]";
+        bool more = false;
+        BEAST_EXPECT((query (store, ordered, 0, 4, more) ==
+            std::vector<int>{ 1, 2, 3, 4 }));
+        BEAST_EXPECT(more);
+        BEAST_EXPECT((query (store, ordered, 4, 4, more) ==
+            std::vector<int>{ 5, 6, 7, 8 }));
+        BEAST_EXPECT(more);
+
+        // the last page, short and exactly full
+        BEAST_EXPECT((query (store, ordered, 8, 4, more) ==
+            std::vector<int>{ 9, 10 }));
+        BEAST_EXPECT(! more);
+        BEAST_EXPECT((query (store, ordered, 6, 4, more) ==
+            std::vector<int>{ 7, 8, 9, 10 }));
+        BEAST_EXPECT(! more);
+
+        // past the last row
+        BEAST_EXPECT(query (store, ordered, 10, 4, more).empty ());
+        BEAST_EXPECT(! more);
+
+        // no page limit, every row after the offset
+        BEAST_EXPECT(query (store, ordered, 7, 0, more).size () == 3);
+        BEAST_EXPECT(! more);
+
+        // pages within the rows 3 to 7 a limit of the query selects
+        std::string const limited = "[[],{\"$order\":[{\"id\":1}],"
+            "\"$limit\":{\"index\":2,\"total\":5}}]";
+        BEAST_EXPECT((query (store, limited, 0, 2, more) ==
+            std::vector<int>{ 3, 4 }));
+        BEAST_EXPECT(more);
+        BEAST_EXPECT((query (store, limited, 2, 2, more) ==
+            std::vector<int>{ 5, 6 }));
+        BEAST_EXPECT(more);
+        BEAST_EXPECT((query (store, limited, 4, 2, more) ==
+            std::vector<int>{ 7 }));
+        BEAST_EXPECT(! more);
+        BEAST_EXPECT(query (store, limited, 5, 2, more).empty ());
+        BEAST_EXPECT(! more);
+        // a query limit smaller than the page
+        BEAST_EXPECT((query (store, limited, 0, 10, more) ==
+            std::vector<int>{ 3, 4, 5, 6, 7 }));
+        BEAST_EXPECT(! more);
+
+        // streamed in chunks, nothing in the result itself
+        {
+            TxStore::QueryPage page;
+            page.chunk = 3;
+            std::vector<std::size_t> chunks;
+            page.onChunk = [&chunks](Json::Value const& lines)
+            {
+                chunks.push_back (lines.size ());
+            };
+            auto tx_json = select (ordered);
+            auto const result = store.txHistory (tx_json, page);
+            BEAST_EXPECT((chunks == std::vector<std::size_t>{ 3, 3, 3, 1 }));
+            BEAST_EXPECT(! result.isMember (jss::lines));
+            BEAST_EXPECT(result[jss::count].asUInt () == 10);
+        }
+
+        Config capped;
+        capped["sync_db"].set ("type", "sqlite");
+        capped["sync_db"].set ("query_rows_max", "5");
+        BEAST_EXPECT(TxStore (&db, capped, beast::Journal ())
+            .getQueryRowsMax () == 5);
+    }
+
+    void testMarker ()
+    {
+        testcase ("marker");
+
+        uint256 const queryHash = sha512Half (makeSlice (std::string ("query")));
+        auto const marker = makeRecordMarker (20, queryHash, 42);
+        auto const parsed = parseRecordMarker (marker);
+        if (BEAST_EXPECT(parsed))
+        {
+            BEAST_EXPECT(std::get<0> (*parsed) == 20);
+            BEAST_EXPECT(std::get<1> (*parsed) == queryHash);
+            BEAST_EXPECT(std::get<2> (*parsed) == 42);
+        }
+
+        auto const text = marker.asString ();
+        BEAST_EXPECT(! parseRecordMarker (Json::Value (20)));
+        BEAST_EXPECT(! parseRecordMarker (Json::Value ("")));
+        BEAST_EXPECT(! parseRecordMarker (Json::Value ("zz" +
+            text.substr (2))));
+        // cut short, or with bytes left over
+        BEAST_EXPECT(! parseRecordMarker (Json::Value (
+            text.substr (0, text.size () - 2))));
+        BEAST_EXPECT(! parseRecordMarker (Json::Value (text + "00")));
+    }
+
+public:
+    void run () override
+    {
+        testPage ();
+        testMarker ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TableRecordPage,app,ripple);
+
+} // test
+} // ripple
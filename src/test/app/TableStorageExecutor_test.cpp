@@ -0,0 +1,253 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <peersafe/app/storage/TableStorageExecutor.h>
+#include <test/jtx.h>
+#include <ripple/beast/insight/NullCollector.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/protocol/JsonFields.h>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
+
+namespace ripple {
+namespace test {
+
+class TableStorageExecutor_test : public beast::unit_test::suite
+{
+    void testOrder ()
+    {
+        testcase ("order");
+
+        using namespace jtx;
+        Env env (*this);
+        TableStorageExecutor executor (env.app ().getJobQueue (),
+            beast::insight::NullCollector::New ());
+        uint160 const a (1);
+        uint160 const b (2);
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool release = false;
+        bool bDone = false;
+        std::vector<LedgerIndex> order;
+
+        // holds strand a until strand b has run
+        executor.post (a, 1, [&]()
+        {
+            std::unique_lock<std::mutex> lock (mutex);
+            cv.wait (lock, [&] { return release; });
+            order.push_back (1);
+            return true;
+        });
+        for (LedgerIndex seq : { 7, 5, 6 })
+        {
+            executor.post (a, seq, [&, seq]()
+            {
+                std::lock_guard<std::mutex> lock (mutex);
+                order.push_back (seq);
+                return true;
+            });
+        }
+        executor.post (b, 1, [&]()
+        {
+            std::lock_guard<std::mutex> lock (mutex);
+            bDone = true;
+            cv.notify_all ();
+            return true;
+        });
+
+        {
+            std::unique_lock<std::mutex> lock (mutex);
+            BEAST_EXPECT(cv.wait_for (lock, std::chrono::seconds (10),
+                [&] { return bDone; }));
+            BEAST_EXPECT(order.empty ());
+            release = true;
+            cv.notify_all ();
+        }
+
+        executor.wait (a);
+        BEAST_EXPECT(! executor.busy (a));
+        BEAST_EXPECT((order == std::vector<LedgerIndex>{ 1, 5, 6, 7 }));
+    }
+
+    void testWait ()
+    {
+        testcase ("wait");
+
+        using namespace jtx;
+        Env env (*this);
+        TableStorageExecutor executor (env.app ().getJobQueue (),
+            beast::insight::NullCollector::New ());
+        uint160 const a (1);
+
+        // nothing to wait for
+        executor.wait (a);
+        BEAST_EXPECT(executor.getInfo ()[jss::waited].asUInt () == 0);
+
+        std::atomic<int> written (0);
+        executor.post (a, 1, [&]()
+        {
+            std::this_thread::sleep_for (std::chrono::milliseconds (20));
+            ++written;
+            return true;
+        });
+        executor.post (a, 2, [&]()
+        {
+            ++written;
+            return false;
+        });
+        executor.post (a, 3, [&]() -> bool
+        {
+            ++written;
+            Throw<std::runtime_error> ("write");
+            return true;
+        });
+
+        executor.wait (a);
+        BEAST_EXPECT(written == 3);
+        BEAST_EXPECT(! executor.busy (a));
+        BEAST_EXPECT(executor.pending () == 0);
+
+        auto const info = executor.getInfo ();
+        BEAST_EXPECT(info[jss::pending].asUInt () == 0);
+        BEAST_EXPECT(info[jss::deferred].asUInt () == 3);
+        BEAST_EXPECT(info[jss::failed].asUInt () == 2);
+        BEAST_EXPECT(info[jss::waited].asUInt () == 1);
+        BEAST_EXPECT(info.isMember (jss::wait_ms));
+    }
+
+    void testHold ()
+    {
+        testcase ("hold");
+
+        using namespace jtx;
+        Env env (*this);
+        TableStorageExecutor executor (env.app ().getJobQueue (),
+            beast::insight::NullCollector::New ());
+        uint160 const a (1);
+
+        std::atomic<int> written (0);
+        executor.post (a, 1, [&]()
+        {
+            std::this_thread::sleep_for (std::chrono::milliseconds (20));
+            ++written;
+            return true;
+        });
+
+        {
+            TableStorageExecutor::Hold hold (executor, a);
+
+            // the write posted before is done, the one posted while held waits
+            BEAST_EXPECT(written == 1);
+            executor.post (a, 2, [&]()
+            {
+                ++written;
+                return true;
+            });
+            std::this_thread::sleep_for (std::chrono::milliseconds (50));
+            BEAST_EXPECT(written == 1);
+            BEAST_EXPECT(executor.busy (a));
+
+            TableStorageExecutor::Hold moved (std::move (hold));
+            BEAST_EXPECT(executor.busy (a));
+        }
+
+        executor.wait (a);
+        BEAST_EXPECT(written == 2);
+        BEAST_EXPECT(! executor.busy (a));
+
+        // holding an idle strand
+        {
+            TableStorageExecutor::Hold hold (executor, a);
+            BEAST_EXPECT(executor.busy (a));
+        }
+        BEAST_EXPECT(! executor.busy (a));
+        BEAST_EXPECT(executor.pending () == 0);
+    }
+
+    // An r_get holding a table while a write needing its outcome comes in,
+    // as TableStorage runs them: the writer waits with the map unlocked,
+    // so the reader can still take the map while it holds the strand.
+    void testHoldAndPut ()
+    {
+        testcase ("hold and put");
+
+        using namespace jtx;
+        Env env (*this);
+        TableStorageExecutor executor (env.app ().getJobQueue (),
+            beast::insight::NullCollector::New ());
+        uint160 const a (1);
+
+        std::mutex mutexMap;
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool held = false;
+        std::vector<std::string> order;
+
+        std::thread reader ([&]()
+        {
+            TableStorageExecutor::Hold hold (executor, a);
+            {
+                std::lock_guard<std::mutex> lock (mutex);
+                held = true;
+            }
+            cv.notify_all ();
+
+            // the writer has the map by now
+            std::this_thread::sleep_for (std::chrono::milliseconds (50));
+            std::lock_guard<std::mutex> lock (mutexMap);
+            std::lock_guard<std::mutex> lockOrder (mutex);
+            order.push_back ("read");
+        });
+
+        {
+            std::unique_lock<std::mutex> lock (mutex);
+            cv.wait (lock, [&] { return held; });
+        }
+
+        std::unique_lock<std::mutex> lock (mutexMap);
+        executor.wait (a, lock);
+        BEAST_EXPECT(lock.owns_lock ());
+        BEAST_EXPECT(! executor.busy (a));
+        {
+            std::lock_guard<std::mutex> lockOrder (mutex);
+            order.push_back ("put");
+        }
+        lock.unlock ();
+
+        reader.join ();
+        BEAST_EXPECT(order == std::vector<std::string> ({ "read", "put" }));
+    }
+
+public:
+    void run () override
+    {
+        testOrder ();
+        testWait ();
+        testHold ();
+        testHoldAndPut ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TableStorageExecutor,app,ripple);
+
+} // test
+} // ripple
@@ -0,0 +1,162 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <peersafe/app/storage/TableStorageExecutor.h>
+#include <peersafe/app/storage/TableStorageItem.h>
+#include <peersafe/app/table/TableDirectory.h>
+#include <peersafe/app/tx/ChainSqlTx.h>
+#include <peersafe/protocol/TableDefines.h>
+#include <test/jtx.h>
+#include <ripple/app/tx/impl/ApplyContext.h>
+#include <ripple/beast/insight/NullCollector.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/ledger/Sandbox.h>
+#include <ripple/protocol/JsonFields.h>
+
+namespace ripple {
+namespace test {
+
+class TableStorageItem_test : public beast::unit_test::suite
+{
+    // applies nothing, PutElem only reads the view through it
+    class StorageTx : public ChainSqlTx
+    {
+    public:
+        explicit StorageTx (ApplyContext& ctx)
+            : ChainSqlTx (ctx)
+        {
+        }
+    };
+
+    static Blob
+    blob (std::string const& s)
+    {
+        return Blob (s.begin (), s.end ());
+    }
+
+    static STTx
+    makeTx (AccountID const& owner, uint160 const& nameInDB,
+        TableOpType opType, std::string const& raw)
+    {
+        return STTx (opType == T_CREATE ? ttTABLELISTSET : ttSQLSTATEMENT,
+            [&](STObject& obj)
+            {
+                obj.setAccountID (sfAccount, owner);
+                obj.setAccountID (sfOwner, owner);
+                obj.setFieldU16 (sfOpType, opType);
+                STObject table (sfTable);
+                table.setFieldVL (sfTableName, blob ("user"));
+                table.setFieldH160 (sfNameInDB, nameInDB);
+                STArray tables;
+                tables.push_back (table);
+                obj.setFieldArray (sfTables, tables);
+                obj.setFieldVL (sfRaw, blob (raw));
+            });
+    }
+
+    static int
+    rows (TableStorageItem& item, uint160 const& nameInDB)
+    {
+        int count = -1;
+        auto db = item.getTxStore ().getDatabaseCon ()->checkoutDb ();
+        *db << "SELECT count(*) FROM t_" + to_string (nameInDB),
+            soci::into (count);
+        return count;
+    }
+
+    // A row change of a table without rules is deferred in first_storage
+    // mode, so a write failing in the database still leaves the tx
+    // successful and the table is rolled back at the next check.
+    void testDeferredFailure ()
+    {
+        testcase ("deferred failure");
+
+        using namespace jtx;
+        Env env (*this);
+        AccountID const owner = Account ("alice").id ();
+        uint160 const nameInDB (0x1234);
+
+        Config cfg;
+        cfg.setupControl (true, true, true);
+        cfg["sync_db"].set ("type", "sqlite");
+
+        TableStorageExecutor executor (env.app ().getJobQueue (),
+            beast::insight::NullCollector::New ());
+        TableStorageItem item (env.app (), cfg, env.journal, nullptr,
+            &executor);
+
+        // the table is created before the item opens its transaction
+        BEAST_EXPECT(item.getTxStore ().Dispose (makeTx (owner, nameInDB,
+            T_CREATE, "[{\"field\":\"id\",\"type\":\"int\",\"PK\":1},"
+            "{\"field\":\"name\",\"type\":\"varchar\",\"length\":20}]")).first);
+
+        OpenView view (*env.current ());
+        {
+            Sandbox sb (&view, tapNONE);
+            auto const tablesle = std::make_shared<SLE> (keylet::table (owner));
+            tablesle->setFieldArray (sfTableEntries, STArray ());
+            sb.insert (tablesle);
+            STObject entry (sfEntry);
+            entry.setFieldVL (sfTableName, blob ("user"));
+            entry.setFieldH160 (sfNameInDB, nameInDB);
+            entry.setFieldU32 (sfCreateLgrSeq, 1);
+            BEAST_EXPECT(insertTableEntry (sb, owner, entry) == tesSUCCESS);
+            sb.apply (view);
+        }
+
+        item.InitItem (owner, to_string (nameInDB), "user");
+        item.SetItemParam (1, uint256 (), 1, uint256 ());
+
+        auto put = [&](std::string const& raw)
+        {
+            auto const tx = makeTx (owner, nameInDB, R_INSERT, raw);
+            ApplyContext ctx (env.app (), view, tx, tesSUCCESS, 10,
+                tapNONE, env.journal);
+            StorageTx transactor (ctx);
+            return item.PutElem (transactor, tx, tx.getTransactionID ());
+        };
+
+        BEAST_EXPECT(put ("[{\"id\":1,\"name\":\"a\"}]") == tesSUCCESS);
+        executor.wait (item.GetStrand ());
+        BEAST_EXPECT(rows (item, nameInDB) == 1);
+
+        // a duplicate key, the tx is successful all the same
+        BEAST_EXPECT(put ("[{\"id\":1,\"name\":\"b\"}]") == tesSUCCESS);
+        executor.wait (item.GetStrand ());
+        BEAST_EXPECT(executor.getInfo ()[jss::failed].asUInt () == 1);
+        BEAST_EXPECT(item.isHaveTx (makeTx (owner, nameInDB, R_INSERT,
+            "[{\"id\":1,\"name\":\"b\"}]").getTransactionID ()));
+
+        // the check rolls the table back, the good write before included
+        BEAST_EXPECT(item.doJob (1));
+        BEAST_EXPECT(rows (item, nameInDB) == 0);
+    }
+
+public:
+    void run () override
+    {
+        testDeferredFailure ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TableStorageItem,app,ripple);
+
+} // test
+} // ripple
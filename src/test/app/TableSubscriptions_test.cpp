@@ -0,0 +1,283 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <test/jtx.h>
+#include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/app/misc/TableSubscriptions.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/protocol/JsonFields.h>
+#include <chrono>
+#include <limits>
+#include <mutex>
+
+namespace ripple {
+namespace test {
+
+class TestSub : public InfoSub
+{
+public:
+    explicit
+    TestSub (Source& source)
+        : InfoSub (source)
+    {
+    }
+
+    void
+    send (Json::Value const& jv, bool) override
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        messages_.push_back (jv);
+        texts_.push_back (nullptr);
+    }
+
+    void
+    sendShared (Json::Value const& jv,
+        std::shared_ptr<std::string const> const& text, bool) override
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        messages_.push_back (jv);
+        texts_.push_back (text);
+    }
+
+    std::vector<Json::Value>
+    messages ()
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        return messages_;
+    }
+
+    std::shared_ptr<std::string const>
+    text (std::size_t i)
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        return texts_[i];
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<Json::Value> messages_;
+    std::vector<std::shared_ptr<std::string const>> texts_;
+};
+
+class TableSubscriptions_test : public beast::unit_test::suite
+{
+    static STTx
+    makeTx (std::uint32_t seq)
+    {
+        return STTx (ttACCOUNT_SET,
+            [seq](auto& obj)
+            {
+                obj.setAccountID (sfAccount, jtx::Account ("alice").id ());
+                obj.setFieldU32 (sfSequence, seq);
+            });
+    }
+
+    void testTable ()
+    {
+        testcase ("table");
+
+        using namespace jtx;
+        Env env (*this);
+        auto& jobQueue = env.app ().getJobQueue ();
+        TableSubscriptions subs (jobQueue, env.journal, 4);
+        AccountID const owner = Account ("alice").id ();
+
+        auto a = std::make_shared<TestSub> (env.app ().getOPs ());
+        auto b = std::make_shared<TestSub> (env.app ().getOPs ());
+        auto c = std::make_shared<TestSub> (env.app ().getOPs ());
+        subs.subTable (a, owner, "t1");
+        subs.subTable (b, owner, "t1");
+        subs.subTable (c, owner, "t2");
+
+        for (std::uint32_t i = 0; i < 10; ++i)
+        {
+            auto const tx = makeTx (i);
+            PublishedTx ptx (tx);
+            subs.pubTableTx (owner, "t1", ptx,
+                { std::to_string (i), "" });
+        }
+        jobQueue.rendezvous ();
+
+        auto const messages = a->messages ();
+        BEAST_EXPECT(messages.size () == 10);
+        BEAST_EXPECT(b->messages ().size () == 10);
+        BEAST_EXPECT(c->messages ().empty ());
+        for (std::size_t i = 0; i < messages.size (); ++i)
+        {
+            BEAST_EXPECT(messages[i][jss::type] == "table");
+            BEAST_EXPECT(messages[i][jss::tablename] == "t1");
+            BEAST_EXPECT(messages[i][jss::status] == std::to_string (i));
+            BEAST_EXPECT(messages[i][jss::transaction][jss::Sequence] ==
+                Json::UInt (i));
+        }
+        // written once for every listener
+        BEAST_EXPECT(a->text (0) && a->text (0) == b->text (0));
+
+        // listeners that went away are dropped on the next publish
+        subs.unsubTable (a->getSeq (), owner, "t1");
+        b.reset ();
+        {
+            auto const tx = makeTx (10);
+            PublishedTx ptx (tx);
+            subs.pubTableTx (owner, "t1", ptx, { "db_success", "" });
+        }
+        jobQueue.rendezvous ();
+        BEAST_EXPECT(a->messages ().size () == 10);
+        BEAST_EXPECT(subs.getInfo ()[jss::tables] == 1);
+    }
+
+    void testTx ()
+    {
+        testcase ("tx");
+
+        using namespace jtx;
+        Env env (*this);
+        auto& jobQueue = env.app ().getJobQueue ();
+        TableSubscriptions subs (jobQueue, env.journal, 4);
+
+        auto a = std::make_shared<TestSub> (env.app ().getOPs ());
+        auto const tx1 = makeTx (1);
+        auto const tx2 = makeTx (2);
+        subs.subTx (a, tx1.getTransactionID (), 5, 3);
+        subs.subTx (a, tx2.getTransactionID (), 5, 3);
+        BEAST_EXPECT(! subs.expiresBy (5));
+        BEAST_EXPECT(subs.expiresBy (6));
+        BEAST_EXPECT(subs.waitsValidation (tx1.getTransactionID ()));
+
+        {
+            PublishedTx ptx (tx1);
+            subs.pubTxResult (ptx, { "validate_success", "" }, true, 3);
+        }
+        BEAST_EXPECT(! subs.waitsValidation (tx1.getTransactionID ()));
+
+        // not expired until a later ledger is validated
+        auto const now = std::chrono::steady_clock::now ();
+        subs.expireTxs (5, now);
+        jobQueue.rendezvous ();
+        BEAST_EXPECT(a->messages ().size () == 1);
+        subs.expireTxs (6, now);
+        jobQueue.rendezvous ();
+
+        auto const messages = a->messages ();
+        if (BEAST_EXPECT(messages.size () == 2))
+        {
+            BEAST_EXPECT(messages[0][jss::status] == "validate_success");
+            BEAST_EXPECT(messages[0][jss::transaction][jss::hash] ==
+                to_string (tx1.getTransactionID ()));
+            BEAST_EXPECT(messages[1][jss::status] == "validate_timeout");
+            BEAST_EXPECT(messages[1][jss::transaction][jss::hash] ==
+                to_string (tx2.getTransactionID ()));
+        }
+        BEAST_EXPECT(! subs.expiresBy (100));
+        BEAST_EXPECT(subs.getInfo ()[jss::expired] == 1);
+        BEAST_EXPECT(subs.getInfo ()[jss::txs] == 0);
+    }
+
+    void testExpiry ()
+    {
+        testcase ("expiry");
+
+        using namespace jtx;
+        Env env (*this);
+        auto& jobQueue = env.app ().getJobQueue ();
+        TableSubscriptions subs (jobQueue, env.journal, 4);
+
+        auto a = std::make_shared<TestSub> (env.app ().getOPs ());
+        std::vector<STTx> txs;
+        for (std::uint32_t i = 0; i < 100; ++i)
+        {
+            txs.push_back (makeTx (i));
+            subs.subTx (a, txs.back ().getTransactionID (), 10 + i % 10, 1);
+        }
+        // subscribed again with a later ledger, only that one is kept
+        subs.subTx (a, txs[0].getTransactionID (), 30, 1);
+        subs.unsubTx (txs[1].getTransactionID ());
+
+        auto const now = std::chrono::steady_clock::now ();
+        subs.expireTxs (11, now);
+        jobQueue.rendezvous ();
+        // tx 0 of ledger 10 was subscribed again, the other 9 expire
+        BEAST_EXPECT(a->messages ().size () == 9);
+
+        subs.expireTxs (20, now);
+        jobQueue.rendezvous ();
+        BEAST_EXPECT(a->messages ().size () == 98);
+        BEAST_EXPECT(subs.getInfo ()[jss::txs] == 1);
+        BEAST_EXPECT(subs.expiresBy (31));
+        BEAST_EXPECT(! subs.expiresBy (30));
+    }
+
+    void testUnindex ()
+    {
+        testcase ("unindex");
+
+        using namespace jtx;
+        Env env (*this);
+        auto& jobQueue = env.app ().getJobQueue ();
+        TableSubscriptions subs (jobQueue, env.journal, 4);
+        auto const max = std::numeric_limits<LedgerIndex>::max ();
+
+        auto a = std::make_shared<TestSub> (env.app ().getOPs ());
+        auto const tx = makeTx (1);
+        auto const txId = tx.getTransactionID ();
+
+        // a far ledger is capped
+        subs.subTx (a, txId, max, 10);
+        BEAST_EXPECT(subs.expiresBy (11 + TableSubscriptions::maxTxWait));
+        BEAST_EXPECT(! subs.expiresBy (10 + TableSubscriptions::maxTxWait));
+
+        // neither unsubscribing nor subscribing again leaves ids behind
+        for (int i = 0; i < 100; ++i)
+        {
+            subs.subTx (a, txId, 20 + i, 10);
+            subs.subTx (a, txId, 20 + i, 10);
+            subs.unsubTx (txId);
+        }
+        BEAST_EXPECT(! subs.expiresBy (max));
+        BEAST_EXPECT(subs.getInfo ()[jss::txs] == 0);
+
+        // nor publishing the result
+        subs.subTx (a, txId, 20, 10);
+        {
+            PublishedTx ptx (tx);
+            subs.pubTxResult (ptx, { "validate_success", "" }, true, 12);
+        }
+        BEAST_EXPECT(! subs.expiresBy (max));
+
+        subs.expireTxs (max, std::chrono::steady_clock::now ());
+        jobQueue.rendezvous ();
+        BEAST_EXPECT(a->messages ().size () == 1);
+        BEAST_EXPECT(subs.getInfo ()[jss::expired] == 0);
+    }
+
+public:
+    void run () override
+    {
+        testTable ();
+        testTx ();
+        testExpiry ();
+        testUnindex ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TableSubscriptions,app,ripple);
+
+} // test
+} // ripple
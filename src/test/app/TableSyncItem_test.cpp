@@ -0,0 +1,118 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <peersafe/app/table/TableSyncItem.h>
+#include <ripple/protocol/JsonFields.h>
+#include <test/jtx.h>
+
+namespace ripple {
+namespace test {
+
+class TableSyncItem_test : public beast::unit_test::suite
+{
+    static TableSyncItem::sqldata_type
+    ledgerData (LedgerIndex seq)
+    {
+        protocol::TMTableData data;
+        data.set_ledgerseq (seq);
+        data.set_lastledgerseq (seq - 1);
+        data.set_ledgerhash (to_string (uint256 (seq)));
+        data.set_lastledgerhash (to_string (uint256 (seq - 1)));
+        data.set_seekstop (false);
+        return std::make_pair (seq, data);
+    }
+
+    void testOrder ()
+    {
+        testcase ("out of order ledgers");
+
+        using namespace jtx;
+        Env env (*this);
+        TableSyncItem item (env.app (), env.journal, env.app ().config ());
+        item.SetPara ("abc", 10, uint256 (10), 10, uint256 (10), uint256 ());
+
+        for (LedgerIndex seq : { 14, 12, 13, 12, 11 })
+        {
+            auto data = ledgerData (seq);
+            item.PushDataToBlockDataQueue (data);
+        }
+        auto info = item.GetSyncInfo (20);
+        BEAST_EXPECT(info[jss::fetch_queue].asUInt () == 4);
+        BEAST_EXPECT(info[jss::decode_queue].asUInt () == 0);
+
+        // a range starting after the ledgers already in the queue
+        TableSyncItem::BaseInfo range;
+        BEAST_EXPECT(item.GetRightRequestRange (range));
+        BEAST_EXPECT(range.u32SeqLedger == 14);
+
+        // consecutive ledgers move on to be decoded, in order
+        item.TransBlock2Whole (10, uint256 (10));
+        info = item.GetSyncInfo (20);
+        BEAST_EXPECT(info[jss::fetch_queue].asUInt () == 0);
+        BEAST_EXPECT(info[jss::decode_queue].asUInt () == 4);
+        BEAST_EXPECT(info[jss::pending].asUInt () == 4);
+
+        LedgerIndex seq;
+        uint256 hash;
+        item.GetSyncLedger (seq, hash);
+        BEAST_EXPECT(seq == 14);
+        BEAST_EXPECT(hash == uint256 (14));
+        BEAST_EXPECT(! item.IsBacklogFull ());
+    }
+
+    void testGap ()
+    {
+        testcase ("gap");
+
+        using namespace jtx;
+        Env env (*this);
+        TableSyncItem item (env.app (), env.journal, env.app ().config ());
+        item.SetPara ("abc", 10, uint256 (10), 10, uint256 (10), uint256 ());
+
+        for (LedgerIndex seq : { 11, 13 })
+        {
+            auto data = ledgerData (seq);
+            item.PushDataToBlockDataQueue (data);
+        }
+
+        // ledger 12 is requested again
+        TableSyncItem::BaseInfo range;
+        BEAST_EXPECT(item.GetRightRequestRange (range));
+        BEAST_EXPECT(range.u32SeqLedger == 11);
+        BEAST_EXPECT(range.uStopSeq == 12);
+
+        item.TransBlock2Whole (10, uint256 (10));
+        auto info = item.GetSyncInfo (20);
+        BEAST_EXPECT(info[jss::fetch_queue].asUInt () == 1);
+        BEAST_EXPECT(info[jss::decode_queue].asUInt () == 1);
+    }
+
+public:
+    void run () override
+    {
+        testOrder ();
+        testGap ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TableSyncItem,app,ripple);
+
+} // test
+} // ripple
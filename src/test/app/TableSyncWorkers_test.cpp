@@ -0,0 +1,144 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <peersafe/app/table/TableSyncWorkers.h>
+#include <test/jtx.h>
+#include <ripple/core/JobQueue.h>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
+
+namespace ripple {
+namespace test {
+
+class TableSyncWorkers_test : public beast::unit_test::suite
+{
+    void testLimit (std::size_t limit)
+    {
+        testcase ("limit " + std::to_string (limit));
+
+        using namespace jtx;
+        Env env (*this);
+
+        TableSyncWorkers workers (env.app ().getJobQueue (), limit, 1);
+        BEAST_EXPECT(workers.workers () == limit);
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::size_t running = 0;
+        std::size_t maxRunning = 0;
+        std::vector<std::size_t> order;
+
+        std::size_t const count = 20;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            workers.post (jtOPERATESQL, "test", [&, i]()
+            {
+                {
+                    std::lock_guard<std::mutex> lock (mutex);
+                    ++running;
+                    maxRunning = std::max (maxRunning, running);
+                    order.push_back (i);
+                }
+                std::this_thread::sleep_for (std::chrono::milliseconds (2));
+                std::lock_guard<std::mutex> lock (mutex);
+                --running;
+                cv.notify_all ();
+            });
+        }
+
+        {
+            std::unique_lock<std::mutex> lock (mutex);
+            BEAST_EXPECT(cv.wait_for (lock, std::chrono::seconds (10),
+                [&] { return order.size () == count && running == 0; }));
+            BEAST_EXPECT(maxRunning <= limit);
+            // with a single worker queued work runs in the order posted
+            if (limit == 1)
+                BEAST_EXPECT(std::is_sorted (order.begin (), order.end ()));
+        }
+
+        while (workers.active () != 0)
+            std::this_thread::sleep_for (std::chrono::milliseconds (1));
+        BEAST_EXPECT(workers.queued () == 0);
+    }
+
+    void testReaders ()
+    {
+        testcase ("readers");
+
+        using namespace jtx;
+        Env env (*this);
+
+        TableSyncWorkers workers (env.app ().getJobQueue (), 1, 1);
+        BEAST_EXPECT(workers.readers () == 1);
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool release = false;
+        std::vector<std::string> order;
+        auto run = [&](std::string const& name, bool wait)
+        {
+            return [&, name, wait]()
+            {
+                std::unique_lock<std::mutex> lock (mutex);
+                if (wait)
+                    cv.wait (lock, [&] { return release; });
+                order.push_back (name);
+                cv.notify_all ();
+            };
+        };
+
+        // a read holding its slot delays the next read, not the applies
+        workers.post (jtTABLELOCALREAD, "test", run ("read1", true));
+        workers.post (jtTABLELOCALREAD, "test", run ("read2", false));
+        workers.post (jtOPERATESQL, "test", run ("apply1", false));
+        workers.post (jtOPERATESQL, "test", run ("apply2", false));
+
+        {
+            std::unique_lock<std::mutex> lock (mutex);
+            BEAST_EXPECT(cv.wait_for (lock, std::chrono::seconds (10),
+                [&] { return order.size () == 2; }));
+            BEAST_EXPECT((order == std::vector<std::string>{
+                "apply1", "apply2" }));
+            release = true;
+            cv.notify_all ();
+            BEAST_EXPECT(cv.wait_for (lock, std::chrono::seconds (10),
+                [&] { return order.size () == 4; }));
+            BEAST_EXPECT(order[2] == "read1" && order[3] == "read2");
+        }
+
+        while (workers.active () != 0)
+            std::this_thread::sleep_for (std::chrono::milliseconds (1));
+        BEAST_EXPECT(workers.queued () == 0);
+    }
+
+public:
+    void run () override
+    {
+        testLimit (1);
+        testLimit (3);
+        testReaders ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TableSyncWorkers,app,ripple);
+
+} // test
+} // ripple
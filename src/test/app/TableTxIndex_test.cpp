@@ -0,0 +1,114 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <test/jtx.h>
+#include <peersafe/app/util/TableSyncUtil.h>
+#include <ripple/core/DatabaseCon.h>
+#include <ripple/core/SociDB.h>
+
+namespace ripple {
+namespace test {
+
+class TableTxIndex_test : public beast::unit_test::suite
+{
+    void testTxTableNames ()
+    {
+        testcase ("tx table names");
+
+        STTx const statement (ttSQLSTATEMENT,
+            [](auto& obj)
+            {
+                STObject table (sfTable);
+                table.setFieldH160 (sfNameInDB, uint160 (1));
+                STArray tables;
+                tables.push_back (table);
+                obj.setFieldArray (sfTables, tables);
+            });
+        auto names = TableSyncUtil::GetTxTableNames (statement);
+        BEAST_EXPECT(names.size () == 1 &&
+            names[0] == to_string (uint160 (1)));
+
+        // names are normalized, whatever the case of the hex in the json
+        std::string const statements =
+            R"([{"Tables":[{"Table":{"NameInDB":"00000000000000000000000000000000000000AA"}}]},)"
+            R"({"Tables":[{"Table":{"NameInDB":"00000000000000000000000000000000000000bb"}}]},)"
+            R"({"Tables":[{"Table":{"NameInDB":"00000000000000000000000000000000000000aa"}}]},)"
+            R"({"Tables":[{"Table":{"NameInDB":"not hex"}}]}])";
+        STTx const transaction (ttSQLTRANSACTION,
+            [&statements](auto& obj)
+            {
+                obj.setFieldVL (sfStatements,
+                    Slice (statements.data (), statements.size ()));
+            });
+        names = TableSyncUtil::GetTxTableNames (transaction);
+        BEAST_EXPECT(names == std::vector<std::string> ({
+            to_string (uint160 (0xAA)), to_string (uint160 (0xBB)) }));
+
+        STTx const other (ttACCOUNT_SET, [](auto&) {});
+        BEAST_EXPECT(TableSyncUtil::GetTxTableNames (other).empty ());
+    }
+
+    void testNextLedger ()
+    {
+        testcase ("next ledger");
+
+        using namespace jtx;
+        Env env (*this);
+        auto& app = env.app ();
+
+        {
+            auto db = app.getTxnDB ().checkoutDb ();
+            *db << "DELETE FROM TableTxIndexState;";
+            *db << "DELETE FROM TableTransactions WHERE NameInDB = 'AA';";
+        }
+        // no ledger saved with the index yet
+        BEAST_EXPECT(! TableSyncUtil::NextTableTxLedger (app, "AA", 1000, 1020));
+
+        {
+            auto db = app.getTxnDB ().checkoutDb ();
+            *db << "DELETE FROM TableTxIndexState;";
+            *db << "INSERT INTO TableTxIndexState (StartSeq) VALUES (1000);";
+            *db << "INSERT INTO TableTransactions "
+                "(NameInDB, LedgerSeq, TxnSeq, TransID) VALUES "
+                "('AA', 1005, 0, 'T1'), ('AA', 1010, 1, 'T2');";
+        }
+        // before the index
+        BEAST_EXPECT(! TableSyncUtil::NextTableTxLedger (app, "AA", 999, 1020));
+        BEAST_EXPECT(! TableSyncUtil::NextTableTxLedger (app, "AA", 1006, 1005));
+
+        auto next = TableSyncUtil::NextTableTxLedger (app, "AA", 1005, 1020);
+        BEAST_EXPECT(next && *next == 1005);
+
+        // ledgers 1001 to 1004 are not stored, their txs may be missing
+        BEAST_EXPECT(! TableSyncUtil::NextTableTxLedger (app, "AA", 1001, 1020));
+    }
+
+public:
+    void run () override
+    {
+        testTxTableNames ();
+        testNextLedger ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TableTxIndex,app,ripple);
+
+} // test
+} // ripple
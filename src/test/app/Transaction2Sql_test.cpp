@@ -310,6 +310,45 @@ public:
 		}
 	}
 
+	void test_batch_insert() {
+		// create table
+		{
+			std::string raw = "[{\"field\":\"id\",\"type\":\"int\"},\
+{\"field\":\"name\",\"type\":\"varchar\",\"length\":20},\
+{\"field\":\"age\",\"type\":\"int\"}]";
+			int ret = createTable(raw, "");
+			BEAST_EXPECT(ret == 0);
+		}
+
+		// more rows than one multi-row insert can hold,and rows with different fields
+		{
+			std::string raw = "[";
+			for (int i = 1; i <= 1000; i++) {
+				if (i != 1)
+					raw += ",";
+				if (i % 300 == 0)
+					raw += (boost::format("{\"id\":%1%,\"name\":\"name%1%\"}") % i).str();
+				else
+					raw += (boost::format("{\"id\":%1%,\"name\":\"name%1%\",\"age\":%1%}") % i).str();
+			}
+			raw += "]";
+			int ret = insert_Records(raw);
+			BEAST_EXPECT(ret == 0);
+
+			Json::Value result = getRecords("[[\"id\"]]");
+			BEAST_EXPECT(result[jss::lines].size() == 1000);
+
+			result = getRecords("[[\"id\",\"age\"],{\"id\":600}]");
+			BEAST_EXPECT(result[jss::lines].size() == 1);
+			BEAST_EXPECT(result[jss::lines][0u]["age"].asInt() == 0);
+		}
+
+		// drop table
+		{
+			test_DropTableTransaction();
+		}
+	}
+
 	void test_crashfix_on_select() {
 		{
 			std::string query = "[[],{\"$and\":[{\"$order\":[{\"id\" : -1}]},{\"id\":{\"$ge\" : 3}}]}]";
@@ -2424,6 +2463,7 @@ public:
 
 		test_fixbug_RR207();
 		test_fixbug_RR377();
+		test_batch_insert();
 		test_crashfix_on_select();
 
 		//test_CreateTableForeginTransaction();
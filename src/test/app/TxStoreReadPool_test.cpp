@@ -0,0 +1,124 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <peersafe/app/sql/TxStoreReadPool.h>
+#include <peersafe/app/table/TableStatusDBSQLite.h>
+#include <test/jtx.h>
+#include <ripple/beast/utility/temp_dir.h>
+#include <ripple/protocol/JsonFields.h>
+
+namespace ripple {
+namespace test {
+
+class TxStoreReadPool_test : public beast::unit_test::suite
+{
+    void testPool ()
+    {
+        testcase ("pool");
+
+        using namespace jtx;
+        Env env (*this);
+        beast::temp_dir td;
+        std::string const owner = to_string (Account ("alice").id ());
+        uint160 const a (1);
+        uint160 const b (2);
+
+        Config cfg;
+        cfg.legacy ("database_path", td.path ());
+        cfg["sync_db"].set ("type", "sqlite");
+        cfg["sync_db"].set ("db", "pool");
+
+        // the tables as the primary connection has synced them
+        TxStoreDBConn primary (cfg);
+        beast::Journal journal = env.journal;
+        TableStatusDBSQLite status (primary.GetDBConn (), &env.app (),
+            journal);
+        BEAST_EXPECT(status.InitDB (setup_SyncDatabaseCon (cfg)));
+        auto sync = [&](uint160 const& nameInDB, LedgerIndex seq)
+        {
+            BEAST_EXPECT(status.InsertSnycDB ("t" + to_string (nameInDB),
+                to_string (nameInDB), owner, seq, uint256 (), true, "",
+                uint256 ()));
+        };
+        sync (a, 100);
+        sync (b, 90);
+        BEAST_EXPECT(TxStoreReadPool::watermark (status, { a, b }) == 90);
+
+        {
+            // no [sync_db_read], reads stay on the primary
+            TxStoreReadPool pool (env.app (), cfg, env.journal);
+            BEAST_EXPECT(! pool.enabled ());
+            BEAST_EXPECT(! pool.checkout ({ a }, 100));
+            auto const info = pool.getInfo ();
+            BEAST_EXPECT(info[jss::connections].asUInt () == 0);
+            BEAST_EXPECT(info[jss::reads].asUInt () == 0);
+            BEAST_EXPECT(info[jss::fallbacks].asUInt () == 0);
+        }
+
+        cfg["sync_db_read"].set ("connections", "2");
+        cfg["sync_db_read"].set ("max_lag", "5");
+        TxStoreReadPool pool (env.app (), cfg, env.journal);
+        BEAST_EXPECT(pool.enabled ());
+        BEAST_EXPECT(pool.getInfo ()[jss::connections].asUInt () == 2);
+
+        // checked out in turn, each connection goes back to the pool
+        auto const first = pool.checkout ({ a }, 100);
+        auto const second = pool.checkout ({ a }, 100);
+        auto const third = pool.checkout ({ a }, 100);
+        if (BEAST_EXPECT(first && second && third))
+        {
+            BEAST_EXPECT(first.txStore != second.txStore);
+            BEAST_EXPECT(first.txStore == third.txStore);
+            BEAST_EXPECT(first.txStore->getDatabaseCon () !=
+                primary.GetDBConn ());
+            BEAST_EXPECT(first.watermark == 100);
+        }
+
+        // a replica lagging more than max_lag is passed over
+        BEAST_EXPECT(! pool.checkout ({ a, b }, 96));
+        auto const lagging = pool.checkout ({ a, b }, 95);
+        if (BEAST_EXPECT(lagging))
+            BEAST_EXPECT(lagging.watermark == 90);
+        // and so is a table it doesn't know
+        BEAST_EXPECT(! pool.checkout ({ uint160 (3) }, 100));
+
+        // the replica reads what the primary writes
+        sync (b, 100);
+        auto const caught = pool.checkout ({ a, b }, 100);
+        if (BEAST_EXPECT(caught))
+            BEAST_EXPECT(caught.watermark == 100);
+
+        auto const info = pool.getInfo ();
+        BEAST_EXPECT(info[jss::reads].asUInt () == 5);
+        BEAST_EXPECT(info[jss::fallbacks].asUInt () == 2);
+        BEAST_EXPECT(info[jss::max_lag].asUInt () == 5);
+    }
+
+public:
+    void run () override
+    {
+        testPool ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TxStoreReadPool,app,ripple);
+
+} // test
+} // ripple
@@ -0,0 +1,274 @@
+//-----------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2015 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/LedgerSaveQueue.h>
+#include <ripple/beast/insight/NullCollector.h>
+#include <ripple/consensus/LedgerTiming.h>
+#include <ripple/core/DatabaseCon.h>
+#include <ripple/core/SociDB.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/JsonFields.h>
+#include <test/jtx.h>
+#include <chrono>
+
+namespace ripple {
+namespace test {
+
+// A ledger following the last closed one holding `count` AccountSet
+// transactions, each from its own account, and one SQLStatement on
+// table `nameInDB`.
+static std::shared_ptr<Ledger const>
+makeSaveLedger (jtx::Env& env, std::size_t count, uint160 const& nameInDB)
+{
+    auto const parent = env.app ().getLedgerMaster ().getClosedLedger ();
+    auto const closeTime = env.app ().timeKeeper ().closeTime ();
+    auto ledger = std::make_shared<Ledger> (*parent, closeTime);
+
+    auto insert = [&ledger](STTx const& tx, AccountID const& id,
+        std::uint32_t index)
+    {
+        STObject finalFields (sfFinalFields);
+        finalFields.setAccountID (sfAccount, id);
+        STObject node (sfModifiedNode);
+        node.setFieldU16 (sfLedgerEntryType, ltACCOUNT_ROOT);
+        node.setFieldH256 (sfLedgerIndex, keylet::account (id).key);
+        node.setFieldObject (sfFinalFields, finalFields);
+        STArray nodes (sfAffectedNodes);
+        nodes.push_back (node);
+        STObject meta (sfMetadata);
+        meta.setFieldU8 (sfTransactionResult, tesSUCCESS);
+        meta.setFieldU32 (sfTransactionIndex, index);
+        meta.setFieldArray (sfAffectedNodes, nodes);
+
+        auto txn = std::make_shared<Serializer> ();
+        tx.add (*txn);
+        auto metaData = std::make_shared<Serializer> ();
+        meta.add (*metaData);
+        ledger->rawTxInsert (tx.getTransactionID (), txn, metaData);
+    };
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        AccountID const id (i + 1);
+        STTx const tx (ttACCOUNT_SET,
+            [&id](auto& obj)
+            {
+                obj.setAccountID (sfAccount, id);
+                obj.setFieldU32 (sfSequence, 1);
+            });
+        insert (tx, id, i);
+    }
+
+    AccountID const owner (count + 1);
+    STTx const statement (ttSQLSTATEMENT,
+        [&owner, &nameInDB](auto& obj)
+        {
+            obj.setAccountID (sfAccount, owner);
+            obj.setAccountID (sfOwner, owner);
+            obj.setFieldU32 (sfSequence, 1);
+            STObject table (sfTable);
+            table.setFieldH160 (sfNameInDB, nameInDB);
+            STArray tables;
+            tables.push_back (table);
+            obj.setFieldArray (sfTables, tables);
+        });
+    insert (statement, owner, count);
+
+    ledger->updateSkipList ();
+    ledger->setAccepted (closeTime, ledgerDefaultTimeResolution, true,
+        env.app ().config ());
+    return ledger;
+}
+
+class SaveLedger_test : public beast::unit_test::suite
+{
+    void testSave ()
+    {
+        testcase ("save");
+
+        using namespace jtx;
+        Env env (*this);
+        std::size_t const count = 50;
+        uint160 const nameInDB (7);
+        auto const ledger = makeSaveLedger (env, count, nameInDB);
+        auto const seq = ledger->info ().seq;
+
+        BEAST_EXPECT(pendSaveValidated (env.app (), ledger, true, false));
+
+        auto db = env.app ().getTxnDB ().checkoutDb ();
+        int rows = 0;
+        *db << "SELECT COUNT(*) FROM Transactions WHERE LedgerSeq = :seq;",
+            soci::use (seq), soci::into (rows);
+        BEAST_EXPECT(rows == count + 1);
+        *db << "SELECT COUNT(*) FROM AccountTransactions "
+            "WHERE LedgerSeq = :seq;",
+            soci::use (seq), soci::into (rows);
+        BEAST_EXPECT(rows == count + 1);
+        std::string const name = to_string (nameInDB);
+        *db << "SELECT COUNT(*) FROM TableTransactions "
+            "WHERE LedgerSeq = :seq AND NameInDB = :name;",
+            soci::use (seq), soci::use (name),
+            soci::into (rows);
+        BEAST_EXPECT(rows == 1);
+
+        // the bound blob round trips to the same transaction
+        AccountID const id (3);
+        std::string account = toBase58 (id);
+        std::string transID;
+        *db << "SELECT TransID FROM AccountTransactions "
+            "WHERE Account = :account;",
+            soci::use (account), soci::into (transID);
+        soci::blob raw (*db);
+        std::string status;
+        *db << "SELECT RawTxn, Status FROM Transactions "
+            "WHERE TransID = :id;",
+            soci::use (transID), soci::into (raw), soci::into (status);
+        Blob rawTxn;
+        convert (raw, rawTxn);
+        SerialIter sit (makeSlice (rawTxn));
+        STTx const tx (sit);
+        BEAST_EXPECT(to_string (tx.getTransactionID ()) == transID);
+        BEAST_EXPECT(tx.getAccountID (sfAccount) == id);
+        BEAST_EXPECT(status == std::string (1, TXN_SQL_VALIDATED));
+    }
+
+    void testQueue ()
+    {
+        testcase ("queue");
+
+        using namespace jtx;
+        Env env (*this);
+        std::vector<std::shared_ptr<Ledger const>> ledgers;
+        auto prev = env.app ().getLedgerMaster ().getClosedLedger ();
+        for (std::size_t i = 0; i < LedgerSaveQueue::batchSize + 3; ++i)
+        {
+            auto next = std::make_shared<Ledger> (*prev,
+                env.app ().timeKeeper ().closeTime ());
+            ledgers.push_back (next);
+            prev = next;
+        }
+        auto seqOf = [](LedgerSaveQueue::Item const& item)
+        {
+            return item.ledger->info ().seq;
+        };
+
+        LedgerSaveQueue queue (beast::insight::NullCollector::New ());
+        BEAST_EXPECT(queue.add (ledgers[0], false));
+        BEAST_EXPECT(! queue.add (ledgers[1], false));
+        BEAST_EXPECT(! queue.add (ledgers[2], false));
+        BEAST_EXPECT(! queue.add (ledgers[4], false));
+        BEAST_EXPECT(queue.pending () == 4);
+
+        // consecutive ledgers only, in order
+        auto batch = queue.take (false);
+        if (BEAST_EXPECT(batch.size () == 3))
+        {
+            for (std::size_t i = 0; i < 3; ++i)
+                BEAST_EXPECT(seqOf (batch[i]) == ledgers[i]->info ().seq);
+            BEAST_EXPECT(! batch[0].current);
+        }
+        batch = queue.take (false);
+        BEAST_EXPECT(batch.size () == 1 &&
+            seqOf (batch[0]) == ledgers[4]->info ().seq);
+
+        // drained, the next ledger starts a job again
+        BEAST_EXPECT(queue.take (false).empty ());
+        BEAST_EXPECT(queue.add (ledgers[3], false));
+        BEAST_EXPECT(queue.take (false).size () == 1);
+        BEAST_EXPECT(queue.take (false).empty ());
+
+        // a batch is at most batchSize ledgers
+        for (auto const& ledger : ledgers)
+            queue.add (ledger, false);
+        BEAST_EXPECT(queue.take (false).size () == LedgerSaveQueue::batchSize);
+        BEAST_EXPECT(queue.take (false).size () == 3);
+        BEAST_EXPECT(queue.take (false).empty ());
+
+        // current ledgers have their own job and never wait for old ones
+        BEAST_EXPECT(queue.add (ledgers[0], false));
+        BEAST_EXPECT(! queue.add (ledgers[1], false));
+        BEAST_EXPECT(queue.add (ledgers[5], true));
+        // queued again as current, it moves to the current queue
+        BEAST_EXPECT(! queue.add (ledgers[1], true));
+        BEAST_EXPECT(! queue.add (ledgers[1], false));
+        batch = queue.take (true);
+        if (BEAST_EXPECT(batch.size () == 1))
+        {
+            BEAST_EXPECT(seqOf (batch[0]) == ledgers[1]->info ().seq);
+            BEAST_EXPECT(batch[0].current);
+        }
+        batch = queue.take (true);
+        BEAST_EXPECT(batch.size () == 1 &&
+            seqOf (batch[0]) == ledgers[5]->info ().seq);
+        BEAST_EXPECT(queue.take (true).empty ());
+        batch = queue.take (false);
+        BEAST_EXPECT(batch.size () == 1 &&
+            seqOf (batch[0]) == ledgers[0]->info ().seq);
+        BEAST_EXPECT(queue.take (false).empty ());
+        BEAST_EXPECT(queue.pending () == 0);
+
+        queue.onBatch (3, std::chrono::milliseconds (6),
+            std::chrono::milliseconds (9), std::chrono::milliseconds (3));
+        auto const info = queue.getInfo ();
+        BEAST_EXPECT(info[jss::batches].asUInt () == 1);
+        BEAST_EXPECT(info[jss::ledgers_saved].asUInt () == 3);
+        BEAST_EXPECT(info[jss::txn_db_ms].asUInt () == 9);
+    }
+
+public:
+    void run () override
+    {
+        testSave ();
+        testQueue ();
+    }
+};
+
+// Times saving a synthetic 5k transaction ledger to the
+// transaction and ledger databases.
+class SaveLedgerBench_test : public beast::unit_test::suite
+{
+public:
+    void run () override
+    {
+        using namespace jtx;
+        using namespace std::chrono;
+
+        testcase ("5000 transactions");
+        Env env (*this);
+        std::size_t const count = 5000;
+        auto const ledger = makeSaveLedger (env, count, uint160 (7));
+
+        auto const start = steady_clock::now ();
+        BEAST_EXPECT(pendSaveValidated (env.app (), ledger, true, false));
+        auto const elapsed = steady_clock::now () - start;
+
+        log << "    saved " << count << " transactions in " <<
+            duration_cast<milliseconds> (elapsed).count () << " ms" <<
+            std::endl;
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SaveLedger,ledger,ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(SaveLedgerBench,ledger,ripple);
+
+} // test
+} // ripple
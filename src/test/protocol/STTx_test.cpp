@@ -37,6 +37,46 @@ public:
 
         testcase ("ed25519 signatures");
         testSTTx (KeyType::ed25519);
+
+        testcase ("parsed raw");
+        testRawJson ();
+    }
+
+    void testRawJson()
+    {
+        auto setRaw = [](STTx& tx, std::string const& raw)
+        {
+            tx.setFieldVL (sfRaw, Slice (raw.data (), raw.size ()));
+        };
+
+        STTx tx (ttSQLSTATEMENT,
+            [](auto& obj)
+            {
+                obj.setFieldU16 (sfOpType, 6);
+            });
+        expect (tx.getRawJson () == nullptr);
+
+        setRaw (tx, R"([{"id":1,"name":"a"},{"id":2,"name":"b"}])");
+        auto const raw = tx.getRawJson ();
+        if (expect (raw != nullptr))
+        {
+            expect (raw->isArray () && raw->size () == 2);
+            expect ((*raw)[1u]["name"].asString () == "b");
+        }
+        // parsed once, shared by every caller and by copies
+        expect (tx.getRawJson () == raw);
+        STTx const copy (tx);
+        expect (copy.getRawJson () == raw);
+        expect (tx.buildRawJson ("") == *raw);
+
+        setRaw (tx, R"([{"id":3}])");
+        auto const changed = tx.getRawJson ();
+        if (expect (changed != nullptr && changed != raw))
+            expect ((*changed)[0u]["id"].asInt () == 3);
+        expect (copy.getRawJson () == raw);
+
+        setRaw (tx, "[{");
+        expect (tx.getRawJson () == nullptr);
     }
 
     void testSTTx(KeyType keyType)
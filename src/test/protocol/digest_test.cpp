@@ -26,6 +26,7 @@
 #include <chrono>
 #include <cmath>
 #include <numeric>
+#include <thread>
 #include <vector>
 
 namespace ripple {
@@ -149,14 +150,105 @@ public:
         pass ();
     }
 
+    void testSHA512HalfSM3 ()
+    {
+        testcase ("SHA512Half vs SM3");
+        test<sha512_half_hasher> ("SHA512Half");
+        test<sm3_hasher> ("SM3");
+        pass ();
+    }
+
+    // Hashes the whole dataset split over 1, 2, 4 and 8 threads.
+    template <class Hasher>
+    void testThreads (char const* name)
+    {
+        using namespace std::chrono;
+
+        log << "    " << name << ":" << '\n';
+        for (std::size_t threads : { 1, 2, 4, 8 })
+        {
+            auto const start = high_resolution_clock::now ();
+            std::vector<std::thread> workers;
+            for (std::size_t t = 0; t < threads; ++t)
+            {
+                workers.emplace_back ([this, t, threads]
+                {
+                    for (std::size_t i = t; i < dataset1.size (); i += threads)
+                    {
+                        Hasher h;
+                        h (dataset1[i].data (), dataset1[i].size ());
+                        (void) static_cast<typename Hasher::result_type>(h);
+                    }
+                });
+            }
+            for (auto& w : workers)
+                w.join ();
+            auto const d = high_resolution_clock::now () - start;
+            log <<
+                "       " << threads << " threads = " <<
+                duration_cast<milliseconds>(d).count () << " ms" << std::endl;
+        }
+    }
+
+    void testParallel ()
+    {
+        testcase ("parallel");
+        testThreads<sha512_half_hasher> ("SHA512Half");
+        testThreads<sm3_hasher> ("SM3");
+        pass ();
+    }
+
     void run ()
     {
         testSHA512 ();
         testSHA256 ();
         testRIPEMD160 ();
+        testSHA512HalfSM3 ();
+        testParallel ();
+    }
+};
+
+class sm3_test : public beast::unit_test::suite
+{
+    std::string hash (std::string const& message, std::size_t chunk)
+    {
+        sm3_hasher h;
+        for (std::size_t i = 0; i < message.size (); i += chunk)
+            h (message.data () + i, std::min (chunk, message.size () - i));
+        return to_string (static_cast<sm3_hasher::result_type>(h));
+    }
+
+public:
+    void run ()
+    {
+        testcase ("GB/T 32905 examples");
+
+        // The two examples of the standard, hashed in one piece
+        // and fed in pieces across block boundaries.
+        std::string const abc = "abc";
+        std::string abcd;
+        for (int i = 0; i < 16; ++i)
+            abcd += "abcd";
+
+        for (std::size_t chunk : { 1, 3, 63, 64, 1000 })
+        {
+            BEAST_EXPECT(hash (abc, chunk) ==
+                "66C7F0F462EEEDD9D1F2D46BDC10E4E24167C4875CF2F7A2297DA02B8F4BA8E0");
+            BEAST_EXPECT(hash (abcd, chunk) ==
+                "DEBE9FF92275B8A138604889C18E5A4D6FDB70E5387E5765293DCBA39C0C5732");
+        }
+
+        // the length field just fits, or spills into another block
+        BEAST_EXPECT(hash (std::string (55, 'a'), 7) ==
+            "288337EEF51EEC62E7544D7270424C8DBE656254C99852870A73B2453A6A7FB1");
+        BEAST_EXPECT(hash (std::string (56, 'a'), 7) ==
+            "BA00EBEDAAB54065A5FD4F9F56326016203166BCEE3EED44EA868D59D67AA3C8");
+        BEAST_EXPECT(hash (std::string (1000, 'a'), 100) ==
+            "F4BEDCA973227D45C5B822551D2E762D4CFB0E9AF70B241452545727B5FB046F");
     }
 };
 
 BEAST_DEFINE_TESTSUITE_MANUAL(digest,ripple_data,ripple);
+BEAST_DEFINE_TESTSUITE(sm3,ripple_data,ripple);
 
 } // ripple
@@ -27,10 +27,26 @@
 #include <test/app/SetRegularKey_test.cpp>
 #include <test/app/SetTrust_test.cpp>
 #include <test/app/SHAMapStore_test.cpp>
+#include <test/app/SigVerifier_test.cpp>
+#include <test/app/SpeculativeApply_test.cpp>
+#include <test/app/TableSubscriptions_test.cpp>
+#include <test/app/SQLPredicate_test.cpp>
+#include <test/app/SQLSchemaCache_test.cpp>
+#include <test/app/SQLStatementCache_test.cpp>
+#include <test/app/TableBulkLoad_test.cpp>
+#include <test/app/TableDirectory_test.cpp>
+#include <test/app/TableEntryCache_test.cpp>
+#include <test/app/TableRecordPage_test.cpp>
+#include <test/app/TableStorageExecutor_test.cpp>
+#include <test/app/TableStorageItem_test.cpp>
+#include <test/app/TableSyncItem_test.cpp>
+#include <test/app/TableSyncWorkers_test.cpp>
+#include <test/app/TableTxIndex_test.cpp>
 #include <test/app/Taker_test.cpp>
 #include <test/app/Ticket_test.cpp>
 #include <test/app/Transaction_ordering_test.cpp>
 #include <test/app/TrustAndBalance_test.cpp>
+#include <test/app/TxStoreReadPool_test.cpp>
 #include <test/app/TxQ_test.cpp>
 #include <test/app/ValidatorKeys_test.cpp>
 #include <test/app/ValidatorList_test.cpp>
@@ -24,6 +24,7 @@
 #include <test/ledger/Invariants_test.cpp>
 #include <test/ledger/PaymentSandbox_test.cpp>
 #include <test/ledger/PendingSaves_test.cpp>
+#include <test/ledger/SaveLedger_test.cpp>
 #include <test/ledger/SHAMapV2_test.cpp>
 #include <test/ledger/SkipList_test.cpp>
 #include <test/ledger/View_test.cpp>